@@ -1,6 +1,7 @@
 
 #include "arena.h"
 #include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,9 +12,23 @@
 #define THREAD_COUNT 4
 #define MAX_PER_THREAD (ALLOC_COUNT / THREAD_COUNT)
 
-double millis(clock_t start, clock_t end)
+// Growth steps past ARENA_MAX_ALLOWED_SIZE (4 GiB by default) are skipped; build the
+// library and this suite with a larger -DARENA_MAX_ALLOWED_SIZE to sweep all the way.
+#define GROWTH_START (1ULL << 20)
+#define GROWTH_END (16ULL << 30)
+#define GROWTH_PAGE 4096
+
+// Wall-clock time: clock() sums CPU time over threads and misses time spent blocked.
+struct timespec now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts;
+}
+
+double millis(struct timespec start, struct timespec end)
 {
-	return 1000.0 * (end - start) / CLOCKS_PER_SEC;
+	return 1000.0 * (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e6;
 }
 
 // ────────────────────────────── ARENA BENCHMARKS ──────────────────────────────
@@ -27,13 +42,13 @@ void benchmark_arena_alloc(void)
 		return;
 	}
 
-	clock_t start = clock();
+	struct timespec start = now();
 	for (int i = 0; i < ALLOC_COUNT; ++i)
 	{
 		void* ptr = arena_alloc(arena, ALLOC_SIZE);
 		memset(ptr, 0xAA, ALLOC_SIZE);
 	}
-	clock_t end = clock();
+	struct timespec end = now();
 	printf("[arena_alloc]     %d x %d bytes: %.2f ms\n", ALLOC_COUNT, ALLOC_SIZE, millis(start, end));
 
 	arena_destroy(arena);
@@ -46,13 +61,13 @@ void benchmark_arena_calloc(void)
 	if (!arena)
 		return;
 
-	clock_t start = clock();
+	struct timespec start = now();
 	for (int i = 0; i < ALLOC_COUNT; ++i)
 	{
 		void* ptr = arena_calloc(arena, ALLOC_SIZE, 1);
 		memset(ptr, 0xBB, ALLOC_SIZE);
 	}
-	clock_t end = clock();
+	struct timespec end = now();
 	printf("[arena_calloc]    %d x %d bytes: %.2f ms\n", ALLOC_COUNT, ALLOC_SIZE, millis(start, end));
 
 	arena_destroy(arena);
@@ -63,27 +78,27 @@ void benchmark_arena_calloc(void)
 
 void benchmark_malloc_free(void)
 {
-	clock_t start = clock();
+	struct timespec start = now();
 	for (int i = 0; i < ALLOC_COUNT; ++i)
 	{
 		void* ptr = malloc(ALLOC_SIZE);
 		memset(ptr, 0xAA, ALLOC_SIZE);
 		free(ptr);
 	}
-	clock_t end = clock();
+	struct timespec end = now();
 	printf("[malloc/free]     %d x %d bytes: %.2f ms\n", ALLOC_COUNT, ALLOC_SIZE, millis(start, end));
 }
 
 void benchmark_calloc_free(void)
 {
-	clock_t start = clock();
+	struct timespec start = now();
 	for (int i = 0; i < ALLOC_COUNT; ++i)
 	{
 		void* ptr = calloc(ALLOC_SIZE, 1);
 		memset(ptr, 0xBB, ALLOC_SIZE);
 		free(ptr);
 	}
-	clock_t end = clock();
+	struct timespec end = now();
 	printf("[calloc/free]     %d x %d bytes: %.2f ms\n", ALLOC_COUNT, ALLOC_SIZE, millis(start, end));
 }
 
@@ -112,7 +127,7 @@ void benchmark_arena_multithreaded(void)
 	pthread_t    threads[THREAD_COUNT];
 	thread_arg_t args[THREAD_COUNT];
 
-	clock_t start = clock();
+	struct timespec start = now();
 	for (int i = 0; i < THREAD_COUNT; ++i)
 	{
 		args[i].arena     = arena;
@@ -121,7 +136,7 @@ void benchmark_arena_multithreaded(void)
 	}
 	for (int i = 0; i < THREAD_COUNT; ++i)
 		pthread_join(threads[i], NULL);
-	clock_t end = clock();
+	struct timespec end = now();
 
 	printf("[arena_multithreaded] %d threads × %d allocs: %.2f ms\n", THREAD_COUNT, MAX_PER_THREAD, millis(start, end));
 
@@ -129,6 +144,74 @@ void benchmark_arena_multithreaded(void)
 	arena_delete(&arena);
 }
 
+// ────────────────────────────── GROWTH BENCHMARKS ─────────────────────────────
+
+static void touch_pages(uint8_t* buffer, size_t from, size_t to)
+{
+	for (size_t i = from; i < to; i += GROWTH_PAGE)
+		buffer[i] = 0xCC;
+}
+
+void benchmark_arena_growth(void)
+{
+	t_arena* arena = arena_create(GROWTH_START, true);
+	if (!arena)
+		return;
+
+	void* block = arena_alloc(arena, arena->size);
+	if (block)
+		touch_pages(arena->buffer, 0, arena->size);
+
+	for (unsigned long long target = GROWTH_START * 2; block && target <= GROWTH_END; target *= 2)
+	{
+		if (target > ARENA_MAX_ALLOWED_SIZE)
+		{
+			printf("[arena_grow]      -> %6llu MiB: skipped (above ARENA_MAX_ALLOWED_SIZE)\n", target >> 20);
+			continue;
+		}
+
+		size_t          old_size = arena->size;
+		struct timespec start    = now();
+		bool            grown    = arena_grow(arena, old_size);
+		struct timespec end      = now();
+		if (!grown)
+		{
+			printf("[arena_grow]      -> %6llu MiB: failed\n", target >> 20);
+			break;
+		}
+		printf("[arena_grow]      -> %6llu MiB: %.2f ms\n", target >> 20, millis(start, end));
+
+		block = arena_alloc(arena, arena->size - arena->offset);
+		if (block)
+			touch_pages(arena->buffer, old_size, arena->size);
+	}
+
+	arena_delete(&arena);
+}
+
+void benchmark_realloc_growth(void)
+{
+	size_t   size   = GROWTH_START;
+	uint8_t* buffer = malloc(size);
+	if (!buffer)
+		return;
+	touch_pages(buffer, 0, size);
+
+	for (; (unsigned long long) size * 2 <= GROWTH_END && size * 2 <= ARENA_MAX_ALLOWED_SIZE; size *= 2)
+	{
+		struct timespec start = now();
+		uint8_t*        grown = realloc(buffer, size * 2);
+		struct timespec end   = now();
+		if (!grown)
+			break;
+		buffer = grown;
+		printf("[realloc]         -> %6zu MiB: %.2f ms\n", (size * 2) >> 20, millis(start, end));
+		touch_pages(buffer, size, size * 2);
+	}
+
+	free(buffer);
+}
+
 // ───────────────────────────────────────────────
 
 int main(void)
@@ -144,5 +227,10 @@ int main(void)
 	printf("\n🔀 Multi-threaded Arena Benchmark\n\n");
 	benchmark_arena_multithreaded();
 
+	printf("\n📈 Buffer Growth Benchmark (1 MiB to 16 GiB, capped at ARENA_MAX_ALLOWED_SIZE = %llu MiB, pages touched)\n\n",
+	       (unsigned long long) ARENA_MAX_ALLOWED_SIZE >> 20);
+	benchmark_arena_growth();
+	benchmark_realloc_growth();
+
 	return 0;
 }
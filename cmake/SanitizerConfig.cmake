@@ -14,6 +14,15 @@ option(ARENA_DEBUG_CHECKS    "Enable internal arena checks" OFF)
 # Enable memory poisoning with 0xDEADBEEF to detect use-after-free bugs
 option(ARENA_POISON_MEMORY   "Enable poisoning" OFF)
 
+# Check that released memory still holds its poison when it is handed out again (implies poisoning)
+option(ARENA_POISON_VERIFY   "Verify poison on reuse" OFF)
+
+# Describe arenas to Valgrind Memcheck as mempools (needs valgrind/memcheck.h)
+option(ARENA_VALGRIND        "Enable Valgrind annotations" OFF)
+
+# Poisoned bytes left in front of each allocation in ASAN/Valgrind builds (0 keeps offsets unchanged)
+set(ARENA_REDZONE_SIZE 0 CACHE STRING "Redzone bytes between arena allocations")
+
 # Enable thread-safety across all arenas using internal mutexes
 option(ARENA_ENABLE_THREAD_SAFE "Enable thread-safe arena" OFF)
 
@@ -49,6 +58,24 @@ if (ARENA_POISON_MEMORY)
     message(STATUS "☣️  Memory poisoning enabled")
 endif()
 
+# Poison Verification: report writes through stale pointers after reset/pop
+if (ARENA_POISON_VERIFY)
+    add_compile_definitions(ARENA_POISON_MEMORY ARENA_POISON_VERIFY)
+    message(STATUS "🔎 Poison verification enabled")
+endif()
+
+# Valgrind Annotations: mempool client requests for Memcheck
+if (ARENA_VALGRIND)
+    add_compile_definitions(ARENA_VALGRIND)
+    message(STATUS "🧪 Valgrind annotations enabled")
+endif()
+
+# Redzones: catch overflows into the next allocation (ASAN or Valgrind builds)
+if (ARENA_REDZONE_SIZE GREATER 0)
+    add_compile_definitions(ARENA_REDZONE_SIZE=${ARENA_REDZONE_SIZE})
+    message(STATUS "🧱 Arena redzones: ${ARENA_REDZONE_SIZE} bytes")
+endif()
+
 # Debug Checks: enable internal consistency verification
 if (ARENA_DEBUG_CHECKS)
     add_compile_definitions(ARENA_DEBUG_CHECKS ARENA_DEBUG_LOG)
@@ -36,7 +36,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "internal/arena_backing.h"
 #include "internal/arena_debug.h"
+#include "internal/arena_sanitize.h"
 #include "arena_hooks.h"
 #include "internal/arena_internal.h"
 #include "internal/arena_math.h"
@@ -78,6 +80,47 @@ extern "C"
 	 */
 	typedef size_t (*arena_grow_callback)(size_t current_size, size_t requested_size);
 
+	struct s_arena;
+
+	/**
+	 * @typedef arena_grow_policy_fn
+	 * @brief Function pointer type for context-aware growth policies.
+	 *
+	 * @details
+	 * Unlike `arena_grow_callback`, a policy sees the whole arena (size, offset,
+	 * `stats.growth_history`, its own `grow_policy` parameters) and a user
+	 * context. It is called with the arena lock held and may update the
+	 * `state` of `arena->grow_policy`.
+	 *
+	 * @param arena         Arena being grown.
+	 * @param required_size Bytes needed past the current offset.
+	 * @param context       The policy's `context` pointer.
+	 * @return The new buffer size, at least `offset + required_size`, or `0` to fail.
+	 *
+	 * @ingroup arena_grow_policy
+	 */
+	typedef size_t (*arena_grow_policy_fn)(struct s_arena* arena, size_t required_size, void* context);
+
+	/**
+	 * @struct t_arena_grow_policy
+	 * @brief Growth policy of an arena: a function, its context and parameters.
+	 *
+	 * @details
+	 * Built with one of the `arena_grow_policy_*()` presets or filled in by hand
+	 * for a custom function. When `fn` is `NULL`, the arena uses `grow_cb`.
+	 *
+	 * @ingroup arena_grow_policy
+	 */
+	typedef struct s_arena_grow_policy
+	{
+		arena_grow_policy_fn fn;          /**< Computes the new size; `NULL` falls back to `grow_cb`. */
+		void*                context;     /**< User data passed to `fn`. */
+		double               factor;      /**< Size multiplier (geometric, adaptive). */
+		size_t               step;        /**< Growth cap, increment or window, depending on the preset. */
+		size_t               granularity; /**< Rounding of the new size (`0` = none). */
+		size_t               state;       /**< Mutable state of stateful policies. */
+	} t_arena_grow_policy;
+
 	/**
 	 * @typedef t_arena_marker
 	 * @brief Type used for marking and rolling back arena allocation state.
@@ -90,6 +133,103 @@ extern "C"
 	 */
 	typedef size_t t_arena_marker;
 
+	/**
+	 * @struct t_arena_shrink_policy
+	 * @brief Hysteresis settings for `arena_might_shrink()`.
+	 *
+	 * @details
+	 * With a window set (in resets, milliseconds, or both, whichever ends
+	 * first), `arena_might_shrink()` sizes the arena for the peak usage of the
+	 * last complete window rather than the current offset, and never before a
+	 * first window completed. The target keeps `headroom_percent` above that
+	 * peak and never goes below `min_size`. All zero (the default) keeps the
+	 * immediate `ARENA_MIN_SHRINK_RATIO` behavior.
+	 *
+	 * @ingroup arena_resize
+	 */
+	typedef struct s_arena_shrink_policy
+	{
+		size_t   window_resets;    /**< Resets per window (`0` = no reset-based window). */
+		uint64_t window_ms;        /**< Window length in milliseconds (`0` = no time-based window). */
+		size_t   min_size;         /**< Size the arena is never shrunk below. */
+		unsigned headroom_percent; /**< Headroom kept above the windowed peak. */
+	} t_arena_shrink_policy;
+
+	/**
+	 * @struct t_arena_shrink_window
+	 * @brief Peak-usage tracking behind `t_arena_shrink_policy`.
+	 *
+	 * @ingroup arena_resize_internal
+	 */
+	typedef struct s_arena_shrink_window
+	{
+		size_t   peak;       /**< Peak offset of the current window. */
+		size_t   last_peak;  /**< Peak offset of the last complete window. */
+		size_t   resets;     /**< Resets in the current window. */
+		uint64_t started_ms; /**< Start of the current window (monotonic clock). */
+		bool     complete;   /**< Whether at least one window has completed. */
+		bool     shrunk;     /**< Whether the arena shrank since its last growth. */
+		bool     avoided;    /**< Whether a refused shrink was counted in the current window. */
+	} t_arena_shrink_window;
+
+	/**
+	 * @struct t_arena_guards
+	 * @brief Guard pages placed after the sub-arenas of an arena (see `arena_set_guard_pages()`).
+	 *
+	 * @ingroup arena_sub_internal
+	 */
+	typedef struct s_arena_guards
+	{
+		size_t* offsets;  /**< Buffer offsets of the protected pages, ascending. */
+		size_t  count;    /**< Number of protected pages. */
+		size_t  capacity; /**< Capacity of `offsets`. */
+		bool    enabled;  /**< Whether new sub-arenas get a guard page. */
+	} t_arena_guards;
+
+	/**
+	 * @typedef t_arena_large
+	 * @brief Header of a large allocation served by its own memory mapping.
+	 *
+	 * @details
+	 * Opaque outside of the allocator; see `arena_set_large_threshold()`.
+	 *
+	 * @ingroup arena_alloc
+	 */
+	typedef struct s_arena_large t_arena_large;
+
+	/**
+	 * @typedef t_arena_io_pin
+	 * @brief Buffer range used by a system call made without the arena lock.
+	 *
+	 * @details
+	 * Opaque outside of the library; see `arena_read_fd()` and `arena_writer_flush()`.
+	 *
+	 * @ingroup arena_io
+	 */
+	typedef struct s_arena_io_pin t_arena_io_pin;
+
+	/**
+	 * @typedef t_arena_io_retired
+	 * @brief Buffer left behind by a growth while a system call was still using it.
+	 *
+	 * @details
+	 * Opaque outside of the library; released once the last pin is gone.
+	 *
+	 * @ingroup arena_io
+	 */
+	typedef struct s_arena_io_retired t_arena_io_retired;
+
+	/**
+	 * @typedef t_arena_budget
+	 * @brief Memory budget shared by a group of arenas.
+	 *
+	 * @details
+	 * Defined in `arena_budget.h`; see `arena_budget_attach()`.
+	 *
+	 * @ingroup arena_budget
+	 */
+	typedef struct s_arena_budget t_arena_budget;
+
 	/**
 	 * @struct t_arena
 	 * @brief The main memory arena structure used for fast allocation.
@@ -103,16 +243,31 @@ extern "C"
 	 * - `size`: Total size of the buffer in bytes.
 	 * - `offset`: Current bump pointer offset (number of bytes used).
 	 * - `grow_cb`: Optional callback for dynamic resizing.
+	 * - `grow_policy`: Context-aware growth policy, used instead of `grow_cb` when set.
 	 * - `parent_ref`: If this is a sub-arena, points to the parent arena.
 	 * - `marker_stack`: Stack of saved markers for scoped rollback.
 	 * - `marker_stack_top`: Index of the top of the marker stack.
 	 * - `owns_buffer`: Whether the arena owns the memory and should free it.
 	 * - `can_grow`: Whether this arena can grow dynamically.
 	 * - `is_destroying`: Flag indicating the arena is currently being destroyed.
+	 * - `is_frozen`: Flag indicating the arena is read-only (see `arena_freeze()`).
+	 * - `backing`: Where the buffer memory comes from (heap block or memory mapping).
+	 * - `large_list`: Dedicated mappings of oversized allocations, newest first.
+	 * - `large_threshold`: Size from which allocations bypass the buffer (`0` = never).
+	 * - `guards`: `PROT_NONE` pages placed after sub-arenas (see `arena_set_guard_pages()`).
+	 * - `cycle_peak`: Peak offset since the last `arena_reset()`.
+	 * - `shrink_policy`: Hysteresis settings of `arena_might_shrink()`.
+	 * - `shrink_window`: Windowed peak usage tracked for the shrink policy.
 	 *
 	 * Thread Safety:
 	 * - `lock`: Mutex used when `ARENA_ENABLE_THREAD_SAFE` is enabled.
 	 * - `use_lock`: Whether this arena uses thread-safe locking internally.
+	 * - `pregrow_percent`: High-water mark of background pre-growth (`0` = not watched).
+	 * - `pregrow_pending`: Whether a pre-growth request is queued for the worker.
+	 * - `pregrow_stalled`: Size at which the last pre-growth failed (no retry until it changes).
+	 * - `bias_owner`, `bias_depth`, `bias_revoke`: Biased locking state (see `arena_enable_biased_lock()`).
+	 * - `io_pins`, `io_retired`: Buffer ranges in use by I/O made without the lock, and the buffers
+	 *   kept alive for it after a growth (see `arena_read_fd()`).
 	 *
 	 * Debug and Instrumentation:
 	 * - `stats`: Runtime statistics for allocations, peak usage, etc.
@@ -127,20 +282,44 @@ extern "C"
 	 */
 	typedef struct s_arena
 	{
-		uint8_t*            buffer;     /**< Pointer to the memory buffer. */
-		size_t              size;       /**< Total size of the buffer. */
-		size_t              offset;     /**< Current used offset (bump pointer). */
-		arena_grow_callback grow_cb;    /**< Optional callback for dynamic resizing. */
-		struct s_arena*     parent_ref; /**< Reference to parent arena if this is a sub-arena. */
-		t_arena_marker      marker_stack[ARENA_MAX_STACK_DEPTH]; /**< Stack of saved markers. */
-		int                 marker_stack_top;                    /**< Top index of marker stack. */
-		_Atomic bool        owns_buffer;                         /**< Whether this arena owns the buffer memory. */
-		_Atomic bool        can_grow;                            /**< Whether the arena supports dynamic growth. */
-		_Atomic bool        is_destroying;                       /**< Indicates the arena is being destroyed. */
+		uint8_t*              buffer;      /**< Pointer to the memory buffer. */
+		size_t                size;        /**< Total size of the buffer. */
+		size_t                offset;      /**< Current used offset (bump pointer). */
+		arena_grow_callback   grow_cb;     /**< Optional callback for dynamic resizing. */
+		t_arena_grow_policy   grow_policy; /**< Growth policy, preferred over `grow_cb`. */
+		struct s_arena*       parent_ref;  /**< Reference to parent arena if this is a sub-arena. */
+		t_arena_marker        marker_stack[ARENA_MAX_STACK_DEPTH]; /**< Stack of saved markers. */
+		int                   marker_stack_top;                    /**< Top index of marker stack. */
+		_Atomic bool          owns_buffer;                         /**< Whether this arena owns the buffer memory. */
+		_Atomic bool          can_grow;                            /**< Whether the arena supports dynamic growth. */
+		_Atomic bool          is_destroying;                       /**< Indicates the arena is being destroyed. */
+		_Atomic bool          is_frozen;                           /**< Indicates the arena is read-only. */
+		t_arena_backing       backing;                             /**< Heap or mapping metadata for the buffer. */
+		t_arena_large*        large_list;                          /**< Dedicated mappings of large allocations. */
+		size_t                large_threshold;                     /**< Size from which allocations get a mapping. */
+		t_arena_guards        guards;                              /**< Guard pages after sub-arenas. */
+		size_t                cycle_peak;                          /**< Peak offset since the last reset. */
+		t_arena_shrink_policy shrink_policy;                       /**< Shrink hysteresis settings. */
+		t_arena_shrink_window shrink_window;                       /**< Windowed peak usage for shrinking. */
+		t_arena_budget*       budget;                              /**< Budget charged for this arena's memory. */
+		size_t                budget_charged;                      /**< Bytes currently charged to `budget`. */
+		unsigned              create_flags;                        /**< `ARENA_CREATE_*` flags kept across growth. */
+		size_t                clean_from;                          /**< Bytes from here to `size` are known to be zero. */
 
 #ifdef ARENA_ENABLE_THREAD_SAFE
-		pthread_mutex_t lock;     /**< Mutex for thread-safe operations. */
-		bool            use_lock; /**< Enable or disable internal locking. */
+		pthread_mutex_t     lock;            /**< Mutex for thread-safe operations. */
+		bool                use_lock;        /**< Enable or disable internal locking. */
+		unsigned            pregrow_percent; /**< Usage percentage that triggers a pre-growth. */
+		_Atomic bool        pregrow_pending; /**< A pre-growth request is queued. */
+		size_t              pregrow_stalled; /**< Size at which the last pre-growth failed. */
+		bool                trim_registered; /**< Registered with the pressure trimmer. */
+		bool                prezero_watched; /**< Dirty memory is zeroed in the background after resets. */
+		_Atomic bool        prezero_pending; /**< A pre-zeroing pass is queued. */
+		_Atomic(uintptr_t)  bias_owner;      /**< Bias owner token, or an `ARENA_BIAS_*` state. */
+		_Atomic unsigned    bias_depth;      /**< Owner's lock depth on the biased fast path. */
+		_Atomic bool        bias_revoke;     /**< The bias is being (or was) revoked. */
+		t_arena_io_pin*     io_pins;         /**< Buffer ranges in use by I/O made without the lock. */
+		t_arena_io_retired* io_retired;      /**< Former buffers kept until the last pin is gone. */
 #endif
 
 		t_arena_stats stats; /**< Allocation and memory usage statistics. */
@@ -163,6 +342,10 @@ extern "C"
 	void* arena_alloc_labeled(t_arena* arena, size_t size, const char* label);
 	void* arena_alloc_aligned_labeled(t_arena* arena, size_t size, size_t alignment, const char* label);
 
+	t_arena_error arena_try_alloc(t_arena* arena, size_t size, void** out);
+	t_arena_error arena_try_alloc_aligned(t_arena* arena, size_t size, size_t alignment, void** out);
+	t_arena_error arena_try_calloc(t_arena* arena, size_t count, size_t size, void** out);
+
 	void* arena_calloc(t_arena* arena, size_t count, size_t size);
 	void* arena_calloc_aligned(t_arena* arena, size_t count, size_t size, size_t alignment);
 	void* arena_calloc_labeled(t_arena* arena, size_t count, size_t size, const char* label);
@@ -174,11 +357,18 @@ extern "C"
 	bool arena_alloc_sub_labeled_aligned(t_arena* parent, t_arena* child, size_t size, size_t alignment,
 	                                     const char* label);
 
+	void arena_set_guard_pages(t_arena* arena, bool enabled);
+	bool arena_guard_pages(t_arena* arena);
+
 	void* arena_realloc_last(t_arena* arena, void* old_ptr, size_t old_size, size_t new_size);
 
+	void   arena_set_large_threshold(t_arena* arena, size_t threshold);
+	size_t arena_large_threshold(t_arena* arena);
+
 	bool arena_grow(t_arena* arena, size_t required_size);
 	void arena_shrink(t_arena* arena, size_t new_size);
 	bool arena_might_shrink(t_arena* arena);
+	void arena_set_shrink_policy(t_arena* arena, t_arena_shrink_policy policy);
 
 	size_t         arena_used(t_arena* arena);
 	size_t         arena_remaining(t_arena* arena);
@@ -186,8 +376,14 @@ extern "C"
 	t_arena_marker arena_mark(t_arena* arena);
 	void           arena_pop(t_arena* arena, t_arena_marker marker);
 
+	bool arena_freeze(t_arena* arena);
+	bool arena_seal(t_arena* arena);
+	bool arena_is_frozen(const t_arena* arena);
+
 #ifdef __cplusplus
 }
 #endif
 
+#include "internal/arena_lock.h"
+
 #endif // ARENA_H
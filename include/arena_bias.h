@@ -0,0 +1,74 @@
+/**
+ * @file arena_bias.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Biased locking: an owner-thread fast path for mostly single-threaded arenas.
+ *
+ * @details
+ * A thread-safe arena pays `pthread_mutex_lock()` on every `ARENA_LOCK`, even
+ * when a single thread does nearly all of its work. Once biased with
+ * `arena_enable_biased_lock()`, the first thread that locks the arena becomes
+ * its owner, and from then on the owner enters and leaves the arena with two
+ * plain stores and no atomic read-modify-write or mutex.
+ *
+ * The first time another thread locks the arena, it revokes the bias: it
+ * raises a flag, forces a memory barrier on every thread of the process
+ * (`membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED)`), waits until the owner is
+ * outside the arena, and from then on every thread, owner included, takes the
+ * mutex. Revocation is permanent, so an arena that is shared after all costs
+ * one handshake and then behaves as before.
+ *
+ * @note
+ * Requires `ARENA_ENABLE_THREAD_SAFE`, an arena that uses its lock, and Linux
+ * `membarrier()`. Background workers (pre-growth, pre-zeroing, the trimmer)
+ * lock the arenas they watch, so the first pass of a worker revokes the bias.
+ *
+ * @ingroup arena_bias
+ *
+ * @example
+ * @code
+ * t_arena* arena = arena_create(1 << 20, true);
+ * arena_enable_biased_lock(arena);
+ * for (int i = 0; i < n; ++i)
+ *     arena_alloc(arena, 64);   // the owner never touches the mutex
+ * // A monitor thread calling arena_get_stats(arena) revokes the bias once.
+ * @endcode
+ */
+
+#ifndef ARENA_BIAS_H
+#define ARENA_BIAS_H
+
+#include "arena.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Bias `arena` towards the next thread that locks it.
+	 *
+	 * @return `true` if the bias is (or already was) in force, `false` if the
+	 * arena has no lock, the bias was revoked, or `membarrier()` is unavailable.
+	 *
+	 * @ingroup arena_bias
+	 */
+	bool arena_enable_biased_lock(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Whether `arena` is biased and the bias was not revoked yet.
+	 *
+	 * @ingroup arena_bias
+	 */
+	bool arena_is_biased(t_arena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_BIAS_H
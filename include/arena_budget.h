@@ -0,0 +1,216 @@
+/**
+ * @file arena_budget.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Memory budgets: hard caps on the memory of a group of arenas.
+ *
+ * @details
+ * A growable arena otherwise grows until `ARENA_MAX_ALLOWED_SIZE` or until the
+ * system runs out of memory. Attaching arenas to a `t_arena_budget` caps the
+ * total they may hold: every byte an attached arena obtains (its buffer,
+ * growths, large-object mappings) is charged to the budget first, and every
+ * byte it gives back (shrinks, released mappings, destruction) is credited.
+ *
+ * Budgets nest: a budget with a parent charges the parent as well, so a
+ * process-wide budget can contain one budget per tenant. A charge succeeds only
+ * if it fits every level, and is rolled back entirely otherwise.
+ *
+ * When a charge does not fit, the policy of the budget that overflowed decides:
+ * - `ARENA_BUDGET_FAIL`: the allocation fails at once.
+ * - `ARENA_BUDGET_RECLAIM`: the reclaim callback is asked to free memory
+ *   (e.g. shrink or reset idle arenas of the group), then the charge is retried.
+ * - `ARENA_BUDGET_BLOCK`: the caller waits until other arenas of the budget
+ *   give memory back, up to a timeout (requires `ARENA_ENABLE_THREAD_SAFE`;
+ *   without it the policy behaves like `ARENA_BUDGET_FAIL`).
+ *
+ * @note
+ * Charges happen with the growing arena's lock held. A reclaim callback may
+ * shrink or reset other arenas, but must not touch the arena being grown, and
+ * a blocked growth keeps that arena locked until it returns. A budget must
+ * outlive every arena attached to it and every child budget.
+ *
+ * @ingroup arena_budget
+ *
+ * @example
+ * @code
+ * static t_arena_budget process, tenant_a;
+ * arena_budget_init(&process, 512UL << 20, NULL);
+ * arena_budget_init(&tenant_a, 128UL << 20, &process);
+ * arena_budget_set_policy(&tenant_a, ARENA_BUDGET_BLOCK, 200);
+ *
+ * t_arena* arena = arena_create_in_budget(&tenant_a, 1 << 20, true);
+ * void*    block = arena_alloc(arena, size); // NULL once tenant_a is exhausted
+ * arena_delete(&arena);                      // credits tenant_a and process
+ * @endcode
+ */
+
+#ifndef ARENA_BUDGET_H
+#define ARENA_BUDGET_H
+
+#include "arena.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Maximum number of reclaim callbacks run for a single charge.
+#ifndef ARENA_BUDGET_MAX_RECLAIMS
+#define ARENA_BUDGET_MAX_RECLAIMS 4
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @enum e_arena_budget_policy
+	 * @brief What a charge does when it does not fit the budget.
+	 *
+	 * @ingroup arena_budget
+	 */
+	typedef enum e_arena_budget_policy
+	{
+		ARENA_BUDGET_FAIL,    /**< Fail the allocation. */
+		ARENA_BUDGET_RECLAIM, /**< Run the reclaim callback, then retry. */
+		ARENA_BUDGET_BLOCK,   /**< Wait for memory to be credited, up to a timeout. */
+	} t_arena_budget_policy;
+
+	/**
+	 * @typedef arena_budget_reclaim_fn
+	 * @brief Ask the owner of a budget to free memory.
+	 *
+	 * @param budget  Budget that overflowed.
+	 * @param needed  Bytes missing for the pending charge.
+	 * @param context User context given to `arena_budget_set_reclaim()`.
+	 *
+	 * @return Bytes released (`0` stops the retries).
+	 *
+	 * @ingroup arena_budget
+	 */
+	typedef size_t (*arena_budget_reclaim_fn)(t_arena_budget* budget, size_t needed, void* context);
+
+	/**
+	 * @struct s_arena_budget
+	 * @brief Memory budget shared by a group of arenas.
+	 *
+	 * @details
+	 * Initialize with `arena_budget_init()`. The counters can be read at any
+	 * time with `atomic_load()`.
+	 *
+	 * @ingroup arena_budget
+	 */
+	struct s_arena_budget
+	{
+		size_t                  limit;           /**< Maximum bytes charged (`0` = unlimited). */
+		_Atomic size_t          used;            /**< Bytes currently charged. */
+		_Atomic size_t          peak;            /**< Highest value of `used`. */
+		_Atomic size_t          denials;         /**< Charges that failed. */
+		_Atomic size_t          reclaims;        /**< Reclaim callbacks run. */
+		_Atomic size_t          waits;           /**< Charges that blocked. */
+		t_arena_budget*         parent;          /**< Enclosing budget, also charged. */
+		t_arena_budget_policy   policy;          /**< Behavior when a charge does not fit. */
+		uint64_t                timeout_ms;      /**< Longest wait of `ARENA_BUDGET_BLOCK` (`0` = none). */
+		arena_budget_reclaim_fn reclaim_cb;      /**< Callback of `ARENA_BUDGET_RECLAIM`. */
+		void*                   reclaim_context; /**< Context passed to `reclaim_cb`. */
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+		pthread_mutex_t wait_lock; /**< Guards waiting on `credited`. */
+		pthread_cond_t  credited;  /**< Broadcast when memory is credited. */
+#endif
+	};
+
+	/**
+	 * @brief
+	 * Initialize a budget of `limit` bytes, nested in `parent` if not `NULL`.
+	 *
+	 * @details
+	 * The budget starts empty with the `ARENA_BUDGET_FAIL` policy.
+	 *
+	 * @return `true` on success, `false` if its synchronization could not be set up.
+	 *
+	 * @ingroup arena_budget
+	 */
+	bool arena_budget_init(t_arena_budget* budget, size_t limit, t_arena_budget* parent);
+
+	/**
+	 * @brief
+	 * Release the resources of a budget no arena is attached to anymore.
+	 *
+	 * @ingroup arena_budget
+	 */
+	void arena_budget_destroy(t_arena_budget* budget);
+
+	/**
+	 * @brief
+	 * Select what happens when a charge does not fit.
+	 *
+	 * @param budget     Budget to configure.
+	 * @param policy     Over-budget policy.
+	 * @param timeout_ms Longest wait of `ARENA_BUDGET_BLOCK`, `0` to wait indefinitely.
+	 *
+	 * @ingroup arena_budget
+	 */
+	void arena_budget_set_policy(t_arena_budget* budget, t_arena_budget_policy policy, uint64_t timeout_ms);
+
+	/**
+	 * @brief
+	 * Set the callback run by the `ARENA_BUDGET_RECLAIM` policy.
+	 *
+	 * @ingroup arena_budget
+	 */
+	void arena_budget_set_reclaim(t_arena_budget* budget, arena_budget_reclaim_fn reclaim_cb, void* context);
+
+	/**
+	 * @brief
+	 * Bytes currently charged to `budget`, including its child budgets.
+	 *
+	 * @ingroup arena_budget
+	 */
+	size_t arena_budget_used(const t_arena_budget* budget);
+
+	/**
+	 * @brief
+	 * Charge `arena`'s memory to `budget` from now on.
+	 *
+	 * @details
+	 * The arena's current buffer (if owned) and large allocations are charged
+	 * under the budget's policy. An arena that is already attached is detached
+	 * first. Fails, leaving the arena detached, if the memory does not fit.
+	 *
+	 * @return `true` if the arena is attached.
+	 *
+	 * @ingroup arena_budget
+	 */
+	bool arena_budget_attach(t_arena* arena, t_arena_budget* budget);
+
+	/**
+	 * @brief
+	 * Credit everything `arena` holds back to its budget and stop tracking it.
+	 *
+	 * @ingroup arena_budget
+	 */
+	void arena_budget_detach(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Create a heap arena whose initial buffer is charged to `budget`.
+	 *
+	 * @details
+	 * The buffer is charged before it is allocated, so creation itself obeys
+	 * the budget's policy.
+	 *
+	 * @return The attached arena, or `NULL` if the budget or the allocation refused it.
+	 *
+	 * @ingroup arena_budget
+	 *
+	 * @see arena_create
+	 */
+	t_arena* arena_create_in_budget(t_arena_budget* budget, size_t size, bool allow_grow);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_BUDGET_H
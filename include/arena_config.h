@@ -26,6 +26,72 @@
 #define ARENA_MAX_ALLOWED_SIZE (1ULL << 32)
 #endif
 
+/// Owned buffers of at least this size are mmap-backed and resized with mremap
+#ifndef ARENA_MMAP_THRESHOLD
+#define ARENA_MMAP_THRESHOLD (1UL << 20)
+#endif
+
+/// Default size from which allocations get a dedicated mapping (0 disables the bypass)
+#ifndef ARENA_LARGE_THRESHOLD
+#define ARENA_LARGE_THRESHOLD 0
+#endif
+
+/// Maximum number of arenas watched by the background pre-growth worker
+#ifndef ARENA_PREGROW_MAX_ARENAS
+#define ARENA_PREGROW_MAX_ARENAS 64
+#endif
+
+/// Address space reserved for a watched arena, in multiples of its size, so the worker can grow it in place
+#ifndef ARENA_PREGROW_RESERVE_FACTOR
+#define ARENA_PREGROW_RESERVE_FACTOR 16
+#endif
+
+/// Bytes of freshly grown memory the pre-growth worker faults in per lock hold
+#ifndef ARENA_PREGROW_FAULT_CHUNK
+#define ARENA_PREGROW_FAULT_CHUNK (1UL << 20)
+#endif
+
+/// Maximum number of arenas watched by the pre-zeroing worker
+#ifndef ARENA_PREZERO_MAX_ARENAS
+#define ARENA_PREZERO_MAX_ARENAS 128
+#endif
+
+/// Maximum number of arenas and scratch pools registered with the pressure trimmer
+#ifndef ARENA_TRIM_MAX_ARENAS
+#define ARENA_TRIM_MAX_ARENAS 64
+#endif
+#ifndef ARENA_TRIM_MAX_POOLS
+#define ARENA_TRIM_MAX_POOLS 16
+#endif
+
+/// Capacity of the background reclaimer's queue of destroyed buffers
+#ifndef ARENA_RECLAIM_QUEUE_SIZE
+#define ARENA_RECLAIM_QUEUE_SIZE 64
+#endif
+
+/// Buffers cached per size class, and arena structs cached, by the recycle cache
+#ifndef ARENA_RECYCLE_BIN_DEPTH
+#define ARENA_RECYCLE_BIN_DEPTH 8
+#endif
+#ifndef ARENA_RECYCLE_MAX_STRUCTS
+#define ARENA_RECYCLE_MAX_STRUCTS 64
+#endif
+
+/// Verifying poison on reuse needs poisoning
+#if defined(ARENA_POISON_VERIFY) && !defined(ARENA_POISON_MEMORY)
+#define ARENA_POISON_MEMORY
+#endif
+
+/// Recent allocations remembered per arena to name the owner of corrupted poison
+#ifndef ARENA_POISON_HISTORY
+#define ARENA_POISON_HISTORY 32
+#endif
+
+/// Poisoned bytes left in front of each allocation in AddressSanitizer/Valgrind builds (0 keeps offsets unchanged)
+#ifndef ARENA_REDZONE_SIZE
+#define ARENA_REDZONE_SIZE 0
+#endif
+
 /// Default alignment value supported
 #ifndef ARENA_DEFAULT_ALIGNMENT
 #define ARENA_DEFAULT_ALIGNMENT 8
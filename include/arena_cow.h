@@ -0,0 +1,68 @@
+/**
+ * @file arena_cow.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Copy-on-write clones of mapped arenas for cheap speculative state.
+ *
+ * @details
+ * `arena_clone_cow()` maps the file behind a persistent (`arena_open_persistent()`)
+ * or memfd (`arena_create_memfd()`) arena a second time with `MAP_PRIVATE`.
+ * The clone starts with the same contents and offset as its source, but no
+ * byte is copied up front: the kernel duplicates a page only when the clone
+ * first writes to it. Cloning therefore costs a few system calls no matter
+ * how large the arena is.
+ *
+ * A clone is either:
+ * - discarded with `arena_delete()`, dropping every private page; or
+ * - promoted with `arena_cow_promote()`, which writes the pages that differ
+ *   back into the source arena and adopts the clone's offset.
+ *
+ * @note
+ * Clones cannot grow or shrink, and the source arena should not be modified
+ * while clones are alive: pages the clone has not written yet still show the
+ * source's current contents.
+ *
+ * @ingroup arena_cow
+ */
+
+#ifndef ARENA_COW_H
+#define ARENA_COW_H
+
+#include "arena.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Create a private copy-on-write clone of a file- or memfd-backed arena.
+	 *
+	 * @param source Arena to clone (must use a `ARENA_BACKING_FILE` or `ARENA_BACKING_MEMFD` backing).
+	 * @return A heap-allocated clone to release with `arena_delete()`, or `NULL` on failure.
+	 *
+	 * @ingroup arena_cow
+	 */
+	t_arena* arena_clone_cow(t_arena* source);
+
+	/**
+	 * @brief
+	 * Write the pages a clone modified back into its source and adopt its offset.
+	 *
+	 * @param clone  Clone created by `arena_clone_cow()`.
+	 * @param source Arena the clone was created from.
+	 * @return `true` on success, `false` if the arenas are unrelated or `source` is too small.
+	 *
+	 * @ingroup arena_cow
+	 */
+	bool arena_cow_promote(t_arena* clone, t_arena* source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_COW_H
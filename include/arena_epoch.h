@@ -0,0 +1,217 @@
+/**
+ * @file arena_epoch.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Epoch rings: generational arenas reset once lock-free readers are done.
+ *
+ * @details
+ * A common pattern is to build an immutable snapshot in an arena, publish a
+ * pointer to it, and let reader threads use it in place. The arena can only
+ * be reset once no reader still holds a pointer into it, which usually means
+ * reference counts or a reader lock.
+ *
+ * An epoch ring replaces them with epoch-based reclamation over `count`
+ * fixed-size arenas. The writer allocates from `arena_epoch_current()`, the
+ * arena of the current epoch, and publishes its snapshot there. Calling
+ * `arena_epoch_advance()` moves to the next epoch, whose arena is the oldest
+ * of the ring and is reset first, but only once no reader can still be using
+ * it.
+ *
+ * Each reader thread registers once and brackets its reads with
+ * `arena_epoch_enter()` / `arena_epoch_exit()`. Entering records the current
+ * epoch in the reader's own cache line; nothing is shared between readers
+ * and no lock is taken, so reads scale with the number of threads.
+ *
+ * Contract:
+ * - When the writer advances, everything readers can reach must live in the
+ *   current arena: republish (or copy) older data before advancing.
+ * - A reader that entered at epoch `e` may use data of epochs `e - 1` and
+ *   later, so the arena of epoch `k` is reset once every active reader
+ *   entered at `k + 2` or later. With three arenas or more, readers of the
+ *   current epoch never hold the writer back; with two, advancing waits for
+ *   every reader to leave.
+ * - The writer side (allocating, advancing) belongs to one thread at a time.
+ *
+ * Arenas of a ring do not grow, since growing could move a buffer that
+ * readers are using.
+ *
+ * @ingroup arena_epoch
+ *
+ * @example
+ * @code
+ * // Writer
+ * t_config* config = arena_alloc(arena_epoch_current(&ring), sizeof(*config));
+ * build_config(config);
+ * atomic_store_explicit(&g_config, config, memory_order_release);
+ * arena_epoch_advance(&ring);
+ *
+ * // Reader
+ * arena_epoch_enter(reader);
+ * const t_config* config = atomic_load_explicit(&g_config, memory_order_acquire);
+ * use_config(config);
+ * arena_epoch_exit(reader);
+ * @endcode
+ */
+
+#ifndef ARENA_EPOCH_H
+#define ARENA_EPOCH_H
+
+#include "arena.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Maximum number of arenas in an epoch ring.
+#ifndef ARENA_EPOCH_MAX_ARENAS
+#define ARENA_EPOCH_MAX_ARENAS 8
+#endif
+
+/// Maximum number of readers registered with an epoch ring at once.
+#ifndef ARENA_EPOCH_MAX_READERS
+#define ARENA_EPOCH_MAX_READERS 64
+#endif
+
+/// Alignment of reader records, so readers do not share cache lines.
+#define ARENA_EPOCH_CACHE_LINE 64
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	struct s_arena_epoch;
+
+	/**
+	 * @brief
+	 * Per-thread reader record of an epoch ring.
+	 *
+	 * @details
+	 * Written only by its reader thread and read by the writer when it
+	 * advances.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	typedef struct s_arena_epoch_reader
+	{
+		_Alignas(ARENA_EPOCH_CACHE_LINE) _Atomic uint64_t epoch; ///< Epoch entered, or `0` outside
+		unsigned              depth;                             ///< Nesting depth of `arena_epoch_enter()`
+		atomic_bool           in_use;                            ///< Whether a thread registered this record
+		struct s_arena_epoch* ring;                              ///< Ring the record belongs to
+	} t_arena_epoch_reader;
+
+	/**
+	 * @brief
+	 * Ring of generational arenas with its epoch counter and reader records.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	typedef struct s_arena_epoch
+	{
+		t_arena              arenas[ARENA_EPOCH_MAX_ARENAS];   ///< Arena of epoch `e` is `arenas[e % count]`
+		size_t               count;                            ///< Number of arenas in the ring
+		_Atomic uint64_t     epoch;                            ///< Current epoch (starts at 1)
+		t_arena_epoch_reader readers[ARENA_EPOCH_MAX_READERS]; ///< Reader records
+	} t_arena_epoch;
+
+	/**
+	 * @brief
+	 * Initialize an epoch ring of `count` fixed-size arenas.
+	 *
+	 * @param ring       Ring to initialize.
+	 * @param count      Number of arenas, from 2 to `ARENA_EPOCH_MAX_ARENAS`.
+	 * @param arena_size Size of each arena in bytes.
+	 *
+	 * @return `true` on success, `false` otherwise.
+	 *
+	 * @ingroup arena_epoch
+	 *
+	 * @see arena_epoch_destroy
+	 */
+	bool arena_epoch_init(t_arena_epoch* ring, size_t count, size_t arena_size);
+
+	/**
+	 * @brief
+	 * Destroy every arena of a ring; no reader may be inside.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	void arena_epoch_destroy(t_arena_epoch* ring);
+
+	/**
+	 * @brief
+	 * Arena of the current epoch, for the writer to allocate from.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	t_arena* arena_epoch_current(t_arena_epoch* ring);
+
+	/**
+	 * @brief
+	 * Current epoch of a ring.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	uint64_t arena_epoch_now(t_arena_epoch* ring);
+
+	/**
+	 * @brief
+	 * Advance to the next epoch if no reader still uses its arena.
+	 *
+	 * @return `true` if the ring advanced, `false` if a reader holds it back.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	bool arena_epoch_try_advance(t_arena_epoch* ring);
+
+	/**
+	 * @brief
+	 * Advance to the next epoch, waiting for readers that still use its arena.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	void arena_epoch_advance(t_arena_epoch* ring);
+
+	/**
+	 * @brief
+	 * Register the calling thread as a reader of `ring`.
+	 *
+	 * @return The thread's reader record, or `NULL` if every record is taken.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	t_arena_epoch_reader* arena_epoch_register(t_arena_epoch* ring);
+
+	/**
+	 * @brief
+	 * Give a reader record back; the reader must be outside.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	void arena_epoch_unregister(t_arena_epoch_reader* reader);
+
+	/**
+	 * @brief
+	 * Enter the current epoch; calls nest.
+	 *
+	 * @return The epoch the reader is in.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	uint64_t arena_epoch_enter(t_arena_epoch_reader* reader);
+
+	/**
+	 * @brief
+	 * Leave the epoch entered by the matching `arena_epoch_enter()`.
+	 *
+	 * @ingroup arena_epoch
+	 */
+	void arena_epoch_exit(t_arena_epoch_reader* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_EPOCH_H
@@ -81,6 +81,136 @@
  * @ingroup arena_internal
  */
 
+/**
+ * @defgroup arena_grow_policy Growth Policies
+ * @brief Context-aware, per-arena growth strategies with built-in presets.
+ *
+ * @details
+ * A `t_arena_grow_policy` sees the whole arena and a user context. Presets cover geometric
+ * growth with a step cap, linear steps, page or huge-page rounding, and an adaptive factor
+ * that follows how often the arena grows. `grow_cb` remains the fallback.
+ * @ingroup arena_resize
+ */
+
+/**
+ * @defgroup arena_pregrow Background Pre-Growth
+ * @brief Worker thread that grows watched arenas before they fill up.
+ *
+ * @details
+ * Once an allocation pushes a watched arena past its high-water mark, a background worker
+ * grows it in place with its growth callback and faults in the new pages, so the allocation
+ * path finds ready memory instead of paying for the copy inline.
+ * @ingroup arena_resize
+ */
+
+/**
+ * @defgroup arena_pregrow_internal Background Pre-Growth Internals
+ * @brief Worker loop, registry and notification path.
+ * @ingroup arena_internal
+ */
+
+/**
+ * @defgroup arena_budget Memory Budgets
+ * @brief Hard caps on the memory held by groups of arenas.
+ *
+ * @details
+ * Arenas attached to a budget charge it for every byte they obtain and credit it for every
+ * byte they release. Budgets nest (process, then tenant), and an over-budget policy decides
+ * whether a refused charge fails, runs a reclaim callback, or waits for memory to be freed.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_budget_internal Memory Budget Internals
+ * @brief Charge, credit and wait helpers.
+ * @ingroup arena_internal
+ */
+
+/**
+ * @defgroup arena_trim Pressure Trimming
+ * @brief Background release of idle arena memory when the system runs short.
+ *
+ * @details
+ * A trimmer thread samples PSI (`/proc/pressure/memory`), cgroup `memory.events` or a custom
+ * source. Under pressure it shrinks and decommits the registered arenas that went idle (all
+ * of them under full pressure) and trims the free slots of registered scratch pools.
+ * @ingroup arena_resize
+ */
+
+/**
+ * @defgroup arena_trim_internal Pressure Trimming Internals
+ * @brief Trimmer thread, registry and pressure parsing.
+ * @ingroup arena_internal
+ */
+
+/**
+ * @defgroup arena_reclaim Deferred Buffer Release
+ * @brief Background thread that releases the buffers of destroyed arenas.
+ *
+ * @details
+ * While the reclaimer runs, `arena_destroy()` queues large private buffers instead of
+ * unmapping them on the calling thread. The queue is bounded (full means inline release),
+ * and `arena_reclaimer_flush()` / `arena_reclaimer_stop()` drain it for shutdown.
+ * @ingroup arena_cleanup
+ */
+
+/**
+ * @defgroup arena_reclaim_internal Deferred Buffer Release Internals
+ * @brief Queue and release loop of the reclaimer.
+ * @ingroup arena_internal
+ */
+
+/**
+ * @defgroup arena_prezero Background Pre-Zeroing
+ * @brief Clean-memory watermark and a low-priority worker that zeroes reset arenas.
+ *
+ * @details
+ * Each arena knows from which offset its buffer is still zero, so `arena_calloc()` only clears
+ * what lies below. Watched arenas have the memory dirtied by the previous cycle zeroed by a
+ * `SCHED_IDLE` worker after each reset (or scratch release), top down, stopping at the offset.
+ * @ingroup arena_alloc
+ */
+
+/**
+ * @defgroup arena_prezero_internal Background Pre-Zeroing Internals
+ * @brief Worker loop, registry and notification path.
+ * @ingroup arena_internal
+ */
+
+/**
+ * @defgroup arena_prefault Prefaulting & Memory Locking
+ * @brief Arenas whose pages are faulted in, and optionally locked in RAM, ahead of use.
+ *
+ * @details
+ * `arena_create_with_flags()` populates the buffer at creation (`ARENA_CREATE_PREFAULT`) and
+ * can `mlock()` it (`ARENA_CREATE_MLOCK`); both hold across growth. `arena_prefault_range()`
+ * warms any part of an arena, e.g. after `arena_reset()`.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_prefault_internal Prefaulting & Memory Locking Internals
+ * @brief Parallel population and re-locking around resizes.
+ * @ingroup arena_internal
+ */
+
+/**
+ * @defgroup arena_recycle Recycle Cache
+ * @brief Reuse of destroyed arena structs and buffers across create/destroy cycles.
+ *
+ * @details
+ * While enabled, `arena_destroy()` keeps private buffers in power-of-two size classes and
+ * `arena_delete()` keeps the struct, so the next `arena_create()` of a similar size reuses
+ * them and only clears the bytes the previous owner wrote. Hits and misses are counted.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_recycle_internal Recycle Cache Internals
+ * @brief Size classes, dirty tracking and the cache lock.
+ * @ingroup arena_internal
+ */
+
 /**
  * @defgroup arena_scratch Scratch Arena Pool
  * @brief Public API for acquiring and releasing temporary memory arenas from a pool.
@@ -97,6 +227,82 @@
  * @ingroup arena_internal
  */
 
+/**
+ * @defgroup arena_persist Persistent Arenas
+ * @brief File-backed arenas that survive process restarts.
+ *
+ * @details
+ * Persistent arenas keep their buffer in a `MAP_SHARED` mapping of a file, with the
+ * offset stored in a header page. They are reopened in O(1) and flushed with `arena_sync()`.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_handoff Exec Handoff
+ * @brief memfd-backed arenas that can be passed to a new process image.
+ *
+ * @details
+ * `arena_handoff_prepare()` writes a manifest of memfd arenas that survives `execve()`,
+ * and `arena_handoff_adopt()` remaps the same memory in the new image without copying it.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_writer Buffered Writer
+ * @brief Arena-resident output buffers flushed with `writev()`.
+ *
+ * @details
+ * `t_arena_writer` appends bytes and formatted text into arena chunks, extending the last
+ * chunk in place while it is the arena's last allocation, and hands all chunks to the
+ * kernel in one gathered write per `IOV_MAX` chunks.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_cow Copy-on-Write Clones
+ * @brief Private `MAP_PRIVATE` views of mapped arenas for speculative work.
+ *
+ * @details
+ * `arena_clone_cow()` clones a persistent or memfd arena in O(1); pages are copied by the
+ * kernel only when the clone writes them. Clones are discarded with `arena_delete()` or
+ * merged back with `arena_cow_promote()`.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_shared Shared-Memory Arenas
+ * @brief Arenas shared between processes, with allocator state inside the region.
+ *
+ * @details
+ * `arena_create_shared()` places a header (offset, capacity, statistics) at the start of
+ * a `shm_open()` or memfd region. Any attached process allocates with a lock-free atomic
+ * bump and exchanges position-independent `t_shared_ref` values instead of pointers.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_bias Biased Locking
+ * @brief Owner-thread fast path for thread-safe arenas used mostly by one thread.
+ *
+ * @details
+ * `arena_enable_biased_lock()` lets the first thread that locks an arena skip its mutex from then
+ * on. The first lock by another thread revokes the bias with a `membarrier()` handshake, and the
+ * arena uses its mutex for good.
+ * @ingroup arena_core
+ */
+
+/**
+ * @defgroup arena_epoch Epoch Rings
+ * @brief Generational arenas reset once lock-free readers have left their epoch.
+ *
+ * @details
+ * The writer publishes immutable data from the arena of the current epoch and calls
+ * `arena_epoch_advance()`, which resets the oldest arena of the ring once no registered reader
+ * can still reach it. Readers bracket their reads with `arena_epoch_enter()` / `arena_epoch_exit()`,
+ * which only store to the reader's own record.
+ * @ingroup arena_core
+ */
+
 /**
  * @defgroup arena_state Arena State Management
  * @brief Functions for inspecting and manipulating arena usage state.
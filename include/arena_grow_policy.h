@@ -0,0 +1,132 @@
+/**
+ * @file arena_grow_policy.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Context-aware growth policies and built-in presets.
+ *
+ * @details
+ * A `t_arena_grow_policy` decides how much a growable arena grows. It replaces
+ * the context-free `grow_cb` (which stays the fallback) and can be switched at
+ * runtime, so a memory-constrained arena can grow in small steps while a
+ * throughput-critical one grows aggressively.
+ *
+ * Presets:
+ * - `arena_grow_policy_geometric()`: multiply the size, optionally capping one step.
+ * - `arena_grow_policy_linear()`: add a fixed increment.
+ * - `arena_grow_policy_rounded()`: double, rounded up to pages or huge pages.
+ * - `arena_grow_policy_adaptive()`: raise the factor when growths come in quick
+ *   succession, lower it when they become rare.
+ *
+ * Every preset returns at least the size the failed allocation needs.
+ *
+ * @ingroup arena_grow_policy
+ *
+ * @example
+ * @code
+ * t_arena* cache = arena_create(64 * 1024, true);
+ * arena_set_grow_policy(cache, arena_grow_policy_linear(64 * 1024));
+ *
+ * t_arena* frames = arena_create(1 << 20, true);
+ * arena_set_grow_policy(frames, arena_grow_policy_rounded(ARENA_HUGE_PAGE_SIZE));
+ * @endcode
+ */
+
+#ifndef ARENA_GROW_POLICY_H
+#define ARENA_GROW_POLICY_H
+
+#include "arena.h"
+
+/// Default multiplier of the geometric and adaptive presets.
+#ifndef ARENA_GROW_DEFAULT_FACTOR
+#define ARENA_GROW_DEFAULT_FACTOR 2.0
+#endif
+
+/// Bounds of the adaptive preset's factor.
+#ifndef ARENA_GROW_ADAPTIVE_MIN_FACTOR
+#define ARENA_GROW_ADAPTIVE_MIN_FACTOR 1.5
+#endif
+#ifndef ARENA_GROW_ADAPTIVE_MAX_FACTOR
+#define ARENA_GROW_ADAPTIVE_MAX_FACTOR 8.0
+#endif
+
+/// Allocations between two growths below which the adaptive preset speeds up.
+#ifndef ARENA_GROW_ADAPTIVE_WINDOW
+#define ARENA_GROW_ADAPTIVE_WINDOW 64
+#endif
+
+/// Huge page size used with `arena_grow_policy_rounded()`.
+#ifndef ARENA_HUGE_PAGE_SIZE
+#define ARENA_HUGE_PAGE_SIZE (2UL << 20)
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Select the growth policy of `arena`.
+	 *
+	 * @details
+	 * The policy is copied into the arena. A policy with a `NULL` function
+	 * restores the arena's `grow_cb`.
+	 *
+	 * @ingroup arena_grow_policy
+	 */
+	void arena_set_grow_policy(t_arena* arena, t_arena_grow_policy policy);
+
+	/**
+	 * @brief
+	 * Multiply the size by `factor`, growing by at most `max_step` bytes at once.
+	 *
+	 * @param factor   Multiplier (`> 1`, otherwise `ARENA_GROW_DEFAULT_FACTOR`).
+	 * @param max_step Largest single growth in bytes (`0` = unbounded).
+	 *
+	 * @ingroup arena_grow_policy
+	 */
+	t_arena_grow_policy arena_grow_policy_geometric(double factor, size_t max_step);
+
+	/**
+	 * @brief
+	 * Grow by multiples of `step` bytes.
+	 *
+	 * @param step Increment in bytes (`0` = one page).
+	 *
+	 * @ingroup arena_grow_policy
+	 */
+	t_arena_grow_policy arena_grow_policy_linear(size_t step);
+
+	/**
+	 * @brief
+	 * Double the size and round it up to a multiple of `granularity`.
+	 *
+	 * @param granularity Rounding in bytes, e.g. `ARENA_HUGE_PAGE_SIZE` (`0` = one page).
+	 *
+	 * @ingroup arena_grow_policy
+	 */
+	t_arena_grow_policy arena_grow_policy_rounded(size_t granularity);
+
+	/**
+	 * @brief
+	 * Grow faster when growths follow each other closely, slower otherwise.
+	 *
+	 * @details
+	 * The factor starts at `ARENA_GROW_DEFAULT_FACTOR`. It doubles (up to
+	 * `ARENA_GROW_ADAPTIVE_MAX_FACTOR`) when fewer than `window` allocations
+	 * happened since the previous growth, and halves (down to
+	 * `ARENA_GROW_ADAPTIVE_MIN_FACTOR`) after more than four windows.
+	 *
+	 * @param window Allocations per window (`0` = `ARENA_GROW_ADAPTIVE_WINDOW`).
+	 *
+	 * @ingroup arena_grow_policy
+	 */
+	t_arena_grow_policy arena_grow_policy_adaptive(size_t window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_GROW_POLICY_H
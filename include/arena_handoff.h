@@ -0,0 +1,130 @@
+/**
+ * @file arena_handoff.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Zero-copy handoff of live arenas across `execve()` using memfd regions.
+ *
+ * @details
+ * Arenas created with `arena_create_memfd()` keep their buffer in an anonymous
+ * `memfd_create()` file mapped with `MAP_SHARED`. The memory belongs to the
+ * file, not to the mapping, so it survives an `execve()` as long as the file
+ * descriptor does.
+ *
+ * The handoff protocol for a binary upgrade is:
+ * 1. The old process calls `arena_handoff_prepare()` right before `execve()`.
+ *    It writes a small manifest (descriptor, size, offset and address of each
+ *    arena) into another memfd, clears `FD_CLOEXEC` on every descriptor
+ *    involved, and exports the manifest descriptor in `ARENA_HANDOFF_ENV`.
+ * 2. The new process image calls `arena_handoff_adopt()`, which maps each
+ *    region again (at its previous address when possible) and rebuilds the
+ *    arenas with their offsets. No byte of arena data is copied or written to disk.
+ *
+ * This extends the snapshot idea of `arena_io.h` to an in-memory restart path.
+ *
+ * @note
+ * Arenas passed to `arena_handoff_prepare()` must not be modified afterwards:
+ * the manifest records their state at that point.
+ *
+ * @ingroup arena_handoff
+ */
+
+#ifndef ARENA_HANDOFF_H
+#define ARENA_HANDOFF_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Magic string identifying an arena handoff manifest.
+#define ARENA_HANDOFF_MAGIC "ARENAHND"
+
+/// Version number of the handoff manifest format.
+#define ARENA_HANDOFF_VERSION 1
+
+/// Environment variable carrying the manifest descriptor across `execve()`.
+#define ARENA_HANDOFF_ENV "ARENA_HANDOFF_FD"
+
+/// Maximum number of arenas described by one manifest.
+#ifndef ARENA_HANDOFF_MAX_ARENAS
+#define ARENA_HANDOFF_MAX_ARENAS 64
+#endif
+
+/**
+ * @brief
+ * Description of one arena inside a handoff manifest.
+ *
+ * @ingroup arena_handoff
+ */
+typedef struct s_arena_handoff_entry
+{
+	int32_t  fd;       ///< memfd holding the arena buffer
+	uint32_t can_grow; ///< Non-zero if the arena was growable
+	uint64_t size;     ///< Buffer size in bytes
+	uint64_t offset;   ///< Bump offset at prepare time
+	uint64_t base;     ///< Buffer address in the old process image
+} t_arena_handoff_entry;
+
+/**
+ * @brief
+ * Header of a handoff manifest, followed by `count` entries.
+ *
+ * @ingroup arena_handoff
+ */
+typedef struct s_arena_handoff_manifest
+{
+	char     magic[8]; ///< Magic string ("ARENAHND", not NUL-terminated)
+	uint32_t version;  ///< Manifest format version
+	uint32_t count;    ///< Number of entries that follow
+} t_arena_handoff_manifest;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Create a heap-allocated arena whose buffer lives in a memfd region.
+	 *
+	 * @param name        Name shown in `/proc/<pid>/fd` (may be `NULL`).
+	 * @param size        Buffer size in bytes.
+	 * @param allow_grow  Whether the arena may grow (the memfd is extended).
+	 * @return The new arena, or `NULL` on failure.
+	 *
+	 * @ingroup arena_handoff
+	 */
+	t_arena* arena_create_memfd(const char* name, size_t size, bool allow_grow);
+
+	/**
+	 * @brief
+	 * Write a handoff manifest for `count` memfd arenas and keep it open across `execve()`.
+	 *
+	 * @param arenas Arenas to hand off (all created with `arena_create_memfd()`).
+	 * @param count  Number of arenas.
+	 * @return The manifest descriptor, or `-1` on failure.
+	 *
+	 * @ingroup arena_handoff
+	 */
+	int arena_handoff_prepare(t_arena* const* arenas, size_t count);
+
+	/**
+	 * @brief
+	 * Rebuild arenas described by a handoff manifest.
+	 *
+	 * @param manifest_fd Manifest descriptor, or `-1` to read it from `ARENA_HANDOFF_ENV`.
+	 * @param out         Receives the adopted arenas in manifest order (`NULL` for failed entries).
+	 * @param max_arenas  Capacity of `out`.
+	 * @return Number of arenas successfully adopted.
+	 *
+	 * @ingroup arena_handoff
+	 */
+	size_t arena_handoff_adopt(int manifest_fd, t_arena** out, size_t max_arenas);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_HANDOFF_H
@@ -16,6 +16,8 @@
  *
  * - `arena_save_to_file()` writes the arena's used memory to a file.
  * - `arena_load_from_file()` restores the memory contents from a file into an existing arena.
+ * - `arena_read_file()` / `arena_read_fd()` ingest arbitrary input straight into a new
+ *   arena allocation and return a `t_arena_view` over it.
  *
  * @note
  * These functions are meant for single-threaded or externally synchronized use.
@@ -57,6 +59,45 @@ typedef struct s_arena_snapshot_header
 	size_t   used;     ///< Number of bytes used in the arena buffer
 } __attribute__((packed)) t_arena_snapshot_header;
 
+/// Chunk size used to read streams whose length is unknown (pipes, sockets, procfs).
+#ifndef ARENA_READ_CHUNK_SIZE
+#define ARENA_READ_CHUNK_SIZE (64 * 1024)
+#endif
+
+/// Inputs at least this large are announced to the kernel as sequential reads.
+#ifndef ARENA_READ_SEQUENTIAL_THRESHOLD
+#define ARENA_READ_SEQUENTIAL_THRESHOLD (1024 * 1024)
+#endif
+
+/**
+ * @brief
+ * Options for `arena_read_file()` and `arena_read_fd()`.
+ *
+ * @ingroup arena_io
+ */
+typedef enum e_arena_read_flags
+{
+	ARENA_READ_DEFAULT       = 0,      ///< Read the bytes as they are.
+	ARENA_READ_NUL_TERMINATE = 1 << 0, ///< Append a `'\0'` after the data (not counted in `size`).
+} t_arena_read_flags;
+
+/**
+ * @brief
+ * Bytes ingested into an arena.
+ *
+ * @details
+ * `data` points into arena memory and stays valid until the arena is reset,
+ * popped below it, or destroyed. A failed read returns `{NULL, 0}`; an empty
+ * input returns a non-NULL `data` with `size == 0`.
+ *
+ * @ingroup arena_io
+ */
+typedef struct s_arena_view
+{
+	uint8_t* data; ///< First byte of the ingested data.
+	size_t   size; ///< Number of bytes read.
+} t_arena_view;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -97,6 +138,32 @@ extern "C"
 	 */
 	bool arena_load_from_file(t_arena* arena, const char* path);
 
+	/**
+	 * @brief
+	 * Read a whole file into a new arena allocation.
+	 *
+	 * @param arena Destination arena.
+	 * @param path  File to read.
+	 * @param flags Combination of `t_arena_read_flags`.
+	 * @return A view over the data, or `{NULL, 0}` on failure.
+	 *
+	 * @ingroup arena_io
+	 */
+	t_arena_view arena_read_file(t_arena* arena, const char* path, unsigned flags);
+
+	/**
+	 * @brief
+	 * Read everything from a descriptor (from its current position) into a new arena allocation.
+	 *
+	 * @param arena Destination arena.
+	 * @param fd    Readable descriptor (file, pipe, socket...). It is not closed.
+	 * @param flags Combination of `t_arena_read_flags`.
+	 * @return A view over the data, or `{NULL, 0}` on failure.
+	 *
+	 * @ingroup arena_io
+	 */
+	t_arena_view arena_read_fd(t_arena* arena, int fd, unsigned flags);
+
 #ifdef __cplusplus
 }
 #endif
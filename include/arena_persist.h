@@ -0,0 +1,121 @@
+/**
+ * @file arena_persist.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Persistent arenas backed by a shared file mapping.
+ *
+ * @details
+ * A persistent arena keeps its buffer inside a `MAP_SHARED` mapping of a
+ * regular file (on disk, tmpfs, or a DAX-capable filesystem). Allocations are
+ * written straight into the page cache, so there is no explicit save step:
+ *
+ * - The first page of the file holds a `t_arena_persist_header` with the
+ *   arena size, the bump offset, and the address the buffer was mapped at.
+ * - `arena_sync()` stores the current offset in the header and flushes the
+ *   header plus the used range with `msync()`. Only dirty pages are written.
+ * - `arena_open_persistent()` on an existing file maps it again in O(1),
+ *   restores the offset, and tries to reuse the previous address so that
+ *   absolute pointers stored inside the arena remain valid.
+ *
+ * Compared to `arena_save_to_file()` / `arena_load_from_file()`, reopening a
+ * persistent arena does not read the data: pages are faulted in lazily on
+ * first access.
+ *
+ * @note
+ * Allocations made after the last `arena_sync()` (or clean `arena_destroy()`)
+ * are not accounted for in the header after a crash. A file can only be open
+ * in one persistent arena at a time (it is locked with `flock()`).
+ *
+ * @ingroup arena_persist
+ */
+
+#ifndef ARENA_PERSIST_H
+#define ARENA_PERSIST_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Magic string identifying a persistent arena file.
+#define ARENA_PERSIST_MAGIC "ARENAPRS"
+
+/// Version number of the persistent arena file format.
+#define ARENA_PERSIST_VERSION 1
+
+/**
+ * @brief
+ * Header stored in the first page of a persistent arena file.
+ *
+ * @details
+ * The arena buffer starts `header_len` bytes into the file (one page), so the
+ * buffer itself stays page-aligned in memory.
+ *
+ * @ingroup arena_persist
+ */
+typedef struct s_arena_persist_header
+{
+	char     magic[8];   ///< Magic string ("ARENAPRS", not NUL-terminated)
+	uint32_t version;    ///< File format version
+	uint32_t header_len; ///< Bytes reserved before the arena buffer
+	uint64_t size;       ///< Capacity of the arena buffer in bytes
+	uint64_t offset;     ///< Bump offset recorded by the last sync
+	uint64_t base;       ///< Buffer address at the time of the last sync
+} t_arena_persist_header;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Open (or create) a persistent arena backed by the file at `path`.
+	 *
+	 * @details
+	 * If the file is empty or missing, it is created with room for `size`
+	 * bytes of arena data. Otherwise the stored header is validated, `size`
+	 * is ignored, and the arena is restored with its previous offset.
+	 *
+	 * @param path        Path of the backing file.
+	 * @param size        Buffer size used when the file is created.
+	 * @param allow_grow  Whether the arena (and file) may grow on demand.
+	 * @return A heap-allocated arena, or `NULL` on failure.
+	 *
+	 * @ingroup arena_persist
+	 */
+	t_arena* arena_open_persistent(const char* path, size_t size, bool allow_grow);
+
+	/**
+	 * @brief
+	 * Record the current offset in the file header and flush dirty pages.
+	 *
+	 * @param arena Persistent arena to synchronize.
+	 * @return `true` if the data reached the backing file, `false` otherwise.
+	 *
+	 * @ingroup arena_persist
+	 */
+	bool arena_sync(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Return how far the buffer moved compared to the previous session.
+	 *
+	 * @details
+	 * `0` means the arena was reopened at its previous address. Any other
+	 * value must be added to absolute pointers stored inside the arena.
+	 *
+	 * @param arena Persistent arena to inspect.
+	 * @return Address delta (new base minus old base) in bytes.
+	 *
+	 * @ingroup arena_persist
+	 */
+	intptr_t arena_persist_relocation(const t_arena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_PERSIST_H
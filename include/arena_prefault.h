@@ -0,0 +1,108 @@
+/**
+ * @file arena_prefault.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Prefaulted and memory-locked arenas for paths that must not page-fault.
+ *
+ * @details
+ * A fresh buffer is only reserved: each page faults in on first touch, i.e.
+ * during request handling. `arena_create_with_flags()` moves that cost to
+ * creation:
+ * - `ARENA_CREATE_PREFAULT` populates every page of the buffer up front,
+ *   with `MADV_POPULATE_WRITE` where the kernel supports it and by touching
+ *   each page otherwise. Buffers of `ARENA_PREFAULT_PARALLEL_MIN` bytes and
+ *   more are split between up to `ARENA_PREFAULT_MAX_THREADS` threads.
+ * - `ARENA_CREATE_MLOCK` also locks the buffer in RAM with `mlock()`, so it
+ *   is never swapped or reclaimed.
+ *
+ * Both flags stick to the arena: after a growth the new pages are prefaulted
+ * and the buffer is locked again; shrinking and destruction unlock what they
+ * give back. Pressure trimming leaves locked pages alone.
+ *
+ * `arena_prefault_range()` warms part of any arena, e.g. the region the next
+ * cycle will use right after `arena_reset()`.
+ *
+ * @note
+ * Locking is subject to `RLIMIT_MEMLOCK`; creation fails if the buffer
+ * cannot be locked. Only bytes past the offset are touched by the fallback,
+ * so live allocations are never written.
+ *
+ * @ingroup arena_prefault
+ *
+ * @example
+ * @code
+ * t_arena* audio = arena_create_with_flags(1 << 20, false, ARENA_CREATE_PREFAULT | ARENA_CREATE_MLOCK);
+ * ...
+ * arena_reset(frame);
+ * arena_prefault_range(frame, 0, 256 * 1024); // before the next frame starts
+ * @endcode
+ */
+
+#ifndef ARENA_PREFAULT_H
+#define ARENA_PREFAULT_H
+
+#include "arena.h"
+#include <stdbool.h>
+
+/// Range size from which prefaulting is split between threads.
+#ifndef ARENA_PREFAULT_PARALLEL_MIN
+#define ARENA_PREFAULT_PARALLEL_MIN (64UL << 20)
+#endif
+
+/// Maximum number of threads used to prefault one range.
+#ifndef ARENA_PREFAULT_MAX_THREADS
+#define ARENA_PREFAULT_MAX_THREADS 4
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @enum e_arena_create_flags
+	 * @brief Options of `arena_create_with_flags()`.
+	 *
+	 * @ingroup arena_prefault
+	 */
+	typedef enum e_arena_create_flags
+	{
+		ARENA_CREATE_PREFAULT = 1u << 0, /**< Fault in every page of the buffer. */
+		ARENA_CREATE_MLOCK    = 1u << 1, /**< Lock the buffer in RAM (implies prefaulting). */
+	} t_arena_create_flags;
+
+	/**
+	 * @brief
+	 * `arena_create()` with the buffer prefaulted and/or locked.
+	 *
+	 * @param size       Size of the buffer in bytes.
+	 * @param allow_grow Whether the arena may grow.
+	 * @param flags      `ARENA_CREATE_*` flags, kept for later growth.
+	 *
+	 * @return The arena, or `NULL` if it could not be created or locked.
+	 *
+	 * @ingroup arena_prefault
+	 */
+	t_arena* arena_create_with_flags(size_t size, bool allow_grow, unsigned flags);
+
+	/**
+	 * @brief
+	 * Fault in the pages of `[offset, offset + len)` of the buffer.
+	 *
+	 * @details
+	 * The range is clamped to the buffer and, for the touch fallback, to bytes
+	 * past the current offset. Contents are not changed.
+	 *
+	 * @return `false` if the arena is `NULL`, frozen or has no buffer.
+	 *
+	 * @ingroup arena_prefault
+	 */
+	bool arena_prefault_range(t_arena* arena, size_t offset, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_PREFAULT_H
@@ -0,0 +1,116 @@
+/**
+ * @file arena_pregrow.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Background pre-growth: grow watched arenas before they run out of space.
+ *
+ * @details
+ * The allocation that finds a growable arena full pays for the whole
+ * `arena_grow()` inline: allocate, copy, free, then fault in the new pages.
+ * Watching an arena hands that work to a background worker instead. Once an
+ * allocation pushes the offset past the arena's high-water mark (a percentage
+ * of its current size), the worker is woken, grows the arena with its growth
+ * callback and touches the new pages, so the allocations that follow find
+ * ready memory.
+ *
+ * The worker never moves the buffer, so pointers returned by `arena_alloc()`
+ * stay valid while it runs. It grows the buffer in place, by committing
+ * address space reserved behind it: the first growth of a watched arena
+ * still happens inline and moves the buffer (as any growth may) to the start
+ * of a reservation of `ARENA_PREGROW_RESERVE_FACTOR` times its new size.
+ * Growths within the reservation, on the worker or inline, leave the buffer
+ * where it is. When the buffer cannot grow in place (reservation used up,
+ * file or memfd mapping with no room behind it), the worker leaves the next
+ * growth to the allocating thread, which may move the buffer as usual.
+ *
+ * The growth runs under the arena lock, on the worker's thread and ahead of
+ * need, and the new pages are faulted in slices with the lock released in
+ * between, so allocating threads are only briefly held up.
+ *
+ * One worker thread serves every watched arena. It starts with the first
+ * `arena_pregrow_watch()` and is joined when the last arena is unwatched.
+ * `arena_destroy()` unwatches its arena automatically.
+ *
+ * @note
+ * Pre-growth requires `ARENA_ENABLE_THREAD_SAFE` and an arena that uses its
+ * lock. `arena_pregrow_unwatch()` and `arena_destroy()` wait for the worker to
+ * finish with the arena, so they must not be called with its lock held.
+ *
+ * @ingroup arena_pregrow
+ *
+ * @example
+ * @code
+ * t_arena* arena = arena_create(1 << 20, true);
+ * arena_pregrow_watch(arena, 80); // grow in the background past 80% usage
+ *
+ * // The worker may grow the arena while a request is handled; the request
+ * // stays where it is.
+ * for (int i = 0; i < requests; ++i)
+ *     handle_request(arena_alloc(arena, request_size(i)));
+ *
+ * arena_delete(&arena); // unwatches the arena
+ * @endcode
+ */
+
+#ifndef ARENA_PREGROW_H
+#define ARENA_PREGROW_H
+
+#include "arena.h"
+#include <stdbool.h>
+
+/// Default high-water mark, in percent of the arena size.
+#ifndef ARENA_PREGROW_DEFAULT_PERCENT
+#define ARENA_PREGROW_DEFAULT_PERCENT 80
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Start growing `arena` in the background once it is `high_water_percent` full.
+	 *
+	 * @details
+	 * Calling it again on a watched arena updates its high-water mark.
+	 *
+	 * @param arena              Growable, lock-protected arena to watch.
+	 * @param high_water_percent Usage (1-99) that triggers a pre-growth, or `0`
+	 *                           for `ARENA_PREGROW_DEFAULT_PERCENT`.
+	 *
+	 * @return `true` if the arena is watched, `false` on invalid arguments, when
+	 *         the arena cannot grow or has no lock, when `ARENA_PREGROW_MAX_ARENAS`
+	 *         arenas are already watched, or if the worker could not start.
+	 *
+	 * @ingroup arena_pregrow
+	 */
+	bool arena_pregrow_watch(t_arena* arena, unsigned high_water_percent);
+
+	/**
+	 * @brief
+	 * Stop pre-growing `arena`.
+	 *
+	 * @details
+	 * Waits for a pre-growth in progress on this arena to finish. Unwatching the
+	 * last arena stops the worker thread. Does nothing if `arena` is not watched.
+	 *
+	 * @ingroup arena_pregrow
+	 */
+	void arena_pregrow_unwatch(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Check whether `arena` is watched by the pre-growth worker.
+	 *
+	 * @ingroup arena_pregrow
+	 */
+	bool arena_pregrow_is_watched(t_arena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_PREGROW_H
@@ -0,0 +1,115 @@
+/**
+ * @file arena_prezero.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Background pre-zeroing of reset arenas for `arena_calloc()`.
+ *
+ * @details
+ * Every arena tracks a watermark, `clean_from`: the bytes from there to the
+ * end of the buffer are known to be zero (fresh buffers, untouched pages,
+ * decommitted pages). `arena_calloc()` only clears the part of its block that
+ * lies below the watermark, so allocating from clean memory costs no
+ * `memset()` at all.
+ *
+ * After `arena_reset()`, everything the previous cycle wrote is below the
+ * watermark again. Watching an arena with `arena_prezero_watch()` hands that
+ * range to a low-priority (`SCHED_IDLE`) worker, which zeroes it from the top
+ * down in `ARENA_PREZERO_CHUNK` slices and lowers the watermark as it goes,
+ * stopping where the arena's offset is. The next cycle's `arena_calloc()`
+ * calls then find pre-cleaned memory.
+ *
+ * `scratch_pool_prezero()` watches every slot of a scratch pool, and
+ * `scratch_release()` then resets a watched slot so its memory is cleaned
+ * before it is acquired again.
+ *
+ * @note
+ * Requires `ARENA_ENABLE_THREAD_SAFE` and an arena that uses its lock. Each
+ * slice is zeroed under the arena lock, so allocations wait for at most one
+ * slice. `arena_destroy()` unwatches automatically. With
+ * `ARENA_POISON_MEMORY`, resets poison what the cycle used and the worker
+ * then zeroes the poison away.
+ *
+ * @ingroup arena_prezero
+ *
+ * @example
+ * @code
+ * arena_prezero_watch(frame_arena);
+ * for (;;)
+ * {
+ *     build_frame(frame_arena); // arena_calloc() skips the memset on clean memory
+ *     arena_reset(frame_arena); // the worker cleans up while the next frame waits
+ * }
+ * @endcode
+ */
+
+#ifndef ARENA_PREZERO_H
+#define ARENA_PREZERO_H
+
+#include "arena.h"
+#include "arena_scratch.h"
+#include <stdbool.h>
+
+/// Bytes zeroed per hold of the arena lock.
+#ifndef ARENA_PREZERO_CHUNK
+#define ARENA_PREZERO_CHUNK (256UL * 1024)
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Zero the dirty memory of `arena` in the background after each reset.
+	 *
+	 * @return `true` if the arena is watched (watching twice has no effect).
+	 *
+	 * @ingroup arena_prezero
+	 */
+	bool arena_prezero_watch(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Stop pre-zeroing `arena`; waits if the worker is zeroing it.
+	 *
+	 * @details
+	 * Must not be called with the arena lock held.
+	 *
+	 * @ingroup arena_prezero
+	 */
+	void arena_prezero_unwatch(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Wait until the worker has nothing left to zero in `arena`.
+	 *
+	 * @ingroup arena_prezero
+	 */
+	void arena_prezero_wait(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Bytes of `arena` known to be zero (from `clean_from` to the end).
+	 *
+	 * @ingroup arena_prezero
+	 */
+	size_t arena_clean_bytes(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Watch every slot of `pool`; released slots are reset and pre-zeroed.
+	 *
+	 * @return `false` if a slot could not be watched.
+	 *
+	 * @ingroup arena_prezero
+	 */
+	bool scratch_pool_prezero(t_scratch_arena_pool* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_PREZERO_H
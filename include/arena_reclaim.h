@@ -0,0 +1,114 @@
+/**
+ * @file arena_reclaim.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Deferred release of destroyed arena buffers on a background thread.
+ *
+ * @details
+ * `arena_destroy()` normally poisons (when enabled) and releases the buffer
+ * on the calling thread. For multi-gigabyte buffers the `free()`/`munmap()`
+ * alone takes milliseconds, which a request thread should not pay. While the
+ * reclaimer runs, `arena_destroy()` hands owned heap and anonymous-mapping
+ * buffers of at least `min_size` bytes to it instead and returns at once.
+ *
+ * The queue holds `ARENA_RECLAIM_QUEUE_SIZE` buffers. When it is full, the
+ * buffer is released inline as before, so memory never piles up unbounded.
+ * File-backed and shared buffers are always released inline.
+ *
+ * Call `arena_reclaimer_flush()` to wait until every queued buffer is gone
+ * (e.g. before measuring RSS or forking), and `arena_reclaimer_stop()` at
+ * shutdown; it flushes the queue and joins the thread.
+ *
+ * @note
+ * Requires `ARENA_ENABLE_THREAD_SAFE`. A budget the arena was attached to is
+ * credited when the arena is destroyed, not when the buffer is released.
+ *
+ * @ingroup arena_reclaim
+ *
+ * @example
+ * @code
+ * arena_reclaimer_start(0);     // defer buffers of ARENA_RECLAIM_MIN_SIZE and more
+ * ...
+ * arena_delete(&request_arena); // returns without unmapping
+ * ...
+ * arena_reclaimer_stop();       // releases what is still queued
+ * @endcode
+ */
+
+#ifndef ARENA_RECLAIM_H
+#define ARENA_RECLAIM_H
+
+#include "arena.h"
+#include <stdbool.h>
+
+/// Default size from which destroyed buffers are released in the background.
+#ifndef ARENA_RECLAIM_MIN_SIZE
+#define ARENA_RECLAIM_MIN_SIZE ARENA_MMAP_THRESHOLD
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @struct s_arena_reclaim_stats
+	 * @brief Counters of the reclaimer.
+	 *
+	 * @ingroup arena_reclaim
+	 */
+	typedef struct s_arena_reclaim_stats
+	{
+		size_t deferred;      /**< Buffers handed to the reclaimer. */
+		size_t inline_frees;  /**< Eligible buffers released inline because the queue was full. */
+		size_t pending;       /**< Buffers queued or being released. */
+		size_t pending_bytes; /**< Bytes queued or being released. */
+	} t_arena_reclaim_stats;
+
+	/**
+	 * @brief
+	 * Start releasing destroyed buffers in the background.
+	 *
+	 * @param min_size Smallest buffer deferred (`0` = `ARENA_RECLAIM_MIN_SIZE`).
+	 *
+	 * @return `true` if the thread runs, `false` if it was already running or
+	 *         could not be started.
+	 *
+	 * @ingroup arena_reclaim
+	 */
+	bool arena_reclaimer_start(size_t min_size);
+
+	/**
+	 * @brief
+	 * Wait until every queued buffer has been released.
+	 *
+	 * @ingroup arena_reclaim
+	 */
+	void arena_reclaimer_flush(void);
+
+	/**
+	 * @brief
+	 * Release what is still queued, then join the thread.
+	 *
+	 * @details
+	 * Buffers destroyed afterwards are released inline again.
+	 *
+	 * @ingroup arena_reclaim
+	 */
+	void arena_reclaimer_stop(void);
+
+	/**
+	 * @brief
+	 * Snapshot of the reclaimer counters.
+	 *
+	 * @ingroup arena_reclaim
+	 */
+	t_arena_reclaim_stats arena_reclaimer_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_RECLAIM_H
@@ -0,0 +1,122 @@
+/**
+ * @file arena_recycle.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Process-wide cache of destroyed arena structs and buffers.
+ *
+ * @details
+ * A per-request `arena_create()` → work → `arena_delete()` cycle pays for a
+ * `calloc()` of the struct, a zeroed buffer (a `calloc()` or a fresh mapping
+ * whose pages all fault in again) and their release, every time. While the
+ * cache is enabled, `arena_destroy()` keeps owned heap and anonymous-mapping
+ * buffers in bins by power-of-two size class, and `arena_delete()` keeps the
+ * struct. The next `arena_create()` or `arena_init()` of a similar size takes
+ * a warm buffer from its bin instead.
+ *
+ * A cached buffer is handed out for requests of at least half its capacity,
+ * so the waste stays below 2x. Only the bytes the previous owner may have
+ * written (up to its peak usage) are cleared again, so arenas still start
+ * zeroed. Nothing is ever evicted: a buffer that does not fit in its bin or
+ * under the byte limit is released as usual.
+ *
+ * `arena_recycle_stats()` reports hits and misses so the hit rate of a
+ * workload can be checked before tuning `ARENA_RECYCLE_BIN_DEPTH` or the
+ * byte limit.
+ *
+ * @note
+ * Cached buffers are not charged to any budget. File-backed, shared and
+ * borrowed buffers are never cached. With `ARENA_POISON_MEMORY`, the used
+ * part of a cached buffer is poisoned, and cleared again when it is reused.
+ *
+ * @ingroup arena_recycle
+ *
+ * @example
+ * @code
+ * arena_recycle_enable(0); // ARENA_RECYCLE_MAX_BYTES
+ * for (;;)
+ * {
+ *     t_arena* request = arena_create(64 * 1024, true); // warm after the first round
+ *     handle(request);
+ *     arena_delete(&request);                           // back to the cache
+ * }
+ * arena_recycle_disable();
+ * @endcode
+ */
+
+#ifndef ARENA_RECYCLE_H
+#define ARENA_RECYCLE_H
+
+#include "arena.h"
+#include <stdbool.h>
+
+/// Default number of bytes the recycle cache may hold.
+#ifndef ARENA_RECYCLE_MAX_BYTES
+#define ARENA_RECYCLE_MAX_BYTES (64UL << 20)
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @struct s_arena_recycle_stats
+	 * @brief Counters of the recycle cache.
+	 *
+	 * @ingroup arena_recycle
+	 */
+	typedef struct s_arena_recycle_stats
+	{
+		size_t hits;           /**< Buffer requests served from the cache. */
+		size_t misses;         /**< Buffer requests that had to allocate. */
+		size_t struct_hits;    /**< Arena structs reused by `arena_create()`. */
+		size_t struct_misses;  /**< Arena structs `arena_create()` had to allocate. */
+		size_t rejected;       /**< Destroyed buffers released because bin or limit was full. */
+		size_t cached_buffers; /**< Buffers currently cached. */
+		size_t cached_bytes;   /**< Bytes currently cached. */
+	} t_arena_recycle_stats;
+
+	/**
+	 * @brief
+	 * Start caching destroyed arenas.
+	 *
+	 * @param max_bytes Bytes the cached buffers may hold (`0` = `ARENA_RECYCLE_MAX_BYTES`).
+	 *
+	 * @details
+	 * Calling it again only changes the limit; what is cached is kept.
+	 *
+	 * @ingroup arena_recycle
+	 */
+	void arena_recycle_enable(size_t max_bytes);
+
+	/**
+	 * @brief
+	 * Stop caching and release everything cached.
+	 *
+	 * @ingroup arena_recycle
+	 */
+	void arena_recycle_disable(void);
+
+	/**
+	 * @brief
+	 * Release everything cached, but keep caching.
+	 *
+	 * @ingroup arena_recycle
+	 */
+	void arena_recycle_drain(void);
+
+	/**
+	 * @brief
+	 * Snapshot of the cache counters.
+	 *
+	 * @ingroup arena_recycle
+	 */
+	t_arena_recycle_stats arena_recycle_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_RECYCLE_H
@@ -20,6 +20,8 @@
  * - Fixed-size pool of memory arenas
  * - Optional thread safety via mutex
  * - Simple API: `scratch_acquire()` / `scratch_release()`
+ * - Memory of idle slots can be handed back with `scratch_pool_trim()`
+ * - Guarded pools (`scratch_pool_init_guarded()`) fault on slot overruns
  * - Suitable for high-frequency temporary allocations
  *
  * @note
@@ -90,6 +92,7 @@ extern "C"
 	{
 		t_scratch_slot  slots[SCRATCH_MAX_SLOTS]; ///< Array of scratch slots
 		size_t          slot_size;                ///< Size of each arena in bytes
+		t_arena*        guarded;                  ///< Parent of the slots of a guarded pool, or `NULL`
 		bool            thread_safe;              ///< Whether locking is enabled
 		pthread_mutex_t lock;                     ///< Mutex for protecting slot access
 	} t_scratch_arena_pool;
@@ -110,6 +113,29 @@ extern "C"
 	 */
 	bool scratch_pool_init(t_scratch_arena_pool* pool, size_t slot_size, bool thread_safe);
 
+	/**
+	 * @brief
+	 * Initialize a scratch pool whose slots are separated by guard pages.
+	 *
+	 * @details
+	 * The slots are page-aligned sub-arenas of one parent arena with guard pages
+	 * enabled (`arena_set_guard_pages()`), so writing past the end of a slot
+	 * faults instead of corrupting the next one. Slots are rounded up to whole
+	 * pages and cannot grow.
+	 *
+	 * @param pool         Pointer to the scratch pool structure to initialize.
+	 * @param slot_size    Minimum size of each scratch arena (in bytes).
+	 * @param thread_safe  If `true`, enables mutex-based locking for slot access.
+	 *
+	 * @return `true` if the pool was successfully initialized, `false` otherwise.
+	 *
+	 * @ingroup arena_scratch
+	 *
+	 * @see scratch_pool_init
+	 * @see scratch_pool_destroy
+	 */
+	bool scratch_pool_init_guarded(t_scratch_arena_pool* pool, size_t slot_size, bool thread_safe);
+
 	/**
 	 * @brief
 	 * Destroy all arenas in a scratch pool and reset its metadata.
@@ -139,6 +165,25 @@ extern "C"
 	 */
 	t_arena* scratch_acquire(t_scratch_arena_pool* pool);
 
+	/**
+	 * @brief
+	 * Return the memory of the pool's free slots to the system.
+	 *
+	 * @details
+	 * Every slot that is not in use is claimed for the duration of the trim,
+	 * reset, shrunk back to `slot_size` if it grew, and decommitted with
+	 * `arena_decommit()`. Slots in use are skipped.
+	 *
+	 * @param pool Pointer to the scratch arena pool to trim.
+	 *
+	 * @return Bytes released.
+	 *
+	 * @ingroup arena_scratch
+	 *
+	 * @see arena_trimmer_register_pool
+	 */
+	size_t scratch_pool_trim(t_scratch_arena_pool* pool);
+
 	/**
 	 * @brief
 	 * Release a scratch arena back to the pool for reuse.
@@ -0,0 +1,204 @@
+/**
+ * @file arena_shared.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Cross-process shared-memory arenas with a lock-free bump allocator.
+ *
+ * @details
+ * A shared arena lives entirely inside a shared memory object (`shm_open()`
+ * for named arenas, `memfd_create()` for anonymous ones). Unlike `t_arena`,
+ * whose offset and mutex are process-local, all allocator state is stored in
+ * a header at the start of the shared region:
+ *
+ * - capacity, bump offset, and peak usage;
+ * - allocation statistics (count, bytes, alignment waste, failures).
+ *
+ * Allocation is a compare-and-swap on the shared offset, so any thread of any
+ * attached process can allocate without a lock. Because each process may map
+ * the region at a different address, data structures stored in the arena
+ * should link to each other with `t_shared_ref` values (offsets from the start
+ * of the region), converted with `arena_shared_ref()` / `arena_shared_ptr()`.
+ *
+ * A typical use is a producer process building messages that consumer
+ * processes read in place, with zero copies.
+ *
+ * @note
+ * Shared arenas have a fixed capacity: growing the region would require every
+ * attached process to remap it. Memory is reclaimed as a whole with
+ * `arena_shared_reset()`, which callers must coordinate between processes.
+ *
+ * @ingroup arena_shared
+ */
+
+#ifndef ARENA_SHARED_H
+#define ARENA_SHARED_H
+
+#include "arena.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Magic string identifying a shared arena region.
+#define ARENA_SHARED_MAGIC "ARENASHM"
+
+/// Version number of the shared arena header layout.
+#define ARENA_SHARED_VERSION 1
+
+/// Null value for `t_shared_ref` (offset 0 always points at the header).
+#define ARENA_SHARED_NULL ((t_shared_ref) 0)
+
+/**
+ * @brief
+ * Position-independent reference to memory inside a shared arena.
+ *
+ * @details
+ * The value is the byte offset from the start of the shared region, so the
+ * same reference is valid in every process attached to the arena.
+ *
+ * @ingroup arena_shared
+ */
+typedef uint64_t t_shared_ref;
+
+/**
+ * @brief
+ * Allocator state stored at the start of the shared region.
+ *
+ * @ingroup arena_shared
+ */
+typedef struct s_shared_arena_header
+{
+	char             magic[8];               ///< Magic string ("ARENASHM", not NUL-terminated)
+	uint32_t         version;                ///< Header layout version
+	uint32_t         header_len;             ///< Bytes reserved before the data area (page multiple)
+	uint64_t         size;                   ///< Capacity of the data area in bytes
+	_Atomic uint64_t offset;                 ///< Bump offset into the data area
+	_Atomic uint64_t peak_usage;             ///< Highest offset reached
+	_Atomic uint64_t allocations;            ///< Successful allocations (all processes)
+	_Atomic uint64_t bytes_allocated;        ///< Bytes handed out (all processes)
+	_Atomic uint64_t wasted_alignment_bytes; ///< Alignment padding (all processes)
+	_Atomic uint64_t failed_allocations;     ///< Allocations rejected for lack of space
+	_Atomic uint32_t attached;               ///< Number of live handles on the region
+} t_shared_arena_header;
+
+/**
+ * @brief
+ * Process-local handle on a shared arena.
+ *
+ * @ingroup arena_shared
+ */
+typedef struct s_shared_arena
+{
+	t_shared_arena_header* header;  ///< Header at the start of the mapping
+	uint8_t*               data;    ///< Start of the data area in this process
+	size_t                 map_len; ///< Length of the mapping in bytes
+	int                    fd;      ///< Shared memory descriptor
+} t_shared_arena;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Create a shared arena with `size` bytes of data.
+	 *
+	 * @param name Name of the POSIX shared memory object, or `NULL` for an anonymous memfd.
+	 * @param size Capacity of the data area in bytes.
+	 * @return A handle on the new arena, or `NULL` on failure (including if `name` exists).
+	 *
+	 * @ingroup arena_shared
+	 */
+	t_shared_arena* arena_create_shared(const char* name, size_t size);
+
+	/**
+	 * @brief
+	 * Attach to an existing named shared arena.
+	 *
+	 * @ingroup arena_shared
+	 */
+	t_shared_arena* arena_open_shared(const char* name);
+
+	/**
+	 * @brief
+	 * Attach to a shared arena through an inherited or received descriptor.
+	 *
+	 * @details
+	 * The descriptor is duplicated; the caller keeps ownership of `fd`.
+	 *
+	 * @ingroup arena_shared
+	 */
+	t_shared_arena* arena_open_shared_fd(int fd);
+
+	/**
+	 * @brief
+	 * Detach from a shared arena and free the handle (the region itself persists).
+	 *
+	 * @ingroup arena_shared
+	 */
+	void arena_shared_close(t_shared_arena** arena);
+
+	/**
+	 * @brief
+	 * Remove the name of a shared arena; the memory is freed once all handles are closed.
+	 *
+	 * @ingroup arena_shared
+	 */
+	bool arena_shared_unlink(const char* name);
+
+	/**
+	 * @brief
+	 * Allocate `size` bytes aligned to `alignment` with a lock-free bump.
+	 *
+	 * @ingroup arena_shared
+	 */
+	void* arena_shared_alloc(t_shared_arena* arena, size_t size, size_t alignment);
+
+	/**
+	 * @brief
+	 * Release every allocation at once (all processes must have stopped using them).
+	 *
+	 * @ingroup arena_shared
+	 */
+	void arena_shared_reset(t_shared_arena* arena);
+
+	/**
+	 * @brief
+	 * Number of data bytes currently allocated.
+	 *
+	 * @ingroup arena_shared
+	 */
+	size_t arena_shared_used(const t_shared_arena* arena);
+
+	/**
+	 * @brief
+	 * Snapshot of the statistics shared by all attached processes.
+	 *
+	 * @ingroup arena_shared
+	 */
+	t_arena_stats arena_shared_get_stats(const t_shared_arena* arena);
+
+	/**
+	 * @brief
+	 * Convert a pointer into the arena into a position-independent reference.
+	 *
+	 * @ingroup arena_shared
+	 */
+	t_shared_ref arena_shared_ref(const t_shared_arena* arena, const void* ptr);
+
+	/**
+	 * @brief
+	 * Convert a reference back into a pointer valid in the calling process.
+	 *
+	 * @ingroup arena_shared
+	 */
+	void* arena_shared_ptr(const t_shared_arena* arena, t_shared_ref ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_SHARED_H
@@ -58,6 +58,8 @@ extern "C"
 		size_t  peak_usage;             ///< Highest offset reached (i.e., peak memory usage)
 		size_t  wasted_alignment_bytes; ///< Total bytes wasted due to alignment padding
 		size_t  shrinks;                ///< Number of times the arena was shrunk
+		size_t  shrinks_avoided;        ///< Shrinks skipped by the shrink policy's hysteresis (one per window at most)
+		size_t  regrows_after_shrink;   ///< Growths that undid a previous shrink
 		size_t* growth_history;         ///< Array of size values recorded during arena growth
 		size_t  growth_history_count;   ///< Number of growth events recorded
 		size_t  live_allocations;       ///< Number of active allocations (not yet released)
@@ -66,6 +68,9 @@ extern "C"
 		size_t  last_alloc_id;          ///< Unique ID of the last allocation
 		size_t  alloc_id_counter;       ///< Total allocation ID counter (used for tracking)
 		size_t  failed_allocations;     ///< Number of failed allocation attempts
+		size_t  large_allocations;      ///< Number of allocations served by a dedicated mapping
+		size_t  large_bytes;            ///< Bytes currently held in dedicated large-object mappings
+		size_t  background_grows;       ///< Number of growths done ahead of time by the pre-growth worker
 	} t_arena_stats;
 
 	struct s_arena;
@@ -0,0 +1,214 @@
+/**
+ * @file arena_trim.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Memory-pressure-driven trimming of idle arenas and scratch pools.
+ *
+ * @details
+ * Arenas keep their buffer between cycles, so a process whose load dropped
+ * still holds the memory of its busiest moment unless every call site polls
+ * `arena_might_shrink()`. The trimmer does it for them: a background thread
+ * samples a memory-pressure source every `interval_ms` and, while the system
+ * is under pressure, trims the registered arenas and scratch pools.
+ *
+ * Trimming an arena means `arena_might_shrink()` followed by
+ * `arena_decommit()`, which hands the pages past the offset back to the kernel
+ * without moving the buffer. Under `ARENA_PRESSURE_SOME` only arenas that did
+ * not allocate since the previous pass are trimmed; under
+ * `ARENA_PRESSURE_FULL` every registered arena is. Scratch pools are trimmed
+ * with `scratch_pool_trim()`, which only touches slots that are not in use.
+ *
+ * The default source, `arena_pressure_read()`, reads the `avg10` averages of
+ * `/proc/pressure/memory` (PSI) and falls back to the cgroup v2
+ * `memory.events` counters; tests and embedders can plug in their own.
+ *
+ * @note
+ * The trimmer requires `ARENA_ENABLE_THREAD_SAFE`; without it the registry
+ * and thread functions fail, while `arena_decommit()` and
+ * `scratch_pool_trim()` remain available. `arena_destroy()` and
+ * `scratch_pool_destroy()` unregister automatically and must not be called
+ * with the arena lock held.
+ *
+ * @ingroup arena_trim
+ *
+ * @example
+ * @code
+ * arena_trimmer_start(NULL, NULL, 0); // PSI / cgroup, default interval
+ * arena_trimmer_register(request_arena);
+ * arena_trimmer_register_pool(&scratch);
+ * // ... under pressure, idle arenas shrink and release their free pages ...
+ * arena_trimmer_stop();
+ * @endcode
+ */
+
+#ifndef ARENA_TRIM_H
+#define ARENA_TRIM_H
+
+#include "arena.h"
+#include "arena_scratch.h"
+#include <stdbool.h>
+
+/// Default sampling interval of the trimmer, in milliseconds.
+#ifndef ARENA_TRIM_INTERVAL_MS
+#define ARENA_TRIM_INTERVAL_MS 1000
+#endif
+
+/// PSI `some avg10` percentage from which the default source reports pressure.
+#ifndef ARENA_PSI_SOME_THRESHOLD
+#define ARENA_PSI_SOME_THRESHOLD 10.0
+#endif
+
+/// PSI `full avg10` percentage from which the default source reports full pressure.
+#ifndef ARENA_PSI_FULL_THRESHOLD
+#define ARENA_PSI_FULL_THRESHOLD 5.0
+#endif
+
+/// Files read by the default pressure source.
+#ifndef ARENA_PSI_PATH
+#define ARENA_PSI_PATH "/proc/pressure/memory"
+#endif
+#ifndef ARENA_CGROUP_EVENTS_PATH
+#define ARENA_CGROUP_EVENTS_PATH "/sys/fs/cgroup/memory.events"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @enum e_arena_pressure
+	 * @brief Memory pressure reported by a pressure source.
+	 *
+	 * @ingroup arena_trim
+	 */
+	typedef enum e_arena_pressure
+	{
+		ARENA_PRESSURE_NONE = 0, /**< No pressure: nothing is trimmed. */
+		ARENA_PRESSURE_SOME,     /**< Some stalls: trim idle arenas. */
+		ARENA_PRESSURE_FULL,     /**< Severe stalls or cgroup limit hit: trim everything. */
+	} t_arena_pressure;
+
+	/**
+	 * @typedef arena_pressure_fn
+	 * @brief Sample the current memory pressure.
+	 *
+	 * @details
+	 * Called from the trimmer thread only, once per interval.
+	 *
+	 * @ingroup arena_trim
+	 */
+	typedef t_arena_pressure (*arena_pressure_fn)(void* context);
+
+	/**
+	 * @brief
+	 * Default pressure source: PSI, then cgroup v2 `memory.events`.
+	 *
+	 * @details
+	 * PSI reports `ARENA_PRESSURE_FULL` or `ARENA_PRESSURE_SOME` when its
+	 * `avg10` values reach `ARENA_PSI_FULL_THRESHOLD` or
+	 * `ARENA_PSI_SOME_THRESHOLD`. Without PSI, new `max` or `oom` events report
+	 * full pressure and new `high` events some pressure. Without either file
+	 * it reports no pressure.
+	 *
+	 * @param context Unused.
+	 *
+	 * @ingroup arena_trim
+	 */
+	t_arena_pressure arena_pressure_read(void* context);
+
+	/**
+	 * @brief
+	 * Return the free pages of `arena` (past its offset) to the kernel.
+	 *
+	 * @details
+	 * Applies `MADV_DONTNEED` to the whole pages between the offset and the end
+	 * of an owned heap or anonymous-mapping buffer. The buffer does not move and
+	 * the pages read as zero when next touched. Shared, file and frozen arenas
+	 * are left alone.
+	 *
+	 * @return Bytes decommitted.
+	 *
+	 * @ingroup arena_trim
+	 */
+	size_t arena_decommit(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Start the trimmer thread.
+	 *
+	 * @param source      Pressure source, or `NULL` for `arena_pressure_read()`.
+	 * @param context     Context passed to `source`.
+	 * @param interval_ms Sampling interval (`0` = `ARENA_TRIM_INTERVAL_MS`).
+	 *
+	 * @return `true` if the thread runs, `false` if it was already running or
+	 *         could not be started.
+	 *
+	 * @ingroup arena_trim
+	 */
+	bool arena_trimmer_start(arena_pressure_fn source, void* context, unsigned interval_ms);
+
+	/**
+	 * @brief
+	 * Stop and join the trimmer thread. Registrations are kept.
+	 *
+	 * @ingroup arena_trim
+	 */
+	void arena_trimmer_stop(void);
+
+	/**
+	 * @brief
+	 * Trim `arena` when the trimmer detects pressure.
+	 *
+	 * @details
+	 * The arena must use its lock. Registering twice has no effect.
+	 *
+	 * @ingroup arena_trim
+	 */
+	bool arena_trimmer_register(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Stop trimming `arena`; waits if a trim of it is in progress.
+	 *
+	 * @ingroup arena_trim
+	 */
+	void arena_trimmer_unregister(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Trim the free slots of `pool` when the trimmer detects pressure.
+	 *
+	 * @ingroup arena_trim
+	 */
+	bool arena_trimmer_register_pool(t_scratch_arena_pool* pool);
+
+	/**
+	 * @brief
+	 * Stop trimming `pool`; waits if a trim of it is in progress.
+	 *
+	 * @ingroup arena_trim
+	 */
+	void arena_trimmer_unregister_pool(t_scratch_arena_pool* pool);
+
+	/**
+	 * @brief
+	 * Run one trimming pass at `level` on the calling thread.
+	 *
+	 * @details
+	 * Does what the trimmer thread does when its source reports `level`; works
+	 * whether or not the thread runs.
+	 *
+	 * @return Bytes released (shrunk or decommitted).
+	 *
+	 * @ingroup arena_trim
+	 */
+	size_t arena_trim_now(t_arena_pressure level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_TRIM_H
@@ -0,0 +1,159 @@
+/**
+ * @file arena_writer.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Buffered writer that builds output in arena memory and flushes it with `writev()`.
+ *
+ * @details
+ * A `t_arena_writer` appends raw bytes and formatted text into chunks allocated
+ * from an arena. While the writer's last chunk is also the arena's last
+ * allocation, it is extended in place with `arena_realloc_last()`, so most
+ * output ends up in one contiguous block. When something else allocated in
+ * between, a new chunk is started instead.
+ *
+ * `arena_writer_flush()` hands every chunk to the kernel with `writev()`:
+ * output goes from arena memory to the descriptor without an intermediate
+ * buffer or copy. The arena lock is released while `writev()` blocks, so a
+ * slow descriptor does not stall other threads using the arena.
+ *
+ * Chunks are linked by offsets relative to the arena buffer, not pointers, so
+ * the writer stays valid when the arena grows and its buffer moves. They are
+ * always carved from the buffer, even above `arena_set_large_threshold()`.
+ *
+ * @note
+ * A writer must not be used concurrently from several threads, and it becomes
+ * invalid when its arena is reset, popped below its first chunk, or destroyed.
+ *
+ * @ingroup arena_writer
+ */
+
+#ifndef ARENA_WRITER_H
+#define ARENA_WRITER_H
+
+#include "arena.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/// Default capacity of a new writer chunk, in bytes.
+#ifndef ARENA_WRITER_CHUNK_SIZE
+#define ARENA_WRITER_CHUNK_SIZE 4096
+#endif
+
+/// Offset value marking the end of the chunk list.
+#define ARENA_WRITER_NO_CHUNK ((size_t) -1)
+
+/**
+ * @brief
+ * Header stored in front of each chunk of writer output.
+ *
+ * @ingroup arena_writer
+ */
+typedef struct s_arena_writer_chunk
+{
+	size_t next_off; ///< Arena offset of the next chunk header, or `ARENA_WRITER_NO_CHUNK`.
+	size_t len;      ///< Bytes written to this chunk.
+	size_t cap;      ///< Bytes available after the header.
+} t_arena_writer_chunk;
+
+/**
+ * @brief
+ * Append-only writer over arena-resident chunks.
+ *
+ * @ingroup arena_writer
+ */
+typedef struct s_arena_writer
+{
+	t_arena* arena;       ///< Arena providing chunk memory.
+	size_t   head_off;    ///< Arena offset of the first chunk header.
+	size_t   tail_off;    ///< Arena offset of the last chunk header.
+	size_t   total;       ///< Bytes written since the last flush or reset.
+	size_t   chunk_size;  ///< Minimum capacity of new chunks.
+	size_t   chunk_count; ///< Number of chunks in the list.
+	bool     failed;      ///< Set when a write could not be stored.
+} t_arena_writer;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Initialize a writer on `arena`.
+	 *
+	 * @param writer     Writer to initialize.
+	 * @param arena      Arena providing memory.
+	 * @param chunk_size Minimum chunk capacity (`0` for `ARENA_WRITER_CHUNK_SIZE`).
+	 * @return `true` on success, `false` on invalid arguments.
+	 *
+	 * @ingroup arena_writer
+	 */
+	bool arena_writer_init(t_arena_writer* writer, t_arena* arena, size_t chunk_size);
+
+	/**
+	 * @brief
+	 * Append `len` bytes.
+	 *
+	 * @ingroup arena_writer
+	 */
+	bool arena_writer_write(t_arena_writer* writer, const void* data, size_t len);
+
+	/**
+	 * @brief
+	 * Append a NUL-terminated string (without its terminator).
+	 *
+	 * @ingroup arena_writer
+	 */
+	bool arena_writer_puts(t_arena_writer* writer, const char* str);
+
+	/**
+	 * @brief
+	 * Append `printf`-style formatted text.
+	 *
+	 * @ingroup arena_writer
+	 */
+	bool arena_writer_printf(t_arena_writer* writer, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+	/**
+	 * @brief
+	 * Append formatted text from a `va_list`.
+	 *
+	 * @ingroup arena_writer
+	 */
+	bool arena_writer_vprintf(t_arena_writer* writer, const char* fmt, va_list args);
+
+	/**
+	 * @brief
+	 * Number of bytes buffered since the last flush or reset.
+	 *
+	 * @ingroup arena_writer
+	 */
+	size_t arena_writer_size(const t_arena_writer* writer);
+
+	/**
+	 * @brief
+	 * Write all buffered output to `fd` with `writev()` and empty the writer.
+	 *
+	 * @return Number of bytes written, or `-1` on error.
+	 *
+	 * @ingroup arena_writer
+	 */
+	ssize_t arena_writer_flush(t_arena_writer* writer, int fd);
+
+	/**
+	 * @brief
+	 * Drop all buffered output without writing it.
+	 *
+	 * @ingroup arena_writer
+	 */
+	void arena_writer_reset(t_arena_writer* writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_WRITER_H
@@ -0,0 +1,193 @@
+/**
+ * @file arena_backing.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Internal description of where an arena buffer comes from.
+ *
+ * @details
+ * Most arenas own a heap buffer obtained from `calloc()` and resized with
+ * `realloc()`; large owned buffers are anonymous mappings resized with
+ * `mremap()`. Some arenas instead live inside a memory mapping of a file (for
+ * example a `MAP_SHARED` mapping of a persistent arena). The `t_arena_backing` record stored in
+ * every `t_arena` tells the resize and cleanup paths which primitives to use
+ * for the buffer, so that the rest of the allocator can stay agnostic.
+ *
+ * A zero-initialized backing describes a plain heap buffer, which keeps
+ * `calloc`'ed or `{0}`-initialized arenas valid without extra setup.
+ *
+ * These APIs are **not** intended for external use and may change without notice.
+ *
+ * @ingroup arena_internal
+ */
+
+#ifndef ARENA_BACKING_H
+#define ARENA_BACKING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	typedef struct s_arena t_arena;
+
+	/**
+	 * @brief
+	 * Kind of memory an arena buffer is carved from.
+	 *
+	 * @ingroup arena_internal
+	 */
+	typedef enum e_arena_backing_kind
+	{
+		ARENA_BACKING_HEAP = 0, ///< `calloc`/`realloc`/`free` managed buffer (default).
+		ARENA_BACKING_FILE,     ///< `MAP_SHARED` mapping of a persistent file (header page in front).
+		ARENA_BACKING_MEMFD,    ///< `MAP_SHARED` mapping of an anonymous `memfd_create()` file.
+		ARENA_BACKING_COW,      ///< `MAP_PRIVATE` copy-on-write view of a file or memfd arena.
+		ARENA_BACKING_MMAP,     ///< Anonymous private mapping for large owned buffers (`mremap` growth).
+	} t_arena_backing_kind;
+
+	/**
+	 * @brief
+	 * Mapping metadata for arenas whose buffer is not a plain heap block.
+	 *
+	 * @details
+	 * For mapped backings the arena buffer starts `header_len` bytes into the
+	 * mapping, which leaves room for an on-disk header in front of user data.
+	 * An anonymous mapping can sit at the start of a larger reservation, which
+	 * lets it grow without moving.
+	 *
+	 * @ingroup arena_internal
+	 */
+	typedef struct s_arena_backing
+	{
+		t_arena_backing_kind kind;        ///< Where the buffer memory comes from.
+		int                  fd;          ///< Descriptor behind the mapping (unused for heap buffers).
+		void*                map_base;    ///< Start of the whole mapping, header included.
+		size_t               map_len;     ///< Length of the whole mapping in bytes.
+		size_t               header_len;  ///< Bytes reserved in front of the buffer.
+		intptr_t             relocation;  ///< Address shift applied when the mapping was reopened.
+		size_t               reserve_len; ///< Address space reserved from `map_base` (0 if none), `PROT_NONE` past `map_len`.
+	} t_arena_backing;
+
+	/**
+	 * @brief Return the system page size, cached after the first call.
+	 * @ingroup arena_internal
+	 */
+	size_t arena_page_size(void);
+
+	/**
+	 * @brief Round `size` up to the next multiple of the page size.
+	 * @ingroup arena_internal
+	 */
+	size_t arena_page_round(size_t size);
+
+	/**
+	 * @brief Reset a backing record to the default heap state.
+	 * @ingroup arena_internal
+	 */
+	void arena_backing_reset(t_arena_backing* backing);
+
+	/**
+	 * @brief Whether the buffer described by `backing` lives in a memory mapping.
+	 * @ingroup arena_internal
+	 */
+	bool arena_backing_is_mapped(const t_arena_backing* backing);
+
+	/**
+	 * @brief
+	 * Map `len` bytes of `fd` as `MAP_SHARED`, preferring the address `hint`.
+	 *
+	 * @return The mapping address, or `NULL` on failure.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void* arena_backing_map_shared(int fd, size_t len, void* hint);
+
+	/**
+	 * @brief
+	 * Build a heap-allocated arena over an existing shared mapping of `fd`.
+	 *
+	 * @details
+	 * The arena owns the mapping and the descriptor: they are released by
+	 * `arena_destroy()`. `relocation` records how far the buffer moved from
+	 * the address it had in a previous session (0 when unknown or unchanged).
+	 *
+	 * @return The new arena, or `NULL` if the struct could not be allocated.
+	 *
+	 * @ingroup arena_internal
+	 */
+	t_arena* arena_backing_adopt(t_arena_backing_kind kind, int fd, void* map, size_t map_len, size_t header_len,
+	                             size_t size, size_t offset, intptr_t relocation, bool allow_grow, const char* label);
+
+	/**
+	 * @brief
+	 * Allocate a zeroed, owned arena buffer of `size` bytes and describe it in `backing`.
+	 *
+	 * @details
+	 * Buffers below `ARENA_MMAP_THRESHOLD` come from `calloc()`; larger ones are
+	 * anonymous mappings (`ARENA_BACKING_MMAP`) so they can be resized with `mremap()`.
+	 *
+	 * @return The buffer, or `NULL` on failure.
+	 *
+	 * @ingroup arena_internal
+	 */
+	uint8_t* arena_backing_alloc(t_arena_backing* backing, size_t size);
+
+	/**
+	 * @brief
+	 * Resize the buffer described by `backing` from `old_size` to `new_size` bytes.
+	 *
+	 * @return The (possibly moved) buffer, or `NULL` on failure (the old buffer stays valid).
+	 *
+	 * @ingroup arena_internal
+	 */
+	uint8_t* arena_backing_resize(t_arena_backing* backing, uint8_t* buffer, size_t old_size, size_t new_size);
+
+	/**
+	 * @brief
+	 * Grow the buffer described by `backing` to `new_size` bytes without moving it.
+	 *
+	 * @details
+	 * Commits reserved address space behind the buffer, or extends its mapping
+	 * with `mremap()` where nothing is mapped right after it. Heap buffers and
+	 * copy-on-write views cannot grow in place.
+	 *
+	 * @return The unchanged buffer, or `NULL` if it cannot grow in place.
+	 *
+	 * @ingroup arena_internal
+	 */
+	uint8_t* arena_backing_extend(t_arena_backing* backing, size_t new_size);
+
+	/**
+	 * @brief
+	 * Grow the buffer described by `backing`, keeping address space reserved behind it.
+	 *
+	 * @details
+	 * Within the current reservation the buffer grows in place. Otherwise it
+	 * moves to the start of a fresh reservation of `reserve_len` bytes, so that
+	 * later growths up to that length can be done with `arena_backing_extend()`.
+	 * Only heap buffers and anonymous mappings can be moved into a reservation.
+	 *
+	 * @return The (possibly moved) buffer, or `NULL` on failure (the old buffer stays valid).
+	 *
+	 * @ingroup arena_internal
+	 */
+	uint8_t* arena_backing_resize_reserved(t_arena_backing* backing, uint8_t* buffer, size_t old_size, size_t new_size,
+	                                       size_t reserve_len);
+
+	/**
+	 * @brief Release the buffer described by `backing` and reset the record.
+	 * @ingroup arena_internal
+	 */
+	void arena_backing_release(t_arena_backing* backing, uint8_t* buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_BACKING_H
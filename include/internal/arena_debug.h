@@ -10,6 +10,7 @@
  * This header defines debug-related features for arena memory systems, including:
  * - Debug labels and unique arena identifiers.
  * - Custom error reporting via callbacks.
+ * - Structured error codes (`t_arena_error`) and a per-thread last error.
  * - Optional memory poisoning to detect use-after-reset/pop.
  * - Internal consistency checks with assertions.
  * - Logging macros for diagnostics.
@@ -31,6 +32,7 @@
 #include "arena_config.h"
 #include <stdarg.h>
 #include <stdatomic.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -57,6 +59,56 @@ extern "C"
 	 */
 	typedef void (*arena_error_callback)(const char* message, void* context);
 
+	/**
+	 * @brief
+	 * Reason an allocation failed.
+	 *
+	 * @details
+	 * Returned by the `arena_try_alloc*()` functions and recorded per thread by
+	 * every allocation failure (see `arena_last_error()`).
+	 *
+	 * @ingroup arena_debug
+	 */
+	typedef enum e_arena_error
+	{
+		ARENA_OK = 0,          ///< No error.
+		ARENA_ERR_NULL_ARENA,  ///< The arena pointer was `NULL`.
+		ARENA_ERR_ZERO_SIZE,   ///< Zero-size request (or zero `count`/`size` for calloc).
+		ARENA_ERR_ALIGNMENT,   ///< Alignment is not a power of two.
+		ARENA_ERR_FROZEN,      ///< The arena is frozen (`arena_freeze()`).
+		ARENA_ERR_DESTROYING,  ///< The arena is being destroyed.
+		ARENA_ERR_OVERFLOW,    ///< The request does not fit in `size_t`.
+		ARENA_ERR_FULL,        ///< Not enough room and the arena cannot grow.
+		ARENA_ERR_GROW_FAILED, ///< Growing the buffer failed or did not make enough room.
+		ARENA_ERR_NO_MEMORY,   ///< A large-object mapping could not be created.
+		ARENA_ERR_COUNT        ///< Number of codes, not an error.
+	} t_arena_error;
+
+	/**
+	 * @brief
+	 * Quiet section state of a thread, saved and restored around each try-function.
+	 *
+	 * @ingroup arena_debug
+	 */
+	typedef struct s_arena_quiet
+	{
+		const t_arena* arena;  ///< Arena whose errors are silenced.
+		bool           active; ///< Whether a quiet section is open.
+	} t_arena_quiet;
+
+#ifdef ARENA_POISON_VERIFY
+	/**
+	 * @brief
+	 * Range handed out by an allocation, remembered to name it in poison reports.
+	 */
+	typedef struct s_arena_poison_owner
+	{
+		size_t      offset; ///< Start of the allocation in the buffer.
+		size_t      size;   ///< Size of the allocation.
+		const char* label;  ///< Allocation label (must outlive the arena).
+	} t_arena_poison_owner;
+#endif
+
 	/**
 	 * @brief
 	 * Debug metadata associated with an arena.
@@ -68,6 +120,11 @@ extern "C"
 		arena_error_callback error_cb;         ///< Callback function for reporting errors.
 		void*                error_context;    ///< Optional context passed to the error callback.
 		atomic_int           subarena_counter; ///< Internal counter for sub-arenas.
+#ifdef ARENA_POISON_VERIFY
+		size_t               poison_hi;                    ///< `[offset, poison_hi)` holds intact poison.
+		size_t               owner_count;                  ///< Allocations recorded so far.
+		t_arena_poison_owner owners[ARENA_POISON_HISTORY]; ///< Ring of the latest allocations.
+#endif
 	} t_arena_debug;
 
 	/**
@@ -100,6 +157,42 @@ extern "C"
 	 */
 	void arena_default_error_callback(const char* msg, void* ctx);
 
+	/**
+	 * @brief Report an allocation failure and record its code as the thread's last error.
+	 * @ingroup arena_debug
+	 */
+	void arena_report_failure(t_arena* arena, t_arena_error error, const char* fmt, ...);
+
+	/**
+	 * @brief Record `error` as the calling thread's last error without reporting it.
+	 * @ingroup arena_debug
+	 */
+	void arena_set_last_error(t_arena_error error);
+
+	/**
+	 * @brief Return the code of the calling thread's last allocation failure.
+	 * @ingroup arena_debug
+	 */
+	t_arena_error arena_last_error(void);
+
+	/**
+	 * @brief Return a static, human-readable description of an error code.
+	 * @ingroup arena_debug
+	 */
+	const char* arena_error_string(t_arena_error error);
+
+	/**
+	 * @brief Open a section where errors of `arena` only reach custom callbacks; returns the state to restore.
+	 * @ingroup arena_debug
+	 */
+	t_arena_quiet arena_errors_quiet_begin(const t_arena* arena);
+
+	/**
+	 * @brief Close a quiet section, restoring the state returned by `arena_errors_quiet_begin()`.
+	 * @ingroup arena_debug
+	 */
+	void arena_errors_quiet_end(t_arena_quiet outer);
+
 // ─────────────────────────────────────────────────────────────
 // Memory Poisoning
 // ─────────────────────────────────────────────────────────────
@@ -116,11 +209,63 @@ extern "C"
 	 * @ingroup arena_debug
 	 */
 	void arena_poison_memory(void* ptr, size_t size);
+
+	/**
+	 * @brief Poison `[from, to)` of the buffer as it becomes free again, phased from the buffer start.
+	 * @ingroup arena_debug
+	 */
+	void arena_poison_free(t_arena* arena, size_t from, size_t to);
 #else
 /**
  * @brief No-op poison macro when poisoning is disabled.
  */
 #define arena_poison_memory(ptr, size) ((void) (ptr), (void) (size))
+#define arena_poison_free(arena, from, to) ((void) (arena), (void) (from), (void) (to))
+#endif
+
+#ifdef ARENA_POISON_VERIFY
+	/**
+	 * @brief Check that the free memory of `arena` still holds its poison.
+	 * @ingroup arena_debug
+	 */
+	bool arena_verify_poison(t_arena* arena);
+
+	/**
+	 * @brief Report poison overwritten in `[from, to)` before it is handed out.
+	 * @ingroup arena_debug
+	 */
+	bool arena_poison_check(t_arena* arena, size_t from, size_t to);
+
+	/**
+	 * @brief Remember `[offset, offset + size)` as owned by `label`.
+	 * @ingroup arena_debug
+	 */
+	void arena_poison_record(t_arena* arena, size_t offset, size_t size, const char* label);
+
+/**
+ * @brief Verify the free bytes an allocation is about to take.
+ */
+#define ARENA_POISON_CHECK(arena, from, to) ((void) arena_poison_check((arena), (from), (to)))
+
+/**
+ * @brief Record an allocation for later poison reports.
+ */
+#define ARENA_POISON_RECORD(arena, offset, size, label) arena_poison_record((arena), (offset), (size), (label))
+
+/**
+ * @brief Forget poison at and above `limit` (memory zeroed or rewritten there).
+ */
+#define ARENA_POISON_CLIP(arena, limit)         \
+	do                                          \
+	{                                           \
+		if ((arena)->debug.poison_hi > (limit)) \
+			(arena)->debug.poison_hi = (limit); \
+	} while (0)
+#else
+#define arena_verify_poison(arena) ((void) (arena), true)
+#define ARENA_POISON_CHECK(arena, from, to) ((void) 0)
+#define ARENA_POISON_RECORD(arena, offset, size, label) ((void) 0)
+#define ARENA_POISON_CLIP(arena, limit) ((void) 0)
 #endif
 
 	// ─────────────────────────────────────────────────────────────
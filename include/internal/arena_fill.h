@@ -0,0 +1,135 @@
+/**
+ * @file arena_fill.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Vectorized fill and scan kernels used for poisoning, zeroing and verifying arena memory.
+ *
+ * @details
+ * Poisoning a large buffer one `uint32_t` at a time, or zeroing it with
+ * cached stores, dominates `arena_reset()` and `arena_calloc()` on big arenas.
+ * These kernels fill 64-byte blocks with the widest vector unit the CPU
+ * offers, chosen once at run time:
+ * - AVX-512F, AVX2 or SSE2 on x86-64,
+ * - NEON on AArch64,
+ * - 64-bit scalar stores elsewhere.
+ *
+ * Ranges of at least `ARENA_FILL_STREAM_MIN` bytes are written with
+ * non-temporal stores on x86-64, so a multi-gigabyte reset does not evict
+ * the working set from the caches.
+ *
+ * A 32-bit pattern is always laid out from the start of the range, whatever
+ * its alignment, so the result is byte-for-byte the same as a word loop.
+ * `arena_scan_pattern()` checks a range against such a pattern with the same
+ * kernels, for `ARENA_POISON_VERIFY`.
+ *
+ * These APIs are **not** intended for external use and may change without notice.
+ *
+ * @ingroup arena_internal
+ */
+
+#ifndef ARENA_FILL_H
+#define ARENA_FILL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Range size from which fills use non-temporal stores
+#ifndef ARENA_FILL_STREAM_MIN
+#define ARENA_FILL_STREAM_MIN (4UL << 20)
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/**
+	 * @brief
+	 * Instruction sets a fill kernel can be built on.
+	 *
+	 * @ingroup arena_internal
+	 */
+	typedef enum e_arena_fill_isa
+	{
+		ARENA_FILL_SCALAR = 0, ///< Portable 64-bit stores.
+		ARENA_FILL_SSE2,       ///< 128-bit stores (x86-64 baseline).
+		ARENA_FILL_AVX2,       ///< 256-bit stores.
+		ARENA_FILL_AVX512,     ///< 512-bit stores.
+		ARENA_FILL_NEON,       ///< 128-bit stores on AArch64.
+		ARENA_FILL_ISA_COUNT
+	} t_arena_fill_isa;
+
+	/**
+	 * @brief
+	 * Repeat the 32-bit `pattern` over `size` bytes starting at `dst`.
+	 *
+	 * @details
+	 * A trailing partial word receives the leading bytes of the pattern.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void arena_fill_pattern(void* dst, uint32_t pattern, size_t size);
+
+	/**
+	 * @brief
+	 * Zero `size` bytes; large ranges bypass the caches.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void arena_fill_zero(void* dst, size_t size);
+
+	/**
+	 * @brief
+	 * Zero `size` bytes with non-temporal stores whatever the size.
+	 *
+	 * @details
+	 * For background cleaning of memory the caller does not read next.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void arena_fill_zero_stream(void* dst, size_t size);
+
+	/**
+	 * @brief
+	 * Find the first byte of `[src, src + size)` that breaks the repeated `pattern`.
+	 *
+	 * @return Index of that byte, or `size` if the whole range matches.
+	 *
+	 * @ingroup arena_internal
+	 */
+	size_t arena_scan_pattern(const void* src, uint32_t pattern, size_t size);
+
+	/**
+	 * @brief
+	 * Instruction set of the kernel currently in use.
+	 *
+	 * @ingroup arena_internal
+	 */
+	t_arena_fill_isa arena_fill_isa(void);
+
+	/**
+	 * @brief
+	 * Force the kernel built on `isa`, e.g. to compare kernels in tests or benchmarks.
+	 *
+	 * @return `false` (and no change) if this build or CPU cannot run it.
+	 *
+	 * @ingroup arena_internal
+	 */
+	bool arena_fill_use_isa(t_arena_fill_isa isa);
+
+	/**
+	 * @brief
+	 * Printable name of `isa` (e.g. `"avx2"`).
+	 *
+	 * @ingroup arena_internal
+	 */
+	const char* arena_fill_isa_name(t_arena_fill_isa isa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_FILL_H
@@ -35,33 +35,90 @@ extern "C"
 
 /**
  * @def ARENA_LOCK
- * @brief Acquire the mutex lock if thread safety is enabled.
+ * @brief Acquire the arena lock if thread safety is enabled (the bias owner skips the mutex).
  * @param arena Pointer to the arena.
  */
 #ifdef ARENA_ENABLE_THREAD_SAFE
-#define ARENA_LOCK(arena)                       \
-	do                                          \
-	{                                           \
-		if ((arena)->use_lock)                  \
-			pthread_mutex_lock(&(arena)->lock); \
+#define ARENA_LOCK(arena)              \
+	do                                 \
+	{                                  \
+		if ((arena)->use_lock)         \
+			arena_lock_acquire(arena); \
 	} while (0)
 
 /**
  * @def ARENA_UNLOCK
- * @brief Release the mutex lock if thread safety is enabled.
+ * @brief Release the arena lock if thread safety is enabled.
  * @param arena Pointer to the arena.
  */
-#define ARENA_UNLOCK(arena)                       \
-	do                                            \
-	{                                             \
-		if ((arena)->use_lock)                    \
-			pthread_mutex_unlock(&(arena)->lock); \
+#define ARENA_UNLOCK(arena)            \
+	do                                 \
+	{                                  \
+		if ((arena)->use_lock)         \
+			arena_lock_release(arena); \
 	} while (0)
 #else
 #define ARENA_LOCK(arena) ((void) 0)
 #define ARENA_UNLOCK(arena) ((void) 0)
 #endif
 
+/**
+ * @def ARENA_PREGROW_CHECK
+ * @brief Wake the pre-growth worker once a watched arena passes its high-water mark.
+ * @param arena Pointer to the arena, locked, right after its offset advanced.
+ */
+#ifdef ARENA_ENABLE_THREAD_SAFE
+#define ARENA_PREGROW_CHECK(arena)                                             \
+	do                                                                         \
+	{                                                                          \
+		if ((arena)->pregrow_percent &&                                        \
+		    (arena)->offset >= (arena)->size / 100 * (arena)->pregrow_percent) \
+			arena_pregrow_notify(arena);                                       \
+	} while (0)
+#else
+#define ARENA_PREGROW_CHECK(arena) ((void) 0)
+#endif
+
+/**
+ * @def ARENA_PREGROW_RESERVE
+ * @brief Address space to reserve when growing `arena` to `size` bytes (`0` unless it is watched).
+ * @param arena Pointer to the arena, locked.
+ * @param size  New buffer size in bytes.
+ */
+#ifdef ARENA_ENABLE_THREAD_SAFE
+#define ARENA_PREGROW_RESERVE(arena, size)                                         \
+	((arena)->pregrow_percent && (size) <= SIZE_MAX / ARENA_PREGROW_RESERVE_FACTOR \
+	     ? (size) * ARENA_PREGROW_RESERVE_FACTOR                                   \
+	     : (size_t) 0)
+#else
+#define ARENA_PREGROW_RESERVE(arena, size) ((void) (arena), (size_t) 0)
+#endif
+
+/**
+ * @def ARENA_PREZERO_NOTIFY
+ * @brief Queue background zeroing of a watched arena's dirty memory.
+ * @param arena Pointer to the arena, locked, after its offset moved back.
+ */
+#ifdef ARENA_ENABLE_THREAD_SAFE
+#define ARENA_PREZERO_NOTIFY(arena) arena_prezero_notify(arena)
+#else
+#define ARENA_PREZERO_NOTIFY(arena) ((void) 0)
+#endif
+
+/**
+ * @def ARENA_IO_PINNED
+ * @brief Whether I/O made without the lock is using the buffer of `arena`.
+ * @param arena Pointer to the arena, locked.
+ */
+#ifdef ARENA_ENABLE_THREAD_SAFE
+#define ARENA_IO_PINNED(arena) ((arena)->io_pins != NULL)
+#else
+#define ARENA_IO_PINNED(arena) ((void) (arena), false)
+#endif
+
+// A frozen arena never changes again, so its fields can be read without the lock.
+#define ARENA_IS_FROZEN(arena) atomic_load_explicit(&(arena)->is_frozen, memory_order_acquire)
+
 	// ─────────────────────────────────────────────────────────────
 	// Internal helper functions
 	// ─────────────────────────────────────────────────────────────
@@ -105,6 +162,17 @@ extern "C"
 	 */
 	void arena_update_peak(t_arena* arena);
 
+	/**
+	 * @brief
+	 * Bytes of the buffer that may have been handed out since the last reset.
+	 *
+	 * @param arena Arena to inspect (lock held).
+	 * @return `max(cycle_peak, offset)`, clamped to the buffer size.
+	 *
+	 * @ingroup arena_internal
+	 */
+	size_t arena_cycle_high_water(const t_arena* arena);
+
 	/**
 	 * @brief
 	 * Zero out and reset all debug/stats metadata associated with the arena.
@@ -116,6 +184,206 @@ extern "C"
 	 */
 	void arena_zero_metadata(t_arena* arena);
 
+	void arena_thaw_pages(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Large-object bypass internals (see `arena_set_large_threshold()`).
+	 *
+	 * @details
+	 * All of these must be called with the arena lock held.
+	 * - `arena_large_wanted()`: whether an allocation should get its own mapping.
+	 * - `arena_alloc_in_buffer()`: allocate from the bump buffer even above the threshold (takes the lock itself).
+	 * - `arena_large_map()`: map and link a large allocation whose ticket byte is reserved.
+	 * - `arena_large_is_last()`: whether `ptr` is the newest allocation and has its own mapping.
+	 * - `arena_large_resize()`: resize the mapping of the newest large allocation.
+	 * - `arena_large_release()`: unmap the large allocations at or past `marker`.
+	 * - `arena_large_protect()`: change the protection of every large mapping.
+	 * - `arena_large_mapped()`: total length of the large mappings.
+	 *
+	 * @ingroup arena_internal
+	 */
+	bool   arena_large_wanted(const t_arena* arena, size_t size, size_t alignment);
+	void*  arena_alloc_in_buffer(t_arena* arena, size_t size, size_t alignment, const char* label);
+	void*  arena_large_map(t_arena* arena, size_t size, size_t ticket);
+	bool   arena_large_is_last(const t_arena* arena, const void* ptr);
+	void*  arena_large_resize(t_arena* arena, size_t new_size);
+	void   arena_large_release(t_arena* arena, size_t marker);
+	bool   arena_large_protect(t_arena* arena, int prot);
+	size_t arena_large_mapped(const t_arena* arena);
+
+	/**
+	 * @brief
+	 * Guard page internals (see `arena_set_guard_pages()`).
+	 *
+	 * @details
+	 * - `arena_guard_carve()`: allocate a page-rounded sub-arena block followed by
+	 *   a guard page (takes the parent lock itself).
+	 * - `arena_guard_release()`: unprotect and forget the guards at or past `marker`.
+	 * - `arena_guard_protect()`: change the protection of every guard page.
+	 * - `arena_guard_rebase()`: protect the guards again after a resize, or forget them if the buffer moved.
+	 * - `arena_guard_clear()`: release every guard and free the list.
+	 *
+	 * All but `arena_guard_carve()` must be called with the arena lock held.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void* arena_guard_carve(t_arena* parent, size_t* size, size_t alignment);
+	void  arena_guard_release(t_arena* arena, size_t marker);
+	bool  arena_guard_protect(t_arena* arena, int prot);
+	void  arena_guard_rebase(t_arena* arena, const uint8_t* new_buffer);
+	void  arena_guard_clear(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Fold the finished cycle's peak into the shrink window and roll it if due.
+	 *
+	 * @details
+	 * Called by `arena_reset()` with the arena lock held.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void arena_shrink_window_on_reset(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Queue a background pre-growth of a watched arena.
+	 *
+	 * @details
+	 * Called by `ARENA_PREGROW_CHECK()` with the arena lock held.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void arena_pregrow_notify(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Grow an arena without moving its buffer.
+	 *
+	 * @details
+	 * Called by the pre-growth worker. Fails silently when the buffer cannot
+	 * be extended where it lies.
+	 *
+	 * @ingroup arena_internal
+	 */
+	bool arena_grow_in_place(t_arena* arena, size_t required_size);
+
+	/**
+	 * @brief
+	 * Queue a pre-zeroing pass over a watched arena.
+	 *
+	 * @details
+	 * Called by `ARENA_PREZERO_NOTIFY()` with the arena lock held.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void arena_prezero_notify(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Budget accounting of attached arenas (see `arena_budget_attach()`).
+	 *
+	 * @details
+	 * Called with the arena lock held; no-ops for arenas without a budget.
+	 * - `arena_budget_charge()`: charge memory about to be obtained, under the
+	 *   budget's over-budget policy.
+	 * - `arena_budget_credit()`: credit memory that was released.
+	 *
+	 * @ingroup arena_internal
+	 */
+	bool arena_budget_charge(t_arena* arena, size_t bytes);
+	void arena_budget_credit(t_arena* arena, size_t bytes);
+
+	/**
+	 * @brief
+	 * Hand a destroyed arena's buffer to the background reclaimer.
+	 *
+	 * @details
+	 * Called by `arena_destroy()`. Returns `false` if the buffer must be
+	 * released inline (reclaimer stopped, buffer too small or not private,
+	 * queue full); on success `backing` is reset.
+	 *
+	 * @ingroup arena_internal
+	 */
+	bool arena_reclaim_defer(t_arena_backing* backing, uint8_t* buffer, size_t size);
+
+	/**
+	 * @brief
+	 * Recycle cache of destroyed arenas (see `arena_recycle_enable()`).
+	 *
+	 * @details
+	 * - `arena_recycle_take()`: zeroed cached buffer for `arena_create()` /
+	 *   `arena_init()`, or `NULL`.
+	 * - `arena_recycle_offer()`: keep the buffer of an arena being destroyed;
+	 *   on success its backing is reset.
+	 * - `arena_recycle_take_struct()` / `arena_recycle_offer_struct()`: the
+	 *   same for structs freed by `arena_delete()`.
+	 *
+	 * @ingroup arena_internal
+	 */
+	uint8_t* arena_recycle_take(t_arena_backing* backing, size_t size);
+	bool     arena_recycle_offer(t_arena* arena);
+	t_arena* arena_recycle_take_struct(void);
+	bool     arena_recycle_offer_struct(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Keep the `ARENA_CREATE_*` flags of an arena in force across resizes.
+	 *
+	 * @details
+	 * Called with the arena lock held; no-ops for arenas created without flags.
+	 * - `arena_prefault_unpin()`: unlock the buffer before it is resized or
+	 *   released.
+	 * - `arena_prefault_pin()`: lock the buffer again and prefault
+	 *   `[from, size)`; `false` if it could not be locked.
+	 *
+	 * @ingroup arena_internal
+	 */
+	bool arena_prefault_pin(t_arena* arena, size_t from);
+	void arena_prefault_unpin(t_arena* arena);
+
+	/**
+	 * @brief
+	 * Buffer range used by a system call made without the arena lock.
+	 *
+	 * @details
+	 * Lives on the stack of the calling thread and is linked into
+	 * `arena->io_pins` from `arena_io_pin()` to `arena_io_unpin()`.
+	 *
+	 * @ingroup arena_internal
+	 */
+	struct s_arena_io_pin
+	{
+		struct s_arena_io_pin* next;   ///< Next pin of the same arena.
+		uint8_t*               buffer; ///< Arena buffer when the range was pinned (`NULL` if it lies outside).
+		uint8_t*               data;   ///< Start of the range.
+		size_t                 len;    ///< Length of the range in bytes.
+		bool                   write;  ///< Whether the kernel writes into the range.
+	};
+
+	/**
+	 * @brief
+	 * I/O without the arena lock (see `arena_read_fd()` and `arena_writer_flush()`).
+	 *
+	 * @details
+	 * Called with the arena lock held, which is then dropped for the system
+	 * call. No-ops without `ARENA_ENABLE_THREAD_SAFE`.
+	 * - `arena_io_pin()`: keep `[data, data + len)` valid until it is
+	 *   unpinned, whatever other threads do to the buffer. Ranges outside of
+	 *   the buffer (large-object mappings) never move and are not tracked.
+	 * - `arena_io_unpin()`: release the range and return where it lives now;
+	 *   for a `write` pin, the bytes are carried over if the buffer moved.
+	 * - `arena_io_pinned_resize()`: growth of a pinned buffer, used instead of
+	 *   `arena_backing_resize()`. The buffer is extended in place when
+	 *   possible; otherwise it is copied (except the `write` ranges) into a new
+	 *   one and kept alive until the last pin is gone.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void     arena_io_pin(t_arena* arena, struct s_arena_io_pin* pin, void* data, size_t len, bool write);
+	void*    arena_io_unpin(t_arena* arena, struct s_arena_io_pin* pin);
+	uint8_t* arena_io_pinned_resize(t_arena* arena, size_t new_size, size_t old_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,131 @@
+/**
+ * @file arena_lock.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Lock acquisition behind `ARENA_LOCK` / `ARENA_UNLOCK`, with the biased fast path.
+ *
+ * @details
+ * `bias_owner` holds one of the `ARENA_BIAS_*` states or, once claimed, the
+ * owner's token: the address of a thread-local byte, unique among live
+ * threads. Every write to it happens with the mutex held, so a thread that
+ * holds the mutex reads it reliably.
+ *
+ * The owner enters by bumping `bias_depth` and then reading `bias_revoke`;
+ * a revoker sets `bias_revoke`, issues `membarrier()` and then waits for
+ * `bias_depth` to drop to zero. The system-wide barrier stands in for the
+ * fence the owner leaves out, so either the owner sees the flag and falls
+ * back to the mutex, or the revoker sees the owner inside and waits. Nested
+ * locks by the owner only bump the depth, like the recursive mutex would.
+ *
+ * Included by `arena.h` after `t_arena` is defined.
+ *
+ * @ingroup arena_internal
+ */
+
+#ifndef ARENA_LOCK_H
+#define ARENA_LOCK_H
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define ARENA_BIAS_NONE ((uintptr_t) 0)      ///< Biased locking disabled.
+#define ARENA_BIAS_REVOKED ((uintptr_t) 1)   ///< Bias revoked; everyone takes the mutex.
+#define ARENA_BIAS_UNCLAIMED ((uintptr_t) 2) ///< Biased, waiting for its first locker.
+
+	/// Per-thread byte whose address identifies the thread as a bias owner.
+	extern _Thread_local char arena_bias_token;
+
+	/**
+	 * @brief
+	 * Claim or revoke the bias of an arena whose mutex was just acquired.
+	 *
+	 * @ingroup arena_internal
+	 */
+	void arena_bias_settle(t_arena* arena);
+
+	static inline uintptr_t arena_bias_self(void)
+	{
+		return (uintptr_t) &arena_bias_token;
+	}
+
+	/**
+	 * @brief
+	 * Owner fast path: enter the arena unless a revocation is under way.
+	 *
+	 * @return `true` if the arena was entered without the mutex.
+	 */
+	static inline bool arena_bias_enter(t_arena* arena)
+	{
+		unsigned depth = atomic_load_explicit(&arena->bias_depth, memory_order_relaxed);
+		atomic_store_explicit(&arena->bias_depth, depth + 1, memory_order_relaxed);
+		if (depth)
+			return true;
+		atomic_signal_fence(memory_order_seq_cst); // the revoker's membarrier() orders the store before the load
+		if (!atomic_load_explicit(&arena->bias_revoke, memory_order_relaxed))
+			return true;
+		atomic_store_explicit(&arena->bias_depth, 0, memory_order_release);
+		return false;
+	}
+
+	static inline void arena_lock_acquire(t_arena* arena)
+	{
+		if (atomic_load_explicit(&arena->bias_owner, memory_order_relaxed) == arena_bias_self() &&
+		    arena_bias_enter(arena))
+			return;
+		pthread_mutex_lock(&arena->lock);
+		if (atomic_load_explicit(&arena->bias_owner, memory_order_relaxed) >= ARENA_BIAS_UNCLAIMED)
+			arena_bias_settle(arena);
+	}
+
+	static inline void arena_lock_release(t_arena* arena)
+	{
+		if (atomic_load_explicit(&arena->bias_owner, memory_order_relaxed) == arena_bias_self())
+		{
+			unsigned depth = atomic_load_explicit(&arena->bias_depth, memory_order_relaxed);
+			if (depth)
+			{
+				atomic_store_explicit(&arena->bias_depth, depth - 1, memory_order_release);
+				return;
+			}
+		}
+		pthread_mutex_unlock(&arena->lock);
+	}
+
+	/**
+	 * @brief
+	 * Whether the calling thread is inside `arena` through its bias.
+	 */
+	static inline bool arena_bias_held(t_arena* arena)
+	{
+		return atomic_load_explicit(&arena->bias_owner, memory_order_relaxed) == arena_bias_self() &&
+		       atomic_load_explicit(&arena->bias_depth, memory_order_relaxed) != 0;
+	}
+
+	/**
+	 * @brief
+	 * Whether another thread owns the bias of `arena`, so holding its mutex
+	 * does not exclude the owner.
+	 */
+	static inline bool arena_bias_foreign(t_arena* arena)
+	{
+		uintptr_t owner = atomic_load_explicit(&arena->bias_owner, memory_order_relaxed);
+		return owner > ARENA_BIAS_UNCLAIMED && owner != arena_bias_self();
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_ENABLE_THREAD_SAFE
+
+#endif // ARENA_LOCK_H
@@ -0,0 +1,156 @@
+/**
+ * @file arena_sanitize.h
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * AddressSanitizer and Valgrind annotations for memory inside arena buffers.
+ *
+ * @details
+ * An arena buffer is a single `calloc()` block or mapping, so memory checkers
+ * see all of it as valid for as long as the arena lives. These annotations
+ * describe the bump allocator to them:
+ * - with AddressSanitizer (`-fsanitize=address`, detected automatically), the
+ *   free part of the buffer is poisoned with `ASAN_POISON_MEMORY_REGION()` and
+ *   each allocation is unpoisoned as it is handed out, so an access past the
+ *   end of an allocation, or through a pointer kept across `arena_pop()`,
+ *   `arena_reset()` or a shrink, is reported where it happens;
+ * - with `ARENA_VALGRIND` defined and `<valgrind/memcheck.h>` available, the
+ *   arena is registered as a Memcheck mempool (`VALGRIND_MEMPOOL_ALLOC`,
+ *   `VALGRIND_MEMPOOL_TRIM`, ...) and free memory is marked inaccessible.
+ *
+ * `ARENA_REDZONE_SIZE` leaves that many poisoned bytes in front of every
+ * allocation but the first, so overflows into the next allocation are caught
+ * too. It defaults to 0 because it changes offsets; set it in sanitizer
+ * builds only.
+ *
+ * The library itself writes free memory (poisoning, pre-zeroing, page
+ * touching) and reads or rewrites the used range in bulk (snapshots,
+ * copy-on-write promotion, buffer moves). Those paths open the range first;
+ * bulk operations on the used range drop the redzones below the offset, and
+ * the poisoning of sub-arenas carved from it.
+ *
+ * Without either checker every macro expands to nothing.
+ *
+ * These APIs are **not** intended for external use and may change without notice.
+ *
+ * @ingroup arena_debug
+ */
+
+#ifndef ARENA_SANITIZE_H
+#define ARENA_SANITIZE_H
+
+#include "arena_config.h"
+#include <stddef.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define ARENA_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ARENA_ASAN
+#endif
+#endif
+
+#if defined(ARENA_VALGRIND) && defined(__has_include)
+#if !__has_include(<valgrind/memcheck.h>)
+#undef ARENA_VALGRIND
+#endif
+#endif
+
+#if defined(ARENA_ASAN) || defined(ARENA_VALGRIND)
+#define ARENA_SANITIZE
+#endif
+
+#ifdef ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	typedef struct s_arena t_arena;
+
+#ifdef ARENA_SANITIZE
+	/**
+	 * @brief Describe a freshly set buffer: `[0, offset)` in use, the rest free.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_attach(t_arena* arena);
+
+	/**
+	 * @brief Make the whole buffer plain memory again before it is released, moved or rewritten.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_detach(t_arena* arena);
+
+	/**
+	 * @brief Hand out `[start, start + size)`; `from` is the offset before the allocation.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_alloc(t_arena* arena, size_t from, size_t start, size_t size);
+
+	/**
+	 * @brief Mark `[from, to)` free again after a pop, reset or shrink.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_release(t_arena* arena, size_t from, size_t to);
+
+	/**
+	 * @brief Resize the last allocation, at `start`, in place.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_resize(t_arena* arena, size_t start, size_t old_size, size_t new_size);
+
+	/**
+	 * @brief Let the library write `[ptr, ptr + size)` of free memory.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_open(void* ptr, size_t size);
+
+	/**
+	 * @brief Mark `[ptr, ptr + size)` free again after `arena_sanitize_open()`.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_close(void* ptr, size_t size);
+
+	/**
+	 * @brief Let the library read the first `size` bytes of the buffer in bulk.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_read_begin(const t_arena* arena, size_t size);
+
+	/**
+	 * @brief End a bulk read started by `arena_sanitize_read_begin()`.
+	 * @ingroup arena_debug
+	 */
+	void arena_sanitize_read_end(const t_arena* arena, size_t size);
+
+#define ARENA_SAN_ATTACH(arena) arena_sanitize_attach(arena)
+#define ARENA_SAN_DETACH(arena) arena_sanitize_detach(arena)
+#define ARENA_SAN_ALLOC(arena, from, start, size) arena_sanitize_alloc((arena), (from), (start), (size))
+#define ARENA_SAN_RELEASE(arena, from, to) arena_sanitize_release((arena), (from), (to))
+#define ARENA_SAN_RESIZE(arena, start, old_size, new_size) \
+	arena_sanitize_resize((arena), (start), (old_size), (new_size))
+#define ARENA_SAN_OPEN(ptr, size) arena_sanitize_open((ptr), (size))
+#define ARENA_SAN_CLOSE(ptr, size) arena_sanitize_close((ptr), (size))
+#define ARENA_SAN_READ_BEGIN(arena, size) arena_sanitize_read_begin((arena), (size))
+#define ARENA_SAN_READ_END(arena, size) arena_sanitize_read_end((arena), (size))
+#else
+#define ARENA_SAN_ATTACH(arena) ((void) 0)
+#define ARENA_SAN_DETACH(arena) ((void) 0)
+#define ARENA_SAN_ALLOC(arena, from, start, size) ((void) 0)
+#define ARENA_SAN_RELEASE(arena, from, to) ((void) 0)
+#define ARENA_SAN_RESIZE(arena, start, old_size, new_size) ((void) 0)
+#define ARENA_SAN_OPEN(ptr, size) ((void) 0)
+#define ARENA_SAN_CLOSE(ptr, size) ((void) 0)
+#define ARENA_SAN_READ_BEGIN(arena, size) ((void) 0)
+#define ARENA_SAN_READ_END(arena, size) ((void) 0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_SANITIZE_H
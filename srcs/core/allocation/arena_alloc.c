@@ -16,6 +16,11 @@
  * - `arena_alloc_labeled()`: Allocation with a debug label for tracking.
  * - `arena_alloc_aligned_labeled()`: Full control over alignment and labeling.
  *
+ * `arena_try_alloc()` and `arena_try_alloc_aligned()` return a `t_arena_error`
+ * instead, and do not format or print anything on failure unless a custom
+ * error callback is installed. Every failure also records its code as the
+ * thread's `arena_last_error()`.
+ *
  * Internally, all of these functions delegate to `arena_alloc_internal()`, which
  * handles alignment, capacity checks, thread safety, debug labeling, and allocation
  * hooks.
@@ -34,6 +39,7 @@
  */
 
 #include "arena.h"
+#include "arena_fill.h"
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
@@ -50,10 +56,14 @@ static inline bool   arena_ensure_capacity(t_arena* arena, size_t size, size_t a
                                            size_t* aligned_offset, size_t* wasted);
 static inline void   arena_update_stats(t_arena* arena, size_t size, size_t wasted);
 static inline void   arena_commit_allocation(t_arena* arena, size_t size, size_t wasted, size_t aligned_offset);
-static inline void   arena_zero_if_needed(void* ptr, size_t size, const char* label);
+static inline void   arena_zero_if_needed(void* ptr, size_t size, size_t dirty, const char* label);
+static inline void*  arena_alloc_large(t_arena* arena, size_t size, const char* label);
 static inline void   arena_invoke_allocation_hook(t_arena* arena, void* ptr, size_t size, size_t offset, size_t wasted,
                                                   const char* label);
+static inline void*  arena_alloc_dispatch(t_arena* arena, size_t size, size_t alignment, const char* label,
+                                          bool allow_large);
 void*                arena_alloc_internal(t_arena* arena, size_t size, size_t alignment, const char* label);
+void*                arena_alloc_in_buffer(t_arena* arena, size_t size, size_t alignment, const char* label);
 
 /*
  * Public API
@@ -278,6 +288,78 @@ void* arena_alloc_aligned_labeled(t_arena* arena, size_t size, size_t alignment,
 	return arena_alloc_internal(arena, size, alignment, label);
 }
 
+/**
+ * @brief
+ * Allocate memory with default alignment, returning an error code instead of reporting.
+ *
+ * @details
+ * Same as `arena_try_alloc_aligned()` with `ARENA_DEFAULT_ALIGNMENT`.
+ *
+ * @param arena Pointer to the arena to allocate from.
+ * @param size  Number of bytes to allocate.
+ * @param out   Receives the allocation, or `NULL` on failure. May be `NULL`.
+ *
+ * @return `ARENA_OK` on success, or the reason of the failure.
+ *
+ * @ingroup arena_alloc
+ *
+ * @see arena_try_alloc_aligned
+ */
+t_arena_error arena_try_alloc(t_arena* arena, size_t size, void** out)
+{
+	return arena_try_alloc_aligned(arena, size, ARENA_DEFAULT_ALIGNMENT, out);
+}
+
+/**
+ * @brief
+ * Allocate aligned memory, returning an error code instead of reporting.
+ *
+ * @details
+ * Behaves like `arena_alloc_aligned()`, but a failure is returned as a
+ * `t_arena_error` and no message is formatted or printed, unless the arena
+ * has a custom error callback (`arena_set_error_callback()`), which still
+ * receives it. This keeps loops that fill a fixed arena until it is full,
+ * and treat `ARENA_ERR_FULL` as their stop condition, cheap. Errors of other
+ * arenas that hooks or growth callbacks use during the call are reported as
+ * usual.
+ *
+ * The failure is also recorded as the thread's `arena_last_error()`, and
+ * counted in `failed_allocations`.
+ *
+ * @param arena     Pointer to the arena to allocate from.
+ * @param size      Number of bytes to allocate.
+ * @param alignment Required alignment (must be a power of two).
+ * @param out       Receives the allocation, or `NULL` on failure. May be `NULL`.
+ *
+ * @return `ARENA_OK` on success, or the reason of the failure.
+ *
+ * @ingroup arena_alloc
+ *
+ * @see arena_alloc_aligned
+ * @see arena_error_string
+ *
+ * @example
+ * @code
+ * t_arena* batch = arena_create(64 * 1024, false);
+ * void*    item  = NULL;
+ * size_t   count = 0;
+ *
+ * while (arena_try_alloc(batch, 256, &item) == ARENA_OK)
+ *     count++;
+ * // arena_last_error() == ARENA_ERR_FULL, nothing was printed
+ * @endcode
+ */
+t_arena_error arena_try_alloc_aligned(t_arena* arena, size_t size, size_t alignment, void** out)
+{
+	t_arena_quiet outer = arena_errors_quiet_begin(arena);
+	void*         ptr   = arena_alloc_internal(arena, size, alignment, "arena_try_alloc");
+	arena_errors_quiet_end(outer);
+
+	if (out)
+		*out = ptr;
+	return ptr ? ARENA_OK : arena_last_error();
+}
+
 /*
  * Internal helpers
  */
@@ -312,17 +394,23 @@ static inline bool arena_alloc_validate_input(t_arena* arena, size_t size, size_
 {
 	if (!arena)
 	{
-		arena_report_error(NULL, "%s failed: NULL arena", label);
+		arena_report_failure(NULL, ARENA_ERR_NULL_ARENA, "%s failed: NULL arena", label);
 		return false;
 	}
 	if (size == 0)
 	{
-		arena_report_error(arena, "%s failed: zero-size allocation", label);
+		arena_report_failure(arena, ARENA_ERR_ZERO_SIZE, "%s failed: zero-size allocation", label);
 		return false;
 	}
 	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
 	{
-		arena_report_error(arena, "%s failed: alignment (%zu) is not a power-of-two", label, alignment);
+		arena_report_failure(arena, ARENA_ERR_ALIGNMENT, "%s failed: alignment (%zu) is not a power-of-two", label,
+		                     alignment);
+		return false;
+	}
+	if (ARENA_IS_FROZEN(arena))
+	{
+		arena_report_failure(arena, ARENA_ERR_FROZEN, "%s failed: arena is frozen", label);
 		return false;
 	}
 	return true;
@@ -357,7 +445,7 @@ static inline bool arena_is_being_destroyed(t_arena* arena, const char* label)
 {
 	(void)label;
 	if (atomic_load_explicit(&arena->is_destroying, memory_order_acquire))
-		return true;
+		return arena_set_last_error(ARENA_ERR_DESTROYING), true;
 	return false;
 }
 
@@ -390,7 +478,7 @@ static inline bool arena_check_overflow(t_arena* arena, size_t size, const char*
 	if (size > SIZE_MAX - arena->offset)
 	{
 		arena->stats.failed_allocations++;
-		arena_report_error(arena, "%s failed: size overflow (requested: %zu)", label, size);
+		arena_report_failure(arena, ARENA_ERR_OVERFLOW, "%s failed: size overflow (requested: %zu)", label, size);
 		return true;
 	}
 	return false;
@@ -409,6 +497,9 @@ static inline bool arena_check_overflow(t_arena* arena, size_t size, const char*
  * This value is used to ensure that allocations start at properly aligned memory
  * locations, which is essential for performance and correctness on many platforms.
  *
+ * Unless the arena is empty, `ARENA_REDZONE_SIZE` bytes are skipped first; they
+ * stay poisoned in AddressSanitizer and Valgrind builds and count as padding.
+ *
  * @param arena     Pointer to the arena structure.
  * @param alignment The desired alignment (must be a power of two).
  *
@@ -421,7 +512,7 @@ static inline bool arena_check_overflow(t_arena* arena, size_t size, const char*
  */
 static inline size_t arena_calc_aligned_offset(t_arena* arena, size_t alignment)
 {
-	size_t curr    = (size_t) (arena->buffer + arena->offset);
+	size_t curr    = (size_t) (arena->buffer + arena->offset) + (arena->offset ? ARENA_REDZONE_SIZE : 0);
 	size_t aligned = align_up(curr, alignment);
 	return aligned - (size_t) arena->buffer;
 }
@@ -455,12 +546,12 @@ static inline bool arena_try_grow(t_arena* arena, size_t size, const char* label
 {
 	if (!arena->can_grow)
 	{
-		arena_report_error(arena, "%s failed: cannot grow", label);
+		arena_report_failure(arena, ARENA_ERR_FULL, "%s failed: cannot grow", label);
 		return false;
 	}
 	if (!arena_grow(arena, size))
 	{
-		arena_report_error(arena, "%s failed: growth failed", label);
+		arena_report_failure(arena, ARENA_ERR_GROW_FAILED, "%s failed: growth failed", label);
 		return false;
 	}
 	return true;
@@ -477,7 +568,8 @@ static inline bool arena_try_grow(t_arena* arena, size_t size, const char* label
  *
  * If the buffer is too small and the arena is allowed to grow, it attempts to
  * expand the buffer via `arena_try_grow()`, and then recalculates the offset
- * and checks again.
+ * and checks again. The growth request includes the alignment padding, so a
+ * growth policy that returns exactly `offset + required` is enough.
  *
  * This function returns:
  * - `true` if enough space is available (after optional growth).
@@ -509,13 +601,17 @@ static inline bool arena_ensure_capacity(t_arena* arena, size_t size, size_t ali
 	if (*aligned_offset + size <= arena->size)
 		return true;
 
-	if (!arena_try_grow(arena, size, label))
+	if (size > SIZE_MAX - *wasted)
+		return arena_set_last_error(ARENA_ERR_OVERFLOW), false;
+	if (!arena_try_grow(arena, *wasted + size, label))
 		return false;
 
 	*aligned_offset = arena_calc_aligned_offset(arena, alignment);
 	*wasted         = *aligned_offset - arena->offset;
 
-	return *aligned_offset + size <= arena->size;
+	if (*aligned_offset + size <= arena->size)
+		return true;
+	return arena_set_last_error(ARENA_ERR_GROW_FAILED), false;
 }
 
 /**
@@ -595,6 +691,7 @@ static inline void arena_commit_allocation(t_arena* arena, size_t size, size_t w
 	arena->offset = aligned_offset + size;
 	arena_update_peak(arena);
 	arena_update_stats(arena, size, wasted);
+	ARENA_PREGROW_CHECK(arena);
 }
 
 /**
@@ -606,14 +703,17 @@ static inline void arena_commit_allocation(t_arena* arena, size_t size, size_t w
  * should be zero-initialized or poisoned for debugging purposes.
  *
  * If the provided `label` is exactly `"arena_calloc_zero"`, the memory is cleared
- * using `memset(ptr, 0, size)`. Otherwise, the memory is poisoned using
- * `arena_poison_memory()` to help detect uninitialized access in debugging mode.
+ * using `arena_fill_zero()`, but only its first `dirty` bytes: the rest of the block lies
+ * past the arena's `clean_from` watermark and is already zero. Otherwise, the
+ * memory is poisoned using `arena_poison_memory()` to help detect uninitialized
+ * access in debugging mode.
  *
  * This is typically used in `arena_alloc_internal()` after computing the memory
  * location of a new allocation.
  *
  * @param ptr    Pointer to the memory block to initialize.
  * @param size   Number of bytes to initialize.
+ * @param dirty  Bytes from the start of the block that may be non-zero.
  * @param label  Allocation label string used to determine behavior.
  *
  * @ingroup arena_alloc_internal
@@ -625,14 +725,75 @@ static inline void arena_commit_allocation(t_arena* arena, size_t size, size_t w
  * @see arena_alloc_internal
  * @see arena_poison_memory
  */
-static inline void arena_zero_if_needed(void* ptr, size_t size, const char* label)
+static inline void arena_zero_if_needed(void* ptr, size_t size, size_t dirty, const char* label)
 {
 	if (label && strcmp(label, "arena_calloc_zero") == 0)
-		memset(ptr, 0, size);
+		arena_fill_zero(ptr, dirty < size ? dirty : size);
 	else
 		arena_poison_memory(ptr, size);
 }
 
+/**
+ * @brief
+ * Serve an allocation from a dedicated mapping instead of the bump buffer.
+ *
+ * @details
+ * Reserves a one-byte ticket in the bump buffer (growing it if needed), maps
+ * the object with `arena_large_map()`, and then commits the ticket and the
+ * usual statistics. The mapping is already zeroed, so calloc requests skip
+ * the `memset()`; other requests are poisoned as usual.
+ *
+ * Must be called with the arena lock held.
+ *
+ * @param arena Arena to allocate from.
+ * @param size  Requested size in bytes.
+ * @param label Label of the calling function.
+ *
+ * @return Page-aligned pointer to the allocation, or `NULL` on failure.
+ *
+ * @ingroup arena_alloc_internal
+ *
+ * @see arena_set_large_threshold
+ */
+static inline void* arena_alloc_large(t_arena* arena, size_t size, const char* label)
+{
+	size_t ticket = 0;
+	size_t wasted = 0;
+	void*  result = NULL;
+	if (arena_ensure_capacity(arena, 1, 1, label, &ticket, &wasted))
+	{
+		result = arena_large_map(arena, size, ticket);
+		if (!result)
+			arena_set_last_error(ARENA_ERR_NO_MEMORY);
+	}
+	if (!result)
+	{
+		arena->stats.failed_allocations++;
+		arena_report_error(arena, "%s failed: cannot map large allocation (requested: %zu)", label, size);
+		return NULL;
+	}
+
+	ARENA_POISON_CHECK(arena, arena->offset, ticket + 1);
+	ARENA_SAN_ALLOC(arena, arena->offset, ticket, 1);
+	arena->offset = ticket + 1;
+	arena_update_peak(arena);
+	ARENA_POISON_RECORD(arena, ticket, 1, label);
+	arena->stats.allocations++;
+	arena->stats.live_allocations++;
+	arena->stats.bytes_allocated += size;
+	arena->stats.wasted_alignment_bytes += wasted + 1;
+	arena->stats.alloc_id_counter++;
+	arena->stats.last_alloc_size   = size;
+	arena->stats.last_alloc_offset = ticket;
+
+	if (!label || strcmp(label, "arena_calloc_zero") != 0)
+		arena_poison_memory(result, size);
+	arena_invoke_allocation_hook(arena, result, size, ticket, wasted, label);
+
+	ALOG("[arena] %s: Mapped %zu bytes @ %p (ticket %zu, arena %p)\n", label, size, result, ticket, (void*) arena);
+	return result;
+}
+
 /**
  * @brief
  * Invoke the user-defined allocation hook, if registered.
@@ -697,7 +858,8 @@ static inline void arena_invoke_allocation_hook(t_arena* arena, void* ptr, size_
  * 5. Calculate aligned offset and check capacity.
  * 6. Optionally grow the arena.
  * 7. Commit the allocation (update offset and stats).
- * 8. Zero the memory if requested via label.
+ * 8. Zero the memory if requested via label (with `ARENA_POISON_VERIFY`, the
+ *    free bytes taken are first checked for intact poison).
  * 9. Trigger the allocation hook if registered.
  * 10. Return a pointer to the allocated memory.
  *
@@ -719,6 +881,40 @@ static inline void arena_invoke_allocation_hook(t_arena* arena, void* ptr, size_
  * @see arena_alloc_labeled
  */
 void* arena_alloc_internal(t_arena* arena, size_t size, size_t alignment, const char* label)
+{
+	return arena_alloc_dispatch(arena, size, alignment, label, true);
+}
+
+/**
+ * @brief
+ * Allocate from the bump buffer, never from a large-object mapping.
+ *
+ * @details
+ * Same as `arena_alloc_internal()`, but the large-object bypass is skipped.
+ * Used by callers that locate their blocks by buffer offset, like the writer
+ * chunks, which would otherwise be lost when the block lands in its own
+ * mapping.
+ *
+ * @ingroup arena_alloc_internal
+ *
+ * @see arena_alloc_internal
+ * @see arena_set_large_threshold
+ */
+void* arena_alloc_in_buffer(t_arena* arena, size_t size, size_t alignment, const char* label)
+{
+	return arena_alloc_dispatch(arena, size, alignment, label, false);
+}
+
+/**
+ * @brief
+ * Shared body of `arena_alloc_internal()` and `arena_alloc_in_buffer()`.
+ *
+ * @param allow_large Whether the allocation may get its own large-object mapping.
+ *
+ * @ingroup arena_alloc_internal
+ */
+static inline void* arena_alloc_dispatch(t_arena* arena, size_t size, size_t alignment, const char* label,
+                                         bool allow_large)
 {
 	if (!arena_alloc_validate_input(arena, size, alignment, label))
 		return NULL;
@@ -738,6 +934,13 @@ void* arena_alloc_internal(t_arena* arena, size_t size, size_t alignment, const
 		return NULL;
 	}
 
+	if (allow_large && arena_large_wanted(arena, size, alignment))
+	{
+		void* large = arena_alloc_large(arena, size, label);
+		ARENA_UNLOCK(arena);
+		return large;
+	}
+
 	size_t aligned_offset = 0;
 	size_t wasted         = 0;
 	if (!arena_ensure_capacity(arena, size, alignment, label, &aligned_offset, &wasted))
@@ -748,9 +951,13 @@ void* arena_alloc_internal(t_arena* arena, size_t size, size_t alignment, const
 		return NULL;
 	}
 
+	size_t dirty = aligned_offset < arena->clean_from ? arena->clean_from - aligned_offset : 0;
+	ARENA_POISON_CHECK(arena, arena->offset, aligned_offset + size);
+	ARENA_SAN_ALLOC(arena, arena->offset, aligned_offset, size);
 	arena_commit_allocation(arena, size, wasted, aligned_offset);
+	ARENA_POISON_RECORD(arena, aligned_offset, size, label);
 	void* result = arena->buffer + aligned_offset;
-	arena_zero_if_needed(result, size, label);
+	arena_zero_if_needed(result, size, dirty, label);
 	arena_invoke_allocation_hook(arena, result, size, aligned_offset, wasted, label);
 
 	ALOG("[arena] %s: Allocated %zu bytes @ offset %zu (arena %p)\n", label, size, aligned_offset, (void*) arena);
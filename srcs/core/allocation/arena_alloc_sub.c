@@ -342,6 +342,10 @@ bool arena_alloc_sub_labeled(t_arena* parent, t_arena* child, size_t size, const
  * A debug `label` is assigned to the sub-arena for tracking and logging purposes.
  * If `label` is `NULL`, the label defaults to `"subarena"`.
  *
+ * If the parent has guard pages enabled (`arena_set_guard_pages()`), the block
+ * is rounded up to whole pages, page-aligned and followed by a `PROT_NONE`
+ * page, and `child->size` is the rounded size.
+ *
  * Use this when:
  * - You want to partition a region of memory within an arena for isolated use.
  * - You need alignment control and want to track the sub-arena via a label.
@@ -401,7 +405,8 @@ bool arena_alloc_sub_labeled_aligned(t_arena* parent, t_arena* child, size_t siz
 	if (!arena_alloc_sub_validate(parent, child))
 		return false;
 
-	void* mem = arena_alloc_aligned(parent, size, alignment);
+	void* mem = arena_guard_pages(parent) ? arena_guard_carve(parent, &size, alignment)
+	                                      : arena_alloc_aligned(parent, size, alignment);
 	if (!mem)
 	{
 		arena_report_error(parent, "arena_alloc_sub failed: allocation from parent arena failed");
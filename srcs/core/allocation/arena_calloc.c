@@ -280,16 +280,48 @@ void* arena_calloc_aligned_labeled(t_arena* arena, size_t count, size_t size, si
 	if (would_overflow_mul(count, size, &total))
 	{
 		arena_record_failed_alloc(arena);
-		arena_report_error(arena,
-		                   "arena_calloc failed: multiplication overflow "
-		                   "(count = %zu, size = %zu)",
-		                   count, size);
+		arena_report_failure(arena, ARENA_ERR_OVERFLOW,
+		                     "arena_calloc failed: multiplication overflow "
+		                     "(count = %zu, size = %zu)",
+		                     count, size);
 		return NULL;
 	}
 
 	return arena_alloc_internal(arena, total, alignment, label);
 }
 
+/**
+ * @brief
+ * Allocate zero-initialized memory, returning an error code instead of reporting.
+ *
+ * @details
+ * Behaves like `arena_calloc()`, but a failure is returned as a `t_arena_error`
+ * and no message is formatted or printed unless the arena has a custom error
+ * callback. See `arena_try_alloc_aligned()`.
+ *
+ * @param arena Pointer to the arena to allocate from.
+ * @param count Number of elements.
+ * @param size  Size of each element in bytes.
+ * @param out   Receives the allocation, or `NULL` on failure. May be `NULL`.
+ *
+ * @return `ARENA_OK` on success, or the reason of the failure.
+ *
+ * @ingroup arena_calloc
+ *
+ * @see arena_calloc
+ * @see arena_try_alloc_aligned
+ */
+t_arena_error arena_try_calloc(t_arena* arena, size_t count, size_t size, void** out)
+{
+	t_arena_quiet outer = arena_errors_quiet_begin(arena);
+	void*         ptr   = arena_calloc_aligned_labeled(arena, count, size, ARENA_DEFAULT_ALIGNMENT, NULL);
+	arena_errors_quiet_end(outer);
+
+	if (out)
+		*out = ptr;
+	return ptr ? ARENA_OK : arena_last_error();
+}
+
 /*
  * INTERNAL HELPERS
  */
@@ -327,19 +359,19 @@ static inline bool validate_arena_calloc_input(t_arena* arena, size_t count, siz
 {
 	if (!arena)
 	{
-		arena_report_error(NULL, "arena_calloc failed: NULL arena provided");
+		arena_report_failure(NULL, ARENA_ERR_NULL_ARENA, "arena_calloc failed: NULL arena provided");
 		return false;
 	}
 
 	if (count == 0)
 	{
-		arena_report_error(arena, "arena_calloc failed: zero count (count = %zu)", count);
+		arena_report_failure(arena, ARENA_ERR_ZERO_SIZE, "arena_calloc failed: zero count (count = %zu)", count);
 		return false;
 	}
 
 	if (size == 0)
 	{
-		arena_report_error(arena, "arena_calloc failed: zero element size (size = %zu)", size);
+		arena_report_failure(arena, ARENA_ERR_ZERO_SIZE, "arena_calloc failed: zero element size (size = %zu)", size);
 		return false;
 	}
 
@@ -374,7 +406,7 @@ static inline bool validate_arena_calloc_input(t_arena* arena, size_t count, siz
  */
 static inline void arena_record_failed_alloc(t_arena* arena)
 {
-	if (!arena)
+	if (!arena || ARENA_IS_FROZEN(arena))
 		return;
 	ARENA_LOCK(arena);
 	arena->stats.failed_allocations++;
@@ -0,0 +1,305 @@
+/**
+ * @file arena_guard.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Guard pages after sub-arenas: overruns fault where they happen.
+ *
+ * @details
+ * Sub-arenas are carved back to back from their parent, so a child writing
+ * past its end silently corrupts its sibling, and `ARENA_CHECK` only notices
+ * later, if at all. With guard pages enabled on the parent, every
+ * `arena_alloc_sub*()` block is rounded up to whole pages, page-aligned, and
+ * followed by one `PROT_NONE` page. The first byte written past the child
+ * raises `SIGSEGV` at the faulting instruction, and the allocation hot path
+ * stays unchanged.
+ *
+ * The parent remembers the offset of each guard page (ascending, since
+ * sub-arenas are carved at increasing offsets) and makes it accessible again
+ * before anything else touches that memory:
+ * - `arena_pop()` releases the guards past the marker and `arena_reset()`
+ *   and `arena_destroy()` release them all, before poisoning;
+ * - growing or shrinking lifts them around the resize and protects them again
+ *   if the buffer stayed in place (a moved buffer leaves its sub-arenas
+ *   dangling, so their guards are dropped);
+ * - snapshots lift them while the used range is written out;
+ * - loading a snapshot or promoting a copy-on-write clone, which rewrite the
+ *   used range, drop them.
+ *
+ * A block served by the large-object bypass keeps its guard page in its own
+ * mapping, which is unmapped with it, so it is not tracked.
+ *
+ * Each guard costs a page of the parent buffer and a system call, so this is
+ * a debugging aid rather than a production setting.
+ *
+ * @ingroup arena_sub
+ *
+ * @example
+ * @code
+ * t_arena* parent = arena_create(1 << 20, false);
+ * arena_set_guard_pages(parent, true);
+ *
+ * t_arena child;
+ * arena_alloc_sub(parent, &child, 1000); // child.size == 4096 on 4 KiB pages
+ * memset(child.buffer, 0, child.size);   // fine
+ * child.buffer[child.size] = 0;          // SIGSEGV here, not at the next check
+ * @endcode
+ */
+
+#include "arena.h"
+#include <stdlib.h>
+#include <sys/mman.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline bool arena_guard_place(t_arena* arena, uint8_t* page);
+static inline bool arena_guard_track(t_arena* arena, size_t offset);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Enable or disable guard pages after the sub-arenas of an arena.
+ *
+ * @details
+ * While enabled, each `arena_alloc_sub*()` call on `arena` rounds the child
+ * up to a multiple of the page size, aligns it to at least a page, and
+ * follows it with a `PROT_NONE` page, so an overrun of the child faults
+ * immediately. The child's `size` is the rounded size.
+ *
+ * Sub-arenas created before the call keep their layout. Disabled by default.
+ *
+ * @param arena   Parent arena to configure.
+ * @param enabled Whether new sub-arenas get a guard page.
+ *
+ * @ingroup arena_sub
+ *
+ * @see arena_guard_pages
+ * @see arena_alloc_sub
+ */
+void arena_set_guard_pages(t_arena* arena, bool enabled)
+{
+	if (!arena)
+		return;
+
+	ARENA_LOCK(arena);
+	arena->guards.enabled = enabled;
+	ARENA_UNLOCK(arena);
+}
+
+/**
+ * @brief
+ * Return whether new sub-arenas of an arena get a guard page.
+ *
+ * @ingroup arena_sub
+ */
+bool arena_guard_pages(t_arena* arena)
+{
+	if (!arena)
+		return false;
+
+	ARENA_LOCK(arena);
+	bool enabled = arena->guards.enabled;
+	ARENA_UNLOCK(arena);
+	return enabled;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Allocate a sub-arena block followed by a guard page.
+ *
+ * @details
+ * `*size` is rounded up to whole pages and updated on success. The block is
+ * allocated from `parent` with an alignment of at least a page, together with
+ * the page after it, which is then protected. If the page cannot be
+ * protected, the allocation is rolled back.
+ *
+ * Takes the parent lock itself, like `arena_alloc_aligned()`.
+ *
+ * @param parent    Arena to carve the block from.
+ * @param size      Requested size in bytes; receives the rounded size.
+ * @param alignment Requested alignment (a power of two).
+ *
+ * @return Start of the block, or `NULL` on failure.
+ *
+ * @ingroup arena_alloc_internal
+ *
+ * @see arena_alloc_sub_labeled_aligned
+ */
+void* arena_guard_carve(t_arena* parent, size_t* size, size_t alignment)
+{
+	const size_t page = arena_page_size();
+	const size_t span = arena_page_round(*size);
+	if (!*size)
+		return arena_report_error(parent, "arena_alloc_sub failed: zero-size sub-arena"), NULL;
+	if (span < *size || span > SIZE_MAX - page)
+		return arena_report_error(parent, "arena_alloc_sub failed: size overflow (requested: %zu)", *size), NULL;
+
+	t_arena_marker mark  = arena_mark(parent);
+	uint8_t*       block = arena_alloc_aligned(parent, span + page, alignment > page ? alignment : page);
+	if (!block)
+		return NULL;
+
+	ARENA_LOCK(parent);
+	bool ok = arena_guard_place(parent, block + span);
+	ARENA_UNLOCK(parent);
+	if (!ok)
+	{
+		arena_pop(parent, mark);
+		return arena_report_error(parent, "arena_alloc_sub failed: cannot protect guard page"), NULL;
+	}
+
+	*size = span;
+	return block;
+}
+
+/**
+ * @brief
+ * Make the guard pages at or past `marker` accessible again and forget them.
+ *
+ * @details
+ * Must be called with the arena lock held, before the memory past `marker`
+ * is poisoned or reused. `arena_reset()` and `arena_destroy()` pass `0`.
+ *
+ * @param arena  Arena owning the guards.
+ * @param marker Offset the bump pointer is being rolled back to.
+ *
+ * @ingroup arena_alloc_internal
+ */
+void arena_guard_release(t_arena* arena, size_t marker)
+{
+	const size_t page = arena_page_size();
+
+	while (arena->guards.count && arena->guards.offsets[arena->guards.count - 1] >= marker)
+	{
+		size_t offset = arena->guards.offsets[--arena->guards.count];
+		mprotect(arena->buffer + offset, page, PROT_READ | PROT_WRITE);
+	}
+}
+
+/**
+ * @brief
+ * Apply page protection flags to every guard page.
+ *
+ * @details
+ * Used with `PROT_READ | PROT_WRITE` to lift the guards before the buffer is
+ * moved or read in bulk, and with `PROT_NONE` to put them back. Must be
+ * called with the arena lock held.
+ *
+ * @return `true` if every page was updated.
+ *
+ * @ingroup arena_alloc_internal
+ */
+bool arena_guard_protect(t_arena* arena, int prot)
+{
+	const size_t page = arena_page_size();
+	bool         ok   = true;
+
+	for (size_t i = 0; i < arena->guards.count; ++i)
+		if (mprotect(arena->buffer + arena->guards.offsets[i], page, prot) != 0)
+			ok = false;
+	return ok;
+}
+
+/**
+ * @brief
+ * Put the guards back after the buffer was resized.
+ *
+ * @details
+ * Called with the guards lifted, before `arena->buffer` is updated. If the
+ * buffer stayed in place they are protected again. If it moved, the
+ * sub-arenas they guarded still point into the old buffer and the new
+ * address need not keep the page alignment of the offsets, so the guards are
+ * forgotten. Must be called with the arena lock held.
+ *
+ * @param arena      Arena whose buffer was resized.
+ * @param new_buffer Address of the buffer after the resize.
+ *
+ * @ingroup arena_alloc_internal
+ *
+ * @see arena_grow
+ * @see arena_shrink
+ */
+void arena_guard_rebase(t_arena* arena, const uint8_t* new_buffer)
+{
+	if (new_buffer == arena->buffer)
+		arena_guard_protect(arena, PROT_NONE);
+	else
+		arena->guards.count = 0;
+}
+
+/**
+ * @brief
+ * Release every guard page and free the guard list.
+ *
+ * @details
+ * Called by `arena_destroy()` before the buffer is poisoned, recycled or
+ * released. Must be called with the arena lock held (or during destruction).
+ *
+ * @ingroup arena_alloc_internal
+ */
+void arena_guard_clear(t_arena* arena)
+{
+	arena_guard_release(arena, 0);
+	free(arena->guards.offsets);
+	arena->guards.offsets  = NULL;
+	arena->guards.capacity = 0;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Protect the page at `page` and record it if it lies in the bump buffer.
+ *
+ * @details
+ * A page outside the buffer belongs to a large-object mapping and goes away
+ * when that mapping is unmapped.
+ *
+ * @ingroup arena_alloc_internal
+ */
+static inline bool arena_guard_place(t_arena* arena, uint8_t* page)
+{
+	const size_t size = arena_page_size();
+	const bool   own  = page >= arena->buffer && page < arena->buffer + arena->size;
+
+	if (own && !arena_guard_track(arena, (size_t) (page - arena->buffer)))
+		return false;
+	if (mprotect(page, size, PROT_NONE) == 0)
+		return true;
+	if (own)
+		arena->guards.count--;
+	return false;
+}
+
+/**
+ * @brief
+ * Append `offset` to the guard list, growing it as needed.
+ *
+ * @ingroup arena_alloc_internal
+ */
+static inline bool arena_guard_track(t_arena* arena, size_t offset)
+{
+	if (arena->guards.count == arena->guards.capacity)
+	{
+		size_t  capacity = arena->guards.capacity ? arena->guards.capacity * 2 : 8;
+		size_t* offsets  = realloc(arena->guards.offsets, capacity * sizeof(*offsets));
+		if (!offsets)
+			return false;
+		arena->guards.offsets  = offsets;
+		arena->guards.capacity = capacity;
+	}
+	arena->guards.offsets[arena->guards.count++] = offset;
+	return true;
+}
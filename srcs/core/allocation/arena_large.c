@@ -0,0 +1,351 @@
+/**
+ * @file arena_large.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Large-object bypass: dedicated mappings for oversized allocations.
+ *
+ * @details
+ * Without a bypass, one huge allocation from a small growable arena makes
+ * `arena_grow()` double and `realloc()` the whole buffer, and the arena keeps
+ * that memory until it is destroyed. When a large-object threshold is set,
+ * allocations of at least that size are instead served by their own anonymous
+ * `mmap()` region, so the bump buffer stays small and cache-hot.
+ *
+ * Each large allocation consumes a one-byte *ticket* in the bump buffer. The
+ * ticket's offset orders the mapping with respect to markers: `arena_pop()`
+ * releases exactly the mappings whose ticket lies past the marker, and
+ * `arena_reset()` and `arena_destroy()` release them all. Since every
+ * surviving ticket is below the current offset, the list (newest first) is
+ * sorted by decreasing ticket and releases stop at the first survivor.
+ *
+ * The data starts at the beginning of its mapping (page-aligned) and the
+ * `t_arena_large` header is stored right after it, so no alignment up to the
+ * page size costs extra space.
+ *
+ * `arena_realloc_last()` on the newest large allocation resizes its mapping
+ * with `mremap()` (which may move it) and moves the header along; the bump
+ * buffer and its offset are untouched.
+ *
+ * Only arenas with private memory (heap or anonymous mapping) use the bypass:
+ * file and memfd arenas keep every allocation inside their shared file.
+ *
+ * @ingroup arena_alloc
+ *
+ * @example
+ * @code
+ * t_arena* arena = arena_create(64 * 1024, true);
+ * arena_set_large_threshold(arena, 1 << 20);
+ *
+ * t_arena_marker mark  = arena_mark(arena);
+ * void*          frame = arena_alloc(arena, 200 << 20); // own mapping
+ * // ... use frame ...
+ * arena_pop(arena, mark); // unmaps it, the buffer never grew
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena.h"
+#include <sys/mman.h>
+
+/**
+ * @brief
+ * Header stored after the data of a large-object mapping.
+ *
+ * @ingroup arena_alloc_internal
+ */
+struct s_arena_large
+{
+	t_arena_large* prev;    ///< Previous (older) large allocation.
+	void*          data;    ///< Start of the mapping, returned to the caller.
+	size_t         map_len; ///< Length of the whole mapping.
+	size_t         size;    ///< Requested allocation size.
+	size_t         ticket;  ///< Offset of the ticket byte in the bump buffer.
+};
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline void arena_large_unmap(t_arena* arena, t_arena_large* node);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Set the size from which allocations get a dedicated mapping.
+ *
+ * @details
+ * Allocations of at least `threshold` bytes (with an alignment no larger than
+ * the page size) bypass the bump buffer and are backed by their own anonymous
+ * mapping, released on `arena_reset()`, on `arena_pop()` to a marker taken
+ * before them, and on `arena_destroy()`. `0` disables the bypass, which is the
+ * default (`ARENA_LARGE_THRESHOLD`).
+ *
+ * The threshold is ignored for file- and memfd-backed arenas.
+ *
+ * @param arena     Arena to configure.
+ * @param threshold Minimum size of a large allocation, in bytes, or `0`.
+ *
+ * @ingroup arena_alloc
+ *
+ * @see arena_large_threshold
+ */
+void arena_set_large_threshold(t_arena* arena, size_t threshold)
+{
+	if (!arena)
+		return;
+
+	ARENA_LOCK(arena);
+	arena->large_threshold = threshold;
+	ARENA_UNLOCK(arena);
+}
+
+/**
+ * @brief
+ * Return the large-object threshold of an arena.
+ *
+ * @return The threshold in bytes, or `0` if the bypass is disabled.
+ *
+ * @ingroup arena_alloc
+ */
+size_t arena_large_threshold(t_arena* arena)
+{
+	if (!arena)
+		return 0;
+
+	ARENA_LOCK(arena);
+	size_t threshold = arena->large_threshold;
+	ARENA_UNLOCK(arena);
+	return threshold;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Check whether an allocation should bypass the bump buffer.
+ *
+ * @details
+ * Must be called with the arena lock held.
+ *
+ * @ingroup arena_alloc_internal
+ */
+bool arena_large_wanted(const t_arena* arena, size_t size, size_t alignment)
+{
+	return arena->large_threshold && size >= arena->large_threshold && alignment <= arena_page_size() &&
+	       (arena->backing.kind == ARENA_BACKING_HEAP || arena->backing.kind == ARENA_BACKING_MMAP);
+}
+
+/**
+ * @brief
+ * Map a dedicated region for a large allocation and link it into the arena.
+ *
+ * @details
+ * Must be called with the arena lock held, after the ticket byte at `ticket`
+ * has been reserved in the bump buffer. Updates `large_allocations` and
+ * `large_bytes`; the caller commits the ticket and the generic statistics.
+ *
+ * @param arena  Arena owning the allocation.
+ * @param size   Requested size in bytes.
+ * @param ticket Offset of the reserved ticket byte.
+ *
+ * @return Page-aligned pointer to `size` zeroed bytes, or `NULL` on failure.
+ *
+ * @ingroup arena_alloc_internal
+ */
+void* arena_large_map(t_arena* arena, size_t size, size_t ticket)
+{
+	const size_t header_at = align_up(size, _Alignof(t_arena_large));
+	if (header_at < size || header_at > SIZE_MAX - sizeof(t_arena_large) - arena_page_size())
+		return NULL;
+
+	const size_t map_len = arena_page_round(header_at + sizeof(t_arena_large));
+	if (!arena_budget_charge(arena, map_len))
+		return NULL;
+
+	uint8_t* data = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (data == MAP_FAILED)
+	{
+		arena_budget_credit(arena, map_len);
+		return NULL;
+	}
+
+	t_arena_large* node = (t_arena_large*) (data + header_at);
+	node->prev          = arena->large_list;
+	node->data          = data;
+	node->map_len       = map_len;
+	node->size          = size;
+	node->ticket        = ticket;
+	arena->large_list   = node;
+
+	arena->stats.large_allocations++;
+	arena->stats.large_bytes += size;
+	return data;
+}
+
+/**
+ * @brief
+ * Check whether `ptr` is the newest allocation of the arena and has its own mapping.
+ *
+ * @details
+ * True when `ptr` starts the newest large mapping and nothing was allocated
+ * in the bump buffer after its ticket. Must be called with the arena lock held.
+ *
+ * @ingroup arena_alloc_internal
+ */
+bool arena_large_is_last(const t_arena* arena, const void* ptr)
+{
+	const t_arena_large* node = arena->large_list;
+	return node && node->data == ptr && node->ticket + 1 == arena->offset;
+}
+
+/**
+ * @brief
+ * Resize the mapping of the newest large allocation.
+ *
+ * @details
+ * The mapping is resized with `mremap()`, which may move it; the header is
+ * saved first and rewritten after the new end of the data. Growth is charged
+ * to the budget before the call, and the pages given back on a shrink are
+ * credited. On failure the allocation is left unchanged.
+ *
+ * Must be called with the arena lock held, on an arena whose newest large
+ * allocation is the last one (`arena_large_is_last()`).
+ *
+ * @param arena    Arena owning the allocation.
+ * @param new_size New size in bytes.
+ *
+ * @return Pointer to the (possibly moved) data, or `NULL` on failure.
+ *
+ * @ingroup arena_alloc_internal
+ */
+void* arena_large_resize(t_arena* arena, size_t new_size)
+{
+	const t_arena_large node      = *arena->large_list;
+	const size_t        header_at = align_up(new_size, _Alignof(t_arena_large));
+	if (header_at < new_size || header_at > SIZE_MAX - sizeof(t_arena_large) - arena_page_size())
+		return NULL;
+
+	const size_t map_len = arena_page_round(header_at + sizeof(t_arena_large));
+	if (map_len > node.map_len && !arena_budget_charge(arena, map_len - node.map_len))
+		return NULL;
+
+	uint8_t* data = node.data;
+	if (map_len != node.map_len)
+	{
+		data = mremap(node.data, node.map_len, map_len, MREMAP_MAYMOVE);
+		if (data == MAP_FAILED)
+		{
+			if (map_len > node.map_len)
+				arena_budget_credit(arena, map_len - node.map_len);
+			return NULL;
+		}
+		if (map_len < node.map_len)
+			arena_budget_credit(arena, node.map_len - map_len);
+	}
+
+	t_arena_large* moved = (t_arena_large*) (data + header_at);
+	*moved               = node;
+	moved->data          = data;
+	moved->map_len       = map_len;
+	moved->size          = new_size;
+	arena->large_list    = moved;
+
+	arena->stats.large_bytes = arena->stats.large_bytes - node.size + new_size;
+	return data;
+}
+
+/**
+ * @brief
+ * Unmap every large allocation whose ticket lies at or past `marker`.
+ *
+ * @details
+ * Must be called with the arena lock held. `arena_reset()` and
+ * `arena_destroy()` pass `0` to release them all.
+ *
+ * @param arena  Arena owning the allocations.
+ * @param marker Offset the bump pointer is being rolled back to.
+ *
+ * @ingroup arena_alloc_internal
+ */
+void arena_large_release(t_arena* arena, size_t marker)
+{
+	while (arena->large_list && arena->large_list->ticket >= marker)
+	{
+		t_arena_large* node = arena->large_list;
+		arena->large_list   = node->prev;
+		arena_large_unmap(arena, node);
+	}
+}
+
+/**
+ * @brief
+ * Apply page protection flags to every large-allocation mapping.
+ *
+ * @details
+ * Used by `arena_freeze()` so large objects become read-only along with the
+ * buffer. Must be called with the arena lock held.
+ *
+ * @return `true` if every mapping was updated.
+ *
+ * @ingroup arena_alloc_internal
+ */
+bool arena_large_protect(t_arena* arena, int prot)
+{
+	bool ok = true;
+	for (t_arena_large* node = arena->large_list; node; node = node->prev)
+		if (mprotect(node->data, node->map_len, prot) != 0)
+			ok = false;
+	return ok;
+}
+
+/**
+ * @brief
+ * Total length of the large-allocation mappings of `arena`.
+ *
+ * @details
+ * Used by `arena_budget_attach()` to charge the mappings an arena already
+ * holds. Must be called with the arena lock held.
+ *
+ * @ingroup arena_alloc_internal
+ */
+size_t arena_large_mapped(const t_arena* arena)
+{
+	size_t total = 0;
+	for (const t_arena_large* node = arena->large_list; node; node = node->prev)
+		total += node->map_len;
+	return total;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Unmap and uncount one large allocation.
+ *
+ * @details
+ * The region is not poisoned: touching every page of a huge mapping just to
+ * release it would be costly, and any later access faults anyway.
+ *
+ * @ingroup arena_alloc_internal
+ */
+static inline void arena_large_unmap(t_arena* arena, t_arena_large* node)
+{
+	void*  data    = node->data;
+	size_t map_len = node->map_len;
+
+	arena->stats.large_bytes -= node->size;
+	munmap(data, map_len);
+	arena_budget_credit(arena, map_len);
+}
@@ -41,8 +41,10 @@
 
 static inline bool arena_realloc_validate(t_arena* arena, void* old_ptr, size_t new_size);
 static inline bool is_last_allocation(t_arena* arena, void* old_ptr, size_t old_size);
-static inline void update_realloc_stats(t_arena* arena, void* ptr, size_t new_size, size_t old_size, const char* label);
+static inline void  update_realloc_stats(t_arena* arena, void* ptr, size_t new_size, size_t old_size, size_t offset,
+                                         const char* label);
 static inline void* realloc_in_place(t_arena* arena, void* old_ptr, size_t old_size, size_t new_size);
+static inline void* realloc_large_in_place(t_arena* arena, size_t old_size, size_t new_size);
 static inline void* realloc_fallback(t_arena* arena, void* old_ptr, size_t old_size, size_t new_size);
 
 /*
@@ -63,6 +65,9 @@ static inline void* realloc_fallback(t_arena* arena, void* old_ptr, size_t old_s
  * a new block is allocated, data is copied, and the old memory is poisoned
  * to help detect stale access.
  *
+ * A last allocation served by the large-object bypass is resized by
+ * remapping its dedicated mapping, which may move it.
+ *
  * This function:
  * - Validates the input parameters.
  * - Locks the arena for thread safety.
@@ -127,12 +132,12 @@ void* arena_realloc_last(t_arena* arena, void* old_ptr, size_t old_size, size_t
 	ARENA_LOCK(arena);
 	ARENA_CHECK(arena);
 
-	bool  is_last = is_last_allocation(arena, old_ptr, old_size);
-	void* result  = is_last ? realloc_in_place(arena, old_ptr, old_size, new_size) : NULL;
+	void* result = is_last_allocation(arena, old_ptr, old_size)
+	                   ? realloc_in_place(arena, old_ptr, old_size, new_size)
+	                   : realloc_fallback(arena, old_ptr, old_size, new_size);
 
 	ARENA_UNLOCK(arena);
-
-	return is_last ? result : realloc_fallback(arena, old_ptr, old_size, new_size);
+	return result;
 }
 
 /*
@@ -170,6 +175,8 @@ static inline bool arena_realloc_validate(t_arena* arena, void* old_ptr, size_t
 		return arena_report_error(NULL, "arena_realloc_last failed: NULL arena"), false;
 	if (!old_ptr)
 		return arena_report_error(arena, "arena_realloc_last failed: NULL old_ptr"), false;
+	if (ARENA_IS_FROZEN(arena))
+		return arena_report_error(arena, "arena_realloc_last failed: arena is frozen"), false;
 	if (new_size == 0)
 		return arena_report_error(arena, "arena_realloc_last failed: zero-size reallocation"), false;
 	return true;
@@ -183,6 +190,8 @@ static inline bool arena_realloc_validate(t_arena* arena, void* old_ptr, size_t
  * This helper determines whether `old_ptr` is the last allocation made
  * by the arena. It does so by comparing the pointer to the expected
  * end of the buffer based on `arena->offset` and the known `old_size`.
+ * A block with its own large-object mapping is the last allocation when
+ * its ticket is the last byte of the bump buffer.
  *
  * This check is necessary before attempting an in-place reallocation,
  * as only the last allocation can be safely resized in place.
@@ -200,6 +209,9 @@ static inline bool arena_realloc_validate(t_arena* arena, void* old_ptr, size_t
  */
 static inline bool is_last_allocation(t_arena* arena, void* old_ptr, size_t old_size)
 {
+	if (arena_large_is_last(arena, old_ptr))
+		return true;
+
 	uint8_t* expected = arena->buffer + (arena->offset - old_size);
 	return (uint8_t*) old_ptr == expected;
 }
@@ -209,21 +221,21 @@ static inline bool is_last_allocation(t_arena* arena, void* old_ptr, size_t old_
  * Update arena statistics after a successful reallocation.
  *
  * @details
- * This internal helper updates the arena's internal state to reflect
- * a successful in-place reallocation. It performs the following:
- * - Adjusts the `offset` to account for the new allocation size.
- * - Updates peak usage via `arena_update_peak()`.
+ * This internal helper updates the arena's statistics to reflect
+ * a successful reallocation. It performs the following:
  * - Increments allocation-related counters.
  * - Records metadata about the last allocation (size, offset).
  * - Triggers the allocation hook if one is registered.
  *
- * This function is used exclusively during in-place reallocation,
- * where the existing memory block remains valid and grows or shrinks.
+ * The bump offset is left to the caller: only an in-place resize of a block
+ * in the buffer moves it, while a block in its own large-object mapping is
+ * only located by its ticket.
  *
  * @param arena     Pointer to the arena being updated.
  * @param ptr       Pointer to the reallocated memory block.
  * @param new_size  New size of the allocation (in bytes).
  * @param old_size  Previous size of the allocation (in bytes).
+ * @param offset    Offset of the block, or of its ticket, in the bump buffer.
  * @param label     Descriptive label for logging and tracking.
  *
  * @ingroup arena_alloc_internal
@@ -233,16 +245,14 @@ static inline bool is_last_allocation(t_arena* arena, void* old_ptr, size_t old_
  * @see arena_realloc_last
  * @see arena_update_peak
  */
-static inline void update_realloc_stats(t_arena* arena, void* ptr, size_t new_size, size_t old_size, const char* label)
+static inline void update_realloc_stats(t_arena* arena, void* ptr, size_t new_size, size_t old_size, size_t offset,
+                                        const char* label)
 {
-	arena->offset = (uint8_t*) ptr + new_size - arena->buffer;
-	arena_update_peak(arena);
-
 	arena->stats.reallocations++;
 	arena->stats.live_allocations++;
 	arena->stats.bytes_allocated += (new_size - old_size);
 	arena->stats.last_alloc_size   = new_size;
-	arena->stats.last_alloc_offset = (size_t) ((uint8_t*) ptr - arena->buffer);
+	arena->stats.last_alloc_offset = offset;
 	arena->stats.alloc_id_counter++;
 
 	if (arena->hooks.hook_cb)
@@ -260,10 +270,15 @@ static inline void update_realloc_stats(t_arena* arena, void* ptr, size_t new_si
  *
  * If the new size extends beyond the current buffer capacity, it attempts to grow
  * the arena using `arena_grow()`. If growth fails, the function reports an error
- * and returns `NULL`.
+ * and returns `NULL`. Growth may move the buffer, so the block is located by its
+ * offset and the returned pointer is recomputed from the new buffer.
  *
  * If the new size is smaller than the original, the unused tail of the allocation
- * is poisoned to help catch accidental use of stale memory in debug mode.
+ * is poisoned to help catch accidental use of stale memory in debug mode. A
+ * growth first checks the free bytes it takes when `ARENA_POISON_VERIFY` is on.
+ *
+ * A block with its own large-object mapping is handed to
+ * `realloc_large_in_place()` instead.
  *
  * The function updates internal statistics and triggers the allocation hook with
  * the `"arena_realloc_last (in-place)"` label to reflect the successful resize.
@@ -273,7 +288,7 @@ static inline void update_realloc_stats(t_arena* arena, void* ptr, size_t new_si
  * @param old_size  Size of the current allocation in bytes.
  * @param new_size  Desired new size in bytes.
  *
- * @return `old_ptr` if the resize succeeded in place, or `NULL` on failure.
+ * @return The resized block (moved only if the buffer moved), or `NULL` on failure.
  *
  * @ingroup arena_alloc_internal
  *
@@ -283,20 +298,68 @@ static inline void update_realloc_stats(t_arena* arena, void* ptr, size_t new_si
  */
 static inline void* realloc_in_place(t_arena* arena, void* old_ptr, size_t old_size, size_t new_size)
 {
-	size_t new_end = arena->offset - old_size + new_size;
+	if (arena_large_is_last(arena, old_ptr))
+		return realloc_large_in_place(arena, old_size, new_size);
+
+	size_t block   = (size_t) ((uint8_t*) old_ptr - arena->buffer);
+	size_t new_end = block + new_size;
 
 	if (new_end > arena->size && !arena_grow(arena, new_size - old_size))
 		return arena_report_error(arena, "arena_realloc_last failed: growth failed (needed %zu bytes)",
 		                          new_size - old_size),
 		       NULL;
 
+	old_ptr = arena->buffer + block;
 	if (new_size < old_size)
-		arena_poison_memory((uint8_t*) old_ptr + new_size, old_size - new_size);
+		arena_poison_free(arena, block + new_size, block + old_size);
+	else
+		ARENA_POISON_CHECK(arena, arena->offset, new_end);
+	ARENA_SAN_RESIZE(arena, block, old_size, new_size);
+	ARENA_POISON_RECORD(arena, block, new_size, "arena_realloc_last (in-place)");
+
+	arena->offset = new_end;
+	arena_update_peak(arena);
+	ARENA_PREGROW_CHECK(arena);
 
-	update_realloc_stats(arena, old_ptr, new_size, old_size, "arena_realloc_last (in-place)");
+	update_realloc_stats(arena, old_ptr, new_size, old_size, block, "arena_realloc_last (in-place)");
 	return old_ptr;
 }
 
+/**
+ * @brief
+ * Resize the last allocation when it has its own large-object mapping.
+ *
+ * @details
+ * The mapping is resized with `arena_large_resize()`, which may move it. The
+ * ticket stays the last byte of the bump buffer, so the offset does not
+ * change. Bytes gained by a growth are poisoned like a fresh allocation.
+ *
+ * @param arena     Pointer to the arena managing the memory.
+ * @param old_size  Size of the current allocation in bytes.
+ * @param new_size  Desired new size in bytes.
+ *
+ * @return Pointer to the resized block, or `NULL` on failure (the block is unchanged).
+ *
+ * @ingroup arena_alloc_internal
+ *
+ * @see arena_large_resize
+ * @see realloc_in_place
+ */
+static inline void* realloc_large_in_place(t_arena* arena, size_t old_size, size_t new_size)
+{
+	uint8_t* data = arena_large_resize(arena, new_size);
+	if (!data)
+		return arena_report_error(arena, "arena_realloc_last failed: cannot resize large allocation (requested: %zu)",
+		                          new_size),
+		       NULL;
+
+	if (new_size > old_size)
+		arena_poison_memory(data + old_size, new_size - old_size);
+
+	update_realloc_stats(arena, data, new_size, old_size, arena->offset - 1, "arena_realloc_last (in-place)");
+	return data;
+}
+
 /**
  * @brief
  * Perform a fallback reallocation by allocating new memory and copying data.
@@ -312,7 +375,10 @@ static inline void* realloc_in_place(t_arena* arena, void* old_ptr, size_t old_s
  * - Updates internal reallocation statistics and invokes the allocation hook, if set.
  *
  * This approach ensures consistent tracking of memory usage even when in-place
- * reallocation is not possible.
+ * reallocation is not possible. The arena lock is held by the caller (it is
+ * recursive, so `arena_alloc()` takes it again), and the offset of the new
+ * block is the one `arena_alloc()` recorded: the new block may have its own
+ * large-object mapping, outside the bump buffer.
  *
  * @param arena     Pointer to the arena from which to allocate new memory.
  * @param old_ptr   Pointer to the original memory block.
@@ -334,11 +400,9 @@ static inline void* realloc_fallback(t_arena* arena, void* old_ptr, size_t old_s
 		return NULL;
 
 	memcpy(new_ptr, old_ptr, old_size < new_size ? old_size : new_size);
-
-	ARENA_LOCK(arena);
 	arena_poison_memory(old_ptr, old_size);
-	ARENA_UNLOCK(arena);
 
-	update_realloc_stats(arena, new_ptr, new_size, old_size, "arena_realloc_last (fallback)");
+	update_realloc_stats(arena, new_ptr, new_size, old_size, arena->stats.last_alloc_offset,
+	                     "arena_realloc_last (fallback)");
 	return new_ptr;
 }
\ No newline at end of file
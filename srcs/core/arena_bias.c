@@ -0,0 +1,221 @@
+/**
+ * @file arena_bias.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Biased locking: claiming and revoking the owner fast path of `ARENA_LOCK`.
+ *
+ * @details
+ * The fast path itself is inlined into `ARENA_LOCK` / `ARENA_UNLOCK` (see
+ * `arena_lock.h`). Everything here runs with the arena mutex held:
+ * - `arena_enable_biased_lock()` moves the arena from `ARENA_BIAS_NONE` to
+ *   `ARENA_BIAS_UNCLAIMED`;
+ * - the next thread to take the mutex claims the bias by storing its token;
+ * - any other thread that takes the mutex while the bias is owned revokes it.
+ *
+ * The revoker holds the mutex for the whole handshake, so the owner, once it
+ * sees the flag, simply queues on the mutex behind it. The owner never blocks
+ * while it is inside the arena on its fast path, so the wait is bounded by
+ * the owner's critical section.
+ *
+ * `membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED)` must be registered once per
+ * process before it can be used; `arena_enable_biased_lock()` does it and
+ * refuses the bias where the command is not available.
+ *
+ * @ingroup arena_bias
+ */
+
+#include "arena.h"
+#include "arena_bias.h"
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+_Thread_local char arena_bias_token;
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static bool arena_bias_barrier_ready(void);
+static void arena_bias_barrier(void);
+static void arena_bias_revoke(t_arena* arena);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Bias an arena towards the next thread that locks it.
+ *
+ * @details
+ * The next thread to lock `arena` becomes its owner and locks it from then on
+ * without touching the mutex. The first lock by any other thread revokes the
+ * bias for good. Enabling an arena that is already biased has no effect.
+ *
+ * @param arena Arena created with thread safety enabled.
+ *
+ * @return `true` if the bias is in force, `false` on error or if the bias was
+ *         already revoked.
+ *
+ * @ingroup arena_bias
+ *
+ * @see arena_is_biased
+ */
+bool arena_enable_biased_lock(t_arena* arena)
+{
+	if (!arena)
+		return arena_report_error(NULL, "arena_enable_biased_lock failed: arena is NULL"), false;
+	if (!arena->use_lock)
+		return arena_report_error(arena, "arena_enable_biased_lock failed: arena does not use its lock"), false;
+	if (!arena_bias_barrier_ready())
+		return arena_report_error(arena, "arena_enable_biased_lock failed: membarrier() is unavailable"), false;
+
+	ARENA_LOCK(arena);
+	uintptr_t owner = atomic_load_explicit(&arena->bias_owner, memory_order_relaxed);
+	if (owner == ARENA_BIAS_NONE)
+		atomic_store_explicit(&arena->bias_owner, ARENA_BIAS_UNCLAIMED, memory_order_relaxed);
+	ARENA_UNLOCK(arena);
+
+	if (owner == ARENA_BIAS_REVOKED)
+		return arena_report_error(arena, "arena_enable_biased_lock failed: bias was revoked"), false;
+	return true;
+}
+
+/**
+ * @brief
+ * Whether an arena is biased and the bias was not revoked yet.
+ *
+ * @details
+ * Does not lock the arena, which would revoke the bias of another thread.
+ *
+ * @ingroup arena_bias
+ */
+bool arena_is_biased(t_arena* arena)
+{
+	if (!arena || !arena->use_lock)
+		return false;
+	return atomic_load_explicit(&arena->bias_owner, memory_order_relaxed) >= ARENA_BIAS_UNCLAIMED;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Claim or revoke the bias of an arena whose mutex was just acquired.
+ *
+ * @details
+ * Called by `ARENA_LOCK` when the mutex is held and the arena is biased. An
+ * unclaimed bias goes to the calling thread; a bias owned by another thread
+ * is revoked. The owner itself only gets here while a revocation is pending.
+ *
+ * @ingroup arena_bias
+ */
+void arena_bias_settle(t_arena* arena)
+{
+	uintptr_t owner = atomic_load_explicit(&arena->bias_owner, memory_order_relaxed);
+
+	if (owner == ARENA_BIAS_UNCLAIMED)
+		atomic_store_explicit(&arena->bias_owner, arena_bias_self(), memory_order_relaxed);
+	else if (owner != arena_bias_self())
+		arena_bias_revoke(arena);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Take the bias away from its owner; the arena mutex must be held.
+ *
+ * @details
+ * After the barrier, the owner either sees `bias_revoke` on its next entry or
+ * was already inside, in which case its release store of `bias_depth` hands
+ * over everything it wrote.
+ *
+ * @ingroup arena_bias
+ */
+static void arena_bias_revoke(t_arena* arena)
+{
+	atomic_store(&arena->bias_revoke, true);
+	arena_bias_barrier();
+	while (atomic_load_explicit(&arena->bias_depth, memory_order_acquire) != 0)
+		sched_yield();
+	atomic_store_explicit(&arena->bias_owner, ARENA_BIAS_REVOKED, memory_order_relaxed);
+}
+
+#ifdef __linux__
+
+static _Atomic int g_barrier_state; ///< 0 = not probed, 1 = registered, -1 = unavailable.
+
+/**
+ * @brief
+ * Query and register the private expedited `membarrier()` command, once.
+ *
+ * @ingroup arena_bias
+ */
+static bool arena_bias_barrier_ready(void)
+{
+	int state = atomic_load(&g_barrier_state);
+	if (state)
+		return state > 0;
+
+	long supported = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+	bool ready     = supported >= 0 && (supported & MEMBARRIER_CMD_PRIVATE_EXPEDITED);
+	if (ready)
+		ready = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+	atomic_store(&g_barrier_state, ready ? 1 : -1);
+	return ready;
+}
+
+/**
+ * @brief
+ * Run a full memory barrier on every running thread of the process.
+ *
+ * @ingroup arena_bias
+ */
+static void arena_bias_barrier(void)
+{
+	if (syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) != 0)
+		abort(); // registered before any arena was biased, so it cannot fail
+}
+
+#else
+
+static bool arena_bias_barrier_ready(void)
+{
+	return false;
+}
+
+static void arena_bias_barrier(void)
+{
+}
+
+#endif
+
+#else
+
+bool arena_enable_biased_lock(t_arena* arena)
+{
+	return arena_report_error(arena, "arena_enable_biased_lock failed: built without ARENA_ENABLE_THREAD_SAFE"), false;
+}
+
+bool arena_is_biased(t_arena* arena)
+{
+	(void) arena;
+	return false;
+}
+
+#endif
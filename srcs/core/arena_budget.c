@@ -0,0 +1,516 @@
+/**
+ * @file arena_budget.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Memory budgets shared by groups of arenas.
+ *
+ * @details
+ * A budget's `used` counter is only changed by compare-and-swap, so a charge
+ * either fits under `limit` or leaves the counter untouched. A charge walks the
+ * budget and its ancestors in order and, if one level refuses it, gives back
+ * what the levels below already took.
+ *
+ * Attached arenas charge through `arena_budget_charge()` before they obtain
+ * memory and credit through `arena_budget_credit()` after they released it,
+ * always with their own lock held. `budget_charged` records what the arena
+ * owes, so detaching or destroying it returns exactly that amount.
+ *
+ * Blocking waits on the condition variable of the level that overflowed.
+ * Credits to an `ARENA_BUDGET_BLOCK` level broadcast under its `wait_lock`
+ * after the counter dropped, and waiters re-check the counter under the same
+ * lock before sleeping, so no credit is missed.
+ *
+ * @ingroup arena_budget
+ */
+
+#include "arena.h"
+#include "arena_budget.h"
+#include <errno.h>
+#include <time.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static bool                   arena_budget_acquire(t_arena_budget* budget, size_t bytes);
+static inline t_arena_budget* arena_budget_try_charge(t_arena_budget* budget, size_t bytes);
+static inline bool            arena_budget_take(t_arena_budget* level, size_t bytes);
+static inline void            arena_budget_give(t_arena_budget* budget, const t_arena_budget* stop, size_t bytes);
+static inline bool            arena_budget_fits(const t_arena_budget* level, size_t bytes);
+static inline bool            arena_budget_reclaim(t_arena_budget* over, size_t bytes, size_t* rounds);
+static inline bool            arena_budget_wait(t_arena_budget* over, size_t bytes, struct timespec* deadline);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Initialize a budget of `limit` bytes, nested in `parent` if not `NULL`.
+ *
+ * @param budget Budget to initialize.
+ * @param limit  Maximum bytes charged, `0` for no limit (useful to only account).
+ * @param parent Enclosing budget charged along with this one, or `NULL`.
+ *
+ * @return `true` on success, `false` if `budget` is `NULL` or its condition
+ *         variable could not be set up.
+ *
+ * @ingroup arena_budget
+ *
+ * @see arena_budget_destroy
+ */
+bool arena_budget_init(t_arena_budget* budget, size_t limit, t_arena_budget* parent)
+{
+	if (!budget)
+		return arena_report_error(NULL, "arena_budget_init failed: NULL budget"), false;
+
+	budget->limit = limit;
+	atomic_init(&budget->used, 0);
+	atomic_init(&budget->peak, 0);
+	atomic_init(&budget->denials, 0);
+	atomic_init(&budget->reclaims, 0);
+	atomic_init(&budget->waits, 0);
+	budget->parent          = parent;
+	budget->policy          = ARENA_BUDGET_FAIL;
+	budget->timeout_ms      = 0;
+	budget->reclaim_cb      = NULL;
+	budget->reclaim_context = NULL;
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	pthread_condattr_t attr;
+	if (pthread_condattr_init(&attr) != 0)
+		return arena_report_error(NULL, "arena_budget_init failed: condition setup failed"), false;
+	bool ok = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0 &&
+	          pthread_cond_init(&budget->credited, &attr) == 0;
+	pthread_condattr_destroy(&attr);
+	if (!ok)
+		return arena_report_error(NULL, "arena_budget_init failed: condition setup failed"), false;
+	if (pthread_mutex_init(&budget->wait_lock, NULL) != 0)
+	{
+		pthread_cond_destroy(&budget->credited);
+		return arena_report_error(NULL, "arena_budget_init failed: mutex setup failed"), false;
+	}
+#endif
+	return true;
+}
+
+/**
+ * @brief
+ * Release the resources of a budget.
+ *
+ * @details
+ * No arena may be attached to the budget anymore and no charge may be
+ * blocked on it.
+ *
+ * @param budget Budget to destroy; `NULL` is ignored.
+ *
+ * @ingroup arena_budget
+ */
+void arena_budget_destroy(t_arena_budget* budget)
+{
+	if (!budget)
+		return;
+
+	if (atomic_load(&budget->used) != 0)
+		arena_report_error(NULL, "arena_budget_destroy: %zu bytes still charged", atomic_load(&budget->used));
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	pthread_cond_destroy(&budget->credited);
+	pthread_mutex_destroy(&budget->wait_lock);
+#endif
+}
+
+/**
+ * @brief
+ * Select what happens when a charge does not fit.
+ *
+ * @details
+ * Meant to be called while the budget is being set up, before arenas charge it.
+ *
+ * @ingroup arena_budget
+ */
+void arena_budget_set_policy(t_arena_budget* budget, t_arena_budget_policy policy, uint64_t timeout_ms)
+{
+	if (!budget)
+		return;
+
+	budget->policy     = policy;
+	budget->timeout_ms = timeout_ms;
+}
+
+/**
+ * @brief
+ * Set the callback run by the `ARENA_BUDGET_RECLAIM` policy.
+ *
+ * @ingroup arena_budget
+ */
+void arena_budget_set_reclaim(t_arena_budget* budget, arena_budget_reclaim_fn reclaim_cb, void* context)
+{
+	if (!budget)
+		return;
+
+	budget->reclaim_cb      = reclaim_cb;
+	budget->reclaim_context = context;
+}
+
+/**
+ * @brief
+ * Bytes currently charged to `budget`.
+ *
+ * @ingroup arena_budget
+ */
+size_t arena_budget_used(const t_arena_budget* budget)
+{
+	return budget ? atomic_load_explicit(&budget->used, memory_order_acquire) : 0;
+}
+
+/**
+ * @brief
+ * Charge `arena`'s memory to `budget` from now on.
+ *
+ * @details
+ * Charges the owned buffer and the large-object mappings the arena holds
+ * under the budget's policy. Borrowed buffers (sub-arenas, user memory) are
+ * already accounted for by their owner and are not charged.
+ *
+ * @param arena  Arena to attach.
+ * @param budget Budget to charge.
+ *
+ * @return `true` if the arena is attached, `false` if the arguments are
+ *         invalid or its memory does not fit.
+ *
+ * @ingroup arena_budget
+ *
+ * @see arena_budget_detach
+ */
+bool arena_budget_attach(t_arena* arena, t_arena_budget* budget)
+{
+	if (!arena || !budget)
+		return arena_report_error(arena, "arena_budget_attach failed: invalid arguments"), false;
+
+	ARENA_LOCK(arena);
+	arena_budget_detach(arena);
+
+	size_t bytes = arena_large_mapped(arena);
+	if (atomic_load_explicit(&arena->owns_buffer, memory_order_acquire))
+		bytes += arena->size;
+
+	arena->budget = budget;
+	bool ok       = arena_budget_charge(arena, bytes);
+	if (!ok)
+		arena->budget = NULL;
+	ARENA_UNLOCK(arena);
+	return ok;
+}
+
+/**
+ * @brief
+ * Credit everything `arena` holds back to its budget and stop tracking it.
+ *
+ * @param arena Arena to detach; ignored if `NULL` or not attached.
+ *
+ * @ingroup arena_budget
+ *
+ * @see arena_budget_attach
+ */
+void arena_budget_detach(t_arena* arena)
+{
+	if (!arena)
+		return;
+
+	ARENA_LOCK(arena);
+	arena_budget_credit(arena, arena->budget_charged);
+	arena->budget = NULL;
+	ARENA_UNLOCK(arena);
+}
+
+/**
+ * @brief
+ * Create a heap arena whose initial buffer is charged to `budget`.
+ *
+ * @details
+ * `size` bytes are charged under the budget's policy before the buffer is
+ * allocated, and credited back if the creation fails.
+ *
+ * @param budget     Budget to charge.
+ * @param size       Initial buffer size in bytes.
+ * @param allow_grow Whether the arena may grow (each growth is charged too).
+ *
+ * @return The attached arena, or `NULL` on failure.
+ *
+ * @ingroup arena_budget
+ *
+ * @see arena_create
+ */
+t_arena* arena_create_in_budget(t_arena_budget* budget, size_t size, bool allow_grow)
+{
+	if (!budget || size == 0)
+		return arena_report_error(NULL, "arena_create_in_budget failed: invalid arguments"), NULL;
+
+	if (!arena_budget_acquire(budget, size))
+	{
+		arena_report_error(NULL, "arena_create_in_budget failed: %zu bytes exceed the budget", size);
+		return NULL;
+	}
+
+	t_arena* arena = arena_create(size, allow_grow);
+	if (!arena)
+	{
+		arena_budget_give(budget, NULL, size);
+		return NULL;
+	}
+
+	arena->budget         = budget;
+	arena->budget_charged = size;
+	return arena;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Charge `bytes` the arena is about to obtain to its budget.
+ *
+ * @details
+ * Must be called with the arena lock held. Does nothing for an arena that is
+ * not attached. Applies the budget's over-budget policy and reports an error
+ * if the charge is refused.
+ *
+ * @return `true` if the arena may obtain the memory.
+ *
+ * @ingroup arena_budget_internal
+ */
+bool arena_budget_charge(t_arena* arena, size_t bytes)
+{
+	if (!arena->budget || bytes == 0)
+		return true;
+
+	if (!arena_budget_acquire(arena->budget, bytes))
+		return arena_report_error(arena, "arena budget exceeded: %zu more bytes refused", bytes), false;
+
+	arena->budget_charged += bytes;
+	return true;
+}
+
+/**
+ * @brief
+ * Credit `bytes` the arena released back to its budget.
+ *
+ * @details
+ * Must be called with the arena lock held. Never credits more than the arena
+ * was charged, so memory obtained before attaching is not returned twice.
+ *
+ * @ingroup arena_budget_internal
+ */
+void arena_budget_credit(t_arena* arena, size_t bytes)
+{
+	if (!arena->budget)
+		return;
+
+	if (bytes > arena->budget_charged)
+		bytes = arena->budget_charged;
+	arena->budget_charged -= bytes;
+	arena_budget_give(arena->budget, NULL, bytes);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Charge `bytes` to `budget` and its ancestors, applying the over-budget policy.
+ *
+ * @return `true` if every level was charged, `false` if the charge was refused.
+ *
+ * @ingroup arena_budget_internal
+ */
+static bool arena_budget_acquire(t_arena_budget* budget, size_t bytes)
+{
+	size_t          rounds   = 0;
+	struct timespec deadline = {0, 0};
+
+	for (;;)
+	{
+		t_arena_budget* over = arena_budget_try_charge(budget, bytes);
+		if (!over)
+			return true;
+
+		if (over->policy == ARENA_BUDGET_RECLAIM)
+		{
+			if (arena_budget_reclaim(over, bytes, &rounds))
+				continue;
+		}
+		else if (over->policy == ARENA_BUDGET_BLOCK)
+		{
+			if (arena_budget_wait(over, bytes, &deadline))
+				continue;
+		}
+
+		atomic_fetch_add_explicit(&over->denials, 1, memory_order_relaxed);
+		return false;
+	}
+}
+
+/**
+ * @brief
+ * Try to charge every level once.
+ *
+ * @return `NULL` on success, otherwise the level that refused the charge
+ *         (nothing stays charged).
+ *
+ * @ingroup arena_budget_internal
+ */
+static inline t_arena_budget* arena_budget_try_charge(t_arena_budget* budget, size_t bytes)
+{
+	for (t_arena_budget* level = budget; level; level = level->parent)
+	{
+		if (!arena_budget_take(level, bytes))
+		{
+			arena_budget_give(budget, level, bytes);
+			return level;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ * Add `bytes` to one level if it stays within its limit, and track its peak.
+ *
+ * @ingroup arena_budget_internal
+ */
+static inline bool arena_budget_take(t_arena_budget* level, size_t bytes)
+{
+	size_t used = atomic_load_explicit(&level->used, memory_order_relaxed);
+	do
+	{
+		if (level->limit && (bytes > level->limit || used > level->limit - bytes))
+			return false;
+	} while (!atomic_compare_exchange_weak_explicit(&level->used, &used, used + bytes, memory_order_acq_rel,
+	                                                memory_order_relaxed));
+
+	size_t peak = atomic_load_explicit(&level->peak, memory_order_relaxed);
+	while (used + bytes > peak &&
+	       !atomic_compare_exchange_weak_explicit(&level->peak, &peak, used + bytes, memory_order_relaxed,
+	                                              memory_order_relaxed))
+		;
+	return true;
+}
+
+/**
+ * @brief
+ * Subtract `bytes` from `budget` and its ancestors up to (excluding) `stop`.
+ *
+ * @details
+ * Wakes the charges blocked on every `ARENA_BUDGET_BLOCK` level credited.
+ *
+ * @ingroup arena_budget_internal
+ */
+static inline void arena_budget_give(t_arena_budget* budget, const t_arena_budget* stop, size_t bytes)
+{
+	if (bytes == 0)
+		return;
+
+	for (t_arena_budget* level = budget; level != stop; level = level->parent)
+	{
+		atomic_fetch_sub_explicit(&level->used, bytes, memory_order_acq_rel);
+#ifdef ARENA_ENABLE_THREAD_SAFE
+		if (level->policy == ARENA_BUDGET_BLOCK)
+		{
+			pthread_mutex_lock(&level->wait_lock);
+			pthread_cond_broadcast(&level->credited);
+			pthread_mutex_unlock(&level->wait_lock);
+		}
+#endif
+	}
+}
+
+/**
+ * @brief
+ * Whether `bytes` currently fit into one level.
+ *
+ * @ingroup arena_budget_internal
+ */
+static inline bool arena_budget_fits(const t_arena_budget* level, size_t bytes)
+{
+	size_t used = atomic_load_explicit(&level->used, memory_order_acquire);
+	return !level->limit || (bytes <= level->limit && used <= level->limit - bytes);
+}
+
+/**
+ * @brief
+ * Run the reclaim callback of the level that overflowed.
+ *
+ * @details
+ * At most `ARENA_BUDGET_MAX_RECLAIMS` rounds per charge; a callback that
+ * releases nothing ends them early.
+ *
+ * @return `true` if the charge should be retried.
+ *
+ * @ingroup arena_budget_internal
+ */
+static inline bool arena_budget_reclaim(t_arena_budget* over, size_t bytes, size_t* rounds)
+{
+	if (!over->reclaim_cb || *rounds >= ARENA_BUDGET_MAX_RECLAIMS)
+		return false;
+
+	size_t used   = atomic_load_explicit(&over->used, memory_order_acquire);
+	size_t needed = used + bytes > over->limit ? used + bytes - over->limit : bytes;
+
+	(*rounds)++;
+	atomic_fetch_add_explicit(&over->reclaims, 1, memory_order_relaxed);
+	return over->reclaim_cb(over, needed, over->reclaim_context) > 0;
+}
+
+/**
+ * @brief
+ * Wait until `bytes` fit into the level that overflowed, or until the deadline.
+ *
+ * @details
+ * The deadline is set on the first wait of a charge, so retries after a lost
+ * race do not extend it. A charge larger than the limit never fits and is
+ * refused at once. Without thread safety nobody could credit the budget while
+ * the caller waits, so this always refuses.
+ *
+ * @return `true` if the charge should be retried.
+ *
+ * @ingroup arena_budget_internal
+ */
+static inline bool arena_budget_wait(t_arena_budget* over, size_t bytes, struct timespec* deadline)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	if (bytes > over->limit)
+		return false;
+
+	if (deadline->tv_sec == 0 && deadline->tv_nsec == 0)
+	{
+		atomic_fetch_add_explicit(&over->waits, 1, memory_order_relaxed);
+		clock_gettime(CLOCK_MONOTONIC, deadline);
+		deadline->tv_sec += (time_t) (over->timeout_ms / 1000);
+		deadline->tv_nsec += (long) (over->timeout_ms % 1000) * 1000000L;
+		if (deadline->tv_nsec >= 1000000000L)
+		{
+			deadline->tv_sec++;
+			deadline->tv_nsec -= 1000000000L;
+		}
+	}
+
+	int rc = 0;
+	pthread_mutex_lock(&over->wait_lock);
+	while (!arena_budget_fits(over, bytes) && rc != ETIMEDOUT)
+		rc = over->timeout_ms ? pthread_cond_timedwait(&over->credited, &over->wait_lock, deadline)
+		                      : pthread_cond_wait(&over->credited, &over->wait_lock);
+	bool fits = arena_budget_fits(over, bytes);
+	pthread_mutex_unlock(&over->wait_lock);
+	return fits;
+#else
+	(void) over;
+	(void) bytes;
+	(void) deadline;
+	return false;
+#endif
+}
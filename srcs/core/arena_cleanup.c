@@ -22,6 +22,10 @@
  */
 
 #include "arena.h"
+#include "arena_persist.h"
+#include "arena_pregrow.h"
+#include "arena_prezero.h"
+#include "arena_trim.h"
 
 /*
  * INTERNAL FUNCTION DECLARATIONS
@@ -39,7 +43,8 @@ static inline void arena_free_growth_history(t_arena* arena);
  *
  * @details
  * This function performs a full teardown of the arena's internal state.
- * It frees the memory buffer and growth history if the arena owns them,
+ * It unmaps any large-object allocations, frees the memory buffer and
+ * growth history if the arena owns them,
  * resets all internal fields (via `arena_zero_metadata`), and destroys
  * the mutex if thread safety is enabled.
  *
@@ -48,6 +53,7 @@ static inline void arena_free_growth_history(t_arena* arena);
  * ensuring destruction logic runs only once.
  *
  * If `ARENA_ENABLE_THREAD_SAFE` is defined and locking is active:
+ * - It stops background pre-growth, pre-zeroing and pressure trimming of the arena.
  * - It acquires the arena's internal lock before proceeding.
  * - It performs a consistency check (`ARENA_CHECK`), then safely destroys data.
  * - It unlocks the mutex and destroys it afterward.
@@ -91,6 +97,9 @@ void arena_destroy(t_arena* arena)
 #ifdef ARENA_ENABLE_THREAD_SAFE
 	if (arena->use_lock)
 	{
+		arena_pregrow_unwatch(arena);
+		arena_prezero_unwatch(arena);
+		arena_trimmer_unregister(arena);
 		ARENA_CHECK(arena);
 		ARENA_LOCK(arena);
 
@@ -101,6 +110,8 @@ void arena_destroy(t_arena* arena)
 
 		ARENA_UNLOCK(arena);
 		arena->use_lock = false;
+		atomic_store_explicit(&arena->bias_owner, ARENA_BIAS_NONE, memory_order_relaxed);
+		atomic_store_explicit(&arena->bias_revoke, false, memory_order_relaxed);
 		pthread_mutex_destroy(&arena->lock);
 		return;
 	}
@@ -151,7 +162,8 @@ void arena_delete(t_arena** arena)
 		return;
 
 	arena_destroy(*arena);
-	free(*arena);
+	if (!arena_recycle_offer_struct(*arena))
+		free(*arena);
 	*arena = NULL;
 }
 
@@ -168,10 +180,21 @@ void arena_delete(t_arena** arena)
  * the arena is responsible for freeing its memory buffer. If ownership is confirmed
  * and the buffer is non-null, the function:
  *
- * - Applies optional memory poisoning via `arena_poison_memory()` for debugging.
- * - Frees the memory buffer using `free()`.
+ * - Makes the pages of a frozen arena writable again (`arena_thaw_pages()`).
+ * - Unmaps large-object allocations (`arena_large_release()`), whether or not
+ *   the buffer itself is owned.
+ * - Makes the guard pages after its sub-arenas accessible again and frees
+ *   their list (`arena_guard_clear()`).
+ * - Drops the AddressSanitizer/Valgrind annotations of the buffer
+ *   (`arena_sanitize_detach()`), so a caller-provided buffer is plain memory again.
+ * - Applies optional memory poisoning via `arena_poison_memory()` for debugging, up to
+ *   `arena_cycle_high_water()` (heap buffers only; persistent file contents are synced
+ *   with `arena_sync()` instead).
+ * - Releases the memory buffer through `arena_backing_release()` (`free()` or `munmap()`),
+ *   or hands it to the background reclaimer (`arena_reclaim_defer()`) when it runs.
  * - Clears the buffer pointer.
  * - Resets the `owns_buffer` flag atomically to prevent double-free.
+ * - Credits what is left charged to the arena's budget (`arena_budget_credit()`).
  *
  * This function is typically used during cleanup routines such as `arena_destroy()`
  * to safely deallocate memory only if it was dynamically allocated by the arena itself.
@@ -185,14 +208,27 @@ void arena_delete(t_arena** arena)
  */
 static inline void arena_free_buffer_if_owned(t_arena* arena)
 {
+	arena_thaw_pages(arena);
+	arena_large_release(arena, 0);
+	arena_guard_clear(arena);
+	ARENA_SAN_DETACH(arena);
+
 	bool owns = atomic_load_explicit(&arena->owns_buffer, memory_order_acquire);
 	if (owns && arena->buffer)
 	{
-		arena_poison_memory(arena->buffer, arena->size);
-		free(arena->buffer);
+		if (arena->backing.kind == ARENA_BACKING_FILE)
+			arena_sync(arena);
+		arena_prefault_unpin(arena);
+		if (!arena_recycle_offer(arena) && !arena_reclaim_defer(&arena->backing, arena->buffer, arena->size))
+		{
+			if (!arena_backing_is_mapped(&arena->backing))
+				arena_poison_memory(arena->buffer, arena_cycle_high_water(arena));
+			arena_backing_release(&arena->backing, arena->buffer, arena->size);
+		}
 		arena->buffer = NULL;
 		atomic_store_explicit(&arena->owns_buffer, false, memory_order_release);
 	}
+	arena_budget_credit(arena, arena->budget_charged);
 }
 
 /**
@@ -0,0 +1,267 @@
+/**
+ * @file arena_cow.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Copy-on-write cloning and promotion of mapped arenas.
+ *
+ * @details
+ * This file implements:
+ * - `arena_clone_cow()`: a second, `MAP_PRIVATE` mapping of the file behind a
+ *   persistent or memfd arena, wrapped into a new arena with the same offset;
+ * - `arena_cow_promote()`: merging the pages a clone changed back into its source.
+ *
+ * Clones own a duplicate of the source descriptor, so they stay valid even if
+ * the source is destroyed first. Their backing kind is `ARENA_BACKING_COW`,
+ * which `arena_backing_resize()` refuses to grow or shrink and which
+ * `arena_destroy()` releases with a plain `munmap()`.
+ *
+ * Promotion compares the clone and the source page by page and only copies
+ * pages whose bytes differ. The comparison still reads every page up to the
+ * clone's offset, so promotion time grows with the used size of the arena;
+ * what follows the size of the speculative change is the number of pages
+ * written to the source, and hence dirtied for write-back.
+ *
+ * @ingroup arena_cow
+ *
+ * @example
+ * @code
+ * #include "arena_cow.h"
+ * #include "arena_handoff.h"
+ *
+ * t_arena* state = arena_create_memfd("state", 1 << 20, true);
+ * // ... build the state ...
+ *
+ * t_arena* what_if = arena_clone_cow(state);
+ * // ... mutate what_if freely, state is unaffected ...
+ * if (keep_result)
+ *     arena_cow_promote(what_if, state);
+ * arena_delete(&what_if);
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena_cow.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline bool arena_cow_is_source(const t_arena* arena);
+static inline bool arena_cow_same_file(int a, int b);
+static inline void arena_cow_copy_changed_pages(uint8_t* dst, const uint8_t* src, size_t len);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Create a copy-on-write clone of a mapped arena.
+ *
+ * @details
+ * Under the source lock, the source descriptor is duplicated and the whole
+ * mapping (header page included for persistent arenas) is mapped again with
+ * `MAP_PRIVATE`. The clone is a heap-allocated arena with:
+ * - the same size and offset as the source;
+ * - growth disabled (its file is shared with the source);
+ * - the debug label `"arena_cow_clone"`.
+ *
+ * Heap-backed arenas have no file to map privately and are rejected.
+ *
+ * @param source Persistent or memfd arena to clone.
+ *
+ * @return The clone, or `NULL` on failure.
+ *
+ * @ingroup arena_cow
+ *
+ * @see arena_cow_promote
+ * @see arena_delete
+ */
+t_arena* arena_clone_cow(t_arena* source)
+{
+	if (!source)
+	{
+		arena_report_error(NULL, "arena_clone_cow failed: NULL arena");
+		return NULL;
+	}
+
+	ARENA_LOCK(source);
+
+	if (!arena_cow_is_source(source))
+	{
+		arena_report_error(source, "arena_clone_cow failed: arena is not file- or memfd-backed");
+		ARENA_UNLOCK(source);
+		return NULL;
+	}
+
+	const size_t map_len    = source->backing.map_len;
+	const size_t header_len = source->backing.header_len;
+	const size_t size       = source->size;
+	const size_t offset     = source->offset;
+
+	int fd = fcntl(source->backing.fd, F_DUPFD_CLOEXEC, 0);
+	if (fd < 0)
+	{
+		arena_report_error(source, "arena_clone_cow failed: cannot duplicate descriptor");
+		ARENA_UNLOCK(source);
+		return NULL;
+	}
+
+	void* map = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	ARENA_UNLOCK(source);
+	if (map == MAP_FAILED)
+	{
+		arena_report_error(source, "arena_clone_cow failed: cannot map %zu bytes", map_len);
+		close(fd);
+		return NULL;
+	}
+
+	t_arena* clone =
+	    arena_backing_adopt(ARENA_BACKING_COW, fd, map, map_len, header_len, size, offset, 0, false, "arena_cow_clone");
+	if (!clone)
+	{
+		arena_report_error(source, "arena_clone_cow failed: arena allocation failed");
+		munmap(map, map_len);
+		close(fd);
+	}
+	return clone;
+}
+
+/**
+ * @brief
+ * Promote a clone: apply its changes to the source arena.
+ *
+ * @details
+ * Both arenas are locked (source first). The clone's used range is compared
+ * with the source one page at a time (a full read of that range) and every
+ * differing page is copied into the source buffer. The source offset then becomes the clone's offset and
+ * its peak usage is updated.
+ *
+ * The clone remains valid (and identical to the source) afterwards; release
+ * it with `arena_delete()` or keep using it as a fresh speculation base.
+ * Persistent sources are not flushed: call `arena_sync()` to make the
+ * promotion durable.
+ *
+ * @param clone  Clone returned by `arena_clone_cow()`.
+ * @param source Arena the clone was taken from.
+ *
+ * @return `true` on success, `false` on invalid arguments, unrelated arenas,
+ *         a frozen source, or a source smaller than the clone's offset.
+ *
+ * @ingroup arena_cow
+ *
+ * @see arena_clone_cow
+ */
+bool arena_cow_promote(t_arena* clone, t_arena* source)
+{
+	if (!clone || !source || clone == source)
+	{
+		arena_report_error(NULL, "arena_cow_promote failed: invalid arenas");
+		return false;
+	}
+
+	ARENA_LOCK(source);
+	ARENA_LOCK(clone);
+
+	bool ok = clone->backing.kind == ARENA_BACKING_COW && arena_cow_is_source(source) &&
+	          arena_cow_same_file(clone->backing.fd, source->backing.fd);
+	if (!ok)
+		arena_report_error(source, "arena_cow_promote failed: arena is not a clone of this source");
+	else if (ARENA_IS_FROZEN(source))
+	{
+		arena_report_error(source, "arena_cow_promote failed: source arena is frozen");
+		ok = false;
+	}
+	else if (clone->offset > source->size)
+	{
+		arena_report_error(source, "arena_cow_promote failed: clone offset %zu exceeds source size %zu",
+		                   clone->offset, source->size);
+		ok = false;
+	}
+
+	if (ok)
+	{
+		arena_guard_release(source, 0);
+		arena_guard_protect(clone, PROT_READ | PROT_WRITE);
+		ARENA_SAN_DETACH(source);
+		ARENA_SAN_READ_BEGIN(clone, clone->offset);
+		arena_cow_copy_changed_pages(source->buffer, clone->buffer, clone->offset);
+		ARENA_SAN_READ_END(clone, clone->offset);
+		arena_guard_protect(clone, PROT_NONE);
+		source->offset = clone->offset;
+		arena_update_peak(source);
+		ARENA_POISON_CLIP(source, source->offset);
+		ARENA_SAN_ATTACH(source);
+	}
+
+	ARENA_UNLOCK(clone);
+	ARENA_UNLOCK(source);
+	return ok;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Check whether an arena's buffer lives in a file that can be mapped privately.
+ *
+ * @ingroup arena_cow
+ */
+static inline bool arena_cow_is_source(const t_arena* arena)
+{
+	return arena->buffer &&
+	       (arena->backing.kind == ARENA_BACKING_FILE || arena->backing.kind == ARENA_BACKING_MEMFD);
+}
+
+/**
+ * @brief
+ * Check whether two descriptors refer to the same file.
+ *
+ * @ingroup arena_cow
+ */
+static inline bool arena_cow_same_file(int a, int b)
+{
+	struct stat sa;
+	struct stat sb;
+	if (fstat(a, &sa) != 0 || fstat(b, &sb) != 0)
+		return false;
+	return sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+/**
+ * @brief
+ * Copy the pages of `src` that differ from `dst`.
+ *
+ * @details
+ * Buffers of mapped arenas start on a page boundary, so each chunk covers
+ * exactly one page of both mappings. Writing only the differing pages keeps
+ * untouched source pages clean (no needless write-back for persistent files).
+ *
+ * @param dst Source arena buffer (written).
+ * @param src Clone buffer (read).
+ * @param len Number of bytes to reconcile.
+ *
+ * @ingroup arena_cow
+ */
+static inline void arena_cow_copy_changed_pages(uint8_t* dst, const uint8_t* src, size_t len)
+{
+	const size_t page = arena_page_size();
+	for (size_t pos = 0; pos < len; pos += page)
+	{
+		size_t chunk = len - pos < page ? len - pos : page;
+		if (memcmp(dst + pos, src + pos, chunk) != 0)
+			memcpy(dst + pos, src + pos, chunk);
+	}
+}
@@ -47,10 +47,11 @@
 static inline void     arena_set_default_label(t_arena* arena, const char* fallback);
 static inline t_arena* arena_alloc_struct(void);
 static inline void     arena_log_and_teardown(t_arena** arena, const char* msg);
-static inline void*    arena_alloc_buffer(size_t size);
+static inline void*    arena_alloc_buffer(t_arena_backing* backing, size_t size);
 static inline void     arena_reset_metadata(t_arena* arena);
 static inline bool     arena_init_mutex(t_arena* arena);
-static inline bool     arena_finish_init(t_arena* arena, void* buffer, size_t size, bool allow_grow);
+static inline bool     arena_finish_init(t_arena* arena, void* buffer, size_t size, bool allow_grow,
+                                         const t_arena_backing* backing);
 static inline bool     arena_set_allocated_buffer(t_arena* arena, size_t size);
 static inline void     arena_set_user_buffer(t_arena* arena, void* buffer, size_t size);
 static inline bool     arena_set_or_alloc_buffer(t_arena* arena, void* buffer, size_t size);
@@ -120,14 +121,15 @@ t_arena* arena_create(size_t size, bool allow_grow)
 	if (!arena)
 		return NULL;
 
-	void* buffer = arena_alloc_buffer(size);
+	t_arena_backing backing;
+	void*           buffer = arena_alloc_buffer(&backing, size);
 	if (!buffer)
 	{
 		arena_log_and_teardown(&arena, "arena_create: buffer allocation failed");
 		return NULL;
 	}
 
-	if (!arena_finish_init(arena, buffer, size, allow_grow))
+	if (!arena_finish_init(arena, buffer, size, allow_grow, &backing))
 	{
 		arena_log_and_teardown(&arena, "arena_create: init failure");
 		return NULL;
@@ -195,17 +197,17 @@ bool arena_init(t_arena* arena, size_t size, bool allow_grow)
 		return false;
 	}
 
-	void* buffer = arena_alloc_buffer(size);
+	t_arena_backing backing;
+	void*           buffer = arena_alloc_buffer(&backing, size);
 	if (!buffer)
 	{
-		arena_log_and_teardown(&arena, "arena_init: buffer allocation failed");
-		return NULL;
+		arena_report_error(NULL, "arena_init: buffer allocation failed");
+		return false;
 	}
 
-	if (!arena_finish_init(arena, buffer, size, allow_grow))
+	if (!arena_finish_init(arena, buffer, size, allow_grow, &backing))
 	{
 		arena_report_error(arena, "arena_init: arena_finish_init failed");
-		free(buffer);
 		return false;
 	}
 
@@ -297,6 +299,7 @@ void arena_init_with_buffer(t_arena* arena, void* buffer, size_t size, bool allo
 
 	if (!arena_set_or_alloc_buffer(arena, buffer, size))
 		return;
+	ARENA_SAN_ATTACH(arena);
 
 	arena_set_default_label(arena, "arena_from_buffer");
 	arena_generate_id(arena);
@@ -425,7 +428,8 @@ static inline void arena_set_default_label(t_arena* arena, const char* fallback)
  */
 static inline t_arena* arena_alloc_struct(void)
 {
-	return (t_arena*) calloc(1, sizeof(t_arena));
+	t_arena* arena = arena_recycle_take_struct();
+	return arena ? arena : (t_arena*) calloc(1, sizeof(t_arena));
 }
 
 /**
@@ -472,13 +476,16 @@ static inline void arena_log_and_teardown(t_arena** arena, const char* msg)
  * Allocate a zero-initialized memory buffer for the arena.
  *
  * @details
- * This function wraps `calloc` to allocate a contiguous zeroed memory region
- * of `size` bytes. It is used when the arena needs to allocate its own internal
- * memory buffer (rather than relying on an external one provided by the user).
+ * This function wraps `arena_backing_alloc()` to allocate a contiguous zeroed
+ * memory region of `size` bytes: `calloc` for small buffers, an anonymous
+ * mapping from `ARENA_MMAP_THRESHOLD` bytes on. It is used when the arena needs
+ * to allocate its own internal memory buffer (rather than relying on an
+ * external one provided by the user).
  *
  * If allocation fails, the function reports the failure using `arena_report_error`.
  *
- * @param size The number of bytes to allocate.
+ * @param backing Receives the description of the allocated buffer.
+ * @param size    The number of bytes to allocate.
  * @return A pointer to the allocated memory buffer, or `NULL` if allocation fails.
  *
  * @ingroup arena_internal
@@ -489,9 +496,11 @@ static inline void arena_log_and_teardown(t_arena** arena, const char* msg)
  * @see arena_create
  * @see arena_init
  */
-static inline void* arena_alloc_buffer(size_t size)
+static inline void* arena_alloc_buffer(t_arena_backing* backing, size_t size)
 {
-	void* buffer = calloc(1, size);
+	void* buffer = arena_recycle_take(backing, size);
+	if (!buffer)
+		buffer = arena_backing_alloc(backing, size);
 	if (!buffer)
 		arena_report_error(NULL, "arena_create failed: buffer allocation of %zu bytes failed", size);
 	return buffer;
@@ -508,10 +517,11 @@ static inline void* arena_alloc_buffer(size_t size)
  * It performs the following actions:
  * - Nullifies the memory buffer and resets size/offset tracking.
  * - Clears the marker stack and parent reference.
+ * - Resets the buffer backing to a plain heap buffer and clears the large-object list.
  * - Sets the default grow callback and debug error handler.
  * - Clears all debug metadata and hook pointers.
  * - Resets all internal statistics via `arena_stats_reset`.
- * - Initializes atomic flags like `owns_buffer`, `can_grow`, and `is_destroying`.
+ * - Initializes atomic flags like `owns_buffer`, `can_grow`, `is_destroying`, and `is_frozen`.
  * - Disables locking if thread safety is enabled.
  *
  * This function must be called before using or reinitializing the arena.
@@ -535,11 +545,27 @@ static inline void arena_reset_metadata(t_arena* arena)
 	arena->marker_stack_top = 0;
 	memset(arena->marker_stack, 0, sizeof(arena->marker_stack));
 	arena->parent_ref = NULL;
+	arena_backing_reset(&arena->backing);
+	arena->large_list      = NULL;
+	arena->large_threshold = ARENA_LARGE_THRESHOLD;
+	arena->guards          = (t_arena_guards) {0};
+	arena->cycle_peak      = 0;
+	arena->shrink_policy   = (t_arena_shrink_policy) {0};
+	arena->shrink_window   = (t_arena_shrink_window) {0};
+	arena->budget          = NULL;
+	arena->budget_charged  = 0;
+	arena->create_flags    = 0;
+	arena->clean_from      = 0;
 
 	arena->grow_cb             = default_grow_cb;
+	arena->grow_policy         = (t_arena_grow_policy) {0};
 	arena->debug.error_cb      = arena_default_error_callback;
 	arena->debug.error_context = NULL;
 	arena->debug.label         = NULL;
+#ifdef ARENA_POISON_VERIFY
+	arena->debug.poison_hi   = 0;
+	arena->debug.owner_count = 0;
+#endif
 
 	arena->hooks.hook_cb = NULL;
 	arena->hooks.context = NULL;
@@ -549,9 +575,21 @@ static inline void arena_reset_metadata(t_arena* arena)
 	atomic_store_explicit(&arena->owns_buffer, false, memory_order_release);
 	atomic_store_explicit(&arena->can_grow, false, memory_order_release);
 	atomic_store_explicit(&arena->is_destroying, false, memory_order_release);
+	atomic_store_explicit(&arena->is_frozen, false, memory_order_release);
 
 #ifdef ARENA_ENABLE_THREAD_SAFE
-	arena->use_lock = false;
+	arena->use_lock        = false;
+	arena->pregrow_percent = 0;
+	arena->pregrow_stalled = 0;
+	arena->trim_registered = false;
+	arena->prezero_watched = false;
+	arena->io_pins         = NULL;
+	arena->io_retired      = NULL;
+	atomic_store_explicit(&arena->pregrow_pending, false, memory_order_relaxed);
+	atomic_store_explicit(&arena->prezero_pending, false, memory_order_relaxed);
+	atomic_store_explicit(&arena->bias_owner, ARENA_BIAS_NONE, memory_order_relaxed);
+	atomic_store_explicit(&arena->bias_depth, 0, memory_order_relaxed);
+	atomic_store_explicit(&arena->bias_revoke, false, memory_order_relaxed);
 #endif
 }
 
@@ -616,19 +654,21 @@ fail:
  *
  * The function performs the following:
  * - Resets the arena's internal state via `arena_reset_metadata`.
- * - Sets the buffer, size, and ownership flag.
+ * - Sets the buffer, its backing, size, and ownership flag.
  * - Initializes flags for growth and destruction status.
  * - Initializes the mutex (if thread safety is enabled).
  * - Generates a unique debug ID for the arena.
  *
  * If mutex initialization fails, the buffer is freed immediately
- * to avoid memory leaks and the function returns `false`.
+ * to avoid memory leaks, the arena is left without a buffer (so a later
+ * `arena_destroy()` cannot release it twice) and the function returns `false`.
  * Ownership of the arena structure itself remains with the caller.
  *
  * @param arena       Pointer to the arena being initialized.
  * @param buffer      Pre-allocated memory buffer for arena use.
  * @param size        Size of the memory buffer in bytes.
  * @param allow_grow  Whether the arena may grow dynamically if full.
+ * @param backing     Backing record returned with the buffer by `arena_alloc_buffer()`.
  *
  * @return `true` on success, `false` if mutex setup failed.
  *
@@ -637,20 +677,26 @@ fail:
  * @see arena_create
  * @see arena_init
  */
-static inline bool arena_finish_init(t_arena* arena, void* buffer, size_t size, bool allow_grow)
+static inline bool arena_finish_init(t_arena* arena, void* buffer, size_t size, bool allow_grow,
+                                     const t_arena_backing* backing)
 {
 	arena_reset_metadata(arena);
-	arena->buffer = (uint8_t*) buffer;
-	arena->size   = size;
+	arena->backing = *backing;
+	arena->buffer  = (uint8_t*) buffer;
+	arena->size    = size;
 	atomic_store_explicit(&arena->owns_buffer, true, memory_order_release);
 	atomic_store_explicit(&arena->can_grow, allow_grow, memory_order_release);
 	atomic_store_explicit(&arena->is_destroying, false, memory_order_release);
 
 	if (!arena_init_mutex(arena))
 	{
-		free(buffer);
+		arena_backing_release(&arena->backing, buffer, size);
+		arena->buffer = NULL;
+		arena->size   = 0;
+		atomic_store_explicit(&arena->owns_buffer, false, memory_order_release);
 		return false;
 	}
+	ARENA_SAN_ATTACH(arena);
 	arena_generate_id(arena);
 	return true;
 }
@@ -662,7 +708,7 @@ static inline bool arena_finish_init(t_arena* arena, void* buffer, size_t size,
  * @details
  * This function is used internally when no user-supplied buffer is provided
  * during `arena_init_with_buffer`. It dynamically allocates a memory region
- * of the requested size using `calloc`, stores the resulting buffer and size
+ * of the requested size using `arena_backing_alloc()`, stores the resulting buffer and size
  * into the arena, and marks the arena as the owner of the buffer so it can
  * be freed on destruction.
  *
@@ -681,7 +727,7 @@ static inline bool arena_finish_init(t_arena* arena, void* buffer, size_t size,
  */
 static inline bool arena_set_allocated_buffer(t_arena* arena, size_t size)
 {
-	void* buffer = calloc(1, size);
+	void* buffer = arena_backing_alloc(&arena->backing, size);
 	if (!buffer)
 	{
 		arena_report_error(NULL, "arena_init_with_buffer: malloc for %zu bytes failed", size);
@@ -718,8 +764,9 @@ static inline bool arena_set_allocated_buffer(t_arena* arena, size_t size)
  */
 static inline void arena_set_user_buffer(t_arena* arena, void* buffer, size_t size)
 {
-	arena->buffer = (uint8_t*) buffer;
-	arena->size   = size;
+	arena->buffer     = (uint8_t*) buffer;
+	arena->size       = size;
+	arena->clean_from = size;
 	atomic_store_explicit(&arena->owns_buffer, false, memory_order_release);
 }
 
@@ -0,0 +1,309 @@
+/**
+ * @file arena_epoch.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Epoch rings: reader registration, epoch entry and writer-side advancing.
+ *
+ * @details
+ * A reader enters by storing the epoch it read into its record and reading
+ * the epoch again; if it moved on meanwhile, it stores the new value and
+ * retries. Both sides use sequentially consistent accesses, so when the
+ * writer scans the records either it sees the reader's epoch, or the reader's
+ * first access to published data comes after the scan, when the arena being
+ * reset is no longer reachable. The retry keeps a reader that was preempted
+ * between the two steps from pinning an old epoch for the rest of its
+ * critical section.
+ *
+ * Advancing from epoch `E` resets the arena of epoch `E + 1 - count`. The
+ * scan requires every active reader to have entered at `E + 3 - count` or
+ * later (see the contract in `arena_epoch.h`), computed as
+ * `epoch + count >= E + 3` so early epochs do not underflow. The arena is
+ * reset before the new epoch is published, so `arena_epoch_current()` always
+ * returns a clean arena.
+ *
+ * @ingroup arena_epoch
+ */
+
+#include "arena_epoch.h"
+#include <sched.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static bool arena_epoch_readers_past(t_arena_epoch* ring, uint64_t current);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Initialize an epoch ring of `count` fixed-size arenas.
+ *
+ * @details
+ * The arenas are labeled `"epoch"` and cannot grow. The ring starts at
+ * epoch 1 with no reader registered.
+ *
+ * @param ring       Ring to initialize.
+ * @param count      Number of arenas, from 2 to `ARENA_EPOCH_MAX_ARENAS`.
+ * @param arena_size Size of each arena in bytes.
+ *
+ * @return `true` on success, `false` if the arguments are invalid or an arena
+ *         could not be created.
+ *
+ * @ingroup arena_epoch
+ *
+ * @see arena_epoch_destroy
+ */
+bool arena_epoch_init(t_arena_epoch* ring, size_t count, size_t arena_size)
+{
+	if (!ring || count < 2 || count > ARENA_EPOCH_MAX_ARENAS || arena_size == 0)
+		return arena_report_error(NULL, "arena_epoch_init failed: invalid arguments"), false;
+
+	memset(ring, 0, sizeof(*ring));
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!arena_init(&ring->arenas[i], arena_size, false))
+		{
+			ring->count = i;
+			arena_epoch_destroy(ring);
+			return false;
+		}
+		arena_set_debug_label(&ring->arenas[i], "epoch");
+	}
+	ring->count = count;
+	for (size_t i = 0; i < ARENA_EPOCH_MAX_READERS; ++i)
+		ring->readers[i].ring = ring;
+	atomic_store(&ring->epoch, 1);
+	return true;
+}
+
+/**
+ * @brief
+ * Destroy every arena of a ring.
+ *
+ * @details
+ * All readers must have left; their records become invalid.
+ *
+ * @ingroup arena_epoch
+ */
+void arena_epoch_destroy(t_arena_epoch* ring)
+{
+	if (!ring)
+		return;
+
+	for (size_t i = 0; i < ring->count; ++i)
+		arena_destroy(&ring->arenas[i]);
+	ring->count = 0;
+}
+
+/**
+ * @brief
+ * Arena of the current epoch.
+ *
+ * @details
+ * Only the writer allocates from it. Data published to readers must live in
+ * this arena when the writer advances.
+ *
+ * @ingroup arena_epoch
+ */
+t_arena* arena_epoch_current(t_arena_epoch* ring)
+{
+	if (!ring || !ring->count)
+		return arena_report_error(NULL, "arena_epoch_current failed: ring is not initialized"), NULL;
+
+	return &ring->arenas[atomic_load_explicit(&ring->epoch, memory_order_relaxed) % ring->count];
+}
+
+/**
+ * @brief
+ * Current epoch of a ring (`0` for `NULL`).
+ *
+ * @ingroup arena_epoch
+ */
+uint64_t arena_epoch_now(t_arena_epoch* ring)
+{
+	if (!ring)
+		return 0;
+	return atomic_load(&ring->epoch);
+}
+
+/**
+ * @brief
+ * Advance to the next epoch if no reader still uses its arena.
+ *
+ * @details
+ * The next epoch reuses the oldest arena of the ring. It is reset, then the
+ * new epoch is published. Never blocks.
+ *
+ * @param ring Ring to advance (writer thread only).
+ *
+ * @return `true` if the ring advanced, `false` if a reader that entered too
+ *         long ago is still inside, or on invalid arguments.
+ *
+ * @ingroup arena_epoch
+ *
+ * @see arena_epoch_advance
+ */
+bool arena_epoch_try_advance(t_arena_epoch* ring)
+{
+	if (!ring || !ring->count)
+		return arena_report_error(NULL, "arena_epoch_advance failed: ring is not initialized"), false;
+
+	uint64_t current = atomic_load(&ring->epoch);
+	if (!arena_epoch_readers_past(ring, current))
+		return false;
+
+	arena_reset(&ring->arenas[(current + 1) % ring->count]);
+	atomic_store(&ring->epoch, current + 1);
+	return true;
+}
+
+/**
+ * @brief
+ * Advance to the next epoch, waiting for readers that still use its arena.
+ *
+ * @details
+ * Yields the processor between attempts. Readers are never blocked, so the
+ * wait lasts until the slowest reader of an old epoch exits.
+ *
+ * @ingroup arena_epoch
+ *
+ * @see arena_epoch_try_advance
+ */
+void arena_epoch_advance(t_arena_epoch* ring)
+{
+	if (!ring || !ring->count)
+	{
+		arena_report_error(NULL, "arena_epoch_advance failed: ring is not initialized");
+		return;
+	}
+
+	while (!arena_epoch_try_advance(ring))
+		sched_yield();
+}
+
+/**
+ * @brief
+ * Register the calling thread as a reader of `ring`.
+ *
+ * @details
+ * Claims a free record with an atomic exchange, so readers can register
+ * concurrently. A thread keeps its record for as long as it reads and gives
+ * it back with `arena_epoch_unregister()`.
+ *
+ * @return The reader record, or `NULL` if all `ARENA_EPOCH_MAX_READERS`
+ *         records are taken.
+ *
+ * @ingroup arena_epoch
+ */
+t_arena_epoch_reader* arena_epoch_register(t_arena_epoch* ring)
+{
+	if (!ring || !ring->count)
+		return arena_report_error(NULL, "arena_epoch_register failed: ring is not initialized"), NULL;
+
+	for (size_t i = 0; i < ARENA_EPOCH_MAX_READERS; ++i)
+	{
+		t_arena_epoch_reader* reader = &ring->readers[i];
+		if (!atomic_exchange(&reader->in_use, true))
+		{
+			reader->depth = 0;
+			atomic_store(&reader->epoch, 0);
+			return reader;
+		}
+	}
+	return arena_report_error(NULL, "arena_epoch_register failed: all reader records in use"), NULL;
+}
+
+/**
+ * @brief
+ * Give a reader record back to its ring.
+ *
+ * @ingroup arena_epoch
+ */
+void arena_epoch_unregister(t_arena_epoch_reader* reader)
+{
+	if (!reader)
+		return;
+
+	reader->depth = 0;
+	atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+	atomic_store_explicit(&reader->in_use, false, memory_order_release);
+}
+
+/**
+ * @brief
+ * Enter the current epoch.
+ *
+ * @details
+ * Until the matching `arena_epoch_exit()`, data published in the arena of the
+ * returned epoch or of the epoch before stays valid. Nested calls only count
+ * the depth and keep the outer epoch.
+ *
+ * @return The epoch the reader is in, or `0` for `NULL`.
+ *
+ * @ingroup arena_epoch
+ */
+uint64_t arena_epoch_enter(t_arena_epoch_reader* reader)
+{
+	if (!reader)
+		return 0;
+	if (reader->depth++)
+		return atomic_load_explicit(&reader->epoch, memory_order_relaxed);
+
+	uint64_t epoch = atomic_load_explicit(&reader->ring->epoch, memory_order_relaxed);
+	for (;;)
+	{
+		atomic_store(&reader->epoch, epoch);
+		uint64_t now = atomic_load(&reader->ring->epoch);
+		if (now == epoch)
+			return epoch;
+		epoch = now;
+	}
+}
+
+/**
+ * @brief
+ * Leave the epoch entered by the matching `arena_epoch_enter()`.
+ *
+ * @details
+ * The outermost exit publishes, with release ordering, that the reader is
+ * done with everything it read.
+ *
+ * @ingroup arena_epoch
+ */
+void arena_epoch_exit(t_arena_epoch_reader* reader)
+{
+	if (!reader || !reader->depth)
+		return;
+	if (--reader->depth == 0)
+		atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Whether every active reader entered late enough for the ring to leave `current`.
+ *
+ * @details
+ * Advancing resets the arena of epoch `current + 1 - count`, which readers
+ * that entered at `current + 3 - count` or later no longer use.
+ *
+ * @ingroup arena_epoch
+ */
+static bool arena_epoch_readers_past(t_arena_epoch* ring, uint64_t current)
+{
+	for (size_t i = 0; i < ARENA_EPOCH_MAX_READERS; ++i)
+	{
+		uint64_t epoch = atomic_load(&ring->readers[i].epoch);
+		if (epoch && epoch + ring->count < current + 3)
+			return false;
+	}
+	return true;
+}
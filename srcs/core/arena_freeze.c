@@ -0,0 +1,249 @@
+/**
+ * @file arena_freeze.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Freezing arenas into read-only, lock-free state.
+ *
+ * @details
+ * This file implements:
+ * - `arena_freeze()`: mark an arena as permanently read-only and write-protect
+ *   the pages of its buffer with `mprotect()`;
+ * - `arena_seal()`: additionally seal the memfd behind a memfd arena so that
+ *   no process can modify it through the file;
+ * - `arena_is_frozen()`: query the frozen flag.
+ *
+ * Once the `is_frozen` flag is published (with release ordering, after the
+ * last write under the arena lock), `offset`, `size`, and `stats` never change
+ * again. The read paths (`arena_used()`, `arena_remaining()`, `arena_peak()`,
+ * `arena_mark()`, `arena_get_stats()`) check the flag first and skip the
+ * mutex entirely, and mutating paths (allocation, `arena_pop()`,
+ * `arena_reset()`, resizing, snapshot loading) reject the call before taking
+ * the lock.
+ *
+ * Freezing is one-way. The pages are made writable again only by
+ * `arena_destroy()`, right before the buffer is released.
+ *
+ * @ingroup arena_state
+ *
+ * @example
+ * @code
+ * t_arena* config = arena_create(1 << 20, true);
+ * load_config(config);
+ * arena_freeze(config);
+ *
+ * // From any thread, without contention:
+ * size_t bytes = arena_used(config);
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline bool arena_freeze_page_range(const t_arena* arena, uint8_t** start, size_t* len);
+static inline bool arena_freeze_protect(t_arena* arena, int prot);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Make an arena permanently read-only.
+ *
+ * @details
+ * Under the arena lock, this function:
+ * - Write-protects every whole page of the buffer with `mprotect(PROT_READ)`,
+ *   so stray writes fault immediately instead of corrupting shared data.
+ *   Only arenas that own their buffer are protected; sub-arenas and
+ *   user-provided buffers are frozen logically but left writable, since their
+ *   memory belongs to someone else. For heap buffers, the partial pages at
+ *   both ends are shared with the allocator and stay writable. Dedicated
+ *   large-object mappings are always protected.
+ * - Publishes the `is_frozen` flag.
+ *
+ * Freezing an already frozen arena succeeds without doing anything.
+ *
+ * @param arena Arena to freeze.
+ *
+ * @return `true` if the arena is frozen, `false` if it is `NULL`, being
+ *         destroyed, or `mprotect()` failed (the arena is then left unchanged).
+ *
+ * @ingroup arena_state
+ *
+ * @see arena_seal
+ * @see arena_is_frozen
+ */
+bool arena_freeze(t_arena* arena)
+{
+	if (!arena)
+		return false;
+	if (ARENA_IS_FROZEN(arena))
+		return true;
+
+	ARENA_LOCK(arena);
+	ARENA_CHECK(arena);
+
+	bool ok = !atomic_load_explicit(&arena->is_destroying, memory_order_acquire) && arena->buffer;
+	if (!ok)
+		arena_report_error(arena, "arena_freeze failed: arena has no buffer");
+	else if (!arena_freeze_protect(arena, PROT_READ))
+	{
+		arena_report_error(arena, "arena_freeze failed: mprotect failed");
+		ok = false;
+	}
+
+	if (ok)
+		atomic_store_explicit(&arena->is_frozen, true, memory_order_release);
+
+	ARENA_UNLOCK(arena);
+	return ok;
+}
+
+/**
+ * @brief
+ * Freeze a memfd arena and seal its file against modification.
+ *
+ * @details
+ * The arena is frozen with `arena_freeze()`, then `F_SEAL_SHRINK`,
+ * `F_SEAL_GROW`, and a write seal are added to its memfd. `F_SEAL_WRITE` is
+ * tried first; the kernel refuses it while a writable shared mapping exists
+ * (which includes the arena's own mapping, even after `mprotect()`), in which
+ * case `F_SEAL_FUTURE_WRITE` is used: it forbids `write()` and any new
+ * writable mapping. Receivers of the descriptor can then map it read-only and
+ * rely on its contents never changing.
+ *
+ * @param arena Arena created with `arena_create_memfd()`.
+ *
+ * @return `true` if the arena is frozen and sealed, `false` otherwise.
+ *
+ * @ingroup arena_state
+ *
+ * @see arena_freeze
+ * @see arena_create_memfd
+ */
+bool arena_seal(t_arena* arena)
+{
+	if (!arena || arena->backing.kind != ARENA_BACKING_MEMFD)
+	{
+		arena_report_error(arena, "arena_seal failed: arena is not memfd-backed");
+		return false;
+	}
+	if (!arena_freeze(arena))
+		return false;
+
+	const int base = F_SEAL_SHRINK | F_SEAL_GROW;
+	if (fcntl(arena->backing.fd, F_ADD_SEALS, base | F_SEAL_WRITE) == 0)
+		return true;
+#ifdef F_SEAL_FUTURE_WRITE
+	if (errno == EBUSY && fcntl(arena->backing.fd, F_ADD_SEALS, base | F_SEAL_FUTURE_WRITE) == 0)
+		return true;
+#endif
+
+	arena_report_error(arena, "arena_seal failed: cannot seal memfd");
+	return false;
+}
+
+/**
+ * @brief
+ * Check whether an arena has been frozen.
+ *
+ * @param arena Arena to inspect.
+ *
+ * @return `true` if `arena_freeze()` succeeded on this arena.
+ *
+ * @ingroup arena_state
+ */
+bool arena_is_frozen(const t_arena* arena)
+{
+	return arena && ARENA_IS_FROZEN(arena);
+}
+
+/**
+ * @brief
+ * Make the buffer of a frozen arena writable again before it is released.
+ *
+ * @details
+ * Called by `arena_destroy()` with the arena lock held: heap buffers must be
+ * writable for poisoning and `free()`. Clears the `is_frozen` flag.
+ *
+ * @param arena Arena being destroyed.
+ *
+ * @ingroup arena_internal
+ */
+void arena_thaw_pages(t_arena* arena)
+{
+	if (!ARENA_IS_FROZEN(arena))
+		return;
+
+	if (!arena_freeze_protect(arena, PROT_READ | PROT_WRITE))
+		arena_report_error(arena, "arena_destroy: failed to unprotect frozen buffer");
+	atomic_store_explicit(&arena->is_frozen, false, memory_order_release);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Compute the page-aligned range of the buffer that may be protected.
+ *
+ * @details
+ * Mapped buffers start on a page boundary and own their whole last page.
+ * Heap buffers only contribute the pages lying entirely inside them.
+ *
+ * @param arena Arena to inspect.
+ * @param start Output start of the range.
+ * @param len   Output length of the range in bytes.
+ *
+ * @return `false` if there is nothing to protect.
+ *
+ * @ingroup arena_state
+ */
+static inline bool arena_freeze_page_range(const t_arena* arena, uint8_t** start, size_t* len)
+{
+	if (!atomic_load_explicit(&arena->owns_buffer, memory_order_acquire) || !arena->buffer)
+		return false;
+
+	const size_t    page  = arena_page_size();
+	const uintptr_t begin = align_up((uintptr_t) arena->buffer, page);
+	uintptr_t       end   = (uintptr_t) arena->buffer + arena->size;
+	end                   = arena_backing_is_mapped(&arena->backing) ? align_up(end, page) : end & ~(page - 1);
+	if (end <= begin)
+		return false;
+
+	*start = (uint8_t*) begin;
+	*len   = end - begin;
+	return true;
+}
+
+/**
+ * @brief
+ * Apply page protection flags to the protectable range of a buffer.
+ *
+ * @return `true` on success or if there is nothing to protect.
+ *
+ * @ingroup arena_state
+ */
+static inline bool arena_freeze_protect(t_arena* arena, int prot)
+{
+	uint8_t* start = NULL;
+	size_t   len   = 0;
+	if (!arena_large_protect(arena, prot))
+		return false;
+	if (!arena_freeze_page_range(arena, &start, &len))
+		return true;
+	return mprotect(start, len, prot) == 0 && arena_guard_protect(arena, PROT_NONE);
+}
@@ -0,0 +1,256 @@
+/**
+ * @file arena_grow_policy.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Built-in growth policies and per-arena policy selection.
+ *
+ * @details
+ * `arena_grow()` asks the arena's `grow_policy` for the new size when one is
+ * set, and falls back to `grow_cb` otherwise. The presets below read their
+ * parameters from `arena->grow_policy` itself, so they need no context and
+ * can be set on any number of arenas. They all work from `needed`, the
+ * smallest size that fits the failed allocation, and never return less.
+ *
+ * Sizes that overflow `size_t` saturate to `SIZE_MAX`, which `arena_grow()`
+ * then rejects against `ARENA_MAX_ALLOWED_SIZE`.
+ *
+ * @ingroup arena_grow_policy
+ */
+
+#include "arena.h"
+#include "arena_grow_policy.h"
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static size_t        arena_grow_geometric(t_arena* arena, size_t required_size, void* context);
+static size_t        arena_grow_linear(t_arena* arena, size_t required_size, void* context);
+static size_t        arena_grow_rounded(t_arena* arena, size_t required_size, void* context);
+static size_t        arena_grow_adaptive(t_arena* arena, size_t required_size, void* context);
+static inline size_t arena_grow_needed(const t_arena* arena, size_t required_size);
+static inline size_t arena_grow_scale(size_t size, double factor);
+static inline size_t arena_grow_round(size_t size, size_t granularity);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Select the growth policy of `arena`.
+ *
+ * @details
+ * Takes effect from the next growth. A policy with a `NULL` function restores
+ * the arena's `grow_cb`.
+ *
+ * @param arena  Arena to configure.
+ * @param policy Policy to copy into the arena.
+ *
+ * @ingroup arena_grow_policy
+ */
+void arena_set_grow_policy(t_arena* arena, t_arena_grow_policy policy)
+{
+	if (!arena)
+		return;
+
+	ARENA_LOCK(arena);
+	arena->grow_policy = policy;
+	ARENA_UNLOCK(arena);
+}
+
+/**
+ * @brief
+ * Geometric preset: `size * factor`, with at most `max_step` bytes per growth.
+ *
+ * @ingroup arena_grow_policy
+ */
+t_arena_grow_policy arena_grow_policy_geometric(double factor, size_t max_step)
+{
+	return (t_arena_grow_policy) {
+	    .fn     = arena_grow_geometric,
+	    .factor = factor > 1.0 ? factor : ARENA_GROW_DEFAULT_FACTOR,
+	    .step   = max_step,
+	};
+}
+
+/**
+ * @brief
+ * Linear preset: grow by the smallest multiple of `step` that fits.
+ *
+ * @ingroup arena_grow_policy
+ */
+t_arena_grow_policy arena_grow_policy_linear(size_t step)
+{
+	return (t_arena_grow_policy) {
+	    .fn   = arena_grow_linear,
+	    .step = step ? step : arena_page_size(),
+	};
+}
+
+/**
+ * @brief
+ * Rounded preset: double, then round up to `granularity`.
+ *
+ * @ingroup arena_grow_policy
+ */
+t_arena_grow_policy arena_grow_policy_rounded(size_t granularity)
+{
+	return (t_arena_grow_policy) {
+	    .fn          = arena_grow_rounded,
+	    .factor      = ARENA_GROW_DEFAULT_FACTOR,
+	    .granularity = granularity ? granularity : arena_page_size(),
+	};
+}
+
+/**
+ * @brief
+ * Adaptive preset: tune the factor to how often the arena grows.
+ *
+ * @ingroup arena_grow_policy
+ */
+t_arena_grow_policy arena_grow_policy_adaptive(size_t window)
+{
+	return (t_arena_grow_policy) {
+	    .fn     = arena_grow_adaptive,
+	    .factor = ARENA_GROW_DEFAULT_FACTOR,
+	    .step   = window ? window : ARENA_GROW_ADAPTIVE_WINDOW,
+	};
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Geometric policy function.
+ *
+ * @ingroup arena_grow_policy
+ */
+static size_t arena_grow_geometric(t_arena* arena, size_t required_size, void* context)
+{
+	(void) context;
+	const t_arena_grow_policy* policy   = &arena->grow_policy;
+	size_t                     new_size = arena_grow_scale(arena->size, policy->factor);
+
+	if (policy->step && new_size - arena->size > policy->step)
+		new_size = arena->size + policy->step;
+
+	const size_t needed = arena_grow_needed(arena, required_size);
+	return new_size > needed ? new_size : needed;
+}
+
+/**
+ * @brief
+ * Linear policy function.
+ *
+ * @ingroup arena_grow_policy
+ */
+static size_t arena_grow_linear(t_arena* arena, size_t required_size, void* context)
+{
+	(void) context;
+	const size_t needed = arena_grow_needed(arena, required_size);
+	const size_t step   = arena->grow_policy.step;
+
+	if (needed <= arena->size)
+		return arena->size > SIZE_MAX - step ? SIZE_MAX : arena->size + step;
+
+	const size_t steps = (needed - arena->size + step - 1) / step;
+	if (steps > (SIZE_MAX - arena->size) / step)
+		return SIZE_MAX;
+	return arena->size + steps * step;
+}
+
+/**
+ * @brief
+ * Rounded policy function.
+ *
+ * @ingroup arena_grow_policy
+ */
+static size_t arena_grow_rounded(t_arena* arena, size_t required_size, void* context)
+{
+	(void) context;
+	const t_arena_grow_policy* policy   = &arena->grow_policy;
+	size_t                     new_size = arena_grow_scale(arena->size, policy->factor);
+	const size_t               needed   = arena_grow_needed(arena, required_size);
+
+	if (new_size < needed)
+		new_size = needed;
+	return arena_grow_round(new_size, policy->granularity);
+}
+
+/**
+ * @brief
+ * Adaptive policy function.
+ *
+ * @details
+ * `state` holds the allocation counter at the previous growth. Growing again
+ * within one window means the factor was too small for the workload; no
+ * growth for four windows means it can be more frugal.
+ *
+ * @ingroup arena_grow_policy
+ */
+static size_t arena_grow_adaptive(t_arena* arena, size_t required_size, void* context)
+{
+	(void) context;
+	t_arena_grow_policy* policy = &arena->grow_policy;
+	const size_t         since  = arena->stats.alloc_id_counter - policy->state;
+
+	if (arena->stats.growth_history_count > 0 && since < policy->step)
+	{
+		policy->factor *= 2.0;
+		if (policy->factor > ARENA_GROW_ADAPTIVE_MAX_FACTOR)
+			policy->factor = ARENA_GROW_ADAPTIVE_MAX_FACTOR;
+	}
+	else if (since / 4 >= policy->step)
+	{
+		policy->factor /= 2.0;
+		if (policy->factor < ARENA_GROW_ADAPTIVE_MIN_FACTOR)
+			policy->factor = ARENA_GROW_ADAPTIVE_MIN_FACTOR;
+	}
+	policy->state = arena->stats.alloc_id_counter;
+
+	const size_t new_size = arena_grow_scale(arena->size, policy->factor);
+	const size_t needed   = arena_grow_needed(arena, required_size);
+	return new_size > needed ? new_size : needed;
+}
+
+/**
+ * @brief
+ * Smallest size that fits `required_size` bytes past the offset.
+ *
+ * @ingroup arena_grow_policy
+ */
+static inline size_t arena_grow_needed(const t_arena* arena, size_t required_size)
+{
+	return required_size > SIZE_MAX - arena->offset ? SIZE_MAX : arena->offset + required_size;
+}
+
+/**
+ * @brief
+ * Multiply `size` by `factor`, saturating at `SIZE_MAX`.
+ *
+ * @ingroup arena_grow_policy
+ */
+static inline size_t arena_grow_scale(size_t size, double factor)
+{
+	const double scaled = (double) size * factor;
+	return scaled >= (double) SIZE_MAX ? SIZE_MAX : (size_t) scaled;
+}
+
+/**
+ * @brief
+ * Round `size` up to a multiple of `granularity`, saturating at `SIZE_MAX`.
+ *
+ * @ingroup arena_grow_policy
+ */
+static inline size_t arena_grow_round(size_t size, size_t granularity)
+{
+	const size_t rem = size % granularity;
+	if (rem == 0)
+		return size;
+	return size > SIZE_MAX - (granularity - rem) ? SIZE_MAX : size + (granularity - rem);
+}
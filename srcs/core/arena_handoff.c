@@ -0,0 +1,388 @@
+/**
+ * @file arena_handoff.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * memfd-backed arenas and their handoff across `execve()`.
+ *
+ * @details
+ * This file implements:
+ * - `arena_create_memfd()`: an arena whose buffer is a `MAP_SHARED` mapping
+ *   of an anonymous memfd. Growth extends the memfd and `mremap()`s the mapping.
+ * - `arena_handoff_prepare()`: serialize the descriptor, size, offset, and
+ *   address of a set of memfd arenas into a manifest memfd that is inherited
+ *   by the next process image.
+ * - `arena_handoff_adopt()`: in the new image, map the inherited regions again
+ *   and rebuild the arenas around them.
+ *
+ * The manifest is tiny (one header plus one entry per arena), so a handoff
+ * costs a few system calls per arena no matter how much memory they hold.
+ * Because the address space is empty right after `execve()`, regions are
+ * usually mapped back at their old addresses and internal pointers stay valid.
+ *
+ * @note
+ * All descriptors keep `FD_CLOEXEC` until `arena_handoff_prepare()` is called,
+ * so unrelated `exec` calls (e.g. `system()`) never leak arena memory.
+ *
+ * @ingroup arena_handoff
+ *
+ * @example
+ * @code
+ * #include "arena_handoff.h"
+ * #include <unistd.h>
+ *
+ * extern char** environ;
+ *
+ * int main(int argc, char** argv)
+ * {
+ *     t_arena* cache = NULL;
+ *
+ *     // Upgraded image: pick up the arena from the previous binary.
+ *     if (!arena_handoff_adopt(-1, &cache, 1))
+ *         cache = arena_create_memfd("cache", 1 << 20, true);
+ *
+ *     // ... serve requests, fill the cache ...
+ *
+ *     // Upgrade: hand the arena to the new binary without copying it.
+ *     if (arena_handoff_prepare(&cache, 1) >= 0)
+ *         execve("/usr/local/bin/server-v2", argv, environ);
+ *     return 1;
+ * }
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena_handoff.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline bool     arena_handoff_set_cloexec(int fd, bool enable);
+static inline int      arena_handoff_env_fd(void);
+static inline bool     arena_handoff_read_manifest(int fd, t_arena_handoff_manifest* header,
+                                                   t_arena_handoff_entry* entries, size_t max_entries);
+static inline t_arena* arena_handoff_adopt_entry(const t_arena_handoff_entry* entry);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Create an arena backed by an anonymous memfd region.
+ *
+ * @details
+ * The memfd is created with `MFD_CLOEXEC | MFD_ALLOW_SEALING`, sized with
+ * `ftruncate()` (pages are allocated lazily on first touch), and mapped with
+ * `MAP_SHARED`. The resulting arena behaves like any heap arena, except that:
+ * - growth and shrinking use `ftruncate()` + `mremap()` instead of `realloc()`;
+ * - the buffer can be handed to a new process image with `arena_handoff_prepare()`.
+ *
+ * @param name        Debug name of the memfd (defaults to `"arena"`).
+ * @param size        Buffer size in bytes.
+ * @param allow_grow  Whether the arena may grow.
+ *
+ * @return The new arena, or `NULL` on failure.
+ *
+ * @ingroup arena_handoff
+ *
+ * @see arena_handoff_prepare
+ * @see arena_delete
+ */
+t_arena* arena_create_memfd(const char* name, size_t size, bool allow_grow)
+{
+	if (size == 0 || size > ARENA_MAX_ALLOWED_SIZE)
+	{
+		arena_report_error(NULL, "arena_create_memfd failed: invalid size %zu", size);
+		return NULL;
+	}
+
+	int fd = memfd_create(name ? name : "arena", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (fd < 0)
+	{
+		arena_report_error(NULL, "arena_create_memfd failed: memfd_create failed");
+		return NULL;
+	}
+
+	const size_t map_len = arena_page_round(size);
+	void*        map     = ftruncate(fd, (off_t) map_len) == 0 ? arena_backing_map_shared(fd, map_len, NULL) : NULL;
+	if (!map)
+	{
+		arena_report_error(NULL, "arena_create_memfd failed: cannot map %zu bytes", map_len);
+		close(fd);
+		return NULL;
+	}
+
+	t_arena* arena =
+	    arena_backing_adopt(ARENA_BACKING_MEMFD, fd, map, map_len, 0, size, 0, 0, allow_grow, "arena_memfd");
+	if (!arena)
+	{
+		arena_report_error(NULL, "arena_create_memfd failed: arena allocation failed");
+		munmap(map, map_len);
+		close(fd);
+	}
+	return arena;
+}
+
+/**
+ * @brief
+ * Prepare a set of memfd arenas to be inherited by the next process image.
+ *
+ * @details
+ * For every arena, the descriptor, size, offset, and buffer address are read
+ * under the arena lock and appended to a manifest. The manifest is written to
+ * a new memfd (created without `MFD_CLOEXEC`), `FD_CLOEXEC` is cleared on all
+ * arena descriptors, and the manifest descriptor number is exported in the
+ * `ARENA_HANDOFF_ENV` environment variable for the new image to find.
+ *
+ * Call this immediately before `execve()`. If the exec fails, close the
+ * returned descriptor; the arenas remain usable in the current process.
+ *
+ * @param arenas Array of memfd arenas to hand off.
+ * @param count  Number of arenas (1 to `ARENA_HANDOFF_MAX_ARENAS`).
+ *
+ * @return The manifest descriptor, or `-1` on failure (nothing is exported).
+ *
+ * @ingroup arena_handoff
+ *
+ * @note
+ * `setenv()` is not thread-safe; prepare the handoff from the thread that
+ * performs the `execve()`.
+ *
+ * @see arena_handoff_adopt
+ */
+int arena_handoff_prepare(t_arena* const* arenas, size_t count)
+{
+	if (!arenas || count == 0 || count > ARENA_HANDOFF_MAX_ARENAS)
+	{
+		arena_report_error(NULL, "arena_handoff_prepare failed: invalid arena list (%zu)", count);
+		return -1;
+	}
+
+	t_arena_handoff_entry    entries[ARENA_HANDOFF_MAX_ARENAS];
+	t_arena_handoff_manifest header = {.version = ARENA_HANDOFF_VERSION, .count = (uint32_t) count};
+	memcpy(header.magic, ARENA_HANDOFF_MAGIC, sizeof(header.magic));
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		t_arena* arena = arenas[i];
+		if (!arena || arena->backing.kind != ARENA_BACKING_MEMFD)
+		{
+			arena_report_error(arena, "arena_handoff_prepare failed: arena %zu is not memfd-backed", i);
+			return -1;
+		}
+
+		ARENA_LOCK(arena);
+		entries[i].fd       = arena->backing.fd;
+		entries[i].can_grow = atomic_load_explicit(&arena->can_grow, memory_order_acquire);
+		entries[i].size     = arena->size;
+		entries[i].offset   = arena->offset;
+		entries[i].base     = (uint64_t) (uintptr_t) arena->buffer;
+		ARENA_UNLOCK(arena);
+	}
+
+	int fd = memfd_create("arena_handoff", 0);
+	if (fd < 0)
+	{
+		arena_report_error(NULL, "arena_handoff_prepare failed: memfd_create failed");
+		return -1;
+	}
+
+	const size_t body = count * sizeof(t_arena_handoff_entry);
+	bool         ok   = pwrite(fd, &header, sizeof(header), 0) == (ssize_t) sizeof(header) &&
+	          pwrite(fd, entries, body, sizeof(header)) == (ssize_t) body;
+
+	for (size_t i = 0; ok && i < count; ++i)
+		ok = arena_handoff_set_cloexec(entries[i].fd, false);
+
+	char value[16];
+	snprintf(value, sizeof(value), "%d", fd);
+	if (!ok || setenv(ARENA_HANDOFF_ENV, value, 1) != 0)
+	{
+		arena_report_error(NULL, "arena_handoff_prepare failed: cannot publish manifest");
+		for (size_t i = 0; i < count; ++i)
+			arena_handoff_set_cloexec(entries[i].fd, true);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/**
+ * @brief
+ * Adopt the arenas described by a handoff manifest.
+ *
+ * @details
+ * Reads and validates the manifest, then for every entry:
+ * - checks that the inherited memfd is large enough;
+ * - maps it with `MAP_SHARED`, preferring the address from the old image;
+ * - restores `FD_CLOEXEC` and wraps the mapping into a new heap-allocated arena
+ *   with the recorded offset (see `arena_persist_relocation()` for the address delta).
+ *
+ * The manifest descriptor is closed and `ARENA_HANDOFF_ENV` is removed once
+ * the manifest has been read, so a handoff is consumed exactly once.
+ *
+ * @param manifest_fd Manifest descriptor, or `-1` to use `ARENA_HANDOFF_ENV`.
+ * @param out         Array receiving adopted arenas; failed entries are set to `NULL`.
+ * @param max_arenas  Capacity of `out`; manifests with more entries are rejected.
+ *
+ * @return Number of arenas adopted (0 if there was no valid manifest).
+ *
+ * @ingroup arena_handoff
+ *
+ * @see arena_handoff_prepare
+ */
+size_t arena_handoff_adopt(int manifest_fd, t_arena** out, size_t max_arenas)
+{
+	if (!out || max_arenas == 0)
+		return 0;
+
+	if (manifest_fd < 0)
+		manifest_fd = arena_handoff_env_fd();
+	if (manifest_fd < 0)
+		return 0;
+
+	t_arena_handoff_manifest header;
+	t_arena_handoff_entry    entries[ARENA_HANDOFF_MAX_ARENAS];
+	const size_t             capacity = max_arenas < ARENA_HANDOFF_MAX_ARENAS ? max_arenas : ARENA_HANDOFF_MAX_ARENAS;
+	bool                     valid    = arena_handoff_read_manifest(manifest_fd, &header, entries, capacity);
+
+	close(manifest_fd);
+	unsetenv(ARENA_HANDOFF_ENV);
+	if (!valid)
+	{
+		arena_report_error(NULL, "arena_handoff_adopt failed: invalid manifest");
+		return 0;
+	}
+
+	size_t adopted = 0;
+	for (size_t i = 0; i < header.count; ++i)
+	{
+		out[i] = arena_handoff_adopt_entry(&entries[i]);
+		if (out[i])
+			adopted++;
+		else
+			arena_report_error(NULL, "arena_handoff_adopt: entry %zu (fd %d) could not be adopted", i,
+			                   entries[i].fd);
+	}
+	return adopted;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Set or clear `FD_CLOEXEC` on a descriptor.
+ *
+ * @param fd     Descriptor to update.
+ * @param enable Whether the descriptor should be closed on `execve()`.
+ *
+ * @return `true` on success, `false` if `fcntl()` failed.
+ *
+ * @ingroup arena_handoff
+ */
+static inline bool arena_handoff_set_cloexec(int fd, bool enable)
+{
+	int flags = fcntl(fd, F_GETFD);
+	if (flags < 0)
+		return false;
+
+	flags = enable ? (flags | FD_CLOEXEC) : (flags & ~FD_CLOEXEC);
+	return fcntl(fd, F_SETFD, flags) == 0;
+}
+
+/**
+ * @brief
+ * Read the manifest descriptor number from `ARENA_HANDOFF_ENV`.
+ *
+ * @return The descriptor, or `-1` if the variable is missing or malformed.
+ *
+ * @ingroup arena_handoff
+ */
+static inline int arena_handoff_env_fd(void)
+{
+	const char* value = getenv(ARENA_HANDOFF_ENV);
+	if (!value || !*value)
+		return -1;
+
+	char* end = NULL;
+	long  fd  = strtol(value, &end, 10);
+	if (*end != '\0' || fd < 0 || fd > INT32_MAX)
+		return -1;
+	return (int) fd;
+}
+
+/**
+ * @brief
+ * Read and validate a manifest header and its entries.
+ *
+ * @param fd          Manifest descriptor.
+ * @param header      Output header.
+ * @param entries     Output entries.
+ * @param max_entries Maximum number of entries accepted.
+ *
+ * @return `true` if the manifest is well-formed and fits in `max_entries`.
+ *
+ * @ingroup arena_handoff
+ */
+static inline bool arena_handoff_read_manifest(int fd, t_arena_handoff_manifest* header,
+                                               t_arena_handoff_entry* entries, size_t max_entries)
+{
+	if (pread(fd, header, sizeof(*header), 0) != (ssize_t) sizeof(*header))
+		return false;
+
+	if (memcmp(header->magic, ARENA_HANDOFF_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != ARENA_HANDOFF_VERSION || header->count == 0 || header->count > max_entries)
+		return false;
+
+	const size_t body = header->count * sizeof(t_arena_handoff_entry);
+	return pread(fd, entries, body, sizeof(*header)) == (ssize_t) body;
+}
+
+/**
+ * @brief
+ * Map one inherited memfd region and wrap it into an arena.
+ *
+ * @param entry Manifest entry describing the region.
+ *
+ * @return The adopted arena, or `NULL` if the region is unusable.
+ *
+ * @ingroup arena_handoff
+ */
+static inline t_arena* arena_handoff_adopt_entry(const t_arena_handoff_entry* entry)
+{
+	struct stat st;
+	if (entry->fd < 0 || fstat(entry->fd, &st) != 0)
+		return NULL;
+
+	if (entry->size == 0 || entry->offset > entry->size || (uint64_t) st.st_size < entry->size)
+		return NULL;
+
+	const size_t map_len = (size_t) st.st_size;
+	void*        map     = arena_backing_map_shared(entry->fd, map_len, (void*) (uintptr_t) entry->base);
+	if (!map)
+		return NULL;
+
+	arena_handoff_set_cloexec(entry->fd, true);
+
+	intptr_t relocation = (intptr_t) ((uintptr_t) map - (uintptr_t) entry->base);
+	t_arena* arena = arena_backing_adopt(ARENA_BACKING_MEMFD, entry->fd, map, map_len, 0, entry->size, entry->offset,
+	                                     relocation, entry->can_grow != 0, "arena_adopted");
+	if (!arena)
+		munmap(map, map_len);
+	return arena;
+}
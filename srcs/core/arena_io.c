@@ -13,6 +13,7 @@
  * Functions included:
  * - `arena_save_to_file()`: Save the current contents of an arena to a `.bin` file.
  * - `arena_load_from_file()`: Load previously saved contents into an arena buffer.
+ * - `arena_read_file()` / `arena_read_fd()`: Read raw input directly into arena memory.
  *
  * Features:
  * - Snapshot format includes a magic header and version check.
@@ -81,10 +82,49 @@
  * @endcode
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "arena_io.h"
 #include "arena_debug.h"
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief
+ * Arena block receiving the data of `arena_read_fd()`.
+ *
+ * @ingroup arena_io
+ */
+typedef struct s_arena_read_dest
+{
+	uint8_t*       data; ///< Start of the block.
+	size_t         cap;  ///< Size of the block in bytes.
+	t_arena_marker from; ///< Offset of the arena before the block was allocated.
+} t_arena_read_dest;
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline size_t       arena_read_full(int fd, uint8_t* dst, size_t len, off_t pos, bool positional, bool* failed);
+static inline size_t       arena_read_unlocked(t_arena* arena, int fd, t_arena_read_dest* dest, size_t done, size_t len,
+                                               off_t pos, bool positional, bool* failed);
+static inline bool         arena_read_is_last(const t_arena* arena, const t_arena_read_dest* dest);
+static inline bool         arena_read_resize(t_arena* arena, t_arena_read_dest* dest, size_t new_cap);
+static inline void         arena_read_discard(t_arena* arena, const t_arena_read_dest* dest);
+static inline t_arena_view arena_read_sized(t_arena* arena, int fd, off_t pos, size_t len, unsigned flags);
+static inline t_arena_view arena_read_stream(t_arena* arena, int fd, unsigned flags);
+
+/*
+ * PUBLIC API
+ */
 
 /**
  * @brief
@@ -104,6 +144,8 @@
  * 2. Raw buffer bytes up to the used offset.
  *
  * This function acquires the arena lock to ensure thread-safe access to the buffer.
+ * Guard pages after sub-arenas (see `arena_set_guard_pages()`) are made
+ * readable while the buffer is written out.
  *
  * @param arena Pointer to the arena to serialize.
  * @param path  Filesystem path to write the snapshot file.
@@ -169,16 +211,23 @@ bool arena_save_to_file(const t_arena* arena, const char* path)
 	ARENA_LOCK((t_arena*) arena);
 	size_t      used = arena->offset;
 	const void* buf  = arena->buffer;
+	arena_guard_protect((t_arena*) arena, PROT_READ);
+	ARENA_SAN_READ_BEGIN(arena, used);
 	ARENA_UNLOCK((t_arena*) arena);
 
 	t_arena_snapshot_header header = {.magic = ARENA_SNAPSHOT_MAGIC, .version = ARENA_SNAPSHOT_VERSION, .used = used};
 
-	FILE* f = fopen(path, "wb");
+	FILE* f  = fopen(path, "wb");
+	bool  ok = f && fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(buf, 1, used, f) == used;
+
+	ARENA_LOCK((t_arena*) arena);
+	ARENA_SAN_READ_END(arena, used);
+	arena_guard_protect((t_arena*) arena, PROT_NONE);
+	ARENA_UNLOCK((t_arena*) arena);
+
 	if (!f)
 		return false;
 
-	bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(buf, 1, used, f) == used;
-
 	fclose(f);
 	return ok;
 }
@@ -200,7 +249,8 @@ bool arena_save_to_file(const t_arena* arena, const char* path)
  * - Ownership check (only arenas that own their buffer can be restored).
  * - File open and header verification (magic string and version).
  * - Safe size checks to prevent buffer overflows.
- * - Memory restoration using `fread()`.
+ * - Memory restoration using `fread()`, after dropping the guard pages of
+ *   former sub-arenas (see `arena_set_guard_pages()`).
  * - `arena->offset` is updated only on success.
  *
  * @param arena Pointer to the `t_arena` structure to populate.
@@ -257,21 +307,403 @@ bool arena_load_from_file(t_arena* arena, const char* path)
 	if (!arena || !path)
 		return false;
 
-	if (!atomic_load_explicit(&arena->owns_buffer, memory_order_acquire))
+	if (!atomic_load_explicit(&arena->owns_buffer, memory_order_acquire) || ARENA_IS_FROZEN(arena))
 		return false;
 
 	FILE* f = fopen(path, "rb");
 	if (!f)
 		return false;
 
+	ARENA_LOCK(arena);
+	arena_guard_release(arena, 0);
+	ARENA_UNLOCK(arena);
+	ARENA_SAN_DETACH(arena);
 	t_arena_snapshot_header header;
 	bool ok = fread(&header, sizeof(header), 1, f) == 1 && strncmp(header.magic, ARENA_SNAPSHOT_MAGIC, 9) == 0 &&
 	          header.version == ARENA_SNAPSHOT_VERSION && header.used <= arena->size &&
 	          fread(arena->buffer, 1, header.used, f) == header.used;
 
 	if (ok)
+	{
+		arena_large_release(arena, 0);
 		arena->offset = header.used;
+		arena_update_peak(arena);
+		ARENA_POISON_CLIP(arena, arena->offset);
+	}
+	ARENA_SAN_ATTACH(arena);
 
 	fclose(f);
 	return ok;
 }
+
+/**
+ * @brief
+ * Read a whole file directly into arena memory.
+ *
+ * @details
+ * Opens `path` read-only and delegates to `arena_read_fd()`. The data lands in
+ * a single arena allocation labeled `"arena_read_file"`, so no intermediate
+ * `malloc()` buffer or copy is involved.
+ *
+ * @param arena Destination arena.
+ * @param path  Path of the file to read.
+ * @param flags Combination of `t_arena_read_flags`.
+ *
+ * @return A view over the file contents, or `{NULL, 0}` on failure.
+ *
+ * @ingroup arena_io
+ *
+ * @see arena_read_fd
+ *
+ * @example
+ * @code
+ * t_arena_view cfg = arena_read_file(arena, "config.json", ARENA_READ_NUL_TERMINATE);
+ * if (cfg.data)
+ *     parse_json((const char*) cfg.data, cfg.size);
+ * @endcode
+ */
+t_arena_view arena_read_file(t_arena* arena, const char* path, unsigned flags)
+{
+	t_arena_view view = {NULL, 0};
+	if (!arena || !path)
+	{
+		arena_report_error(arena, "arena_read_file failed: invalid arguments");
+		return view;
+	}
+
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		arena_report_error(arena, "arena_read_file failed: cannot open '%s'", path);
+		return view;
+	}
+
+	view = arena_read_fd(arena, fd, flags);
+	close(fd);
+	return view;
+}
+
+/**
+ * @brief
+ * Read all remaining input from a descriptor directly into arena memory.
+ *
+ * @details
+ * The strategy depends on what `fstat()` reports:
+ * - **Regular files with a known size**: one allocation of exactly the
+ *   remaining size is made, filled with large `pread()` calls, and the file
+ *   position is advanced past the data. Inputs of at least
+ *   `ARENA_READ_SEQUENTIAL_THRESHOLD` bytes are announced with
+ *   `posix_fadvise(POSIX_FADV_SEQUENTIAL)` so the kernel reads ahead aggressively.
+ * - **Streams and files of unknown size** (pipes, sockets, procfs): data is
+ *   read in `ARENA_READ_CHUNK_SIZE` steps into the last allocation of the
+ *   arena, which is extended in place with `arena_realloc_last()` (growing
+ *   the arena when allowed), then trimmed to the exact length. Above the
+ *   arena's large-object threshold the region has its own mapping, which
+ *   `arena_realloc_last()` remaps instead of growing the buffer.
+ *
+ * The destination is allocated under the arena lock, which is released
+ * around every blocking `read()` / `pread()` so that other threads can use
+ * the arena meanwhile. The destination is pinned while the lock is released
+ * (see `arena_io_pin()`): a growth by another thread cannot take the memory
+ * away from the kernel, and the data follows the buffer if it moved. When
+ * another allocation was made in between, a stream is extended by copying it
+ * into a new block instead of in place. On failure, the destination is
+ * released if it is still the last allocation of the arena.
+ *
+ * @param arena Destination arena.
+ * @param fd    Descriptor to read from (not closed).
+ * @param flags Combination of `t_arena_read_flags`.
+ *
+ * @return A view over the data, or `{NULL, 0}` on failure.
+ *
+ * @ingroup arena_io
+ *
+ * @note
+ * A file that shrinks while it is being read yields a shorter view; one that
+ * grows is read up to the size observed by `fstat()`.
+ *
+ * @see arena_read_file
+ */
+t_arena_view arena_read_fd(t_arena* arena, int fd, unsigned flags)
+{
+	t_arena_view view = {NULL, 0};
+	if (!arena || fd < 0)
+	{
+		arena_report_error(arena, "arena_read_fd failed: invalid arguments");
+		return view;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		arena_report_error(arena, "arena_read_fd failed: fstat failed");
+		return view;
+	}
+
+	off_t pos = S_ISREG(st.st_mode) ? lseek(fd, 0, SEEK_CUR) : -1;
+
+	ARENA_LOCK(arena);
+	if (pos >= 0 && st.st_size > pos)
+	{
+		const uint64_t len = (uint64_t) (st.st_size - pos);
+		if (len >= ARENA_MAX_ALLOWED_SIZE)
+			arena_report_error(arena, "arena_read_fd failed: input too large (%llu bytes)", (unsigned long long) len);
+		else
+			view = arena_read_sized(arena, fd, pos, (size_t) len, flags);
+	}
+	else
+		view = arena_read_stream(arena, fd, flags);
+	ARENA_UNLOCK(arena);
+	return view;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Read up to `len` bytes, retrying short reads and interrupted calls.
+ *
+ * @param fd         Descriptor to read from.
+ * @param dst        Destination buffer.
+ * @param len        Number of bytes wanted.
+ * @param pos        File offset for positional reads.
+ * @param positional Whether to use `pread()` at `pos` instead of `read()`.
+ * @param failed     Set to `true` if a read error occurred.
+ *
+ * @return Number of bytes read (less than `len` only at end of input or on error).
+ *
+ * @ingroup arena_io
+ */
+static inline size_t arena_read_full(int fd, uint8_t* dst, size_t len, off_t pos, bool positional, bool* failed)
+{
+	size_t done = 0;
+	while (done < len)
+	{
+		ssize_t n = positional ? pread(fd, dst + done, len - done, pos + (off_t) done) : read(fd, dst + done, len - done);
+		if (n > 0)
+			done += (size_t) n;
+		else if (n == 0)
+			break;
+		else if (errno != EINTR)
+		{
+			*failed = true;
+			break;
+		}
+	}
+	return done;
+}
+
+/**
+ * @brief
+ * Read into `dest` at `done` with the arena lock released.
+ *
+ * @details
+ * Called with the arena lock held. The whole block stays pinned until the
+ * lock is taken again, and `dest->data` is updated if the buffer moved.
+ *
+ * @return Number of bytes read (see `arena_read_full()`).
+ *
+ * @ingroup arena_io
+ */
+static inline size_t arena_read_unlocked(t_arena* arena, int fd, t_arena_read_dest* dest, size_t done, size_t len,
+                                         off_t pos, bool positional, bool* failed)
+{
+	t_arena_io_pin pin;
+	arena_io_pin(arena, &pin, dest->data, dest->cap, true);
+	ARENA_UNLOCK(arena);
+
+	size_t got = arena_read_full(fd, dest->data + done, len, pos, positional, failed);
+
+	ARENA_LOCK(arena);
+	dest->data = arena_io_unpin(arena, &pin);
+	return got;
+}
+
+/**
+ * @brief
+ * Whether nothing was allocated after the destination block.
+ *
+ * @ingroup arena_io
+ */
+static inline bool arena_read_is_last(const t_arena* arena, const t_arena_read_dest* dest)
+{
+	if (arena_large_is_last(arena, dest->data))
+		return true;
+
+	return dest->data == arena->buffer + (arena->offset - dest->cap);
+}
+
+/**
+ * @brief
+ * Resize the destination block to `new_cap` bytes.
+ *
+ * @details
+ * The last block is resized with `arena_realloc_last()`; a block followed by
+ * other allocations is copied into a new one when it grows, and left as is
+ * when it shrinks.
+ *
+ * @return `true` on success, `false` if the arena could not provide the memory.
+ *
+ * @ingroup arena_io
+ */
+static inline bool arena_read_resize(t_arena* arena, t_arena_read_dest* dest, size_t new_cap)
+{
+	t_arena_marker from = dest->from;
+	if (!arena_read_is_last(arena, dest))
+	{
+		if (new_cap <= dest->cap)
+			return true;
+		from = arena->offset;
+	}
+
+	uint8_t* data = arena_realloc_last(arena, dest->data, dest->cap, new_cap);
+	if (!data)
+		return false;
+
+	dest->data = data;
+	dest->cap  = new_cap;
+	dest->from = from;
+	return true;
+}
+
+/**
+ * @brief
+ * Roll the arena back over a failed read's destination, if it is still the last allocation.
+ *
+ * @ingroup arena_io
+ */
+static inline void arena_read_discard(t_arena* arena, const t_arena_read_dest* dest)
+{
+	if (arena_read_is_last(arena, dest))
+		arena_pop(arena, dest->from);
+}
+
+/**
+ * @brief
+ * Read `len` bytes of a regular file into one exact-size allocation.
+ *
+ * @ingroup arena_io
+ */
+static inline t_arena_view arena_read_sized(t_arena* arena, int fd, off_t pos, size_t len, unsigned flags)
+{
+	t_arena_view      view = {NULL, 0};
+	const size_t      nul  = (flags & ARENA_READ_NUL_TERMINATE) ? 1 : 0;
+	t_arena_read_dest dest = {NULL, len + nul, arena->offset};
+
+	dest.data = arena_alloc_labeled(arena, dest.cap, "arena_read_file");
+	if (!dest.data)
+		return view;
+
+	if (len >= ARENA_READ_SEQUENTIAL_THRESHOLD)
+		(void) posix_fadvise(fd, pos, (off_t) len, POSIX_FADV_SEQUENTIAL);
+
+	bool   failed = false;
+	size_t got    = arena_read_unlocked(arena, fd, &dest, 0, len, pos, true, &failed);
+	if (failed)
+	{
+		arena_report_error(arena, "arena_read_fd failed: read error after %zu of %zu bytes", got, len);
+		arena_read_discard(arena, &dest);
+		return view;
+	}
+
+	lseek(fd, pos + (off_t) got, SEEK_SET);
+	if (got < len && !arena_read_resize(arena, &dest, got + nul > 0 ? got + nul : 1))
+	{
+		arena_read_discard(arena, &dest);
+		return view;
+	}
+	if (nul)
+		dest.data[got] = '\0';
+
+	view.data = dest.data;
+	view.size = got;
+	return view;
+}
+
+/**
+ * @brief
+ * Read a stream of unknown length by extending the last allocation in place.
+ *
+ * @details
+ * Capacity doubles on each extension in growable arenas. Fixed-size arenas
+ * extend into whatever space remains (after the redzone that
+ * `ARENA_REDZONE_SIZE` puts in front of the region); once full, one extra
+ * byte is probed to tell a complete input from one that does not fit.
+ *
+ * @ingroup arena_io
+ */
+static inline t_arena_view arena_read_stream(t_arena* arena, int fd, unsigned flags)
+{
+	t_arena_view view     = {NULL, 0};
+	const size_t nul      = (flags & ARENA_READ_NUL_TERMINATE) ? 1 : 0;
+	const bool   can_grow = atomic_load_explicit(&arena->can_grow, memory_order_acquire);
+
+	t_arena_read_dest dest = {NULL, ARENA_READ_CHUNK_SIZE, arena->offset};
+	if (!can_grow)
+	{
+		size_t start = align_up(arena->offset + (arena->offset ? ARENA_REDZONE_SIZE : 0), ARENA_DEFAULT_ALIGNMENT);
+		if (start < arena->size && arena->size - start < dest.cap)
+			dest.cap = arena->size - start;
+	}
+
+	dest.data = arena_alloc_labeled(arena, dest.cap, "arena_read_file");
+	if (!dest.data)
+		return view;
+
+	size_t len    = 0;
+	bool   failed = false;
+	for (;;)
+	{
+		len += arena_read_unlocked(arena, fd, &dest, len, dest.cap - len, 0, false, &failed);
+		if (failed || len < dest.cap)
+			break;
+
+		size_t room    = arena->size - arena->offset;
+		size_t new_cap = can_grow ? dest.cap * 2 : dest.cap + room;
+		if (new_cap == dest.cap)
+		{
+			uint8_t probe;
+			ssize_t n;
+			ARENA_UNLOCK(arena);
+			while ((n = read(fd, &probe, 1)) < 0 && errno == EINTR)
+				;
+			ARENA_LOCK(arena);
+			if (n != 0)
+			{
+				arena_report_error(arena, "arena_read_fd failed: input does not fit in arena");
+				arena_read_discard(arena, &dest);
+				return view;
+			}
+			break;
+		}
+
+		if (!arena_read_resize(arena, &dest, new_cap))
+		{
+			arena_read_discard(arena, &dest);
+			return view;
+		}
+	}
+
+	if (failed)
+	{
+		arena_report_error(arena, "arena_read_fd failed: read error after %zu bytes", len);
+		arena_read_discard(arena, &dest);
+		return view;
+	}
+
+	// Trim the allocation to the data (plus terminator), keeping at least one byte.
+	size_t final_size = len + nul > 0 ? len + nul : 1;
+	if (final_size != dest.cap && !arena_read_resize(arena, &dest, final_size))
+	{
+		arena_read_discard(arena, &dest);
+		return view;
+	}
+	if (nul)
+		dest.data[len] = '\0';
+
+	view.data = dest.data;
+	view.size = len;
+	return view;
+}
@@ -0,0 +1,377 @@
+/**
+ * @file arena_persist.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Persistent arenas living in a `MAP_SHARED` file mapping.
+ *
+ * @details
+ * This file implements arenas whose buffer is a shared mapping of a regular
+ * file. The file layout is:
+ *
+ * ```
+ * [ t_arena_persist_header | padding ]  <- first page (header_len bytes)
+ * [ arena buffer (size bytes)        ]  <- page-aligned, mapped read/write
+ * ```
+ *
+ * Functions included:
+ * - `arena_open_persistent()`: create a new file or reopen an existing one in O(1).
+ * - `arena_sync()`: store the offset in the header and `msync()` the used range.
+ * - `arena_persist_relocation()`: report how far the buffer moved since the last session.
+ *
+ * Growth and shrinking go through the regular `arena_grow()` / `arena_shrink()`
+ * paths: the backing layer resizes the file with `ftruncate()` and the mapping
+ * with `mremap()`. `arena_destroy()` syncs the header and unmaps the file
+ * without poisoning it, so the data is there on the next open.
+ *
+ * This replaces the read-everything reload of `arena_load_from_file()` for
+ * large, long-lived arenas: reopening only maps the file, and pages are read
+ * lazily by the kernel when they are first touched.
+ *
+ * @note
+ * Pointers stored inside the arena remain valid across restarts only if the
+ * mapping lands at the same address. When it cannot, the arena is relocated
+ * and `arena_persist_relocation()` returns the delta to apply.
+ *
+ * @ingroup arena_persist
+ *
+ * @example
+ * @code
+ * #include "arena_persist.h"
+ * #include <stdio.h>
+ *
+ * typedef struct s_counter { unsigned long runs; } t_counter;
+ *
+ * int main(void)
+ * {
+ *     t_arena* arena = arena_open_persistent("state.arena", 1 << 20, true);
+ *     if (!arena)
+ *         return 1;
+ *
+ *     // First run: allocate the root object. Later runs: it is already there.
+ *     t_counter* counter = arena_used(arena) ? (t_counter*) arena->buffer
+ *                                            : arena_calloc(arena, 1, sizeof(t_counter));
+ *     counter->runs++;
+ *     printf("run #%lu\n", counter->runs);
+ *
+ *     arena_sync(arena);
+ *     arena_delete(&arena);
+ *     return 0;
+ * }
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena_persist.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline bool     arena_persist_format(int fd, size_t size, t_arena_persist_header* header);
+static inline bool     arena_persist_read_header(int fd, off_t file_size, t_arena_persist_header* header);
+static inline t_arena* arena_persist_attach(int fd, void* map, size_t map_len, const t_arena_persist_header* header,
+                                            bool fresh, bool allow_grow);
+static inline void     arena_persist_write_header(t_arena* arena);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Open or create a persistent arena backed by a file mapping.
+ *
+ * @details
+ * The function performs the following steps:
+ * - Opens (or creates) `path` and takes an exclusive `flock()` on it so two
+ *   arenas never map the same file at once.
+ * - If the file is empty, formats it: the first page receives a fresh header
+ *   and the file is extended to hold `size` bytes of arena data.
+ * - Otherwise, validates the stored header (magic, version, bounds).
+ * - Maps the file with `MAP_SHARED`, first at the address recorded in the
+ *   header, falling back to any address if that range is taken.
+ * - Builds a heap-allocated `t_arena` over the mapping and restores the
+ *   recorded offset.
+ *
+ * No arena data is read during the open; the cost is constant regardless of
+ * how much the arena holds.
+ *
+ * @param path        Path of the backing file.
+ * @param size        Arena buffer size when the file is created (ignored when reopening).
+ * @param allow_grow  Whether the arena may grow (the file is extended accordingly).
+ *
+ * @return Pointer to the persistent arena, or `NULL` on failure.
+ *
+ * @ingroup arena_persist
+ *
+ * @note
+ * Destroy the arena with `arena_delete()` (or `arena_destroy()` if you keep
+ * the struct); both sync the header and close the file.
+ *
+ * @see arena_sync
+ * @see arena_persist_relocation
+ */
+t_arena* arena_open_persistent(const char* path, size_t size, bool allow_grow)
+{
+	if (!path)
+	{
+		arena_report_error(NULL, "arena_open_persistent failed: NULL path");
+		return NULL;
+	}
+
+	int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (fd < 0)
+	{
+		arena_report_error(NULL, "arena_open_persistent failed: cannot open %s", path);
+		return NULL;
+	}
+
+	if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+	{
+		arena_report_error(NULL, "arena_open_persistent failed: %s is already in use", path);
+		close(fd);
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		arena_report_error(NULL, "arena_open_persistent failed: cannot stat %s", path);
+		close(fd);
+		return NULL;
+	}
+
+	t_arena_persist_header header;
+	const bool             fresh = st.st_size == 0;
+	bool ok = fresh ? arena_persist_format(fd, size, &header) : arena_persist_read_header(fd, st.st_size, &header);
+	if (!ok)
+	{
+		arena_report_error(NULL, "arena_open_persistent failed: invalid or unusable file %s", path);
+		close(fd);
+		return NULL;
+	}
+
+	const size_t map_len = arena_page_round(header.header_len + header.size);
+	void*        hint    = header.base ? (void*) (uintptr_t) (header.base - header.header_len) : NULL;
+	void*        map     = arena_backing_map_shared(fd, map_len, hint);
+	if (!map)
+	{
+		arena_report_error(NULL, "arena_open_persistent failed: mmap of %zu bytes failed", map_len);
+		close(fd);
+		return NULL;
+	}
+
+	t_arena* arena = arena_persist_attach(fd, map, map_len, &header, fresh, allow_grow);
+	if (!arena)
+	{
+		arena_report_error(NULL, "arena_open_persistent failed: arena allocation failed");
+		munmap(map, map_len);
+		close(fd);
+		return NULL;
+	}
+	return arena;
+}
+
+/**
+ * @brief
+ * Persist the arena offset and flush its dirty pages to the backing file.
+ *
+ * @details
+ * Under the arena lock, this function:
+ * - Writes the current size, offset, and buffer address into the header page.
+ * - Calls `msync(MS_SYNC)` on the header and the used part of the buffer.
+ *
+ * The kernel only writes back pages that were modified since the previous
+ * flush, so syncing an arena where little changed is cheap. Bytes beyond the
+ * offset are not flushed; they are free space.
+ *
+ * @param arena Persistent arena to synchronize.
+ *
+ * @return `true` if the data reached the file, `false` if the arena is not
+ *         persistent or `msync()` failed.
+ *
+ * @ingroup arena_persist
+ *
+ * @see arena_open_persistent
+ */
+bool arena_sync(t_arena* arena)
+{
+	if (!arena)
+		return false;
+
+	ARENA_LOCK(arena);
+
+	if (arena->backing.kind != ARENA_BACKING_FILE || !arena->buffer)
+	{
+		arena_report_error(arena, "arena_sync failed: arena is not file-backed");
+		ARENA_UNLOCK(arena);
+		return false;
+	}
+
+	arena_persist_write_header(arena);
+
+	const size_t len = arena_page_round(arena->backing.header_len + arena->offset);
+	const bool   ok  = msync(arena->backing.map_base, len, MS_SYNC) == 0;
+	if (!ok)
+		arena_report_error(arena, "arena_sync failed: msync of %zu bytes failed", len);
+
+	ARENA_UNLOCK(arena);
+	return ok;
+}
+
+/**
+ * @brief
+ * Report the address shift applied when a persistent arena was reopened.
+ *
+ * @param arena Persistent arena to inspect.
+ *
+ * @return `0` if the buffer is at its previous address (or for new files and
+ *         non-persistent arenas), otherwise the new base minus the old one.
+ *
+ * @ingroup arena_persist
+ */
+intptr_t arena_persist_relocation(const t_arena* arena)
+{
+	return arena ? arena->backing.relocation : 0;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Format an empty file as a persistent arena of `size` bytes.
+ *
+ * @details
+ * Extends the file with `ftruncate()` (the data pages stay sparse until they
+ * are written) and fills `header` with the initial values. The header itself
+ * is written through the mapping once it exists.
+ *
+ * @param fd     Descriptor of the empty file.
+ * @param size   Arena buffer size in bytes.
+ * @param header Output header.
+ *
+ * @return `true` on success, `false` if the size is invalid or the file cannot grow.
+ *
+ * @ingroup arena_persist
+ */
+static inline bool arena_persist_format(int fd, size_t size, t_arena_persist_header* header)
+{
+	const size_t header_len = arena_page_size();
+	if (size == 0 || size > ARENA_MAX_ALLOWED_SIZE)
+		return false;
+
+	const size_t file_len = arena_page_round(header_len + size);
+	if (file_len == 0 || ftruncate(fd, (off_t) file_len) != 0)
+		return false;
+
+	memset(header, 0, sizeof(*header));
+	memcpy(header->magic, ARENA_PERSIST_MAGIC, sizeof(header->magic));
+	header->version    = ARENA_PERSIST_VERSION;
+	header->header_len = (uint32_t) header_len;
+	header->size       = size;
+	return true;
+}
+
+/**
+ * @brief
+ * Read and validate the header of an existing persistent arena file.
+ *
+ * @details
+ * Rejects files whose magic or version do not match, whose header length is
+ * not a page multiple, whose offset exceeds the recorded size, or which are
+ * shorter than the header claims (mapping them would fault on access).
+ *
+ * @param fd        Descriptor of the file.
+ * @param file_size Current file size in bytes.
+ * @param header    Output header.
+ *
+ * @return `true` if the header describes a usable arena, `false` otherwise.
+ *
+ * @ingroup arena_persist
+ */
+static inline bool arena_persist_read_header(int fd, off_t file_size, t_arena_persist_header* header)
+{
+	if (pread(fd, header, sizeof(*header), 0) != (ssize_t) sizeof(*header))
+		return false;
+
+	if (memcmp(header->magic, ARENA_PERSIST_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != ARENA_PERSIST_VERSION)
+		return false;
+
+	const size_t page = arena_page_size();
+	if (header->header_len < sizeof(*header) || header->header_len % page != 0)
+		return false;
+
+	if (header->size == 0 || header->size > ARENA_MAX_ALLOWED_SIZE || header->offset > header->size)
+		return false;
+
+	return (uint64_t) file_size >= header->header_len + header->size;
+}
+
+/**
+ * @brief
+ * Build a heap-allocated arena over a persistent file mapping.
+ *
+ * @details
+ * Wraps the mapping with `arena_backing_adopt()`, restoring the stored offset
+ * and computing the relocation against the recorded buffer address, then
+ * rewrites the header page with the new buffer address.
+ *
+ * @param fd          Descriptor of the backing file (owned by the arena on success).
+ * @param map         Mapping of the whole file.
+ * @param map_len     Length of the mapping in bytes.
+ * @param header      Header read from (or prepared for) the file.
+ * @param fresh       Whether the file was just created.
+ * @param allow_grow  Whether the arena may grow.
+ *
+ * @return The new arena, or `NULL` if the struct could not be allocated.
+ *
+ * @ingroup arena_persist
+ */
+static inline t_arena* arena_persist_attach(int fd, void* map, size_t map_len, const t_arena_persist_header* header,
+                                            bool fresh, bool allow_grow)
+{
+	uint8_t* buffer     = (uint8_t*) map + header->header_len;
+	intptr_t relocation = fresh ? 0 : (intptr_t) ((uintptr_t) buffer - (uintptr_t) header->base);
+
+	t_arena* arena = arena_backing_adopt(ARENA_BACKING_FILE, fd, map, map_len, header->header_len, header->size,
+	                                     header->offset, relocation, allow_grow, "arena_persistent");
+	if (!arena)
+		return NULL;
+
+	ARENA_LOCK(arena);
+	memcpy(map, header, sizeof(*header));
+	arena_persist_write_header(arena);
+	ARENA_UNLOCK(arena);
+	return arena;
+}
+
+/**
+ * @brief
+ * Copy the live arena state into the header page of the mapping.
+ *
+ * @param arena Persistent arena (lock held by the caller).
+ *
+ * @ingroup arena_persist
+ */
+static inline void arena_persist_write_header(t_arena* arena)
+{
+	t_arena_persist_header* header = (t_arena_persist_header*) arena->backing.map_base;
+
+	header->size   = arena->size;
+	header->offset = arena->offset;
+	header->base   = (uint64_t) (uintptr_t) arena->buffer;
+}
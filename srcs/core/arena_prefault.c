@@ -0,0 +1,244 @@
+/**
+ * @file arena_prefault.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Prefaulting and memory locking of arena buffers.
+ *
+ * @details
+ * Pages are populated with `MADV_POPULATE_WRITE` (Linux 5.14+), which faults
+ * them in writable without changing their contents. On older kernels each
+ * page past the arena's offset is read and written back instead, as the
+ * pre-growth worker does; bytes below the offset belong to live allocations
+ * and are never written.
+ *
+ * Large ranges are split into page-aligned slices populated by short-lived
+ * threads while the caller holds the arena lock, so nothing moves the buffer
+ * in the meantime.
+ *
+ * `arena_prefault_pin()` and `arena_prefault_unpin()` are called around every
+ * resize of an arena created with `ARENA_CREATE_*` flags: the old buffer is
+ * unlocked before `realloc()` or `mremap()` may release it, and the new one is
+ * locked and its new pages prefaulted afterwards.
+ *
+ * @ingroup arena_prefault
+ */
+
+#include "arena.h"
+#include "arena_prefault.h"
+#include <sys/mman.h>
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+/**
+ * @brief
+ * Slice of a range populated by one thread.
+ *
+ * @ingroup arena_prefault_internal
+ */
+typedef struct s_arena_prefault_slice
+{
+	uint8_t* start;      ///< First byte to populate.
+	uint8_t* end;        ///< One past the last byte.
+	uint8_t* touch_from; ///< First byte the touch fallback may write.
+} t_arena_prefault_slice;
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static void  arena_prefault_run(uint8_t* start, uint8_t* end, uint8_t* touch_from);
+static void* arena_prefault_slice(void* arg);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * `arena_create()` with the buffer prefaulted and/or locked.
+ *
+ * @ingroup arena_prefault
+ *
+ * @see arena_prefault_range
+ */
+t_arena* arena_create_with_flags(size_t size, bool allow_grow, unsigned flags)
+{
+	t_arena* arena = arena_create(size, allow_grow);
+	if (!arena)
+		return NULL;
+
+	ARENA_LOCK(arena);
+	arena->create_flags = flags & (ARENA_CREATE_PREFAULT | ARENA_CREATE_MLOCK);
+	bool ok             = arena_prefault_pin(arena, 0);
+	ARENA_UNLOCK(arena);
+
+	if (!ok)
+		arena_delete(&arena);
+	return arena;
+}
+
+/**
+ * @brief
+ * Fault in the pages of `[offset, offset + len)` of the buffer.
+ *
+ * @ingroup arena_prefault
+ */
+bool arena_prefault_range(t_arena* arena, size_t offset, size_t len)
+{
+	if (!arena || ARENA_IS_FROZEN(arena))
+		return false;
+
+	ARENA_LOCK(arena);
+	if (!arena->buffer)
+	{
+		ARENA_UNLOCK(arena);
+		return arena_report_error(arena, "arena_prefault_range failed: no buffer"), false;
+	}
+
+	size_t end = len > arena->size - offset || offset > arena->size ? arena->size : offset + len;
+	if (offset < end)
+	{
+		size_t touch_from = offset > arena->offset ? offset : arena->offset;
+		arena_prefault_run(arena->buffer + offset, arena->buffer + end, arena->buffer + touch_from);
+	}
+	ARENA_UNLOCK(arena);
+	return true;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Apply the arena's `ARENA_CREATE_*` flags to its buffer.
+ *
+ * @details
+ * Called with the arena lock held after the buffer was created or resized.
+ * Locks the whole buffer (which also faults it in) or prefaults
+ * `[from, size)`. Does nothing for arenas created without flags.
+ *
+ * @return `false` if the buffer could not be locked.
+ *
+ * @ingroup arena_prefault_internal
+ */
+bool arena_prefault_pin(t_arena* arena, size_t from)
+{
+	if (!arena->create_flags || !arena->buffer)
+		return true;
+
+	if (arena->create_flags & ARENA_CREATE_MLOCK)
+	{
+		if (mlock(arena->buffer, arena->size) == 0)
+			return true;
+		arena_report_error(arena, "arena_prefault_pin failed: mlock of %zu bytes refused", arena->size);
+		from = 0;
+	}
+
+	if (from < arena->size)
+	{
+		size_t touch_from = from > arena->offset ? from : arena->offset;
+		arena_prefault_run(arena->buffer + from, arena->buffer + arena->size, arena->buffer + touch_from);
+	}
+	return !(arena->create_flags & ARENA_CREATE_MLOCK);
+}
+
+/**
+ * @brief
+ * Unlock the buffer of an `ARENA_CREATE_MLOCK` arena before it is resized or released.
+ *
+ * @ingroup arena_prefault_internal
+ */
+void arena_prefault_unpin(t_arena* arena)
+{
+	if ((arena->create_flags & ARENA_CREATE_MLOCK) && arena->buffer)
+		munlock(arena->buffer, arena->size);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Populate `[start, end)`, split between threads when it is large.
+ *
+ * @details
+ * Slices are page-aligned so no two threads touch the same page. Slices whose
+ * thread cannot be started are populated by the caller. The free bytes from
+ * `touch_from` are opened to memory checkers while the fallback touches them.
+ *
+ * @ingroup arena_prefault_internal
+ */
+static void arena_prefault_run(uint8_t* start, uint8_t* end, uint8_t* touch_from)
+{
+	t_arena_prefault_slice slices[ARENA_PREFAULT_MAX_THREADS];
+	size_t                 count = 1;
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	if ((size_t) (end - start) >= ARENA_PREFAULT_PARALLEL_MIN)
+		count = ARENA_PREFAULT_MAX_THREADS;
+#endif
+
+	const size_t page  = arena_page_size();
+	const size_t slice = align_up((size_t) (end - start) / count, page);
+	uint8_t*     at    = start;
+	size_t       used  = 0;
+	for (; used < count && at < end; ++used)
+	{
+		uint8_t* next = used + 1 == count || slice > (size_t) (end - at) ? end : at + slice;
+		slices[used]  = (t_arena_prefault_slice) {at, next, touch_from};
+		at            = next;
+	}
+	if (touch_from < end)
+		ARENA_SAN_OPEN(touch_from, (size_t) (end - touch_from));
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	pthread_t threads[ARENA_PREFAULT_MAX_THREADS];
+	bool      started[ARENA_PREFAULT_MAX_THREADS] = {false};
+	for (size_t i = 1; i < used; ++i)
+		started[i] = pthread_create(&threads[i], NULL, arena_prefault_slice, &slices[i]) == 0;
+	arena_prefault_slice(&slices[0]);
+	for (size_t i = 1; i < used; ++i)
+	{
+		if (started[i])
+			pthread_join(threads[i], NULL);
+		else
+			arena_prefault_slice(&slices[i]);
+	}
+#else
+	for (size_t i = 0; i < used; ++i)
+		arena_prefault_slice(&slices[i]);
+#endif
+	if (touch_from < end)
+		ARENA_SAN_CLOSE(touch_from, (size_t) (end - touch_from));
+}
+
+/**
+ * @brief
+ * Populate one slice: `MADV_POPULATE_WRITE`, or touch its free pages.
+ *
+ * @ingroup arena_prefault_internal
+ */
+static void* arena_prefault_slice(void* arg)
+{
+	const t_arena_prefault_slice* slice = arg;
+	const size_t                  page  = arena_page_size();
+	uint8_t*                      base  = (uint8_t*) ((uintptr_t) slice->start & ~(uintptr_t) (page - 1));
+
+	if (madvise(base, (size_t) (slice->end - base), MADV_POPULATE_WRITE) == 0)
+		return NULL;
+
+	uint8_t* byte = slice->start > slice->touch_from ? slice->start : slice->touch_from;
+	while (byte < slice->end)
+	{
+		volatile uint8_t* touch = byte;
+		*touch                  = *touch;
+		byte = (uint8_t*) (((uintptr_t) byte + page) & ~(uintptr_t) (page - 1));
+	}
+	return NULL;
+}
@@ -0,0 +1,435 @@
+/**
+ * @file arena_pregrow.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Background pre-growth worker for watched arenas.
+ *
+ * @details
+ * A single worker thread sleeps on a condition variable until an allocation
+ * pushes a watched arena past its high-water mark. `ARENA_PREGROW_CHECK()`
+ * (run with the arena lock held, right after the offset advanced) then sets the
+ * arena's `pregrow_pending` flag and signals the worker, at most once until the
+ * worker picks the request up.
+ *
+ * The worker grows the arena through `arena_grow_in_place()`, asking for one
+ * byte more than the space left so the growth callback returns its usual next
+ * size, then faults the new pages in `ARENA_PREGROW_FAULT_CHUNK` slices,
+ * releasing the lock between slices and only touching bytes past the current
+ * offset. The worker never moves the buffer, since the allocating threads hold
+ * pointers into it without the lock: it only commits the address space that
+ * the last inline growth reserved behind the buffer (see
+ * `ARENA_PREGROW_RESERVE_FACTOR`). If a growth is not possible that way, or
+ * fails (size limit, out of memory), the arena records the size in
+ * `pregrow_stalled` and is not retried until its size changes; the next
+ * growth then happens inline, on the allocating thread.
+ *
+ * Locking order is arena lock, then worker lock: the worker never holds its own
+ * lock while taking an arena lock, and `arena_pregrow_unwatch()` waits for the
+ * worker to leave the arena before returning, so a destroyed arena is never
+ * touched.
+ *
+ * @ingroup arena_pregrow
+ */
+
+#include "arena.h"
+#include "arena_pregrow.h"
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+/**
+ * @brief
+ * State of the pre-growth worker, shared by every watched arena.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+typedef struct s_arena_pregrow
+{
+	pthread_mutex_t control; ///< Serializes watch/unwatch and worker start/stop.
+	pthread_mutex_t lock;    ///< Guards the fields below.
+	pthread_cond_t  wake;    ///< Signaled when a request is queued or on stop.
+	pthread_cond_t  idle;    ///< Broadcast when the worker leaves an arena.
+	pthread_t       thread;  ///< Worker thread, valid while `running`.
+	bool            running; ///< Whether the worker thread exists.
+	bool            stop;    ///< Asks the worker to exit.
+	t_arena*        busy;    ///< Arena the worker is currently growing.
+	size_t          count;   ///< Number of watched arenas.
+	t_arena*        arenas[ARENA_PREGROW_MAX_ARENAS]; ///< Watched arenas.
+} t_arena_pregrow;
+
+static t_arena_pregrow g_pregrow = {
+    .control = PTHREAD_MUTEX_INITIALIZER,
+    .lock    = PTHREAD_MUTEX_INITIALIZER,
+    .wake    = PTHREAD_COND_INITIALIZER,
+    .idle    = PTHREAD_COND_INITIALIZER,
+};
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static void*           arena_pregrow_worker(void* unused);
+static inline long     arena_pregrow_index(const t_arena* arena);
+static inline bool     arena_pregrow_add(t_arena* arena);
+static inline t_arena* arena_pregrow_next(void);
+static inline bool     arena_pregrow_due(const t_arena* arena);
+static inline void     arena_pregrow_service(t_arena* arena);
+static inline void     arena_pregrow_fault_in(t_arena* arena, size_t from);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Start growing `arena` in the background once it is `high_water_percent` full.
+ *
+ * @details
+ * Registers the arena with the worker (starting it if needed) and sets the
+ * high-water mark checked by the allocation path. Calling it again on a
+ * watched arena only updates the mark.
+ *
+ * The buffer is not moved here. Until an inline growth has placed it in a
+ * reservation, the worker can only extend mappings that happen to have free
+ * address space behind them.
+ *
+ * @param arena              Growable, lock-protected arena to watch.
+ * @param high_water_percent Usage (1-99) that triggers a pre-growth, or `0`
+ *                           for `ARENA_PREGROW_DEFAULT_PERCENT`.
+ *
+ * @return `true` if the arena is watched, `false` otherwise.
+ *
+ * @ingroup arena_pregrow
+ *
+ * @see arena_pregrow_unwatch
+ */
+bool arena_pregrow_watch(t_arena* arena, unsigned high_water_percent)
+{
+	if (!arena || high_water_percent > 99)
+		return arena_report_error(arena, "arena_pregrow_watch failed: invalid arguments"), false;
+	if (!arena->use_lock)
+		return arena_report_error(arena, "arena_pregrow_watch failed: arena has no lock"), false;
+	if (!atomic_load(&arena->can_grow) || !atomic_load(&arena->owns_buffer))
+		return arena_report_error(arena, "arena_pregrow_watch failed: arena cannot grow"), false;
+
+	if (high_water_percent == 0)
+		high_water_percent = ARENA_PREGROW_DEFAULT_PERCENT;
+
+	pthread_mutex_lock(&g_pregrow.control);
+	bool ok = arena_pregrow_index(arena) >= 0 || arena_pregrow_add(arena);
+	if (ok)
+	{
+		ARENA_LOCK(arena);
+		arena->pregrow_percent = high_water_percent;
+		arena->pregrow_stalled = 0;
+		ARENA_PREGROW_CHECK(arena);
+		ARENA_UNLOCK(arena);
+	}
+	pthread_mutex_unlock(&g_pregrow.control);
+	return ok;
+}
+
+/**
+ * @brief
+ * Stop pre-growing `arena`.
+ *
+ * @details
+ * Removes the arena from the worker, waits until the worker is not growing it
+ * anymore, and joins the worker when no watched arena is left. Called by
+ * `arena_destroy()`; must not be called with the arena lock held.
+ *
+ * @param arena Arena to unwatch; ignored if it is not watched.
+ *
+ * @ingroup arena_pregrow
+ *
+ * @see arena_pregrow_watch
+ */
+void arena_pregrow_unwatch(t_arena* arena)
+{
+	if (!arena || !arena->use_lock || !arena_pregrow_is_watched(arena))
+		return;
+
+	pthread_mutex_lock(&g_pregrow.control);
+	pthread_mutex_lock(&g_pregrow.lock);
+	long index = arena_pregrow_index(arena);
+	if (index >= 0)
+		g_pregrow.arenas[index] = g_pregrow.arenas[--g_pregrow.count];
+	while (g_pregrow.busy == arena)
+		pthread_cond_wait(&g_pregrow.idle, &g_pregrow.lock);
+
+	bool last = index >= 0 && g_pregrow.count == 0;
+	if (last)
+	{
+		g_pregrow.stop = true;
+		pthread_cond_signal(&g_pregrow.wake);
+	}
+	pthread_mutex_unlock(&g_pregrow.lock);
+
+	if (last)
+	{
+		pthread_join(g_pregrow.thread, NULL);
+		g_pregrow.running = false;
+		g_pregrow.stop    = false;
+	}
+
+	ARENA_LOCK(arena);
+	arena->pregrow_percent = 0;
+	atomic_store(&arena->pregrow_pending, false);
+	ARENA_UNLOCK(arena);
+	pthread_mutex_unlock(&g_pregrow.control);
+}
+
+/**
+ * @brief
+ * Check whether `arena` is watched by the pre-growth worker.
+ *
+ * @ingroup arena_pregrow
+ */
+bool arena_pregrow_is_watched(t_arena* arena)
+{
+	if (!arena)
+		return false;
+
+	ARENA_LOCK(arena);
+	bool watched = arena->pregrow_percent != 0;
+	ARENA_UNLOCK(arena);
+	return watched;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Queue a pre-growth of a watched arena that passed its high-water mark.
+ *
+ * @details
+ * Called with the arena lock held. Only the first call after the worker
+ * picked up the previous request takes the worker lock; the following ones
+ * return after reading the pending flag.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+void arena_pregrow_notify(t_arena* arena)
+{
+	if (arena->pregrow_stalled == arena->size || atomic_load(&arena->pregrow_pending))
+		return;
+	if (atomic_exchange(&arena->pregrow_pending, true))
+		return;
+
+	pthread_mutex_lock(&g_pregrow.lock);
+	pthread_cond_signal(&g_pregrow.wake);
+	pthread_mutex_unlock(&g_pregrow.lock);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Worker loop: grow arenas with a pending request until asked to stop.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+static void* arena_pregrow_worker(void* unused)
+{
+	(void) unused;
+
+	pthread_mutex_lock(&g_pregrow.lock);
+	while (!g_pregrow.stop)
+	{
+		t_arena* arena = arena_pregrow_next();
+		if (!arena)
+		{
+			pthread_cond_wait(&g_pregrow.wake, &g_pregrow.lock);
+			continue;
+		}
+
+		g_pregrow.busy = arena;
+		pthread_mutex_unlock(&g_pregrow.lock);
+		arena_pregrow_service(arena);
+		pthread_mutex_lock(&g_pregrow.lock);
+		g_pregrow.busy = NULL;
+		pthread_cond_broadcast(&g_pregrow.idle);
+	}
+	pthread_mutex_unlock(&g_pregrow.lock);
+	return NULL;
+}
+
+/**
+ * @brief
+ * Return the registry slot of `arena`, or `-1` if it is not watched.
+ *
+ * @details
+ * Called with `control` or the worker lock held.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+static inline long arena_pregrow_index(const t_arena* arena)
+{
+	for (size_t i = 0; i < g_pregrow.count; ++i)
+		if (g_pregrow.arenas[i] == arena)
+			return (long) i;
+	return -1;
+}
+
+/**
+ * @brief
+ * Register `arena` with the worker, starting the worker thread if needed.
+ *
+ * @details
+ * Called with `control` held.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+static inline bool arena_pregrow_add(t_arena* arena)
+{
+	if (g_pregrow.count == ARENA_PREGROW_MAX_ARENAS)
+		return arena_report_error(arena, "arena_pregrow_watch failed: too many watched arenas"), false;
+
+	if (!g_pregrow.running)
+	{
+		if (pthread_create(&g_pregrow.thread, NULL, arena_pregrow_worker, NULL) != 0)
+			return arena_report_error(arena, "arena_pregrow_watch failed: cannot start worker"), false;
+		g_pregrow.running = true;
+	}
+
+	pthread_mutex_lock(&g_pregrow.lock);
+	g_pregrow.arenas[g_pregrow.count++] = arena;
+	pthread_mutex_unlock(&g_pregrow.lock);
+	return true;
+}
+
+/**
+ * @brief
+ * Pick a watched arena with a pending request.
+ *
+ * @details
+ * Called by the worker with its lock held.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+static inline t_arena* arena_pregrow_next(void)
+{
+	for (size_t i = 0; i < g_pregrow.count; ++i)
+		if (atomic_load(&g_pregrow.arenas[i]->pregrow_pending))
+			return g_pregrow.arenas[i];
+	return NULL;
+}
+
+/**
+ * @brief
+ * Check whether a watched arena still needs a pre-growth.
+ *
+ * @details
+ * Called with the arena lock held. The request may be stale: an allocation
+ * failure, a reset, a shrink or an inline growth can all happen between the
+ * notification and the worker getting the lock.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+static inline bool arena_pregrow_due(const t_arena* arena)
+{
+	return arena->pregrow_percent && arena->offset >= arena->size / 100 * arena->pregrow_percent &&
+	       arena->pregrow_stalled != arena->size && !atomic_load(&arena->is_destroying) && !ARENA_IS_FROZEN(arena) &&
+	       atomic_load(&arena->can_grow) && atomic_load(&arena->owns_buffer);
+}
+
+/**
+ * @brief
+ * Grow one arena ahead of need and fault in its new pages.
+ *
+ * @details
+ * Asking `arena_grow_in_place()` for one byte more than the remaining space
+ * yields the next size of the arena's growth callback (a doubling with the
+ * default one). The buffer does not move, so threads that use it without the
+ * lock are not affected.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+static inline void arena_pregrow_service(t_arena* arena)
+{
+	atomic_store(&arena->pregrow_pending, false);
+
+	ARENA_LOCK(arena);
+	size_t old_size = arena->size;
+	bool   grown    = false;
+	if (arena_pregrow_due(arena))
+	{
+		grown = arena_grow_in_place(arena, arena->size - arena->offset + 1);
+		if (grown)
+			arena->stats.background_grows++;
+		else
+			arena->pregrow_stalled = arena->size;
+	}
+	ARENA_UNLOCK(arena);
+
+	if (grown)
+		arena_pregrow_fault_in(arena, old_size);
+}
+
+/**
+ * @brief
+ * Fault in the pages of `[from, size)` that are still free.
+ *
+ * @details
+ * Each page is read and written back under the lock, one
+ * `ARENA_PREGROW_FAULT_CHUNK` slice at a time, so allocations can proceed
+ * between slices. Bytes below the current offset belong to allocations and are
+ * skipped; the contents of the others are left as they are.
+ *
+ * @ingroup arena_pregrow_internal
+ */
+static inline void arena_pregrow_fault_in(t_arena* arena, size_t from)
+{
+	const size_t page = arena_page_size();
+
+	for (size_t at = from;; at += ARENA_PREGROW_FAULT_CHUNK)
+	{
+		ARENA_LOCK(arena);
+		if (at >= arena->size || atomic_load(&arena->is_destroying) || ARENA_IS_FROZEN(arena))
+		{
+			ARENA_UNLOCK(arena);
+			return;
+		}
+
+		size_t end = at + ARENA_PREGROW_FAULT_CHUNK;
+		if (end > arena->size || end < at)
+			end = arena->size;
+		const size_t first = at > arena->offset ? at : arena->offset;
+		if (first < end)
+			ARENA_SAN_OPEN(arena->buffer + first, end - first);
+		for (size_t i = first; i < end; i += page)
+		{
+			volatile uint8_t* byte = arena->buffer + i;
+			*byte                  = *byte;
+		}
+		if (first < end)
+			ARENA_SAN_CLOSE(arena->buffer + first, end - first);
+		ARENA_UNLOCK(arena);
+	}
+}
+
+#else
+
+bool arena_pregrow_watch(t_arena* arena, unsigned high_water_percent)
+{
+	(void) high_water_percent;
+	return arena_report_error(arena, "arena_pregrow_watch failed: built without ARENA_ENABLE_THREAD_SAFE"), false;
+}
+
+void arena_pregrow_unwatch(t_arena* arena)
+{
+	(void) arena;
+}
+
+bool arena_pregrow_is_watched(t_arena* arena)
+{
+	(void) arena;
+	return false;
+}
+
+#endif
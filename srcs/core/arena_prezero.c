@@ -0,0 +1,405 @@
+/**
+ * @file arena_prezero.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Clean-memory watermark helpers and the background pre-zeroing worker.
+ *
+ * @details
+ * `clean_from` only moves down when memory is known to become zero (a slice
+ * zeroed here, pages decommitted, a buffer shrunk) and up when something may
+ * write below it: an allocation (`arena_update_peak()`), a poisoning reset or
+ * a heap buffer grown by `realloc()`. It never drops below the offset, so the
+ * worker never clears a live allocation.
+ *
+ * `arena_reset()` calls `arena_prezero_notify()` with the arena lock held. It
+ * sets the arena's `prezero_pending` flag and signals the worker, which lowers
+ * its own priority to `SCHED_IDLE` when it starts. The worker clears the flag
+ * before it zeroes, so a reset during the pass queues another one.
+ *
+ * Locking order and unregistration follow the pre-growth worker: the worker
+ * never holds its lock while taking an arena lock, and
+ * `arena_prezero_unwatch()` waits until the worker left the arena.
+ *
+ * @ingroup arena_prezero
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena.h"
+#include "arena_fill.h"
+#include "arena_prezero.h"
+#include <sched.h>
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Bytes of `arena` known to be zero (from `clean_from` to the end).
+ *
+ * @ingroup arena_prezero
+ */
+size_t arena_clean_bytes(t_arena* arena)
+{
+	if (!arena)
+		return 0;
+
+	ARENA_LOCK(arena);
+	size_t clean = arena->size - arena->clean_from;
+	ARENA_UNLOCK(arena);
+	return clean;
+}
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+/**
+ * @brief
+ * State of the pre-zeroing worker, shared by every watched arena.
+ *
+ * @ingroup arena_prezero_internal
+ */
+typedef struct s_arena_prezero
+{
+	pthread_mutex_t control; ///< Serializes watch/unwatch and worker start/stop.
+	pthread_mutex_t lock;    ///< Guards the fields below.
+	pthread_cond_t  wake;    ///< Signaled when a request is queued or on stop.
+	pthread_cond_t  idle;    ///< Broadcast when the worker leaves an arena.
+	pthread_t       thread;  ///< Worker thread, valid while `running`.
+	bool            running; ///< Whether the worker thread exists.
+	bool            stop;    ///< Asks the worker to exit.
+	t_arena*        busy;    ///< Arena the worker is currently zeroing.
+	size_t          count;   ///< Number of watched arenas.
+	t_arena*        arenas[ARENA_PREZERO_MAX_ARENAS]; ///< Watched arenas.
+} t_arena_prezero;
+
+static t_arena_prezero g_prezero = {
+    .control = PTHREAD_MUTEX_INITIALIZER,
+    .lock    = PTHREAD_MUTEX_INITIALIZER,
+    .wake    = PTHREAD_COND_INITIALIZER,
+    .idle    = PTHREAD_COND_INITIALIZER,
+};
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static void*           arena_prezero_worker(void* unused);
+static inline long     arena_prezero_index(const t_arena* arena);
+static inline bool     arena_prezero_add(t_arena* arena);
+static inline t_arena* arena_prezero_next(void);
+static inline void     arena_prezero_service(t_arena* arena);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Zero the dirty memory of `arena` in the background after each reset.
+ *
+ * @details
+ * Registers the arena (starting the worker if needed) and queues a first pass
+ * right away, so memory dirtied before watching is cleaned too.
+ *
+ * @ingroup arena_prezero
+ *
+ * @see arena_prezero_unwatch
+ */
+bool arena_prezero_watch(t_arena* arena)
+{
+	if (!arena)
+		return arena_report_error(NULL, "arena_prezero_watch failed: NULL arena"), false;
+	if (!arena->use_lock)
+		return arena_report_error(arena, "arena_prezero_watch failed: arena has no lock"), false;
+
+	pthread_mutex_lock(&g_prezero.control);
+	bool ok = arena_prezero_index(arena) >= 0 || arena_prezero_add(arena);
+	if (ok)
+	{
+		ARENA_LOCK(arena);
+		arena->prezero_watched = true;
+		arena_prezero_notify(arena);
+		ARENA_UNLOCK(arena);
+	}
+	pthread_mutex_unlock(&g_prezero.control);
+	return ok;
+}
+
+/**
+ * @brief
+ * Stop pre-zeroing `arena`; waits if the worker is zeroing it.
+ *
+ * @details
+ * Joins the worker when no watched arena is left. Called by `arena_destroy()`.
+ *
+ * @ingroup arena_prezero
+ */
+void arena_prezero_unwatch(t_arena* arena)
+{
+	if (!arena || !arena->use_lock)
+		return;
+
+	ARENA_LOCK(arena);
+	bool watched = arena->prezero_watched;
+	ARENA_UNLOCK(arena);
+	if (!watched)
+		return;
+
+	pthread_mutex_lock(&g_prezero.control);
+	pthread_mutex_lock(&g_prezero.lock);
+	long index = arena_prezero_index(arena);
+	if (index >= 0)
+		g_prezero.arenas[index] = g_prezero.arenas[--g_prezero.count];
+	while (g_prezero.busy == arena)
+		pthread_cond_wait(&g_prezero.idle, &g_prezero.lock);
+
+	bool last = index >= 0 && g_prezero.count == 0;
+	if (last)
+	{
+		g_prezero.stop = true;
+		pthread_cond_signal(&g_prezero.wake);
+	}
+	pthread_mutex_unlock(&g_prezero.lock);
+
+	if (last)
+	{
+		pthread_join(g_prezero.thread, NULL);
+		g_prezero.running = false;
+		g_prezero.stop    = false;
+	}
+
+	ARENA_LOCK(arena);
+	arena->prezero_watched = false;
+	atomic_store(&arena->prezero_pending, false);
+	ARENA_UNLOCK(arena);
+	pthread_mutex_unlock(&g_prezero.control);
+}
+
+/**
+ * @brief
+ * Wait until the worker has nothing left to zero in `arena`.
+ *
+ * @details
+ * Returns at once for arenas that are not watched.
+ *
+ * @ingroup arena_prezero
+ */
+void arena_prezero_wait(t_arena* arena)
+{
+	if (!arena)
+		return;
+
+	pthread_mutex_lock(&g_prezero.lock);
+	while (arena_prezero_index(arena) >= 0 && (atomic_load(&arena->prezero_pending) || g_prezero.busy == arena))
+		pthread_cond_wait(&g_prezero.idle, &g_prezero.lock);
+	pthread_mutex_unlock(&g_prezero.lock);
+}
+
+/**
+ * @brief
+ * Watch every slot of `pool`; released slots are reset and pre-zeroed.
+ *
+ * @ingroup arena_prezero
+ */
+bool scratch_pool_prezero(t_scratch_arena_pool* pool)
+{
+	if (!pool)
+		return arena_report_error(NULL, "scratch_pool_prezero failed: NULL pool"), false;
+
+	for (int i = 0; i < SCRATCH_MAX_SLOTS; ++i)
+		if (!arena_prezero_watch(&pool->slots[i].arena))
+			return false;
+	return true;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Queue a pass over a watched arena that has dirty memory past its offset.
+ *
+ * @details
+ * Called with the arena lock held, by `arena_reset()` among others.
+ *
+ * @ingroup arena_prezero_internal
+ */
+void arena_prezero_notify(t_arena* arena)
+{
+	if (!arena->prezero_watched || arena->clean_from <= arena->offset)
+		return;
+	if (atomic_exchange(&arena->prezero_pending, true))
+		return;
+
+	pthread_mutex_lock(&g_prezero.lock);
+	pthread_cond_signal(&g_prezero.wake);
+	pthread_mutex_unlock(&g_prezero.lock);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Worker loop: zero arenas with a pending pass until asked to stop.
+ *
+ * @ingroup arena_prezero_internal
+ */
+static void* arena_prezero_worker(void* unused)
+{
+	(void) unused;
+
+	struct sched_param param = {0};
+	pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+	pthread_mutex_lock(&g_prezero.lock);
+	while (!g_prezero.stop)
+	{
+		t_arena* arena = arena_prezero_next();
+		if (!arena)
+		{
+			pthread_cond_wait(&g_prezero.wake, &g_prezero.lock);
+			continue;
+		}
+
+		g_prezero.busy = arena;
+		pthread_mutex_unlock(&g_prezero.lock);
+		arena_prezero_service(arena);
+		pthread_mutex_lock(&g_prezero.lock);
+		g_prezero.busy = NULL;
+		pthread_cond_broadcast(&g_prezero.idle);
+	}
+	pthread_mutex_unlock(&g_prezero.lock);
+	return NULL;
+}
+
+/**
+ * @brief
+ * Return the registry slot of `arena`, or `-1` if it is not watched.
+ *
+ * @details
+ * Called with `control` or the worker lock held.
+ *
+ * @ingroup arena_prezero_internal
+ */
+static inline long arena_prezero_index(const t_arena* arena)
+{
+	for (size_t i = 0; i < g_prezero.count; ++i)
+		if (g_prezero.arenas[i] == arena)
+			return (long) i;
+	return -1;
+}
+
+/**
+ * @brief
+ * Register `arena` with the worker, starting the worker thread if needed.
+ *
+ * @details
+ * Called with `control` held.
+ *
+ * @ingroup arena_prezero_internal
+ */
+static inline bool arena_prezero_add(t_arena* arena)
+{
+	if (g_prezero.count == ARENA_PREZERO_MAX_ARENAS)
+		return arena_report_error(arena, "arena_prezero_watch failed: too many watched arenas"), false;
+
+	if (!g_prezero.running)
+	{
+		if (pthread_create(&g_prezero.thread, NULL, arena_prezero_worker, NULL) != 0)
+			return arena_report_error(arena, "arena_prezero_watch failed: cannot start worker"), false;
+		g_prezero.running = true;
+	}
+
+	pthread_mutex_lock(&g_prezero.lock);
+	g_prezero.arenas[g_prezero.count++] = arena;
+	pthread_mutex_unlock(&g_prezero.lock);
+	return true;
+}
+
+/**
+ * @brief
+ * Pick a watched arena with a pending pass.
+ *
+ * @details
+ * Called by the worker with its lock held.
+ *
+ * @ingroup arena_prezero_internal
+ */
+static inline t_arena* arena_prezero_next(void)
+{
+	for (size_t i = 0; i < g_prezero.count; ++i)
+		if (atomic_load(&g_prezero.arenas[i]->prezero_pending))
+			return g_prezero.arenas[i];
+	return NULL;
+}
+
+/**
+ * @brief
+ * Zero the dirty bytes between the offset and `clean_from`, top down.
+ *
+ * @details
+ * Each slice takes the arena lock, zeroes up to `ARENA_PREZERO_CHUNK` bytes
+ * just below the watermark with non-temporal stores (the worker never reads
+ * them back) and lowers it. The pass ends when the watermark
+ * meets the offset, which allocations may have moved in the meantime.
+ *
+ * @ingroup arena_prezero_internal
+ */
+static inline void arena_prezero_service(t_arena* arena)
+{
+	atomic_store(&arena->prezero_pending, false);
+
+	for (;;)
+	{
+		ARENA_LOCK(arena);
+		if (arena->clean_from <= arena->offset || !arena->buffer || atomic_load(&arena->is_destroying) ||
+		    ARENA_IS_FROZEN(arena))
+		{
+			ARENA_UNLOCK(arena);
+			return;
+		}
+
+		size_t start = arena->offset;
+		if (arena->clean_from - start > ARENA_PREZERO_CHUNK)
+			start = arena->clean_from - ARENA_PREZERO_CHUNK;
+		ARENA_SAN_OPEN(arena->buffer + start, arena->clean_from - start);
+		arena_fill_zero_stream(arena->buffer + start, arena->clean_from - start);
+		ARENA_SAN_CLOSE(arena->buffer + start, arena->clean_from - start);
+		arena->clean_from = start;
+		ARENA_POISON_CLIP(arena, start);
+		ARENA_UNLOCK(arena);
+	}
+}
+
+#else
+
+bool arena_prezero_watch(t_arena* arena)
+{
+	return arena_report_error(arena, "arena_prezero_watch failed: built without ARENA_ENABLE_THREAD_SAFE"), false;
+}
+
+void arena_prezero_unwatch(t_arena* arena)
+{
+	(void) arena;
+}
+
+void arena_prezero_wait(t_arena* arena)
+{
+	(void) arena;
+}
+
+bool scratch_pool_prezero(t_scratch_arena_pool* pool)
+{
+	(void) pool;
+	return arena_report_error(NULL, "scratch_pool_prezero failed: built without ARENA_ENABLE_THREAD_SAFE"), false;
+}
+
+#endif
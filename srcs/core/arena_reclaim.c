@@ -0,0 +1,297 @@
+/**
+ * @file arena_reclaim.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Background release of destroyed arena buffers.
+ *
+ * @details
+ * `arena_destroy()` offers its buffer through `arena_reclaim_defer()`. If the
+ * reclaimer runs, the buffer is large enough, privately owned and the ring
+ * has room, the buffer and a copy of its backing record are queued and the
+ * arena's backing is reset, so the arena no longer refers to the memory.
+ * Otherwise the caller releases it inline.
+ *
+ * The thread pops buffers in order, poisons heap buffers (when
+ * `ARENA_POISON_MEMORY` is enabled, as the inline path does) and releases
+ * them with `arena_backing_release()` without holding the reclaimer lock.
+ * `drained` is broadcast whenever the queue becomes empty with nothing in
+ * flight, which is what `arena_reclaimer_flush()` waits for.
+ *
+ * @ingroup arena_reclaim
+ */
+
+#include "arena.h"
+#include "arena_reclaim.h"
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+/**
+ * @brief
+ * Buffer waiting to be released.
+ *
+ * @ingroup arena_reclaim_internal
+ */
+typedef struct s_arena_reclaim_item
+{
+	t_arena_backing backing; ///< Backing record taken over from the arena.
+	uint8_t*        buffer;  ///< Buffer to release.
+	size_t          size;    ///< Buffer size in bytes.
+} t_arena_reclaim_item;
+
+/**
+ * @brief
+ * State of the reclaimer thread and its bounded queue.
+ *
+ * @ingroup arena_reclaim_internal
+ */
+typedef struct s_arena_reclaimer
+{
+	pthread_mutex_t       control;   ///< Serializes start and stop.
+	pthread_mutex_t       lock;      ///< Guards the fields below.
+	pthread_cond_t        wake;      ///< Signaled when a buffer is queued or on stop.
+	pthread_cond_t        drained;   ///< Broadcast when nothing is queued or in flight.
+	pthread_t             thread;    ///< Reclaimer thread, valid while `running`.
+	bool                  running;   ///< Whether the thread exists.
+	bool                  stop;      ///< Asks the thread to exit once the queue is empty.
+	size_t                min_size;  ///< Smallest buffer deferred.
+	size_t                head;      ///< Index of the oldest queued buffer.
+	size_t                count;     ///< Number of queued buffers.
+	size_t                in_flight; ///< Buffers popped but not yet released.
+	t_arena_reclaim_stats stats;     ///< Counters reported by `arena_reclaimer_stats()`.
+	t_arena_reclaim_item  queue[ARENA_RECLAIM_QUEUE_SIZE]; ///< Ring of queued buffers.
+} t_arena_reclaimer;
+
+static t_arena_reclaimer g_reclaim = {
+    .control = PTHREAD_MUTEX_INITIALIZER,
+    .lock    = PTHREAD_MUTEX_INITIALIZER,
+    .wake    = PTHREAD_COND_INITIALIZER,
+    .drained = PTHREAD_COND_INITIALIZER,
+};
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static void*       arena_reclaim_worker(void* unused);
+static inline void arena_reclaim_release(t_arena_reclaim_item* item);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Start releasing destroyed buffers in the background.
+ *
+ * @ingroup arena_reclaim
+ *
+ * @see arena_reclaimer_stop
+ */
+bool arena_reclaimer_start(size_t min_size)
+{
+	pthread_mutex_lock(&g_reclaim.control);
+	if (g_reclaim.running)
+	{
+		pthread_mutex_unlock(&g_reclaim.control);
+		return arena_report_error(NULL, "arena_reclaimer_start failed: already running"), false;
+	}
+
+	pthread_mutex_lock(&g_reclaim.lock);
+	g_reclaim.min_size = min_size ? min_size : ARENA_RECLAIM_MIN_SIZE;
+	g_reclaim.stop     = false;
+	bool ok            = pthread_create(&g_reclaim.thread, NULL, arena_reclaim_worker, NULL) == 0;
+	g_reclaim.running  = ok;
+	pthread_mutex_unlock(&g_reclaim.lock);
+	pthread_mutex_unlock(&g_reclaim.control);
+
+	if (!ok)
+		arena_report_error(NULL, "arena_reclaimer_start failed: cannot start thread");
+	return ok;
+}
+
+/**
+ * @brief
+ * Wait until every queued buffer has been released.
+ *
+ * @details
+ * Buffers queued by other threads while waiting are waited for too.
+ *
+ * @ingroup arena_reclaim
+ */
+void arena_reclaimer_flush(void)
+{
+	pthread_mutex_lock(&g_reclaim.lock);
+	while (g_reclaim.count || g_reclaim.in_flight)
+		pthread_cond_wait(&g_reclaim.drained, &g_reclaim.lock);
+	pthread_mutex_unlock(&g_reclaim.lock);
+}
+
+/**
+ * @brief
+ * Release what is still queued, then join the thread.
+ *
+ * @ingroup arena_reclaim
+ */
+void arena_reclaimer_stop(void)
+{
+	pthread_mutex_lock(&g_reclaim.control);
+	if (g_reclaim.running)
+	{
+		pthread_mutex_lock(&g_reclaim.lock);
+		g_reclaim.stop = true;
+		pthread_cond_signal(&g_reclaim.wake);
+		pthread_mutex_unlock(&g_reclaim.lock);
+
+		pthread_join(g_reclaim.thread, NULL);
+
+		pthread_mutex_lock(&g_reclaim.lock);
+		g_reclaim.running = false;
+		g_reclaim.stop    = false;
+		pthread_mutex_unlock(&g_reclaim.lock);
+	}
+	pthread_mutex_unlock(&g_reclaim.control);
+}
+
+/**
+ * @brief
+ * Snapshot of the reclaimer counters.
+ *
+ * @ingroup arena_reclaim
+ */
+t_arena_reclaim_stats arena_reclaimer_stats(void)
+{
+	pthread_mutex_lock(&g_reclaim.lock);
+	t_arena_reclaim_stats stats = g_reclaim.stats;
+	pthread_mutex_unlock(&g_reclaim.lock);
+	return stats;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Queue a destroyed arena's buffer for background release.
+ *
+ * @details
+ * Called by `arena_destroy()` with the arena lock held. On success the
+ * reclaimer owns the buffer and `backing` is reset to the heap default.
+ *
+ * @return `true` if the buffer was queued, `false` if the caller must
+ *         release it itself.
+ *
+ * @ingroup arena_reclaim_internal
+ */
+bool arena_reclaim_defer(t_arena_backing* backing, uint8_t* buffer, size_t size)
+{
+	if (backing->kind != ARENA_BACKING_HEAP && backing->kind != ARENA_BACKING_MMAP)
+		return false;
+
+	pthread_mutex_lock(&g_reclaim.lock);
+	bool eligible = g_reclaim.running && !g_reclaim.stop && size >= g_reclaim.min_size;
+	bool queued   = eligible && g_reclaim.count < ARENA_RECLAIM_QUEUE_SIZE;
+	if (queued)
+	{
+		size_t tail           = (g_reclaim.head + g_reclaim.count++) % ARENA_RECLAIM_QUEUE_SIZE;
+		g_reclaim.queue[tail] = (t_arena_reclaim_item) {*backing, buffer, size};
+		g_reclaim.stats.deferred++;
+		g_reclaim.stats.pending++;
+		g_reclaim.stats.pending_bytes += size;
+		pthread_cond_signal(&g_reclaim.wake);
+	}
+	else if (eligible)
+		g_reclaim.stats.inline_frees++;
+	pthread_mutex_unlock(&g_reclaim.lock);
+
+	if (queued)
+		arena_backing_reset(backing);
+	return queued;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Reclaimer loop: release queued buffers until stopped and drained.
+ *
+ * @ingroup arena_reclaim_internal
+ */
+static void* arena_reclaim_worker(void* unused)
+{
+	(void) unused;
+
+	pthread_mutex_lock(&g_reclaim.lock);
+	for (;;)
+	{
+		while (!g_reclaim.count && !g_reclaim.stop)
+			pthread_cond_wait(&g_reclaim.wake, &g_reclaim.lock);
+		if (!g_reclaim.count)
+			break;
+
+		t_arena_reclaim_item item = g_reclaim.queue[g_reclaim.head];
+		g_reclaim.head            = (g_reclaim.head + 1) % ARENA_RECLAIM_QUEUE_SIZE;
+		g_reclaim.count--;
+		g_reclaim.in_flight++;
+		pthread_mutex_unlock(&g_reclaim.lock);
+
+		arena_reclaim_release(&item);
+
+		pthread_mutex_lock(&g_reclaim.lock);
+		g_reclaim.in_flight--;
+		g_reclaim.stats.pending--;
+		g_reclaim.stats.pending_bytes -= item.size;
+		if (!g_reclaim.count && !g_reclaim.in_flight)
+			pthread_cond_broadcast(&g_reclaim.drained);
+	}
+	pthread_mutex_unlock(&g_reclaim.lock);
+	return NULL;
+}
+
+/**
+ * @brief
+ * Poison (heap buffers only) and release one queued buffer.
+ *
+ * @ingroup arena_reclaim_internal
+ */
+static inline void arena_reclaim_release(t_arena_reclaim_item* item)
+{
+	if (!arena_backing_is_mapped(&item->backing))
+		arena_poison_memory(item->buffer, item->size);
+	arena_backing_release(&item->backing, item->buffer, item->size);
+}
+
+#else
+
+bool arena_reclaimer_start(size_t min_size)
+{
+	(void) min_size;
+	return arena_report_error(NULL, "arena_reclaimer_start failed: thread safety disabled"), false;
+}
+
+void arena_reclaimer_flush(void)
+{
+}
+
+void arena_reclaimer_stop(void)
+{
+}
+
+t_arena_reclaim_stats arena_reclaimer_stats(void)
+{
+	return (t_arena_reclaim_stats) {0};
+}
+
+bool arena_reclaim_defer(t_arena_backing* backing, uint8_t* buffer, size_t size)
+{
+	(void) backing;
+	(void) buffer;
+	(void) size;
+	return false;
+}
+
+#endif
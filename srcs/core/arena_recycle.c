@@ -0,0 +1,423 @@
+/**
+ * @file arena_recycle.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Recycle cache of destroyed arena structs and buffers.
+ *
+ * @details
+ * Bin `k` holds buffers whose capacity is in `[2^k, 2^(k+1))`. A request of
+ * `size` bytes looks in the bins of `size` and of `2 * size` for a buffer of
+ * capacity `size` to `2 * size - 1`, so a lookup scans at most
+ * `2 * ARENA_RECYCLE_BIN_DEPTH` entries.
+ *
+ * Every cached buffer records `dirty`: the bytes past it are zero. A destroyed
+ * buffer is dirty up to the highest offset its arena reached, except heap
+ * buffers that grew, whose `realloc()`ed tail was never cleared. Taking a
+ * buffer clears its dirty bytes outside the cache lock.
+ *
+ * The cache lock is a plain mutex taken for a few loads and stores; it is
+ * never held together with an arena lock other than the caller's.
+ *
+ * @ingroup arena_recycle
+ */
+
+#include "arena.h"
+#include "arena_fill.h"
+#include "arena_recycle.h"
+
+/// Number of size classes (one per bit of `size_t`).
+#define ARENA_RECYCLE_BINS (sizeof(size_t) * 8)
+
+/**
+ * @brief
+ * Cached buffer and the backing record needed to release it.
+ *
+ * @ingroup arena_recycle_internal
+ */
+typedef struct s_arena_recycle_entry
+{
+	t_arena_backing backing;  ///< Backing record taken over from the arena.
+	uint8_t*        buffer;   ///< Cached buffer.
+	size_t          capacity; ///< Usable bytes of `buffer`.
+	size_t          dirty;    ///< Bytes that may be non-zero.
+} t_arena_recycle_entry;
+
+/**
+ * @brief
+ * One size class of the cache.
+ *
+ * @ingroup arena_recycle_internal
+ */
+typedef struct s_arena_recycle_bin
+{
+	size_t                count;                           ///< Cached buffers.
+	t_arena_recycle_entry entries[ARENA_RECYCLE_BIN_DEPTH]; ///< Cached buffers, unordered.
+} t_arena_recycle_bin;
+
+/**
+ * @brief
+ * State of the process-wide recycle cache.
+ *
+ * @ingroup arena_recycle_internal
+ */
+typedef struct s_arena_recycler
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	pthread_mutex_t lock; ///< Guards the fields below.
+#endif
+	bool                  enabled;                            ///< Whether destroyed arenas are cached.
+	size_t                max_bytes;                          ///< Limit of `stats.cached_bytes`.
+	t_arena_recycle_stats stats;                              ///< Counters reported by `arena_recycle_stats()`.
+	size_t                struct_count;                       ///< Cached arena structs.
+	t_arena*              structs[ARENA_RECYCLE_MAX_STRUCTS]; ///< Cached arena structs.
+	t_arena_recycle_bin   bins[ARENA_RECYCLE_BINS];           ///< Cached buffers by size class.
+} t_arena_recycler;
+
+static t_arena_recycler g_recycle = {
+#ifdef ARENA_ENABLE_THREAD_SAFE
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+#endif
+};
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline void   arena_recycle_lock(void);
+static inline void   arena_recycle_unlock(void);
+static inline size_t arena_recycle_class(size_t size);
+static inline size_t arena_recycle_dirty(const t_arena* arena);
+static inline bool   arena_recycle_find(size_t size, t_arena_recycle_entry* out);
+static void          arena_recycle_release_all(void);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Start caching destroyed arenas.
+ *
+ * @ingroup arena_recycle
+ *
+ * @see arena_recycle_disable
+ */
+void arena_recycle_enable(size_t max_bytes)
+{
+	arena_recycle_lock();
+	g_recycle.enabled   = true;
+	g_recycle.max_bytes = max_bytes ? max_bytes : ARENA_RECYCLE_MAX_BYTES;
+	arena_recycle_unlock();
+}
+
+/**
+ * @brief
+ * Stop caching and release everything cached.
+ *
+ * @ingroup arena_recycle
+ */
+void arena_recycle_disable(void)
+{
+	arena_recycle_lock();
+	g_recycle.enabled = false;
+	arena_recycle_unlock();
+	arena_recycle_release_all();
+}
+
+/**
+ * @brief
+ * Release everything cached, but keep caching.
+ *
+ * @ingroup arena_recycle
+ */
+void arena_recycle_drain(void)
+{
+	arena_recycle_release_all();
+}
+
+/**
+ * @brief
+ * Snapshot of the cache counters.
+ *
+ * @ingroup arena_recycle
+ */
+t_arena_recycle_stats arena_recycle_stats(void)
+{
+	arena_recycle_lock();
+	t_arena_recycle_stats stats = g_recycle.stats;
+	arena_recycle_unlock();
+	return stats;
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Take a zeroed buffer of at least `size` bytes from the cache.
+ *
+ * @details
+ * Called by `arena_create()` and `arena_init()` before allocating. On a hit,
+ * `backing` describes the returned buffer.
+ *
+ * @return The buffer, or `NULL` if the cache is disabled or has none that fits.
+ *
+ * @ingroup arena_recycle_internal
+ */
+uint8_t* arena_recycle_take(t_arena_backing* backing, size_t size)
+{
+	t_arena_recycle_entry entry;
+
+	arena_recycle_lock();
+	bool hit = g_recycle.enabled && arena_recycle_find(size, &entry);
+	if (hit)
+	{
+		g_recycle.stats.hits++;
+		g_recycle.stats.cached_buffers--;
+		g_recycle.stats.cached_bytes -= entry.capacity;
+	}
+	else if (g_recycle.enabled)
+		g_recycle.stats.misses++;
+	arena_recycle_unlock();
+
+	if (!hit)
+		return NULL;
+
+	arena_fill_zero(entry.buffer, entry.dirty);
+	*backing = entry.backing;
+	return entry.buffer;
+}
+
+/**
+ * @brief
+ * Keep a destroyed arena's buffer for a later `arena_recycle_take()`.
+ *
+ * @details
+ * Called by `arena_destroy()` with the arena lock held. On success the cache
+ * owns the buffer and the arena's backing is reset; the caller still clears
+ * `buffer` and `owns_buffer`.
+ *
+ * @return `true` if the buffer was cached, `false` if the caller must release
+ *         it itself (cache disabled, buffer not private, bin or limit full).
+ *
+ * @ingroup arena_recycle_internal
+ */
+bool arena_recycle_offer(t_arena* arena)
+{
+	const t_arena_backing* backing = &arena->backing;
+	if (backing->kind != ARENA_BACKING_HEAP && backing->kind != ARENA_BACKING_MMAP)
+		return false;
+
+	t_arena_recycle_entry entry = {
+	    .backing  = *backing,
+	    .buffer   = arena->buffer,
+	    .capacity = backing->kind == ARENA_BACKING_MMAP ? backing->map_len : arena->size,
+	    .dirty    = arena_recycle_dirty(arena),
+	};
+	t_arena_recycle_bin* bin = &g_recycle.bins[arena_recycle_class(entry.capacity)];
+
+	arena_recycle_lock();
+	bool cached = g_recycle.enabled;
+	if (cached && (bin->count == ARENA_RECYCLE_BIN_DEPTH ||
+	               g_recycle.stats.cached_bytes + entry.capacity > g_recycle.max_bytes))
+	{
+		g_recycle.stats.rejected++;
+		cached = false;
+	}
+	if (cached)
+	{
+		arena_poison_memory(entry.buffer, entry.dirty);
+		bin->entries[bin->count++] = entry;
+		g_recycle.stats.cached_buffers++;
+		g_recycle.stats.cached_bytes += entry.capacity;
+	}
+	arena_recycle_unlock();
+
+	if (cached)
+		arena_backing_reset(&arena->backing);
+	return cached;
+}
+
+/**
+ * @brief
+ * Take a zeroed arena struct from the cache.
+ *
+ * @return The struct, or `NULL` if none is cached.
+ *
+ * @ingroup arena_recycle_internal
+ */
+t_arena* arena_recycle_take_struct(void)
+{
+	t_arena* arena = NULL;
+
+	arena_recycle_lock();
+	if (g_recycle.struct_count)
+	{
+		arena = g_recycle.structs[--g_recycle.struct_count];
+		g_recycle.stats.struct_hits++;
+	}
+	else if (g_recycle.enabled)
+		g_recycle.stats.struct_misses++;
+	arena_recycle_unlock();
+
+	if (arena)
+		memset(arena, 0, sizeof(*arena));
+	return arena;
+}
+
+/**
+ * @brief
+ * Keep a destroyed arena struct for `arena_recycle_take_struct()`.
+ *
+ * @return `true` if it was cached, `false` if the caller must `free()` it.
+ *
+ * @ingroup arena_recycle_internal
+ */
+bool arena_recycle_offer_struct(t_arena* arena)
+{
+	arena_recycle_lock();
+	bool cached = g_recycle.enabled && g_recycle.struct_count < ARENA_RECYCLE_MAX_STRUCTS;
+	if (cached)
+		g_recycle.structs[g_recycle.struct_count++] = arena;
+	arena_recycle_unlock();
+	return cached;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Take the cache lock (no-op without `ARENA_ENABLE_THREAD_SAFE`).
+ *
+ * @ingroup arena_recycle_internal
+ */
+static inline void arena_recycle_lock(void)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	pthread_mutex_lock(&g_recycle.lock);
+#endif
+}
+
+/**
+ * @brief
+ * Release the cache lock.
+ *
+ * @ingroup arena_recycle_internal
+ */
+static inline void arena_recycle_unlock(void)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	pthread_mutex_unlock(&g_recycle.lock);
+#endif
+}
+
+/**
+ * @brief
+ * Size class of a buffer: the index of its highest set bit.
+ *
+ * @ingroup arena_recycle_internal
+ */
+static inline size_t arena_recycle_class(size_t size)
+{
+	return ARENA_RECYCLE_BINS - 1 - (size_t) __builtin_clzl(size);
+}
+
+/**
+ * @brief
+ * Bytes of the arena's buffer that may be non-zero.
+ *
+ * @details
+ * Only what was allocated was written (and, with `ARENA_POISON_MEMORY`,
+ * poisoned on reset), unless a heap buffer grew: `realloc()` leaves the new
+ * tail uninitialized.
+ *
+ * @ingroup arena_recycle_internal
+ */
+static inline size_t arena_recycle_dirty(const t_arena* arena)
+{
+	if (arena->backing.kind == ARENA_BACKING_HEAP && arena->stats.growth_history_count)
+		return arena->size;
+
+	size_t dirty = arena->stats.peak_usage;
+	if (arena->cycle_peak > dirty)
+		dirty = arena->cycle_peak;
+	if (arena->offset > dirty)
+		dirty = arena->offset;
+	return dirty < arena->size ? dirty : arena->size;
+}
+
+/**
+ * @brief
+ * Remove a cached buffer of `size` to `2 * size - 1` bytes, if any.
+ *
+ * @details
+ * Called with the cache lock held. Only the bins of `size` and `2 * size`
+ * can hold such a buffer.
+ *
+ * @ingroup arena_recycle_internal
+ */
+static inline bool arena_recycle_find(size_t size, t_arena_recycle_entry* out)
+{
+	const size_t first = arena_recycle_class(size);
+	const size_t last  = first + 1 < ARENA_RECYCLE_BINS ? first + 1 : first;
+
+	for (size_t k = first; k <= last; ++k)
+	{
+		t_arena_recycle_bin* bin = &g_recycle.bins[k];
+		for (size_t i = 0; i < bin->count; ++i)
+		{
+			const size_t capacity = bin->entries[i].capacity;
+			if (capacity < size || capacity - size >= size)
+				continue;
+			*out            = bin->entries[i];
+			bin->entries[i] = bin->entries[--bin->count];
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief
+ * Release every cached buffer and struct.
+ *
+ * @details
+ * The cache is emptied under the lock and released outside of it.
+ *
+ * @ingroup arena_recycle_internal
+ */
+static void arena_recycle_release_all(void)
+{
+	for (size_t k = 0; k < ARENA_RECYCLE_BINS; ++k)
+	{
+		t_arena_recycle_bin bin;
+
+		arena_recycle_lock();
+		bin = g_recycle.bins[k];
+		g_recycle.bins[k].count = 0;
+		for (size_t i = 0; i < bin.count; ++i)
+		{
+			g_recycle.stats.cached_buffers--;
+			g_recycle.stats.cached_bytes -= bin.entries[i].capacity;
+		}
+		arena_recycle_unlock();
+
+		for (size_t i = 0; i < bin.count; ++i)
+			arena_backing_release(&bin.entries[i].backing, bin.entries[i].buffer, bin.entries[i].capacity);
+	}
+
+	t_arena* structs[ARENA_RECYCLE_MAX_STRUCTS];
+	arena_recycle_lock();
+	size_t count = g_recycle.struct_count;
+	memcpy(structs, g_recycle.structs, count * sizeof(*structs));
+	g_recycle.struct_count = 0;
+	arena_recycle_unlock();
+
+	for (size_t i = 0; i < count; ++i)
+		free(structs[i]);
+}
@@ -16,6 +16,7 @@
  * - Automatic resizing policy through user-defined or default callbacks.
  * - Shrinking (`arena_shrink`) of underused memory regions.
  * - Heuristic-based auto-shrinking (`arena_might_shrink`) with safe thresholds.
+ * - Optional shrink hysteresis (`arena_set_shrink_policy`) based on windowed peak usage.
  * - Internal helpers for validation, computation, and buffer reallocation.
  *
  * All operations are thread-safe and acquire internal locks on the arena during
@@ -33,16 +34,20 @@
 
 #include "arena.h"
 #include <math.h>
+#include <sys/mman.h>
+#include <time.h>
 
 /*
  * INTERNAL HELPERS DEFINITIONS
  */
 
-static inline bool   arena_should_grow(const t_arena* arena);
-static inline void   arena_record_growth(t_arena* arena, size_t old_size);
-static inline bool   arena_grow_validate(t_arena* arena, size_t required_size);
-static inline size_t arena_grow_compute_new_size(t_arena* arena, size_t required_size);
-static inline bool   arena_grow_realloc_buffer(t_arena* arena, size_t new_size, size_t old_size);
+static inline bool     arena_should_grow(const t_arena* arena);
+static inline void     arena_record_growth(t_arena* arena, size_t old_size);
+static inline bool     arena_grow_validate(t_arena* arena, size_t required_size);
+static inline size_t   arena_grow_compute_new_size(t_arena* arena, size_t required_size);
+static inline bool     arena_grow_locked(t_arena* arena, size_t required_size, bool in_place);
+static inline bool     arena_grow_realloc_buffer(t_arena* arena, size_t new_size, size_t old_size, bool in_place);
+static inline uint8_t* arena_grow_resize_backing(t_arena* arena, size_t new_size, size_t old_size, bool in_place);
 
 static inline bool arena_can_shrink(t_arena* arena, size_t new_size);
 static inline bool arena_shrink_validate(t_arena* arena, size_t new_size);
@@ -52,6 +57,12 @@ static inline bool   should_attempt_shrink(t_arena* arena);
 static inline bool   arena_should_maybe_shrink(size_t used, size_t size);
 static inline size_t arena_shrink_target(size_t used);
 
+static inline bool     arena_shrink_policy_enabled(const t_arena* arena);
+static inline void     arena_shrink_window_roll(t_arena* arena);
+static inline size_t   arena_shrink_windowed_target(t_arena* arena);
+static inline void     arena_shrink_count_avoided(t_arena* arena);
+static inline uint64_t arena_now_ms(void);
+
 /*
  * PUBLIC API
  */
@@ -70,9 +81,12 @@ static inline size_t arena_shrink_target(size_t used);
  * - The arena is not `NULL`.
  * - `arena->owns_buffer` and `arena->can_grow` are `true`.
  * - The resulting size does not overflow `SIZE_MAX`.
+ * - The resulting size does not exceed `ARENA_MAX_ALLOWED_SIZE`.
  *
  * On success:
- * - The arena buffer is reallocated to a larger size.
+ * - The arena buffer is reallocated to a larger size. Buffers of at least
+ *   `ARENA_MMAP_THRESHOLD` bytes are anonymous mappings grown with `mremap()`,
+ *   which moves page tables instead of copying the contents.
  * - Internal stats are updated, including the `reallocations` counter and
  *   `growth_history`.
  * - The function returns `true`.
@@ -141,37 +155,7 @@ static inline size_t arena_shrink_target(size_t used);
  */
 bool arena_grow(t_arena* arena, size_t required_size)
 {
-	if (!arena)
-		return false;
-
-	if (required_size == 0)
-		return true;
-
-	ARENA_LOCK(arena);
-
-	if (!arena_grow_validate(arena, required_size))
-	{
-		ARENA_UNLOCK(arena);
-		return false;
-	}
-
-	size_t old_size = arena->size;
-	size_t new_size = arena_grow_compute_new_size(arena, required_size);
-	if (new_size == 0)
-	{
-		arena_report_error(arena, "arena_grow failed: computed size invalid");
-		ARENA_UNLOCK(arena);
-		return false;
-	}
-
-	if (new_size > (size_t)(1ULL << 32)) // 4GiB
-	{
-		arena_report_error(arena, "arena_grow rejected size: %zu", new_size);
-		return false;
-	}
-	bool success = arena_grow_realloc_buffer(arena, new_size, old_size);
-	ARENA_UNLOCK(arena);
-	return success;
+	return arena_grow_locked(arena, required_size, false);
 }
 
 /**
@@ -266,7 +250,7 @@ bool arena_grow(t_arena* arena, size_t required_size)
  */
 void arena_shrink(t_arena* arena, size_t new_size)
 {
-	if (!arena)
+	if (!arena || ARENA_IS_FROZEN(arena))
 		return;
 
 	ARENA_LOCK(arena);
@@ -395,9 +379,16 @@ bool arena_might_shrink(t_arena* arena)
 
 	if (arena_should_maybe_shrink(used, size))
 	{
-		const size_t target = arena_shrink_target(used);
+		size_t target = arena_shrink_target(used);
+		if (arena_shrink_policy_enabled(arena))
+		{
+			const size_t plain = target;
+			target             = arena_shrink_windowed_target(arena);
+			if (!target && plain && plain < size)
+				arena_shrink_count_avoided(arena);
+		}
 
-		if (target < size)
+		if (target && target < size)
 		{
 			arena_shrink(arena, target);
 			ARENA_UNLOCK(arena);
@@ -409,6 +400,115 @@ bool arena_might_shrink(t_arena* arena)
 	return false;
 }
 
+/**
+ * @brief
+ * Configure shrink hysteresis for `arena_might_shrink()`.
+ *
+ * @details
+ * Bursty workloads that reset their arena between requests make the plain
+ * ratio check shrink after every quiet moment, and the next burst grows the
+ * buffer right back: two `realloc()` calls per cycle. With a window set,
+ * `arena_might_shrink()` instead:
+ *
+ * - waits until a first window (`window_resets` resets or `window_ms`
+ *   milliseconds, whichever ends first) has completed;
+ * - sizes the arena for the highest usage seen in the last complete window,
+ *   the current one and the current cycle, plus `headroom_percent`;
+ * - never goes below `min_size`.
+ *
+ * Shrinks that the plain ratio check would have done and the policy refused
+ * are counted in `stats.shrinks_avoided`, at most once per window; growths
+ * that follow a shrink are counted in `stats.regrows_after_shrink` either way. Setting a
+ * policy restarts the window; an all-zero policy restores the default
+ * behavior.
+ *
+ * @param arena  Arena to configure.
+ * @param policy Hysteresis settings.
+ *
+ * @ingroup arena_resize
+ *
+ * @see arena_might_shrink
+ *
+ * @example
+ * @code
+ * t_arena_shrink_policy policy = {
+ *     .window_resets    = 64,      // peak over the last 64 requests...
+ *     .window_ms        = 10000,   // ...or 10 seconds
+ *     .min_size         = 1 << 20, // keep at least 1 MiB
+ *     .headroom_percent = 25,
+ * };
+ * arena_set_shrink_policy(arena, policy);
+ *
+ * for (;;)
+ * {
+ *     handle_request(arena);
+ *     arena_reset(arena);
+ *     arena_might_shrink(arena);
+ * }
+ * @endcode
+ */
+void arena_set_shrink_policy(t_arena* arena, t_arena_shrink_policy policy)
+{
+	if (!arena)
+		return;
+
+	ARENA_LOCK(arena);
+	arena->shrink_policy = policy;
+	arena->shrink_window = (t_arena_shrink_window) {0};
+	if (policy.window_ms)
+		arena->shrink_window.started_ms = arena_now_ms();
+	ARENA_UNLOCK(arena);
+}
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Fold the finished cycle into the shrink window.
+ *
+ * @details
+ * Called by `arena_reset()` with the lock held. The peak of the cycle that just
+ * ended joins the window peak and `cycle_peak` restarts from zero. The clock is
+ * only read when a time-based window is configured.
+ *
+ * @ingroup arena_resize_internal
+ */
+void arena_shrink_window_on_reset(t_arena* arena)
+{
+	t_arena_shrink_window* window = &arena->shrink_window;
+
+	if (arena->cycle_peak > window->peak)
+		window->peak = arena->cycle_peak;
+	arena->cycle_peak = 0;
+	window->resets++;
+
+	if (arena_shrink_policy_enabled(arena))
+		arena_shrink_window_roll(arena);
+}
+
+/**
+ * @brief
+ * Grow the arena like `arena_grow()`, but only where its buffer lies.
+ *
+ * @details
+ * Used by the pre-growth worker, which runs while other threads may hold
+ * pointers into the buffer. The buffer is only extended in place (see
+ * `arena_backing_extend()`); when that is not possible the function fails
+ * without reporting an error, and the next growth happens inline.
+ *
+ * @return `true` if the arena grew, `false` otherwise.
+ *
+ * @ingroup arena_resize_internal
+ *
+ * @see arena_grow
+ */
+bool arena_grow_in_place(t_arena* arena, size_t required_size)
+{
+	return arena_grow_locked(arena, required_size, true);
+}
+
 /*
  * INTERNAL HELPERS IMPLEMENTATION
  */
@@ -528,8 +628,8 @@ static inline bool arena_grow_validate(t_arena* arena, size_t required_size)
  * @details
  * This internal function calculates an appropriate new buffer size
  * that satisfies the `required_size` request, starting from the current
- * size and offset. It uses the user-defined growth callback if set,
- * or defaults to `default_grow_cb` otherwise.
+ * size and offset. It uses the arena's growth policy if one is set, then
+ * the user-defined growth callback, or defaults to `default_grow_cb` otherwise.
  *
  * The result is validated to ensure it is:
  * - Large enough to satisfy the requested offset + size.
@@ -548,13 +648,16 @@ static inline bool arena_grow_validate(t_arena* arena, size_t required_size)
  * @see arena_grow
  * @see arena_grow_validate
  * @see arena_grow_callback
+ * @see arena_set_grow_policy
  * @see default_grow_cb
  */
 static inline size_t arena_grow_compute_new_size(t_arena* arena, size_t required_size)
 {
 	arena_grow_callback cb        = arena->grow_cb ? arena->grow_cb : default_grow_cb;
 	size_t              requested = arena->offset + required_size;
-	size_t              new_size  = cb(arena->size, required_size);
+	size_t              new_size  = arena->grow_policy.fn
+	                                    ? arena->grow_policy.fn(arena, required_size, arena->grow_policy.context)
+	                                    : cb(arena->size, required_size);
 
 	if (new_size < requested)
 		return 0;
@@ -564,24 +667,83 @@ static inline size_t arena_grow_compute_new_size(t_arena* arena, size_t required
 	return new_size;
 }
 
+/**
+ * @brief
+ * Validate, size and apply a growth under the arena lock.
+ *
+ * @details
+ * Shared by `arena_grow()` and `arena_grow_in_place()`.
+ *
+ * @param arena          Arena to grow.
+ * @param required_size  Additional bytes needed beyond current usage.
+ * @param in_place       Whether the buffer must stay where it is.
+ *
+ * @return `true` if growth succeeded, `false` otherwise.
+ *
+ * @ingroup arena_resize_internal
+ */
+static inline bool arena_grow_locked(t_arena* arena, size_t required_size, bool in_place)
+{
+	if (!arena)
+		return false;
+
+	if (required_size == 0)
+		return true;
+
+	if (ARENA_IS_FROZEN(arena))
+		return arena_report_error(arena, "arena_grow failed: arena is frozen"), false;
+
+	ARENA_LOCK(arena);
+
+	if (!arena_grow_validate(arena, required_size))
+	{
+		ARENA_UNLOCK(arena);
+		return false;
+	}
+
+	size_t old_size = arena->size;
+	size_t new_size = arena_grow_compute_new_size(arena, required_size);
+	if (new_size == 0)
+	{
+		arena_report_error(arena, "arena_grow failed: computed size invalid");
+		ARENA_UNLOCK(arena);
+		return false;
+	}
+
+	if (new_size > ARENA_MAX_ALLOWED_SIZE)
+	{
+		arena_report_error(arena, "arena_grow rejected size: %zu (limit %zu)", new_size,
+		                   (size_t) ARENA_MAX_ALLOWED_SIZE);
+		ARENA_UNLOCK(arena);
+		return false;
+	}
+	bool success = arena_grow_realloc_buffer(arena, new_size, old_size, in_place);
+	ARENA_UNLOCK(arena);
+	return success;
+}
+
 /**
  * @brief
  * Reallocate the arena's buffer to a new size.
  *
  * @details
- * This internal function performs the actual `realloc()` of the arena's buffer
- * during a grow operation. It attempts to allocate a new buffer of `new_size`
- * bytes, and if successful:
+ * This internal function performs the actual resize of the arena's buffer
+ * during a grow operation through `arena_backing_resize()` (`realloc()` for heap
+ * buffers, `mremap()` for mapped ones). The extra bytes are first charged to the
+ * arena's budget, if any. It attempts to obtain a buffer of
+ * `new_size` bytes, and if successful:
  * - Updates the buffer pointer and size.
  * - Increments the reallocation counter.
  * - Records the previous size in the arena's growth history.
  * - Emits a debug log message indicating the resize.
  *
- * If reallocation fails, an error is reported and `false` is returned.
+ * If reallocation fails, an error is reported and `false` is returned. An
+ * in-place growth that is not possible fails silently.
  *
  * @param arena     Pointer to the arena being resized.
  * @param new_size  Target buffer size after reallocation (in bytes).
  * @param old_size  Original size of the buffer before reallocation.
+ * @param in_place  Whether the buffer must stay where it is.
  *
  * @return `true` if reallocation succeeded, `false` otherwise.
  *
@@ -589,17 +751,41 @@ static inline size_t arena_grow_compute_new_size(t_arena* arena, size_t required
  *
  * @see arena_grow
  * @see arena_record_growth
- * @see realloc
+ * @see arena_backing_resize
  */
-static inline bool arena_grow_realloc_buffer(t_arena* arena, size_t new_size, size_t old_size)
+static inline bool arena_grow_realloc_buffer(t_arena* arena, size_t new_size, size_t old_size, bool in_place)
 {
-	void* new_buf = realloc(arena->buffer, new_size);
+	if (!arena_budget_charge(arena, new_size - old_size))
+		return false;
+
+	arena_prefault_unpin(arena);
+	arena_guard_protect(arena, PROT_READ | PROT_WRITE);
+	ARENA_SAN_DETACH(arena);
+	uint8_t* new_buf = arena_grow_resize_backing(arena, new_size, old_size, in_place);
 	if (!new_buf)
+	{
+		ARENA_SAN_ATTACH(arena);
+		arena_guard_protect(arena, PROT_NONE);
+		arena_prefault_pin(arena, old_size);
+		arena_budget_credit(arena, new_size - old_size);
+		if (in_place)
+			return false;
 		return arena_report_error(arena, "arena_grow failed: realloc failed"), false;
+	}
 
-	arena->buffer = (uint8_t*) new_buf;
+	arena_guard_rebase(arena, new_buf);
+	arena->buffer = new_buf;
 	arena->size   = new_size;
+	ARENA_SAN_ATTACH(arena);
+	if (!arena_backing_is_mapped(&arena->backing))
+		arena->clean_from = new_size; // realloc() does not clear the new tail
+	arena_prefault_pin(arena, old_size);
 	arena->stats.reallocations++;
+	if (arena->shrink_window.shrunk)
+	{
+		arena->stats.regrows_after_shrink++;
+		arena->shrink_window.shrunk = false;
+	}
 
 	arena_record_growth(arena, old_size);
 
@@ -607,6 +793,42 @@ static inline bool arena_grow_realloc_buffer(t_arena* arena, size_t new_size, si
 	return true;
 }
 
+/**
+ * @brief
+ * Resize the buffer for a growth, choosing how it may move.
+ *
+ * @details
+ * In-place growths go through `arena_backing_extend()`, and growths of a
+ * buffer pinned by I/O made without the lock through
+ * `arena_io_pinned_resize()`, which keeps the old buffer alive if it must
+ * move. Other growths of an arena watched by the pre-growth worker move the
+ * buffer, when it has to move anyway, into a reservation of
+ * `ARENA_PREGROW_RESERVE_FACTOR` times the new size, so that the worker can
+ * extend it in place afterwards. Any other growth, or a reservation that
+ * cannot be made, falls back to `arena_backing_resize()`.
+ *
+ * @return The (possibly moved) buffer, or `NULL` on failure.
+ *
+ * @ingroup arena_resize_internal
+ *
+ * @see arena_backing_resize_reserved
+ */
+static inline uint8_t* arena_grow_resize_backing(t_arena* arena, size_t new_size, size_t old_size, bool in_place)
+{
+	if (in_place)
+		return arena_backing_extend(&arena->backing, new_size);
+	if (ARENA_IO_PINNED(arena))
+		return arena_io_pinned_resize(arena, new_size, old_size);
+
+	uint8_t*     new_buf = NULL;
+	const size_t reserve = ARENA_PREGROW_RESERVE(arena, new_size);
+	if (reserve)
+		new_buf = arena_backing_resize_reserved(&arena->backing, arena->buffer, old_size, new_size, reserve);
+	if (!new_buf)
+		new_buf = arena_backing_resize(&arena->backing, arena->buffer, old_size, new_size);
+	return new_buf;
+}
+
 /**
  * @brief
  * Determine whether the arena is eligible for shrinking to a smaller size.
@@ -618,6 +840,7 @@ static inline bool arena_grow_realloc_buffer(t_arena* arena, size_t new_size, si
  * Shrinking is allowed only if:
  * - The arena is not `NULL`.
  * - The arena owns its buffer and is allowed to grow/shrink.
+ * - No I/O made without the lock is using the buffer (`ARENA_IO_PINNED()`).
  * - The proposed `new_size` is not smaller than the current offset.
  * - The ratio of `new_size / current_size` is less than or equal to the
  *   configured threshold (`ARENA_MIN_SHRINK_RATIO`), unless it matches the offset.
@@ -645,7 +868,7 @@ static inline bool arena_can_shrink(t_arena* arena, size_t new_size)
 	bool owns = atomic_load_explicit(&arena->owns_buffer, memory_order_acquire);
 	bool grow = atomic_load_explicit(&arena->can_grow, memory_order_acquire);
 
-	if (!owns || !grow)
+	if (!owns || !grow || ARENA_IO_PINNED(arena))
 		return false;
 
 	if (new_size < arena->offset)
@@ -695,14 +918,16 @@ static inline bool arena_shrink_validate(t_arena* arena, size_t new_size)
  *
  * @details
  * This internal function performs the actual memory reallocation
- * to reduce the arena's backing buffer to `new_size` bytes.
+ * to reduce the arena's backing buffer to `new_size` bytes, using
+ * `arena_backing_resize()` so mapped buffers are shrunk in place.
  *
  * On success:
  * - The arena's `buffer` pointer and `size` field are updated.
+ * - The released bytes are credited to the arena's budget, if any.
  * - The `shrinks` counter in arena statistics is incremented.
  * - A debug log message is printed.
  *
- * If `realloc()` fails, the arena remains unchanged and the function returns `false`.
+ * If the resize fails, the arena remains unchanged and the function returns `false`.
  *
  * @param arena     Pointer to the arena to shrink.
  * @param new_size  New desired size of the arena buffer (in bytes).
@@ -719,13 +944,29 @@ static inline bool arena_shrink_validate(t_arena* arena, size_t new_size)
  */
 static inline bool arena_shrink_apply(t_arena* arena, size_t new_size)
 {
-	void* new_buf = realloc(arena->buffer, new_size);
+	arena_prefault_unpin(arena);
+	arena_guard_protect(arena, PROT_READ | PROT_WRITE);
+	ARENA_SAN_DETACH(arena);
+	uint8_t* new_buf = arena_backing_resize(&arena->backing, arena->buffer, arena->size, new_size);
 	if (!new_buf)
+	{
+		ARENA_SAN_ATTACH(arena);
+		arena_guard_protect(arena, PROT_NONE);
+		arena_prefault_pin(arena, arena->size);
 		return false;
+	}
 
-	arena->buffer = (uint8_t*) new_buf;
+	arena_budget_credit(arena, arena->size - new_size);
+	arena_guard_rebase(arena, new_buf);
+	arena->buffer = new_buf;
 	arena->size   = new_size;
+	ARENA_SAN_ATTACH(arena);
+	if (arena->clean_from > new_size)
+		arena->clean_from = new_size;
+	ARENA_POISON_CLIP(arena, new_size);
+	arena_prefault_pin(arena, new_size);
 	arena->stats.shrinks++;
+	arena->shrink_window.shrunk = true;
 
 	ALOG("[arena_shrink] Arena %p shrunk to %zu bytes\n", (void*) arena, new_size);
 	return true;
@@ -754,7 +995,7 @@ static inline bool arena_shrink_apply(t_arena* arena, size_t new_size)
  */
 static inline bool should_attempt_shrink(t_arena* arena)
 {
-	if (!arena)
+	if (!arena || ARENA_IS_FROZEN(arena))
 		return false;
 
 	return atomic_load_explicit(&arena->can_grow, memory_order_acquire);
@@ -819,4 +1060,118 @@ static inline bool arena_should_maybe_shrink(size_t used, size_t size)
 static inline size_t arena_shrink_target(size_t used)
 {
 	return used + ARENA_SHRINK_PADDING;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief
+ * Check whether a shrink window is configured.
+ *
+ * @ingroup arena_resize_internal
+ */
+static inline bool arena_shrink_policy_enabled(const t_arena* arena)
+{
+	return arena->shrink_policy.window_resets || arena->shrink_policy.window_ms;
+}
+
+/**
+ * @brief
+ * Close the current shrink window if it reached its reset count or duration.
+ *
+ * @details
+ * The closed window's peak also covers the cycle in progress, which may have
+ * started before the window ends.
+ *
+ * @ingroup arena_resize_internal
+ */
+static inline void arena_shrink_window_roll(t_arena* arena)
+{
+	const t_arena_shrink_policy* policy = &arena->shrink_policy;
+	t_arena_shrink_window*       window = &arena->shrink_window;
+	const uint64_t               now    = policy->window_ms ? arena_now_ms() : 0;
+
+	bool due = (policy->window_resets && window->resets >= policy->window_resets) ||
+	           (policy->window_ms && now - window->started_ms >= policy->window_ms);
+	if (!due)
+		return;
+
+	window->last_peak  = window->peak > arena->cycle_peak ? window->peak : arena->cycle_peak;
+	window->peak       = 0;
+	window->resets     = 0;
+	window->started_ms = now;
+	window->complete   = true;
+	window->avoided    = false;
+}
+
+/**
+ * @brief
+ * Compute the hysteresis shrink target, or `0` to keep the current size.
+ *
+ * @details
+ * Called with the lock held once the plain ratio check wants to shrink. The
+ * demand is the highest of the last complete window's peak, the current
+ * window's peak, the current cycle's peak and the offset. The target adds
+ * `headroom_percent` and `ARENA_SHRINK_PADDING`, and is raised to `min_size`.
+ * When that leaves nothing worth shrinking under `ARENA_MIN_SHRINK_RATIO`,
+ * the current size is kept.
+ *
+ * @ingroup arena_resize_internal
+ *
+ * @see arena_set_shrink_policy
+ */
+static inline size_t arena_shrink_windowed_target(t_arena* arena)
+{
+	arena_shrink_window_roll(arena);
+
+	const t_arena_shrink_window* window = &arena->shrink_window;
+	if (!window->complete)
+		return 0;
+
+	size_t demand = window->last_peak;
+	if (window->peak > demand)
+		demand = window->peak;
+	if (arena->cycle_peak > demand)
+		demand = arena->cycle_peak;
+	if (arena->offset > demand)
+		demand = arena->offset;
+
+	const size_t headroom = demand / 100 * arena->shrink_policy.headroom_percent;
+	size_t       target   = arena_shrink_target(demand + headroom);
+	if (target < arena->shrink_policy.min_size)
+		target = arena->shrink_policy.min_size;
+
+	if (!arena_should_maybe_shrink(target, arena->size))
+		return 0;
+	return target;
+}
+
+/**
+ * @brief
+ * Count a shrink that the plain ratio check wanted and the policy refused.
+ *
+ * @details
+ * Counted at most once per window: repeated `arena_might_shrink()` calls
+ * within one window, for example from a monitor polling the arena, refuse
+ * the same shrink rather than avoiding another grow/shrink cycle.
+ *
+ * @ingroup arena_resize_internal
+ */
+static inline void arena_shrink_count_avoided(t_arena* arena)
+{
+	if (arena->shrink_window.avoided)
+		return;
+	arena->shrink_window.avoided = true;
+	arena->stats.shrinks_avoided++;
+}
+
+/**
+ * @brief
+ * Read the monotonic clock in milliseconds.
+ *
+ * @ingroup arena_resize_internal
+ */
+static inline uint64_t arena_now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000u + (uint64_t) ts.tv_nsec / 1000000u;
+}
@@ -29,8 +29,10 @@
  *
  * API overview:
  * - `scratch_pool_init()` creates a pool of pre-allocated arenas.
+ * - `scratch_pool_init_guarded()` carves fixed-size slots separated by guard pages.
  * - `scratch_acquire()` gives out a reset arena ready for use.
  * - `scratch_release()` returns an arena to the pool.
+ * - `scratch_pool_trim()` releases the memory of the slots not in use.
  * - `scratch_pool_destroy()` frees all internal arenas and clears state.
  *
  * This implementation uses `atomic_bool` for per-slot locking and supports
@@ -197,6 +199,7 @@
  */
 
 #include "arena_scratch.h"
+#include "arena_trim.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -271,13 +274,78 @@ bool scratch_pool_init(t_scratch_arena_pool* pool, size_t slot_size, bool thread
 	return true;
 }
 
+/**
+ * @brief
+ * Initialize a scratch pool whose slots are separated by guard pages.
+ *
+ * @details
+ * Instead of one growable arena per slot, the pool creates a single parent
+ * arena with guard pages enabled and carves every slot from it with
+ * `arena_alloc_sub_labeled()`. Each slot is therefore page-aligned, rounded
+ * up to whole pages, and followed by a `PROT_NONE` page: an overrun faults at
+ * the offending write instead of spilling into the next slot.
+ *
+ * Slots are sub-arenas, so they do not grow and `scratch_pool_trim()` only
+ * resets them. Meant for debug builds; each slot costs an extra page.
+ *
+ * @param pool         Pointer to the scratch pool structure to initialize.
+ * @param slot_size    Minimum size of each scratch arena (in bytes).
+ * @param thread_safe  If `true`, enables mutex-based locking for slot access.
+ *
+ * @return `true` if the pool was successfully initialized, `false` otherwise.
+ *
+ * @ingroup arena_scratch
+ *
+ * @see scratch_pool_init
+ * @see arena_set_guard_pages
+ */
+bool scratch_pool_init_guarded(t_scratch_arena_pool* pool, size_t slot_size, bool thread_safe)
+{
+	const size_t page = arena_page_size();
+	if (!pool || slot_size == 0 || slot_size > SIZE_MAX / SCRATCH_MAX_SLOTS - 2 * page)
+		return arena_report_error(NULL, "scratch_pool_init_guarded failed: invalid arguments"), false;
+
+	memset(pool, 0, sizeof(*pool));
+	pool->slot_size   = arena_page_round(slot_size);
+	pool->thread_safe = thread_safe;
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	if (thread_safe)
+		pthread_mutex_init(&pool->lock, NULL);
+#endif
+
+	// One page of slack aligns the first slot, one more per slot holds its guard,
+	// and redzones (ARENA_REDZONE_SIZE) push every later slot to a further page.
+	const size_t redzone = align_up(ARENA_REDZONE_SIZE, page);
+	pool->guarded        = arena_create((pool->slot_size + page + redzone) * SCRATCH_MAX_SLOTS + page, false);
+	if (!pool->guarded)
+	{
+		scratch_pool_destroy(pool);
+		return arena_report_error(NULL, "scratch_pool_init_guarded failed: cannot create parent arena"), false;
+	}
+	arena_set_debug_label(pool->guarded, "scratch_guarded");
+	arena_set_guard_pages(pool->guarded, true);
+
+	for (int i = 0; i < SCRATCH_MAX_SLOTS; ++i)
+	{
+		if (!arena_alloc_sub_labeled(pool->guarded, &pool->slots[i].arena, slot_size, "scratch"))
+		{
+			scratch_pool_destroy(pool);
+			return false;
+		}
+		atomic_store(&pool->slots[i].in_use, false);
+	}
+	return true;
+}
+
 /**
  * @brief
  * Destroy all arenas in a scratch pool and reset its metadata.
  *
  * @details
  * This function deinitializes all scratch arenas in the pool by calling
- * `arena_destroy()` on each slot. If the pool was initialized as thread-safe,
+ * `arena_destroy()` on each slot, then deletes the parent arena of a guarded
+ * pool. If the pool was initialized as thread-safe,
  * it also destroys the associated mutex.
  *
  * After cleanup, the pool's memory is zeroed out using `memset` to prevent
@@ -304,8 +372,10 @@ void scratch_pool_destroy(t_scratch_arena_pool* pool)
 	if (!pool)
 		return;
 
+	arena_trimmer_unregister_pool(pool);
 	for (int i = 0; i < SCRATCH_MAX_SLOTS; ++i)
 		arena_destroy(&pool->slots[i].arena);
+	arena_delete(&pool->guarded);
 
 #ifdef ARENA_ENABLE_THREAD_SAFE
 	if (pool->thread_safe)
@@ -376,6 +446,8 @@ t_arena* scratch_acquire(t_scratch_arena_pool* pool)
  * and clears the `in_use` flag using `atomic_store()`.
  *
  * This allows the arena to be reused by future calls to `scratch_acquire()`.
+ * A slot watched by the pre-zeroing worker (see `scratch_pool_prezero()`) is
+ * reset first, so its memory is cleaned while nobody uses it.
  *
  * If the provided arena does not match any slot in the pool, the function
  * logs an error via `arena_report_error()` and does nothing.
@@ -407,6 +479,12 @@ void scratch_release(t_scratch_arena_pool* pool, t_arena* arena)
 	{
 		if (&pool->slots[i].arena == arena)
 		{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+			ARENA_LOCK(arena);
+			if (arena->prezero_watched)
+				arena_reset(arena); // let the worker clean the slot while it is free
+			ARENA_UNLOCK(arena);
+#endif
 			atomic_store(&pool->slots[i].in_use, false);
 			return;
 		}
@@ -415,6 +493,48 @@ void scratch_release(t_scratch_arena_pool* pool, t_arena* arena)
 	arena_report_error(arena, "scratch_release failed: arena not found in pool");
 }
 
+/**
+ * @brief
+ * Return the memory of the pool's free slots to the system.
+ *
+ * @details
+ * Each free slot is claimed with the same `atomic_exchange()` as
+ * `scratch_acquire()`, so no thread can acquire it while it is trimmed. The
+ * slot's arena is reset, shrunk back to `slot_size` if it grew while in use,
+ * and its remaining pages are decommitted. The slot is then released again.
+ *
+ * @param pool Pointer to the scratch pool to trim.
+ *
+ * @return Bytes released (shrunk or decommitted).
+ *
+ * @ingroup arena_scratch
+ *
+ * @see arena_decommit
+ * @see arena_trimmer_register_pool
+ */
+size_t scratch_pool_trim(t_scratch_arena_pool* pool)
+{
+	if (!pool)
+		return 0;
+
+	size_t released = 0;
+	for (int i = 0; i < SCRATCH_MAX_SLOTS; ++i)
+	{
+		t_scratch_slot* slot = &pool->slots[i];
+		if (atomic_exchange(&slot->in_use, true))
+			continue;
+
+		size_t before = slot->arena.size;
+		arena_reset(&slot->arena);
+		if (before > pool->slot_size)
+			arena_shrink(&slot->arena, pool->slot_size);
+		released += before - slot->arena.size;
+		released += arena_decommit(&slot->arena);
+		atomic_store(&slot->in_use, false);
+	}
+	return released;
+}
+
 /*
  * INTERNAL HELPER
  */
@@ -0,0 +1,524 @@
+/**
+ * @file arena_shared.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Shared-memory arenas usable from several processes at once.
+ *
+ * @details
+ * This file implements:
+ * - creation of a shared region (`shm_open()` or `memfd_create()`) whose first
+ *   page holds a `t_shared_arena_header`;
+ * - attaching to an existing region by name or by descriptor;
+ * - a lock-free bump allocator operating on the shared header with atomics;
+ * - conversion between pointers and position-independent `t_shared_ref` values.
+ *
+ * The header keeps all allocator state in the region, so every process sees
+ * the same offset and statistics. An atomic bump was chosen over a
+ * `PTHREAD_PROCESS_SHARED` mutex: a process that dies while allocating can
+ * never leave the arena locked.
+ *
+ * @ingroup arena_shared
+ *
+ * @example
+ * @code
+ * #include "arena_shared.h"
+ * #include <string.h>
+ *
+ * typedef struct s_msg
+ * {
+ *     t_shared_ref next;
+ *     char         text[32];
+ * } t_msg;
+ *
+ * // Producer
+ * t_shared_arena* shm = arena_create_shared("/bus", 1 << 20);
+ * t_msg*          msg = arena_shared_alloc(shm, sizeof(t_msg), _Alignof(t_msg));
+ * strcpy(msg->text, "hello");
+ * t_shared_ref    ref = arena_shared_ref(shm, msg); // send `ref` to consumers
+ *
+ * // Consumer (another process)
+ * t_shared_arena* view = arena_open_shared("/bus");
+ * t_msg*          read = arena_shared_ptr(view, ref);
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena_shared.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline bool            arena_shared_format_name(const char* name, char* out, size_t out_len);
+static inline size_t          arena_shared_header_len(void);
+static inline t_shared_arena* arena_shared_attach(int fd, const char* label);
+static inline void            arena_shared_update_peak(t_shared_arena_header* header, uint64_t offset);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Create a new shared arena.
+ *
+ * @details
+ * The region is laid out as one header page followed by `size` bytes of data
+ * (rounded up to whole pages). Named arenas are created with
+ * `shm_open(O_CREAT | O_EXCL)` so two producers never format the same region;
+ * a leading `/` is added to `name` when missing. Anonymous arenas use a memfd
+ * that other processes attach to with `arena_open_shared_fd()` after `fork()`
+ * or descriptor passing.
+ *
+ * @param name Shared memory object name, or `NULL` for an anonymous memfd.
+ * @param size Data capacity in bytes (`1` to `ARENA_MAX_ALLOWED_SIZE`).
+ *
+ * @return A handle with `attached == 1`, or `NULL` on failure.
+ *
+ * @ingroup arena_shared
+ *
+ * @see arena_open_shared
+ * @see arena_shared_close
+ */
+t_shared_arena* arena_create_shared(const char* name, size_t size)
+{
+	if (size == 0 || size > ARENA_MAX_ALLOWED_SIZE)
+	{
+		arena_report_error(NULL, "arena_create_shared failed: invalid size %zu", size);
+		return NULL;
+	}
+
+	char path[NAME_MAX + 1];
+	int  fd = -1;
+	if (!name)
+		fd = memfd_create("arena_shared", MFD_CLOEXEC);
+	else if (arena_shared_format_name(name, path, sizeof(path)))
+		fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (fd < 0)
+	{
+		arena_report_error(NULL, "arena_create_shared failed: cannot create '%s'", name ? name : "memfd");
+		return NULL;
+	}
+
+	const size_t header_len = arena_shared_header_len();
+	const size_t map_len    = arena_page_round(header_len + size);
+	if (map_len == 0 || ftruncate(fd, (off_t) map_len) != 0)
+	{
+		arena_report_error(NULL, "arena_create_shared failed: cannot size region to %zu bytes", map_len);
+		close(fd);
+		if (name)
+			shm_unlink(path);
+		return NULL;
+	}
+
+	// The new object is zero-filled, so only the non-zero fields need writing.
+	t_shared_arena_header* header = mmap(NULL, header_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (header == MAP_FAILED)
+	{
+		arena_report_error(NULL, "arena_create_shared failed: cannot map header");
+		close(fd);
+		if (name)
+			shm_unlink(path);
+		return NULL;
+	}
+	header->version    = ARENA_SHARED_VERSION;
+	header->header_len = (uint32_t) header_len;
+	header->size       = map_len - header_len;
+	atomic_init(&header->attached, 0);
+	// Publish the magic last: attachers validate it before trusting the rest.
+	atomic_thread_fence(memory_order_release);
+	memcpy(header->magic, ARENA_SHARED_MAGIC, sizeof(header->magic));
+	munmap(header, header_len);
+
+	t_shared_arena* arena = arena_shared_attach(fd, "arena_create_shared");
+	if (!arena && name)
+		shm_unlink(path);
+	return arena;
+}
+
+/**
+ * @brief
+ * Attach to an existing named shared arena.
+ *
+ * @param name Shared memory object name (with or without the leading `/`).
+ *
+ * @return A new handle, or `NULL` if the region is missing or not a shared arena.
+ *
+ * @ingroup arena_shared
+ */
+t_shared_arena* arena_open_shared(const char* name)
+{
+	char path[NAME_MAX + 1];
+	if (!arena_shared_format_name(name, path, sizeof(path)))
+	{
+		arena_report_error(NULL, "arena_open_shared failed: invalid name");
+		return NULL;
+	}
+
+	int fd = shm_open(path, O_RDWR | O_CLOEXEC, 0);
+	if (fd < 0)
+	{
+		arena_report_error(NULL, "arena_open_shared failed: cannot open '%s'", path);
+		return NULL;
+	}
+	return arena_shared_attach(fd, "arena_open_shared");
+}
+
+/**
+ * @brief
+ * Attach to a shared arena through a descriptor.
+ *
+ * @param fd Descriptor of a region created by `arena_create_shared()`.
+ *
+ * @return A new handle owning a duplicate of `fd`, or `NULL` on failure.
+ *
+ * @ingroup arena_shared
+ */
+t_shared_arena* arena_open_shared_fd(int fd)
+{
+	int copy = fd >= 0 ? fcntl(fd, F_DUPFD_CLOEXEC, 0) : -1;
+	if (copy < 0)
+	{
+		arena_report_error(NULL, "arena_open_shared_fd failed: invalid descriptor %d", fd);
+		return NULL;
+	}
+	return arena_shared_attach(copy, "arena_open_shared_fd");
+}
+
+/**
+ * @brief
+ * Detach from a shared arena.
+ *
+ * @details
+ * Decrements the shared `attached` counter, unmaps the region, closes the
+ * descriptor, frees the handle, and sets `*arena` to `NULL`. Pointers into the
+ * arena obtained through this handle become invalid; `t_shared_ref` values
+ * remain valid for other handles.
+ *
+ * @param arena Address of the handle to close (may point to `NULL`).
+ *
+ * @ingroup arena_shared
+ */
+void arena_shared_close(t_shared_arena** arena)
+{
+	if (!arena || !*arena)
+		return;
+
+	t_shared_arena* handle = *arena;
+	atomic_fetch_sub_explicit(&handle->header->attached, 1, memory_order_acq_rel);
+	munmap(handle->header, handle->map_len);
+	close(handle->fd);
+	free(handle);
+	*arena = NULL;
+}
+
+/**
+ * @brief
+ * Remove the name of a shared arena.
+ *
+ * @param name Shared memory object name.
+ *
+ * @return `true` if the name was removed.
+ *
+ * @ingroup arena_shared
+ */
+bool arena_shared_unlink(const char* name)
+{
+	char path[NAME_MAX + 1];
+	if (!arena_shared_format_name(name, path, sizeof(path)))
+		return false;
+	return shm_unlink(path) == 0;
+}
+
+/**
+ * @brief
+ * Allocate memory from a shared arena without taking a lock.
+ *
+ * @details
+ * The shared offset is advanced with a compare-and-swap loop: each attempt
+ * aligns the current offset, checks the capacity, and publishes the new end.
+ * A losing thread or process simply retries with the updated offset. Alignment
+ * is computed relative to the data area, which is page-aligned in every
+ * process, so the result is aligned regardless of where the region is mapped.
+ *
+ * Statistics are updated with relaxed atomic increments after the bump.
+ *
+ * @param arena     Shared arena handle.
+ * @param size      Number of bytes to allocate (non-zero).
+ * @param alignment Power-of-two alignment, at most the page size.
+ *
+ * @return Pointer to the allocation in this process, or `NULL` on failure.
+ *
+ * @ingroup arena_shared
+ */
+void* arena_shared_alloc(t_shared_arena* arena, size_t size, size_t alignment)
+{
+	if (!arena)
+	{
+		arena_report_error(NULL, "arena_shared_alloc failed: NULL arena");
+		return NULL;
+	}
+	if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > arena_page_size())
+	{
+		arena_report_error(NULL, "arena_shared_alloc failed: invalid size %zu or alignment %zu", size, alignment);
+		return NULL;
+	}
+
+	t_shared_arena_header* header  = arena->header;
+	uint64_t               current = atomic_load_explicit(&header->offset, memory_order_relaxed);
+	uint64_t               aligned = 0;
+	uint64_t               end     = 0;
+	do
+	{
+		aligned = align_up(current, alignment);
+		if (aligned > header->size || size > header->size - aligned)
+		{
+			atomic_fetch_add_explicit(&header->failed_allocations, 1, memory_order_relaxed);
+			arena_report_error(NULL, "arena_shared_alloc failed: out of memory (requested: %zu)", size);
+			return NULL;
+		}
+		end = aligned + size;
+	} while (!atomic_compare_exchange_weak_explicit(&header->offset, &current, end, memory_order_acq_rel,
+	                                                memory_order_relaxed));
+
+	atomic_fetch_add_explicit(&header->allocations, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&header->bytes_allocated, size, memory_order_relaxed);
+	atomic_fetch_add_explicit(&header->wasted_alignment_bytes, aligned - current, memory_order_relaxed);
+	arena_shared_update_peak(header, end);
+
+	return arena->data + aligned;
+}
+
+/**
+ * @brief
+ * Release all allocations of a shared arena.
+ *
+ * @details
+ * Resets the shared offset to zero. Statistics and peak usage are kept, as
+ * with `arena_reset()`. The caller must ensure no process still uses memory
+ * from the arena.
+ *
+ * @param arena Shared arena handle.
+ *
+ * @ingroup arena_shared
+ */
+void arena_shared_reset(t_shared_arena* arena)
+{
+	if (!arena)
+		return;
+	atomic_store_explicit(&arena->header->offset, 0, memory_order_release);
+}
+
+/**
+ * @brief
+ * Return the number of data bytes in use (including alignment padding).
+ *
+ * @ingroup arena_shared
+ */
+size_t arena_shared_used(const t_shared_arena* arena)
+{
+	if (!arena)
+		return 0;
+	return (size_t) atomic_load_explicit(&arena->header->offset, memory_order_acquire);
+}
+
+/**
+ * @brief
+ * Return a snapshot of the shared statistics.
+ *
+ * @details
+ * Fields without a shared counterpart (live allocations, timing, labels) are
+ * zero. Counters are read individually, so a snapshot taken during concurrent
+ * allocation may be slightly inconsistent.
+ *
+ * @param arena Shared arena handle.
+ *
+ * @return Statistics aggregated over every attached process.
+ *
+ * @ingroup arena_shared
+ */
+t_arena_stats arena_shared_get_stats(const t_shared_arena* arena)
+{
+	t_arena_stats stats;
+	memset(&stats, 0, sizeof(stats));
+	if (!arena)
+		return stats;
+
+	t_shared_arena_header* header = arena->header;
+	stats.allocations             = (size_t) atomic_load_explicit(&header->allocations, memory_order_relaxed);
+	stats.bytes_allocated         = (size_t) atomic_load_explicit(&header->bytes_allocated, memory_order_relaxed);
+	stats.wasted_alignment_bytes = (size_t) atomic_load_explicit(&header->wasted_alignment_bytes, memory_order_relaxed);
+	stats.failed_allocations     = (size_t) atomic_load_explicit(&header->failed_allocations, memory_order_relaxed);
+	stats.peak_usage             = (size_t) atomic_load_explicit(&header->peak_usage, memory_order_relaxed);
+	return stats;
+}
+
+/**
+ * @brief
+ * Convert a pointer into a reference valid in every attached process.
+ *
+ * @param arena Shared arena handle.
+ * @param ptr   Pointer into the data area of `arena`.
+ *
+ * @return The reference, or `ARENA_SHARED_NULL` if `ptr` is `NULL` or outside the data area.
+ *
+ * @ingroup arena_shared
+ */
+t_shared_ref arena_shared_ref(const t_shared_arena* arena, const void* ptr)
+{
+	if (!arena || !ptr)
+		return ARENA_SHARED_NULL;
+
+	const uint8_t* p = (const uint8_t*) ptr;
+	if (p < arena->data || p >= arena->data + arena->header->size)
+		return ARENA_SHARED_NULL;
+	return (t_shared_ref) (p - (const uint8_t*) arena->header);
+}
+
+/**
+ * @brief
+ * Convert a reference into a pointer for this process.
+ *
+ * @param arena Shared arena handle.
+ * @param ref   Reference produced by `arena_shared_ref()` in any process.
+ *
+ * @return The pointer, or `NULL` for `ARENA_SHARED_NULL` and out-of-range references.
+ *
+ * @ingroup arena_shared
+ */
+void* arena_shared_ptr(const t_shared_arena* arena, t_shared_ref ref)
+{
+	if (!arena || ref < arena->header->header_len || ref >= arena->map_len)
+		return NULL;
+	return (uint8_t*) arena->header + ref;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Normalize a shared memory object name to the `/name` form.
+ *
+ * @param name    User-supplied name.
+ * @param out     Output buffer.
+ * @param out_len Size of `out`.
+ *
+ * @return `false` if the name is empty, too long, or contains another `/`.
+ *
+ * @ingroup arena_shared
+ */
+static inline bool arena_shared_format_name(const char* name, char* out, size_t out_len)
+{
+	if (!name)
+		return false;
+	if (name[0] == '/')
+		name++;
+	if (name[0] == '\0' || strchr(name, '/'))
+		return false;
+
+	int written = snprintf(out, out_len, "/%s", name);
+	return written > 0 && (size_t) written < out_len;
+}
+
+/**
+ * @brief
+ * Size of the header area: one page, so the data area is page-aligned.
+ *
+ * @ingroup arena_shared
+ */
+static inline size_t arena_shared_header_len(void)
+{
+	return arena_page_round(sizeof(t_shared_arena_header));
+}
+
+/**
+ * @brief
+ * Map a shared region, validate its header, and wrap it into a handle.
+ *
+ * @details
+ * Takes ownership of `fd` (closed on failure).
+ *
+ * @param fd    Descriptor of the shared region.
+ * @param label Caller name used in error messages.
+ *
+ * @return A new handle, or `NULL` on failure.
+ *
+ * @ingroup arena_shared
+ */
+static inline t_shared_arena* arena_shared_attach(int fd, const char* label)
+{
+	const size_t header_len = arena_shared_header_len();
+	struct stat  st;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size <= header_len)
+	{
+		arena_report_error(NULL, "%s failed: region is too small", label);
+		close(fd);
+		return NULL;
+	}
+
+	const size_t           map_len = (size_t) st.st_size;
+	t_shared_arena_header* header  = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (header == MAP_FAILED)
+	{
+		arena_report_error(NULL, "%s failed: cannot map %zu bytes", label, map_len);
+		close(fd);
+		return NULL;
+	}
+
+	if (memcmp(header->magic, ARENA_SHARED_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != ARENA_SHARED_VERSION || header->header_len != header_len ||
+	    header->size != map_len - header_len)
+	{
+		arena_report_error(NULL, "%s failed: not a shared arena region", label);
+		munmap(header, map_len);
+		close(fd);
+		return NULL;
+	}
+	atomic_thread_fence(memory_order_acquire);
+
+	t_shared_arena* arena = malloc(sizeof(t_shared_arena));
+	if (!arena)
+	{
+		arena_report_error(NULL, "%s failed: handle allocation failed", label);
+		munmap(header, map_len);
+		close(fd);
+		return NULL;
+	}
+
+	arena->header  = header;
+	arena->data    = (uint8_t*) header + header_len;
+	arena->map_len = map_len;
+	arena->fd      = fd;
+	atomic_fetch_add_explicit(&header->attached, 1, memory_order_acq_rel);
+	return arena;
+}
+
+/**
+ * @brief
+ * Raise the shared peak usage to at least `offset`.
+ *
+ * @ingroup arena_shared
+ */
+static inline void arena_shared_update_peak(t_shared_arena_header* header, uint64_t offset)
+{
+	uint64_t peak = atomic_load_explicit(&header->peak_usage, memory_order_relaxed);
+	while (peak < offset &&
+	       !atomic_compare_exchange_weak_explicit(&header->peak_usage, &peak, offset, memory_order_relaxed,
+	                                              memory_order_relaxed))
+		;
+}
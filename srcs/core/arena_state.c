@@ -19,7 +19,8 @@
  * - Fully reset the arena for reuse using `arena_reset()`.
  *
  * These utilities are thread-safe and lock the arena internally before
- * accessing or modifying its state.
+ * accessing or modifying its state. Frozen arenas (see `arena_freeze()`) are
+ * read without the lock, and `arena_pop()`/`arena_reset()` reject them.
  *
  * @note
  * These functions are designed for convenience and performance in scenarios like:
@@ -74,6 +75,8 @@ size_t arena_used(t_arena* arena)
 {
 	if (!arena)
 		return 0;
+	if (ARENA_IS_FROZEN(arena))
+		return arena->offset;
 
 	ARENA_LOCK(arena);
 	size_t used = arena->offset;
@@ -123,6 +126,8 @@ size_t arena_remaining(t_arena* arena)
 {
 	if (!arena)
 		return 0;
+	if (ARENA_IS_FROZEN(arena))
+		return arena->size - arena->offset;
 
 	ARENA_LOCK(arena);
 	size_t remaining = arena->size - arena->offset;
@@ -176,6 +181,8 @@ size_t arena_peak(t_arena* arena)
 {
 	if (!arena)
 		return 0;
+	if (ARENA_IS_FROZEN(arena))
+		return arena->stats.peak_usage;
 
 	ARENA_LOCK(arena);
 	size_t peak = arena->stats.peak_usage;
@@ -228,6 +235,8 @@ t_arena_marker arena_mark(t_arena* arena)
 {
 	if (!arena)
 		return 0;
+	if (ARENA_IS_FROZEN(arena))
+		return arena->offset;
 
 	ARENA_LOCK(arena);
 	size_t offset = arena->offset;
@@ -284,6 +293,11 @@ void arena_pop(t_arena* arena, t_arena_marker marker)
 {
 	if (!arena)
 		return;
+	if (ARENA_IS_FROZEN(arena))
+	{
+		arena_report_error(arena, "arena_pop failed: arena is frozen");
+		return;
+	}
 
 	ARENA_LOCK(arena);
 	if (marker > arena->offset)
@@ -293,7 +307,10 @@ void arena_pop(t_arena* arena, t_arena_marker marker)
 		return;
 	}
 
-	arena_poison_memory(arena->buffer + marker, arena->offset - marker);
+	arena_large_release(arena, marker);
+	arena_guard_release(arena, marker);
+	arena_poison_free(arena, marker, arena->offset);
+	ARENA_SAN_RELEASE(arena, marker, arena->offset);
 	arena->offset = marker;
 	ARENA_UNLOCK(arena);
 }
@@ -307,8 +324,10 @@ void arena_pop(t_arena* arena, t_arena_marker marker)
  * discarding all previous allocations. The underlying memory buffer is not
  * freed but reused for future allocations.
  *
- * - All memory is overwritten using `arena_poison_memory()` to catch
- *   use-after-reset bugs (only in debug or poison-enabled builds).
+ * - Memory handed out since the last reset (up to `cycle_peak`) is
+ *   overwritten using `arena_poison_memory()` to catch use-after-reset bugs
+ *   (only in debug or poison-enabled builds). Bytes above were poisoned by an
+ *   earlier reset or never allocated.
  * - Statistics like `peak_usage` and `live_allocations` are not reset.
  *
  * Thread-safe: this function locks the arena during the reset.
@@ -346,12 +365,27 @@ void arena_reset(t_arena* arena)
 {
 	if (!arena)
 		return;
+	if (ARENA_IS_FROZEN(arena))
+	{
+		arena_report_error(arena, "arena_reset failed: arena is frozen");
+		return;
+	}
 
 	ARENA_LOCK(arena);
 	ARENA_ASSERT_VALID(arena);
 
-	arena_poison_memory(arena->buffer, arena->size);
+	arena_large_release(arena, 0);
+	arena_guard_release(arena, 0);
+#ifdef ARENA_POISON_MEMORY
+	size_t used = arena_cycle_high_water(arena);
+	arena_poison_free(arena, 0, used);
+	if (arena->clean_from < used)
+		arena->clean_from = used;
+#endif
+	ARENA_SAN_RELEASE(arena, 0, arena->offset);
 	arena->offset = 0;
+	arena_shrink_window_on_reset(arena);
+	ARENA_PREZERO_NOTIFY(arena);
 
 	ARENA_UNLOCK(arena);
 }
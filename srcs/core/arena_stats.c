@@ -97,6 +97,11 @@ void arena_print_stats(t_arena* arena, FILE* stream)
 	fprintf(stream, "- Bytes Allocated:        %zu bytes\n", arena->stats.bytes_allocated);
 	fprintf(stream, "- Wasted Alignment Bytes: %zu bytes\n", arena->stats.wasted_alignment_bytes);
 	fprintf(stream, "- Shrinks:                %zu\n", arena->stats.shrinks);
+	fprintf(stream, "- Shrinks Avoided:        %zu\n", arena->stats.shrinks_avoided);
+	fprintf(stream, "- Regrows After Shrink:   %zu\n", arena->stats.regrows_after_shrink);
+	fprintf(stream, "- Large Allocations:      %zu\n", arena->stats.large_allocations);
+	fprintf(stream, "- Large Bytes Mapped:     %zu bytes\n", arena->stats.large_bytes);
+	fprintf(stream, "- Background Grows:       %zu\n", arena->stats.background_grows);
 
 	// Last allocation details
 	fprintf(stream, "- Last Alloc Size:        %zu bytes\n", arena->stats.last_alloc_size);
@@ -222,6 +227,8 @@ t_arena_stats arena_get_stats(const t_arena* arena)
 
 	if (!arena)
 		return copy;
+	if (ARENA_IS_FROZEN(arena))
+		return arena->stats;
 
 	ARENA_LOCK((t_arena*) arena);
 
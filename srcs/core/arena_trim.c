@@ -0,0 +1,637 @@
+/**
+ * @file arena_trim.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Page decommit and the memory-pressure trimmer thread.
+ *
+ * @details
+ * The trimmer thread wakes every `interval_ms`, asks its pressure source for
+ * the current level and, unless it is `ARENA_PRESSURE_NONE`, runs the same
+ * pass as `arena_trim_now()` over the registered arenas and scratch pools.
+ *
+ * An arena counts as idle when `alloc_id_counter` did not move since the
+ * previous pass; each registry entry remembers the counter it last saw.
+ *
+ * Locking order is pass lock, then trimmer lock, then arena lock, and the
+ * trimmer lock is never held while an arena or pool is trimmed: the pass marks
+ * the target `busy`, drops the lock, trims, and takes it back.
+ * `arena_trimmer_unregister()` waits for `busy` to change, so a destroyed
+ * arena or pool is never touched.
+ *
+ * @ingroup arena_trim
+ */
+
+#include "arena.h"
+#include "arena_trim.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline bool arena_pressure_read_psi(t_arena_pressure* level);
+static inline bool arena_pressure_read_cgroup(t_arena_pressure* level);
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+/**
+ * @brief
+ * Registered arena and the allocation counter seen by the previous pass.
+ *
+ * @ingroup arena_trim_internal
+ */
+typedef struct s_arena_trim_entry
+{
+	t_arena* arena;   ///< Registered arena.
+	size_t   last_id; ///< `alloc_id_counter` at the previous pass.
+} t_arena_trim_entry;
+
+/**
+ * @brief
+ * State of the trimmer, shared by every registered arena and pool.
+ *
+ * @ingroup arena_trim_internal
+ */
+typedef struct s_arena_trimmer
+{
+	pthread_mutex_t       control;     ///< Serializes start and stop.
+	pthread_mutex_t       pass;        ///< Serializes trimming passes.
+	pthread_mutex_t       lock;        ///< Guards the fields below.
+	pthread_cond_t        wake;        ///< Signaled on stop.
+	pthread_cond_t        idle;        ///< Broadcast when a pass leaves an arena or pool.
+	pthread_t             thread;      ///< Trimmer thread, valid while `running`.
+	bool                  running;     ///< Whether the trimmer thread exists.
+	bool                  stop;        ///< Asks the trimmer thread to exit.
+	arena_pressure_fn     source;      ///< Pressure source sampled by the thread.
+	void*                 context;     ///< Context passed to `source`.
+	unsigned              interval_ms; ///< Sampling interval.
+	const void*           busy;        ///< Arena or pool currently being trimmed.
+	size_t                count;       ///< Number of registered arenas.
+	size_t                pool_count;  ///< Number of registered pools.
+	t_arena_trim_entry    arenas[ARENA_TRIM_MAX_ARENAS]; ///< Registered arenas.
+	t_scratch_arena_pool* pools[ARENA_TRIM_MAX_POOLS];   ///< Registered scratch pools.
+} t_arena_trimmer;
+
+static t_arena_trimmer g_trim = {
+    .control = PTHREAD_MUTEX_INITIALIZER,
+    .pass    = PTHREAD_MUTEX_INITIALIZER,
+    .lock    = PTHREAD_MUTEX_INITIALIZER,
+    .wake    = PTHREAD_COND_INITIALIZER,
+    .idle    = PTHREAD_COND_INITIALIZER,
+};
+
+static void*         arena_trim_worker(void* unused);
+static inline size_t arena_trim_arena(t_arena* arena, t_arena_pressure level, size_t* last_id);
+static inline long   arena_trim_index(const t_arena* arena);
+static inline long   arena_trim_pool_index(const t_scratch_arena_pool* pool);
+static inline void   arena_trim_wait_idle(const void* target);
+
+#endif
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Default pressure source: PSI, then cgroup v2 `memory.events`.
+ *
+ * @details
+ * The cgroup counters only ever grow, so pressure is reported when they moved
+ * since the previous call; the first call only records them.
+ *
+ * @ingroup arena_trim
+ */
+t_arena_pressure arena_pressure_read(void* context)
+{
+	(void) context;
+	t_arena_pressure level = ARENA_PRESSURE_NONE;
+
+	if (arena_pressure_read_psi(&level))
+		return level;
+	if (arena_pressure_read_cgroup(&level))
+		return level;
+	return ARENA_PRESSURE_NONE;
+}
+
+/**
+ * @brief
+ * Return the free pages of `arena` (past its offset) to the kernel.
+ *
+ * @details
+ * Only whole pages strictly inside `[buffer + offset, buffer + size)` are
+ * advised, so neither live data nor the heap allocator's metadata around a
+ * heap buffer is touched. The next allocation faults fresh zero pages in.
+ *
+ * @param arena Arena to decommit.
+ *
+ * @return Bytes decommitted.
+ *
+ * @ingroup arena_trim
+ *
+ * @see arena_might_shrink
+ */
+size_t arena_decommit(t_arena* arena)
+{
+	if (!arena || ARENA_IS_FROZEN(arena))
+		return 0;
+
+	ARENA_LOCK(arena);
+	size_t released = 0;
+	bool   owns     = atomic_load_explicit(&arena->owns_buffer, memory_order_acquire);
+	bool   kind_ok  = arena->backing.kind == ARENA_BACKING_HEAP || arena->backing.kind == ARENA_BACKING_MMAP;
+
+	if (owns && kind_ok && arena->buffer)
+	{
+		const size_t page  = arena_page_size();
+		const size_t start = align_up((size_t) (arena->buffer + arena->offset), page);
+		const size_t end   = (size_t) (arena->buffer + arena->size) & ~(page - 1);
+
+		if (end > start && madvise((void*) start, end - start, MADV_DONTNEED) == 0)
+		{
+			released = end - start;
+			// The decommitted pages read as zero; a partial last page keeps its bytes.
+			const size_t first = start - (size_t) arena->buffer;
+			if (arena->clean_from <= end - (size_t) arena->buffer && arena->clean_from > first)
+				arena->clean_from = first;
+			ARENA_POISON_CLIP(arena, first);
+		}
+	}
+	ARENA_UNLOCK(arena);
+	return released;
+}
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+/**
+ * @brief
+ * Start the trimmer thread.
+ *
+ * @ingroup arena_trim
+ *
+ * @see arena_trimmer_stop
+ */
+bool arena_trimmer_start(arena_pressure_fn source, void* context, unsigned interval_ms)
+{
+	pthread_mutex_lock(&g_trim.control);
+	if (g_trim.running)
+	{
+		pthread_mutex_unlock(&g_trim.control);
+		return arena_report_error(NULL, "arena_trimmer_start failed: already running"), false;
+	}
+
+	pthread_mutex_lock(&g_trim.lock);
+	g_trim.source      = source ? source : arena_pressure_read;
+	g_trim.context     = context;
+	g_trim.interval_ms = interval_ms ? interval_ms : ARENA_TRIM_INTERVAL_MS;
+	g_trim.stop        = false;
+	pthread_mutex_unlock(&g_trim.lock);
+
+	g_trim.running = pthread_create(&g_trim.thread, NULL, arena_trim_worker, NULL) == 0;
+	bool ok        = g_trim.running;
+	pthread_mutex_unlock(&g_trim.control);
+
+	if (!ok)
+		arena_report_error(NULL, "arena_trimmer_start failed: cannot start thread");
+	return ok;
+}
+
+/**
+ * @brief
+ * Stop and join the trimmer thread.
+ *
+ * @details
+ * A pass in progress completes first. Registered arenas and pools stay
+ * registered and can still be trimmed with `arena_trim_now()`.
+ *
+ * @ingroup arena_trim
+ */
+void arena_trimmer_stop(void)
+{
+	pthread_mutex_lock(&g_trim.control);
+	if (g_trim.running)
+	{
+		pthread_mutex_lock(&g_trim.lock);
+		g_trim.stop = true;
+		pthread_cond_signal(&g_trim.wake);
+		pthread_mutex_unlock(&g_trim.lock);
+
+		pthread_join(g_trim.thread, NULL);
+		g_trim.running = false;
+		g_trim.stop    = false;
+	}
+	pthread_mutex_unlock(&g_trim.control);
+}
+
+/**
+ * @brief
+ * Trim `arena` when the trimmer detects pressure.
+ *
+ * @return `true` if the arena is registered.
+ *
+ * @ingroup arena_trim
+ *
+ * @see arena_trimmer_unregister
+ */
+bool arena_trimmer_register(t_arena* arena)
+{
+	if (!arena)
+		return arena_report_error(NULL, "arena_trimmer_register failed: NULL arena"), false;
+	if (!arena->use_lock)
+		return arena_report_error(arena, "arena_trimmer_register failed: arena has no lock"), false;
+
+	ARENA_LOCK(arena);
+	pthread_mutex_lock(&g_trim.lock);
+	bool ok = arena_trim_index(arena) >= 0 || g_trim.count < ARENA_TRIM_MAX_ARENAS;
+	if (ok && arena_trim_index(arena) < 0)
+	{
+		g_trim.arenas[g_trim.count++] = (t_arena_trim_entry) {arena, arena->stats.alloc_id_counter};
+		arena->trim_registered        = true;
+	}
+	pthread_mutex_unlock(&g_trim.lock);
+	ARENA_UNLOCK(arena);
+
+	if (!ok)
+		arena_report_error(arena, "arena_trimmer_register failed: too many registered arenas");
+	return ok;
+}
+
+/**
+ * @brief
+ * Stop trimming `arena`.
+ *
+ * @details
+ * Waits until no pass is trimming the arena. Called by `arena_destroy()`;
+ * must not be called with the arena lock held.
+ *
+ * @ingroup arena_trim
+ */
+void arena_trimmer_unregister(t_arena* arena)
+{
+	if (!arena || !arena->use_lock)
+		return;
+
+	ARENA_LOCK(arena);
+	bool registered        = arena->trim_registered;
+	arena->trim_registered = false;
+	ARENA_UNLOCK(arena);
+	if (!registered)
+		return;
+
+	pthread_mutex_lock(&g_trim.lock);
+	long index = arena_trim_index(arena);
+	if (index >= 0)
+		g_trim.arenas[index] = g_trim.arenas[--g_trim.count];
+	arena_trim_wait_idle(arena);
+	pthread_mutex_unlock(&g_trim.lock);
+}
+
+/**
+ * @brief
+ * Trim the free slots of `pool` when the trimmer detects pressure.
+ *
+ * @return `true` if the pool is registered.
+ *
+ * @ingroup arena_trim
+ */
+bool arena_trimmer_register_pool(t_scratch_arena_pool* pool)
+{
+	if (!pool)
+		return arena_report_error(NULL, "arena_trimmer_register_pool failed: NULL pool"), false;
+
+	pthread_mutex_lock(&g_trim.lock);
+	bool ok = arena_trim_pool_index(pool) >= 0 || g_trim.pool_count < ARENA_TRIM_MAX_POOLS;
+	if (ok && arena_trim_pool_index(pool) < 0)
+		g_trim.pools[g_trim.pool_count++] = pool;
+	pthread_mutex_unlock(&g_trim.lock);
+
+	if (!ok)
+		arena_report_error(NULL, "arena_trimmer_register_pool failed: too many registered pools");
+	return ok;
+}
+
+/**
+ * @brief
+ * Stop trimming `pool`; called by `scratch_pool_destroy()`.
+ *
+ * @ingroup arena_trim
+ */
+void arena_trimmer_unregister_pool(t_scratch_arena_pool* pool)
+{
+	if (!pool)
+		return;
+
+	pthread_mutex_lock(&g_trim.lock);
+	long index = arena_trim_pool_index(pool);
+	if (index >= 0)
+		g_trim.pools[index] = g_trim.pools[--g_trim.pool_count];
+	arena_trim_wait_idle(pool);
+	pthread_mutex_unlock(&g_trim.lock);
+}
+
+/**
+ * @brief
+ * Run one trimming pass at `level` on the calling thread.
+ *
+ * @details
+ * Must not be called with an arena lock held: the pass takes the lock of
+ * every registered arena in turn.
+ *
+ * @ingroup arena_trim
+ */
+size_t arena_trim_now(t_arena_pressure level)
+{
+	if (level == ARENA_PRESSURE_NONE)
+		return 0;
+
+	size_t released = 0;
+	pthread_mutex_lock(&g_trim.pass);
+	pthread_mutex_lock(&g_trim.lock);
+	for (size_t i = 0; i < g_trim.count; ++i)
+	{
+		t_arena* arena   = g_trim.arenas[i].arena;
+		size_t   last_id = g_trim.arenas[i].last_id;
+
+		g_trim.busy = arena;
+		pthread_mutex_unlock(&g_trim.lock);
+		released += arena_trim_arena(arena, level, &last_id);
+		pthread_mutex_lock(&g_trim.lock);
+
+		long index = arena_trim_index(arena);
+		if (index >= 0)
+			g_trim.arenas[index].last_id = last_id;
+		g_trim.busy = NULL;
+		pthread_cond_broadcast(&g_trim.idle);
+	}
+	for (size_t i = 0; i < g_trim.pool_count; ++i)
+	{
+		t_scratch_arena_pool* pool = g_trim.pools[i];
+
+		g_trim.busy = pool;
+		pthread_mutex_unlock(&g_trim.lock);
+		released += scratch_pool_trim(pool);
+		pthread_mutex_lock(&g_trim.lock);
+		g_trim.busy = NULL;
+		pthread_cond_broadcast(&g_trim.idle);
+	}
+	pthread_mutex_unlock(&g_trim.lock);
+	pthread_mutex_unlock(&g_trim.pass);
+	return released;
+}
+
+#else
+
+bool arena_trimmer_start(arena_pressure_fn source, void* context, unsigned interval_ms)
+{
+	(void) source;
+	(void) context;
+	(void) interval_ms;
+	return arena_report_error(NULL, "arena_trimmer_start failed: thread safety disabled"), false;
+}
+
+void arena_trimmer_stop(void)
+{
+}
+
+bool arena_trimmer_register(t_arena* arena)
+{
+	return arena_report_error(arena, "arena_trimmer_register failed: thread safety disabled"), false;
+}
+
+void arena_trimmer_unregister(t_arena* arena)
+{
+	(void) arena;
+}
+
+bool arena_trimmer_register_pool(t_scratch_arena_pool* pool)
+{
+	(void) pool;
+	return arena_report_error(NULL, "arena_trimmer_register_pool failed: thread safety disabled"), false;
+}
+
+void arena_trimmer_unregister_pool(t_scratch_arena_pool* pool)
+{
+	(void) pool;
+}
+
+size_t arena_trim_now(t_arena_pressure level)
+{
+	(void) level;
+	return 0;
+}
+
+#endif
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Read the PSI `avg10` averages.
+ *
+ * @return `false` if PSI is unavailable (no file or unexpected format).
+ *
+ * @ingroup arena_trim_internal
+ */
+static inline bool arena_pressure_read_psi(t_arena_pressure* level)
+{
+	FILE* file = fopen(ARENA_PSI_PATH, "r");
+	if (!file)
+		return false;
+
+	char   kind[8];
+	double avg10 = 0.0;
+	double some  = -1.0;
+	double full  = 0.0;
+	while (fscanf(file, "%7s avg10=%lf %*[^\n]", kind, &avg10) == 2)
+	{
+		if (strcmp(kind, "some") == 0)
+			some = avg10;
+		else if (strcmp(kind, "full") == 0)
+			full = avg10;
+	}
+	fclose(file);
+
+	if (some < 0.0)
+		return false;
+	if (full >= ARENA_PSI_FULL_THRESHOLD)
+		*level = ARENA_PRESSURE_FULL;
+	else if (some >= ARENA_PSI_SOME_THRESHOLD)
+		*level = ARENA_PRESSURE_SOME;
+	else
+		*level = ARENA_PRESSURE_NONE;
+	return true;
+}
+
+/**
+ * @brief
+ * Compare the cgroup v2 `memory.events` counters with the previous call.
+ *
+ * @details
+ * Only the trimmer thread samples the source, so the previous counters live
+ * in function-local statics.
+ *
+ * @return `false` if the file is unavailable.
+ *
+ * @ingroup arena_trim_internal
+ */
+static inline bool arena_pressure_read_cgroup(t_arena_pressure* level)
+{
+	static bool               sampled   = false;
+	static unsigned long long prev_high = 0;
+	static unsigned long long prev_max  = 0;
+
+	FILE* file = fopen(ARENA_CGROUP_EVENTS_PATH, "r");
+	if (!file)
+		return false;
+
+	char               key[16];
+	unsigned long long value = 0;
+	unsigned long long high  = 0;
+	unsigned long long max   = 0;
+	while (fscanf(file, "%15s %llu", key, &value) == 2)
+	{
+		if (strcmp(key, "high") == 0)
+			high = value;
+		else if (strcmp(key, "max") == 0 || strcmp(key, "oom") == 0)
+			max += value;
+	}
+	fclose(file);
+
+	if (!sampled)
+		*level = ARENA_PRESSURE_NONE;
+	else if (max > prev_max)
+		*level = ARENA_PRESSURE_FULL;
+	else if (high > prev_high)
+		*level = ARENA_PRESSURE_SOME;
+	else
+		*level = ARENA_PRESSURE_NONE;
+
+	sampled   = true;
+	prev_high = high;
+	prev_max  = max;
+	return true;
+}
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+/**
+ * @brief
+ * Trimmer loop: sample the source every interval and trim under pressure.
+ *
+ * @ingroup arena_trim_internal
+ */
+static void* arena_trim_worker(void* unused)
+{
+	(void) unused;
+
+	pthread_mutex_lock(&g_trim.lock);
+	while (!g_trim.stop)
+	{
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += g_trim.interval_ms / 1000;
+		deadline.tv_nsec += (long) (g_trim.interval_ms % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+
+		int rc = 0;
+		while (!g_trim.stop && rc != ETIMEDOUT)
+			rc = pthread_cond_timedwait(&g_trim.wake, &g_trim.lock, &deadline);
+		if (g_trim.stop)
+			break;
+
+		arena_pressure_fn source  = g_trim.source;
+		void*             context = g_trim.context;
+		pthread_mutex_unlock(&g_trim.lock);
+		arena_trim_now(source(context));
+		pthread_mutex_lock(&g_trim.lock);
+	}
+	pthread_mutex_unlock(&g_trim.lock);
+	return NULL;
+}
+
+/**
+ * @brief
+ * Trim one arena if the pressure level calls for it.
+ *
+ * @details
+ * Under `ARENA_PRESSURE_SOME` only an arena that did not allocate since the
+ * previous pass is trimmed. Trimming shrinks it (as far as its shrink policy
+ * allows) and decommits what is left past the offset.
+ *
+ * @return Bytes released.
+ *
+ * @ingroup arena_trim_internal
+ */
+static inline size_t arena_trim_arena(t_arena* arena, t_arena_pressure level, size_t* last_id)
+{
+	size_t released = 0;
+
+	ARENA_LOCK(arena);
+	const size_t id   = arena->stats.alloc_id_counter;
+	const bool   idle = id == *last_id;
+	*last_id          = id;
+
+	if (idle || level == ARENA_PRESSURE_FULL)
+	{
+		const size_t before = arena->size;
+		arena_might_shrink(arena);
+		released = before - arena->size;
+		released += arena_decommit(arena);
+	}
+	ARENA_UNLOCK(arena);
+	return released;
+}
+
+/**
+ * @brief
+ * Return the registry slot of `arena`, or `-1`. Called with the trimmer lock held.
+ *
+ * @ingroup arena_trim_internal
+ */
+static inline long arena_trim_index(const t_arena* arena)
+{
+	for (size_t i = 0; i < g_trim.count; ++i)
+		if (g_trim.arenas[i].arena == arena)
+			return (long) i;
+	return -1;
+}
+
+/**
+ * @brief
+ * Return the registry slot of `pool`, or `-1`. Called with the trimmer lock held.
+ *
+ * @ingroup arena_trim_internal
+ */
+static inline long arena_trim_pool_index(const t_scratch_arena_pool* pool)
+{
+	for (size_t i = 0; i < g_trim.pool_count; ++i)
+		if (g_trim.pools[i] == pool)
+			return (long) i;
+	return -1;
+}
+
+/**
+ * @brief
+ * Wait until no pass is trimming `target`. Called with the trimmer lock held.
+ *
+ * @ingroup arena_trim_internal
+ */
+static inline void arena_trim_wait_idle(const void* target)
+{
+	while (g_trim.busy == target)
+		pthread_cond_wait(&g_trim.idle, &g_trim.lock);
+}
+
+#endif
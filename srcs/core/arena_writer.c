@@ -0,0 +1,518 @@
+/**
+ * @file arena_writer.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Arena-backed buffered writer with `writev()` flushing.
+ *
+ * @details
+ * This file implements `t_arena_writer`:
+ * - appending bytes, strings, and formatted text into arena chunks;
+ * - extending the last chunk in place with `arena_realloc_last()` when it is
+ *   still the last allocation of the arena, and starting a new chunk otherwise;
+ * - flushing every chunk to a descriptor with `writev()`, in batches of at
+ *   most `IOV_MAX` vectors, retrying partial writes.
+ *
+ * Each chunk is a `t_arena_writer_chunk` header followed by its data. Chunks
+ * are found through arena offsets, which survive buffer moves caused by
+ * growth, so they are always taken from the bump buffer (never from a
+ * large-object mapping). Every operation that touches chunk memory holds the arena lock, so
+ * other threads may keep allocating from the same arena while a writer is
+ * in use. `arena_writer_flush()` releases it around `writev()`, with the
+ * chunks pinned (see `arena_io_pin()`) so that a growth cannot free them
+ * while the kernel reads them.
+ *
+ * @ingroup arena_writer
+ *
+ * @example
+ * @code
+ * #include "arena_writer.h"
+ *
+ * t_arena_writer out;
+ * arena_writer_init(&out, request_arena, 0);
+ * arena_writer_puts(&out, "HTTP/1.1 200 OK\r\n");
+ * arena_writer_printf(&out, "Content-Length: %zu\r\n\r\n", body_len);
+ * arena_writer_write(&out, body, body_len);
+ * arena_writer_flush(&out, client_fd);
+ * @endcode
+ */
+
+#include "arena_writer.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline t_arena_writer_chunk* arena_writer_chunk_at(const t_arena_writer* writer, size_t off);
+static inline void                  arena_writer_pin(t_arena_writer* writer, t_arena_io_pin* pin);
+static inline int                   arena_writer_gather(const t_arena_writer* writer, size_t* off, struct iovec* iov);
+static inline uint8_t*              arena_writer_reserve(t_arena_writer* writer, size_t len);
+static inline bool                  arena_writer_extend_tail(t_arena_writer* writer, size_t len);
+static inline bool                  arena_writer_new_chunk(t_arena_writer* writer, size_t len);
+static inline bool                  arena_writer_writev_all(int fd, struct iovec* iov, int count, size_t* written);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Initialize an empty writer bound to an arena.
+ *
+ * @details
+ * No memory is allocated until the first write.
+ *
+ * @param writer     Writer to initialize.
+ * @param arena      Arena providing chunk memory.
+ * @param chunk_size Minimum capacity of new chunks (`0` selects `ARENA_WRITER_CHUNK_SIZE`).
+ *
+ * @return `true` on success, `false` if `writer` or `arena` is `NULL`.
+ *
+ * @ingroup arena_writer
+ */
+bool arena_writer_init(t_arena_writer* writer, t_arena* arena, size_t chunk_size)
+{
+	if (!writer || !arena)
+	{
+		arena_report_error(arena, "arena_writer_init failed: invalid arguments");
+		return false;
+	}
+
+	writer->arena      = arena;
+	writer->chunk_size = chunk_size ? chunk_size : ARENA_WRITER_CHUNK_SIZE;
+	arena_writer_reset(writer);
+	return true;
+}
+
+/**
+ * @brief
+ * Append raw bytes to the writer.
+ *
+ * @param writer Writer to append to.
+ * @param data   Bytes to copy (may be `NULL` if `len` is 0).
+ * @param len    Number of bytes.
+ *
+ * @return `true` if the bytes were stored, `false` if the arena is out of
+ *         memory (the writer is then marked as failed).
+ *
+ * @ingroup arena_writer
+ */
+bool arena_writer_write(t_arena_writer* writer, const void* data, size_t len)
+{
+	if (!writer || !writer->arena || (!data && len))
+		return false;
+	if (len == 0)
+		return true;
+
+	ARENA_LOCK(writer->arena);
+	uint8_t* dst = arena_writer_reserve(writer, len);
+	if (dst)
+	{
+		memcpy(dst, data, len);
+		arena_writer_chunk_at(writer, writer->tail_off)->len += len;
+		writer->total += len;
+	}
+	ARENA_UNLOCK(writer->arena);
+	return dst != NULL;
+}
+
+/**
+ * @brief
+ * Append a NUL-terminated string, without the terminator.
+ *
+ * @ingroup arena_writer
+ */
+bool arena_writer_puts(t_arena_writer* writer, const char* str)
+{
+	if (!str)
+		return false;
+	return arena_writer_write(writer, str, strlen(str));
+}
+
+/**
+ * @brief
+ * Append formatted text.
+ *
+ * @ingroup arena_writer
+ *
+ * @see arena_writer_vprintf
+ */
+bool arena_writer_printf(t_arena_writer* writer, const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	bool ok = arena_writer_vprintf(writer, fmt, args);
+	va_end(args);
+	return ok;
+}
+
+/**
+ * @brief
+ * Append formatted text from a `va_list`.
+ *
+ * @details
+ * The text is formatted directly into the free space of the last chunk. If it
+ * does not fit, the exact length reported by `vsnprintf()` is reserved (in
+ * place when possible) and the text is formatted a second time. The
+ * terminating NUL written by `vsnprintf()` is not counted as output.
+ *
+ * @param writer Writer to append to.
+ * @param fmt    `printf` format string.
+ * @param args   Format arguments.
+ *
+ * @return `true` on success, `false` on a format error or out of memory.
+ *
+ * @ingroup arena_writer
+ */
+bool arena_writer_vprintf(t_arena_writer* writer, const char* fmt, va_list args)
+{
+	if (!writer || !writer->arena || !fmt)
+		return false;
+
+	ARENA_LOCK(writer->arena);
+
+	char*  dst   = NULL;
+	size_t avail = 0;
+	if (writer->tail_off != ARENA_WRITER_NO_CHUNK)
+	{
+		t_arena_writer_chunk* tail = arena_writer_chunk_at(writer, writer->tail_off);
+		dst                        = (char*) (tail + 1) + tail->len;
+		avail                      = tail->cap - tail->len;
+	}
+
+	va_list copy;
+	va_copy(copy, args);
+	int needed = vsnprintf(dst, avail, fmt, copy);
+	va_end(copy);
+
+	bool ok = needed >= 0;
+	if (ok && (size_t) needed >= avail)
+	{
+		dst = (char*) arena_writer_reserve(writer, (size_t) needed + 1);
+		ok  = dst && vsnprintf(dst, (size_t) needed + 1, fmt, args) == needed;
+	}
+	if (ok)
+	{
+		arena_writer_chunk_at(writer, writer->tail_off)->len += (size_t) needed;
+		writer->total += (size_t) needed;
+	}
+	else
+		writer->failed = true;
+
+	ARENA_UNLOCK(writer->arena);
+	return ok;
+}
+
+/**
+ * @brief
+ * Return the number of buffered bytes.
+ *
+ * @ingroup arena_writer
+ */
+size_t arena_writer_size(const t_arena_writer* writer)
+{
+	return writer ? writer->total : 0;
+}
+
+/**
+ * @brief
+ * Flush the buffered output to a descriptor.
+ *
+ * @details
+ * All chunks are gathered into `iovec` arrays of at most `IOV_MAX` entries
+ * and written with `writev()`; partial writes and `EINTR` are retried, so a
+ * blocking descriptor receives everything. Each array is gathered under the
+ * arena lock, which is released for the system call: other threads can use
+ * the arena while a slow descriptor blocks. The chunks stay pinned until the
+ * flush ends, so they remain readable even if a growth moves the buffer.
+ *
+ * On success the writer is emptied (`arena_writer_reset()`); the chunk memory
+ * itself is reclaimed with the arena.
+ *
+ * @param writer Writer to flush.
+ * @param fd     Destination descriptor.
+ *
+ * @return The number of bytes written, or `-1` if `writev()` failed or the
+ *         writer had dropped output. The writer is left unchanged on error.
+ *
+ * @ingroup arena_writer
+ */
+ssize_t arena_writer_flush(t_arena_writer* writer, int fd)
+{
+	if (!writer || !writer->arena || fd < 0 || writer->failed)
+		return -1;
+
+	struct iovec   iov[IOV_MAX];
+	t_arena_io_pin pin;
+	size_t         written = 0;
+	bool           ok      = true;
+
+	ARENA_LOCK(writer->arena);
+	arena_writer_pin(writer, &pin);
+	size_t off = writer->head_off;
+	while (ok && off != ARENA_WRITER_NO_CHUNK)
+	{
+		int count = arena_writer_gather(writer, &off, iov);
+		ARENA_UNLOCK(writer->arena);
+		ok = arena_writer_writev_all(fd, iov, count, &written);
+		ARENA_LOCK(writer->arena);
+	}
+	arena_io_unpin(writer->arena, &pin);
+	ARENA_UNLOCK(writer->arena);
+
+	if (!ok)
+	{
+		arena_report_error(writer->arena, "arena_writer_flush failed: writev failed after %zu bytes", written);
+		return -1;
+	}
+
+	arena_writer_reset(writer);
+	return (ssize_t) written;
+}
+
+/**
+ * @brief
+ * Forget all buffered output and clear the failure flag.
+ *
+ * @details
+ * The next write starts a new chunk. Memory of previous chunks stays in the
+ * arena until it is reset or popped.
+ *
+ * @ingroup arena_writer
+ */
+void arena_writer_reset(t_arena_writer* writer)
+{
+	if (!writer)
+		return;
+
+	writer->head_off    = ARENA_WRITER_NO_CHUNK;
+	writer->tail_off    = ARENA_WRITER_NO_CHUNK;
+	writer->total       = 0;
+	writer->chunk_count = 0;
+	writer->failed      = false;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Resolve a chunk offset into a pointer valid until the arena buffer moves.
+ *
+ * @ingroup arena_writer
+ */
+static inline t_arena_writer_chunk* arena_writer_chunk_at(const t_arena_writer* writer, size_t off)
+{
+	return (t_arena_writer_chunk*) (writer->arena->buffer + off);
+}
+
+/**
+ * @brief
+ * Pin the chunks of `writer` for `writev()` calls made without the arena lock.
+ *
+ * @details
+ * Called with the arena lock held. Chunks follow each other in the buffer,
+ * so one range covers them all, from the first header to the end of the
+ * last chunk. An empty writer pins nothing.
+ *
+ * @ingroup arena_writer
+ */
+static inline void arena_writer_pin(t_arena_writer* writer, t_arena_io_pin* pin)
+{
+	if (writer->head_off == ARENA_WRITER_NO_CHUNK)
+	{
+		arena_io_pin(writer->arena, pin, NULL, 0, false);
+		return;
+	}
+
+	const t_arena_writer_chunk* tail = arena_writer_chunk_at(writer, writer->tail_off);
+	const size_t                end  = writer->tail_off + sizeof(*tail) + tail->cap;
+	arena_io_pin(writer->arena, pin, writer->arena->buffer + writer->head_off, end - writer->head_off, false);
+}
+
+/**
+ * @brief
+ * Fill `iov` with up to `IOV_MAX` non-empty chunks, starting at `*off`.
+ *
+ * @details
+ * Called with the arena lock held. `*off` is advanced past the gathered
+ * chunks (`ARENA_WRITER_NO_CHUNK` after the last one).
+ *
+ * @return The number of vectors filled.
+ *
+ * @ingroup arena_writer
+ */
+static inline int arena_writer_gather(const t_arena_writer* writer, size_t* off, struct iovec* iov)
+{
+	int count = 0;
+	for (; *off != ARENA_WRITER_NO_CHUNK && count < IOV_MAX; *off = arena_writer_chunk_at(writer, *off)->next_off)
+	{
+		t_arena_writer_chunk* chunk = arena_writer_chunk_at(writer, *off);
+		if (chunk->len == 0)
+			continue;
+		iov[count].iov_base = chunk + 1;
+		iov[count].iov_len  = chunk->len;
+		count++;
+	}
+	return count;
+}
+
+/**
+ * @brief
+ * Make room for `len` bytes at the end of the last chunk.
+ *
+ * @details
+ * Uses the free space of the last chunk, then tries to extend it in place,
+ * then starts a new chunk. Must be called with the arena lock held.
+ *
+ * @return Pointer to the free space, or `NULL` (writer marked as failed).
+ *
+ * @ingroup arena_writer
+ */
+static inline uint8_t* arena_writer_reserve(t_arena_writer* writer, size_t len)
+{
+	if (writer->tail_off != ARENA_WRITER_NO_CHUNK)
+	{
+		t_arena_writer_chunk* tail = arena_writer_chunk_at(writer, writer->tail_off);
+		if (tail->cap - tail->len < len && !arena_writer_extend_tail(writer, len))
+			tail = NULL;
+		if (tail)
+		{
+			tail = arena_writer_chunk_at(writer, writer->tail_off);
+			return (uint8_t*) (tail + 1) + tail->len;
+		}
+	}
+
+	if (!arena_writer_new_chunk(writer, len))
+	{
+		writer->failed = true;
+		return NULL;
+	}
+	return (uint8_t*) (arena_writer_chunk_at(writer, writer->tail_off) + 1);
+}
+
+/**
+ * @brief
+ * Extend the last chunk in place if it is still the arena's last allocation.
+ *
+ * @details
+ * The chunk capacity at least doubles, so a long run of small writes costs a
+ * logarithmic number of extensions. `arena_realloc_last()` grows the arena if
+ * needed; the chunk keeps its offset even if the buffer moves.
+ *
+ * @return `true` if the last chunk now has room for `len` more bytes.
+ *
+ * @ingroup arena_writer
+ */
+static inline bool arena_writer_extend_tail(t_arena_writer* writer, size_t len)
+{
+	t_arena*              arena = writer->arena;
+	t_arena_writer_chunk* tail  = arena_writer_chunk_at(writer, writer->tail_off);
+	const size_t          old   = sizeof(*tail) + tail->cap;
+
+	if (writer->tail_off + old != arena->offset)
+		return false;
+
+	size_t new_cap = tail->cap * 2;
+	if (new_cap < tail->len + len)
+		new_cap = tail->len + len;
+	if (new_cap > SIZE_MAX - sizeof(*tail))
+		return false;
+
+	tail = arena_realloc_last(arena, tail, old, sizeof(*tail) + new_cap);
+	if (!tail)
+		return false;
+
+	tail->cap = new_cap;
+	return true;
+}
+
+/**
+ * @brief
+ * Allocate a new chunk able to hold `len` bytes and link it at the end of the list.
+ *
+ * @details
+ * Chunks always come from the bump buffer, even past the arena's large-object
+ * threshold: they are found by buffer offset, which a dedicated mapping does
+ * not have.
+ *
+ * @ingroup arena_writer
+ */
+static inline bool arena_writer_new_chunk(t_arena_writer* writer, size_t len)
+{
+	size_t cap = len > writer->chunk_size ? len : writer->chunk_size;
+	if (cap > SIZE_MAX - sizeof(t_arena_writer_chunk))
+		return false;
+
+	t_arena_writer_chunk* chunk =
+	    arena_alloc_in_buffer(writer->arena, sizeof(*chunk) + cap, _Alignof(t_arena_writer_chunk), "arena_writer");
+	if (!chunk)
+		return false;
+
+	chunk->next_off = ARENA_WRITER_NO_CHUNK;
+	chunk->len      = 0;
+	chunk->cap      = cap;
+
+	size_t off = (size_t) ((uint8_t*) chunk - writer->arena->buffer);
+	if (writer->tail_off == ARENA_WRITER_NO_CHUNK)
+		writer->head_off = off;
+	else
+		arena_writer_chunk_at(writer, writer->tail_off)->next_off = off;
+	writer->tail_off = off;
+	writer->chunk_count++;
+	return true;
+}
+
+/**
+ * @brief
+ * Write a batch of vectors completely, retrying partial writes.
+ *
+ * @param fd      Destination descriptor.
+ * @param iov     Vectors to write (modified in place on partial writes).
+ * @param count   Number of vectors.
+ * @param written Incremented by the number of bytes written.
+ *
+ * @return `true` once every byte was written, `false` on error.
+ *
+ * @ingroup arena_writer
+ */
+static inline bool arena_writer_writev_all(int fd, struct iovec* iov, int count, size_t* written)
+{
+	while (count > 0)
+	{
+		ssize_t n = writev(fd, iov, count);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		*written += (size_t) n;
+
+		size_t left = (size_t) n;
+		while (count > 0 && left >= iov->iov_len)
+		{
+			left -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if (count > 0)
+		{
+			iov->iov_base = (uint8_t*) iov->iov_base + left;
+			iov->iov_len -= left;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,636 @@
+/**
+ * @file arena_backing.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief Buffer backing primitives (heap blocks and memory mappings).
+ *
+ * @details
+ * This file implements the low-level operations used to resize and release
+ * an arena buffer according to its `t_arena_backing` record:
+ *
+ * - Heap buffers are resized with `realloc()` and released with `free()`.
+ * - Owned buffers of at least `ARENA_MMAP_THRESHOLD` bytes are anonymous
+ *   mappings resized with `mremap()` alone (`arena_backing_alloc()`), and heap
+ *   buffers growing past that threshold are moved into one.
+ * - File and memfd mappings are resized with `ftruncate()` + `mremap()` and
+ *   released with `munmap()` + `close()`.
+ * - Copy-on-write views share their file with another arena, so they are
+ *   never resized; they are released like any other mapping.
+ * - Anonymous mappings can live at the start of a reservation of `PROT_NONE`
+ *   address space (`arena_backing_resize_reserved()`): growing within it only
+ *   changes page protections, so the buffer never moves, and shrinking gives
+ *   the pages back while keeping the address range.
+ * - `arena_backing_adopt()` wraps an existing mapping into a new arena.
+ *
+ * Keeping these primitives in one place lets `arena_grow()`, `arena_shrink()`
+ * and `arena_destroy()` support several kinds of memory without duplicating
+ * the platform-specific code.
+ *
+ * @note
+ * All functions in this file are considered part of the `@ingroup arena_internal`.
+ * Callers are expected to hold the arena lock where required.
+ *
+ * @ingroup arena_internal
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline uint8_t* arena_backing_resize_mapping(t_arena_backing* backing, size_t new_size, int flags);
+static inline uint8_t* arena_backing_resize_in_reserve(t_arena_backing* backing, size_t new_len, int flags);
+static inline uint8_t* arena_backing_map_anonymous(t_arena_backing* backing, size_t size);
+static inline uint8_t* arena_backing_map_reserved(t_arena_backing* backing, uint8_t* buffer, size_t old_size,
+                                                  size_t new_size, size_t reserve_len);
+static inline uint8_t* arena_backing_migrate(t_arena_backing* backing, uint8_t* buffer, size_t old_size,
+                                             size_t new_size);
+
+/*
+ * PUBLIC API
+ */
+
+/**
+ * @brief
+ * Return the system page size.
+ *
+ * @details
+ * The value is queried once with `sysconf(_SC_PAGESIZE)` and cached in an
+ * atomic so subsequent calls are a single relaxed load. If the query fails,
+ * a conservative 4 KiB page is assumed.
+ *
+ * @return The page size in bytes.
+ *
+ * @ingroup arena_internal
+ */
+size_t arena_page_size(void)
+{
+	static _Atomic size_t cached = 0;
+
+	size_t page = atomic_load_explicit(&cached, memory_order_relaxed);
+	if (page == 0)
+	{
+		long value = sysconf(_SC_PAGESIZE);
+		page       = value > 0 ? (size_t) value : 4096;
+		atomic_store_explicit(&cached, page, memory_order_relaxed);
+	}
+	return page;
+}
+
+/**
+ * @brief
+ * Round a byte count up to a whole number of pages.
+ *
+ * @param size Number of bytes to round.
+ *
+ * @return `size` rounded up to the page size, or `0` on overflow.
+ *
+ * @ingroup arena_internal
+ */
+size_t arena_page_round(size_t size)
+{
+	const size_t page = arena_page_size();
+	if (size > SIZE_MAX - (page - 1))
+		return 0;
+	return (size + page - 1) & ~(page - 1);
+}
+
+/**
+ * @brief
+ * Reset a backing record to describe a plain heap buffer.
+ *
+ * @param backing Backing record to reset.
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_zero_metadata
+ */
+void arena_backing_reset(t_arena_backing* backing)
+{
+	backing->kind        = ARENA_BACKING_HEAP;
+	backing->fd          = -1;
+	backing->map_base    = NULL;
+	backing->map_len     = 0;
+	backing->header_len  = 0;
+	backing->relocation  = 0;
+	backing->reserve_len = 0;
+}
+
+/**
+ * @brief
+ * Check whether a buffer lives inside a memory mapping.
+ *
+ * @details
+ * Mapped buffers must never be passed to `free()`/`realloc()`, and poisoning
+ * them before release is pointless (the pages are unmapped, or belong to a
+ * file whose contents must survive).
+ *
+ * @param backing Backing record to inspect.
+ *
+ * @return `true` for mapped backings, `false` for heap buffers.
+ *
+ * @ingroup arena_internal
+ */
+bool arena_backing_is_mapped(const t_arena_backing* backing)
+{
+	return backing && backing->kind != ARENA_BACKING_HEAP;
+}
+
+/**
+ * @brief
+ * Create a shared read/write mapping of a file descriptor.
+ *
+ * @details
+ * When `hint` is non-NULL the mapping is first attempted at exactly that
+ * address with `MAP_FIXED_NOREPLACE`, so that a reopened arena lands where
+ * it was before and absolute pointers stored inside it stay valid. If the
+ * address is taken (or the kernel ignores the flag), the hinted mapping is
+ * dropped and the region is mapped wherever the kernel chooses.
+ *
+ * @param fd   Descriptor to map.
+ * @param len  Number of bytes to map (page multiple).
+ * @param hint Preferred mapping address, or `NULL`.
+ *
+ * @return The mapping address, or `NULL` on failure.
+ *
+ * @ingroup arena_internal
+ */
+void* arena_backing_map_shared(int fd, size_t len, void* hint)
+{
+	const int prot = PROT_READ | PROT_WRITE;
+
+#ifdef MAP_FIXED_NOREPLACE
+	if (hint)
+	{
+		void* at = mmap(hint, len, prot, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+		if (at == hint)
+			return at;
+		if (at != MAP_FAILED)
+			munmap(at, len);
+	}
+#else
+	(void) hint;
+#endif
+
+	void* map = mmap(NULL, len, prot, MAP_SHARED, fd, 0);
+	return map == MAP_FAILED ? NULL : map;
+}
+
+/**
+ * @brief
+ * Wrap an existing shared mapping into a new heap-allocated arena.
+ *
+ * @details
+ * The arena struct is allocated with `calloc()` and initialized over the
+ * buffer found `header_len` bytes into the mapping. It is then marked as
+ * owning that buffer (so it can grow and is released on destroy), and its
+ * backing record is filled in. `offset` restores the bump pointer of an arena
+ * reopened from a previous session; peak usage starts at the same value.
+ *
+ * @param kind        Mapped backing kind.
+ * @param fd          Descriptor behind the mapping (owned by the arena on success).
+ * @param map         Start of the mapping.
+ * @param map_len     Length of the mapping in bytes.
+ * @param header_len  Bytes reserved in front of the buffer.
+ * @param size        Usable buffer size in bytes.
+ * @param offset      Initial bump offset.
+ * @param relocation  Address shift compared to a previous session.
+ * @param allow_grow  Whether the arena may grow.
+ * @param label       Debug label for the arena.
+ *
+ * @return The new arena, or `NULL` if the struct could not be allocated.
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_open_persistent
+ * @see arena_create_memfd
+ */
+t_arena* arena_backing_adopt(t_arena_backing_kind kind, int fd, void* map, size_t map_len, size_t header_len,
+                             size_t size, size_t offset, intptr_t relocation, bool allow_grow, const char* label)
+{
+	t_arena* arena = (t_arena*) calloc(1, sizeof(t_arena));
+	if (!arena)
+		return NULL;
+
+	arena_init_with_buffer(arena, (uint8_t*) map + header_len, size, allow_grow);
+	arena_set_debug_label(arena, label);
+
+	ARENA_LOCK(arena);
+	atomic_store_explicit(&arena->owns_buffer, true, memory_order_release);
+	arena->backing.kind       = kind;
+	arena->backing.fd         = fd;
+	arena->backing.map_base   = map;
+	arena->backing.map_len    = map_len;
+	arena->backing.header_len = header_len;
+	arena->backing.relocation = relocation;
+
+	arena->offset           = offset;
+	arena->stats.peak_usage = offset;
+	ARENA_SAN_ATTACH(arena);
+	ARENA_UNLOCK(arena);
+	return arena;
+}
+
+/**
+ * @brief
+ * Allocate a zeroed buffer for an arena that owns its memory.
+ *
+ * @details
+ * Small buffers come from `calloc()`. Buffers of at least
+ * `ARENA_MMAP_THRESHOLD` bytes are anonymous private mappings: they are
+ * zeroed lazily by the kernel and can later be grown or shrunk with
+ * `mremap()` instead of `realloc()` plus a copy.
+ *
+ * @param backing Backing record describing the new buffer (reset first).
+ * @param size    Buffer size in bytes.
+ *
+ * @return The buffer, or `NULL` on failure.
+ *
+ * @ingroup arena_internal
+ */
+uint8_t* arena_backing_alloc(t_arena_backing* backing, size_t size)
+{
+	arena_backing_reset(backing);
+	if (size < ARENA_MMAP_THRESHOLD)
+		return (uint8_t*) calloc(1, size);
+	return arena_backing_map_anonymous(backing, size);
+}
+
+/**
+ * @brief
+ * Resize an arena buffer according to its backing.
+ *
+ * @details
+ * Heap buffers are resized with `realloc()`, except when they grow to
+ * `ARENA_MMAP_THRESHOLD` bytes or more: they are then copied once into an
+ * anonymous mapping and become `ARENA_BACKING_MMAP`. Mapped buffers have
+ * their file (if any) resized first when growing (so the new pages are
+ * backed) and last when shrinking (so the mapping never covers a truncated
+ * tail), then the mapping itself is resized with `mremap(MREMAP_MAYMOVE)`,
+ * which relinks page tables instead of copying bytes.
+ *
+ * Copy-on-write views are never resized: truncating the shared file would
+ * change the arena they were cloned from.
+ *
+ * On failure the original buffer and backing record are left untouched.
+ *
+ * @param backing   Backing record of the arena (updated on success).
+ * @param buffer    Current buffer pointer.
+ * @param old_size  Current buffer size in bytes.
+ * @param new_size  Requested buffer size in bytes.
+ *
+ * @return The resized buffer, or `NULL` on failure.
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_grow
+ * @see arena_shrink
+ */
+uint8_t* arena_backing_resize(t_arena_backing* backing, uint8_t* buffer, size_t old_size, size_t new_size)
+{
+	if (!arena_backing_is_mapped(backing))
+	{
+		if (new_size > old_size && new_size >= ARENA_MMAP_THRESHOLD)
+			return arena_backing_migrate(backing, buffer, old_size, new_size);
+		return (uint8_t*) realloc(buffer, new_size);
+	}
+	if (backing->kind == ARENA_BACKING_COW)
+		return NULL;
+
+	return arena_backing_resize_mapping(backing, new_size, MREMAP_MAYMOVE);
+}
+
+/**
+ * @brief
+ * Grow an arena buffer without moving it.
+ *
+ * @details
+ * Within a reservation, the pages up to `new_size` are made accessible.
+ * Other mappings are extended with `mremap()` without `MREMAP_MAYMOVE`
+ * (their file, if any, is extended first), which only succeeds when the
+ * address range right after the mapping is free. Heap buffers are never
+ * grown in place, since `realloc()` may move them.
+ *
+ * Pointers into the buffer stay valid whatever the outcome, so this is safe
+ * while other threads use the buffer.
+ *
+ * @param backing  Backing record of the arena (updated on success).
+ * @param new_size Requested buffer size in bytes, larger than the current one.
+ *
+ * @return The unchanged buffer, or `NULL` if it cannot grow in place.
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_grow_in_place
+ */
+uint8_t* arena_backing_extend(t_arena_backing* backing, size_t new_size)
+{
+	if (!arena_backing_is_mapped(backing) || backing->kind == ARENA_BACKING_COW)
+		return NULL;
+
+	return arena_backing_resize_mapping(backing, new_size, 0);
+}
+
+/**
+ * @brief
+ * Grow an arena buffer inside a reservation of `reserve_len` bytes.
+ *
+ * @details
+ * If the current reservation already covers `new_size`, the buffer grows in
+ * place. Otherwise a fresh `PROT_NONE` reservation is mapped, its first
+ * `new_size` bytes are made accessible, and the buffer moves to its start:
+ * heap buffers are copied there once, anonymous mappings are relinked with
+ * `mremap(MREMAP_FIXED)`. The rest of the old reservation, if any, is
+ * released.
+ *
+ * File, memfd and copy-on-write mappings are never moved into a reservation.
+ *
+ * @param backing     Backing record of the arena (becomes `ARENA_BACKING_MMAP`).
+ * @param buffer      Current buffer pointer.
+ * @param old_size    Current buffer size in bytes.
+ * @param new_size    Requested buffer size in bytes.
+ * @param reserve_len Address space to reserve when the buffer has to move.
+ *
+ * @return The (possibly moved) buffer, or `NULL` on failure (the old buffer
+ *         and backing record are left untouched).
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_backing_extend
+ */
+uint8_t* arena_backing_resize_reserved(t_arena_backing* backing, uint8_t* buffer, size_t old_size, size_t new_size,
+                                       size_t reserve_len)
+{
+	if (backing->kind != ARENA_BACKING_HEAP && backing->kind != ARENA_BACKING_MMAP)
+		return NULL;
+	if (backing->reserve_len && arena_page_round(new_size) <= backing->reserve_len)
+		return arena_backing_resize_mapping(backing, new_size, 0);
+
+	return arena_backing_map_reserved(backing, buffer, old_size, new_size, reserve_len);
+}
+
+/**
+ * @brief
+ * Release an arena buffer according to its backing.
+ *
+ * @details
+ * Heap buffers are returned with `free()`. Mapped buffers are unmapped and
+ * their descriptor is closed; file contents are left exactly as they are.
+ * The backing record is reset to the heap default afterwards.
+ *
+ * @param backing Backing record of the arena.
+ * @param buffer  Buffer pointer to release (may be `NULL`).
+ * @param size    Buffer size in bytes.
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_destroy
+ */
+void arena_backing_release(t_arena_backing* backing, uint8_t* buffer, size_t size)
+{
+	(void) size;
+
+	if (!arena_backing_is_mapped(backing))
+	{
+		free(buffer);
+		arena_backing_reset(backing);
+		return;
+	}
+
+	if (backing->map_base)
+		munmap(backing->map_base, backing->reserve_len ? backing->reserve_len : backing->map_len);
+	if (backing->fd >= 0)
+		close(backing->fd);
+	arena_backing_reset(backing);
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Resize a mapping to hold `new_size` buffer bytes.
+ *
+ * @details
+ * The file behind the mapping, if any, is resized along with it. Anonymous
+ * mappings (`fd < 0`) only need `mremap()`, or a change of protection when
+ * they sit in a reservation.
+ *
+ * @param backing  Backing record to update.
+ * @param new_size Requested buffer size in bytes (header excluded).
+ * @param flags    `MREMAP_MAYMOVE` to let the mapping move, `0` otherwise.
+ *
+ * @return The new buffer address, or `NULL` on failure.
+ *
+ * @ingroup arena_internal
+ */
+static inline uint8_t* arena_backing_resize_mapping(t_arena_backing* backing, size_t new_size, int flags)
+{
+	if (new_size > SIZE_MAX - backing->header_len)
+		return NULL;
+
+	const size_t new_len = arena_page_round(backing->header_len + new_size);
+	if (new_len == 0)
+		return NULL;
+	if (backing->reserve_len)
+		return arena_backing_resize_in_reserve(backing, new_len, flags);
+
+	const bool has_file = backing->fd >= 0;
+	const bool growing  = new_len > backing->map_len;
+	if (has_file && growing && ftruncate(backing->fd, (off_t) new_len) != 0)
+		return NULL;
+
+	void* map = mremap(backing->map_base, backing->map_len, new_len, flags);
+	if (map == MAP_FAILED)
+	{
+		if (has_file && growing)
+			(void) !ftruncate(backing->fd, (off_t) backing->map_len);
+		return NULL;
+	}
+
+	if (has_file && !growing)
+		(void) !ftruncate(backing->fd, (off_t) new_len);
+
+	backing->map_base = map;
+	backing->map_len  = new_len;
+	return (uint8_t*) map + backing->header_len;
+}
+
+/**
+ * @brief
+ * Resize an anonymous mapping that sits at the start of a reservation.
+ *
+ * @details
+ * Within the reservation, growing makes the next pages accessible and
+ * shrinking maps fresh `PROT_NONE` pages over the tail, which frees its
+ * memory but keeps the address range. Growing past the reservation needs
+ * `MREMAP_MAYMOVE`: the mapping moves out and the rest of the reservation
+ * is released.
+ *
+ * @param backing Backing record to update.
+ * @param new_len Requested mapping length, rounded to whole pages.
+ * @param flags   `MREMAP_MAYMOVE` to let the mapping move, `0` otherwise.
+ *
+ * @return The new buffer address, or `NULL` on failure.
+ *
+ * @ingroup arena_internal
+ */
+static inline uint8_t* arena_backing_resize_in_reserve(t_arena_backing* backing, size_t new_len, int flags)
+{
+	uint8_t* base = (uint8_t*) backing->map_base;
+
+	if (new_len <= backing->reserve_len)
+	{
+		if (new_len > backing->map_len &&
+		    mprotect(base + backing->map_len, new_len - backing->map_len, PROT_READ | PROT_WRITE) != 0)
+			return NULL;
+		if (new_len < backing->map_len && mmap(base + new_len, backing->map_len - new_len, PROT_NONE,
+		                                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+			return NULL;
+		backing->map_len = new_len;
+		return base;
+	}
+	if (!(flags & MREMAP_MAYMOVE))
+		return NULL;
+
+	void* map = mremap(base, backing->map_len, new_len, MREMAP_MAYMOVE);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	munmap(base + backing->map_len, backing->reserve_len - backing->map_len);
+	backing->map_base    = map;
+	backing->map_len     = new_len;
+	backing->reserve_len = 0;
+	return (uint8_t*) map;
+}
+
+/**
+ * @brief
+ * Map an anonymous private region for an owned buffer.
+ *
+ * @param backing Backing record to fill in (`ARENA_BACKING_MMAP`).
+ * @param size    Buffer size in bytes.
+ *
+ * @return The mapping, or `NULL` on failure (the backing is left untouched).
+ *
+ * @ingroup arena_internal
+ */
+static inline uint8_t* arena_backing_map_anonymous(t_arena_backing* backing, size_t size)
+{
+	const size_t len = arena_page_round(size);
+	if (len == 0)
+		return NULL;
+
+	void* map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	backing->kind        = ARENA_BACKING_MMAP;
+	backing->fd          = -1;
+	backing->map_base    = map;
+	backing->map_len     = len;
+	backing->header_len  = 0;
+	backing->relocation  = 0;
+	backing->reserve_len = 0;
+	return (uint8_t*) map;
+}
+
+/**
+ * @brief
+ * Move a buffer to the start of a fresh reservation of `reserve_len` bytes.
+ *
+ * @details
+ * The first `new_size` bytes of the reservation are made accessible before
+ * anything moves, so a failure leaves the old buffer in place. A heap buffer
+ * is copied and freed; an anonymous mapping is moved with `mremap()` over
+ * the start of the reservation, and what remains of its old reservation is
+ * unmapped.
+ *
+ * @param backing     Heap or `ARENA_BACKING_MMAP` record (updated on success).
+ * @param buffer      Current buffer.
+ * @param old_size    Current buffer size in bytes.
+ * @param new_size    Requested buffer size in bytes.
+ * @param reserve_len Length of the reservation, at least `new_size`.
+ *
+ * @return The new buffer, or `NULL` on failure.
+ *
+ * @ingroup arena_internal
+ */
+static inline uint8_t* arena_backing_map_reserved(t_arena_backing* backing, uint8_t* buffer, size_t old_size,
+                                                  size_t new_size, size_t reserve_len)
+{
+	const size_t len     = arena_page_round(new_size);
+	const size_t reserve = arena_page_round(reserve_len);
+	const bool   mapped  = arena_backing_is_mapped(backing);
+	const size_t kept    = mapped ? backing->map_len : 0;
+	if (len == 0 || reserve < len || kept > len)
+		return NULL;
+
+	uint8_t* base = mmap(NULL, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+		return NULL;
+	if (mprotect(base + kept, len - kept, PROT_READ | PROT_WRITE) != 0 ||
+	    (mapped && mremap(backing->map_base, kept, kept, MREMAP_MAYMOVE | MREMAP_FIXED, base) == MAP_FAILED))
+	{
+		munmap(base, reserve);
+		return NULL;
+	}
+
+	if (!mapped)
+	{
+		memcpy(base, buffer, old_size);
+		free(buffer);
+	}
+	else if (backing->reserve_len)
+		munmap((uint8_t*) backing->map_base + kept, backing->reserve_len - kept);
+
+	backing->kind        = ARENA_BACKING_MMAP;
+	backing->fd          = -1;
+	backing->map_base    = base;
+	backing->map_len     = len;
+	backing->header_len  = 0;
+	backing->relocation  = 0;
+	backing->reserve_len = reserve;
+	return base;
+}
+
+/**
+ * @brief
+ * Move a heap buffer that crossed `ARENA_MMAP_THRESHOLD` into an anonymous mapping.
+ *
+ * @details
+ * This is the last copying resize of the buffer: later growth goes through
+ * `mremap()`. If the mapping cannot be created, `realloc()` is used instead
+ * and the buffer stays on the heap.
+ *
+ * @param backing  Heap backing record (becomes `ARENA_BACKING_MMAP` on success).
+ * @param buffer   Current heap buffer.
+ * @param old_size Current buffer size in bytes.
+ * @param new_size Requested buffer size in bytes.
+ *
+ * @return The new buffer, or `NULL` on failure (the old buffer stays valid).
+ *
+ * @ingroup arena_internal
+ */
+static inline uint8_t* arena_backing_migrate(t_arena_backing* backing, uint8_t* buffer, size_t old_size,
+                                             size_t new_size)
+{
+	uint8_t* map = arena_backing_map_anonymous(backing, new_size);
+	if (!map)
+		return (uint8_t*) realloc(buffer, new_size);
+
+	memcpy(map, buffer, old_size);
+	free(buffer);
+	return map;
+}
@@ -15,6 +15,7 @@
  * - Human-readable debug labels (`arena_set_debug_label`)
  * - Customizable error reporting with callbacks (`arena_set_error_callback`)
  * - Default and formatted error output (`arena_report_error`)
+ * - Per-thread error codes for allocation failures (`arena_last_error`)
  * - Memory poisoning (`arena_poison_memory`) to detect use-after-reset bugs
  * - Internal consistency checks (`arena_integrity_check`) for development and testing
  *
@@ -38,6 +39,7 @@
 
 #include "arena_debug.h"
 #include "arena.h"
+#include "arena_fill.h"
 #include "arena_stats.h"
 #include <stdarg.h>
 #include <stdatomic.h>
@@ -65,6 +67,26 @@
  */
 static atomic_int g_arena_id_counter = 0;
 
+/**
+ * @brief
+ * Per-thread error state.
+ *
+ * @details
+ * - `tl_last_error`: code of the thread's last allocation failure.
+ * - `tl_quiet`: innermost open quiet section; errors of its arena are only
+ *   formatted for custom callbacks.
+ *
+ * @ingroup arena_debug
+ */
+_Thread_local static t_arena_error tl_last_error = ARENA_OK;
+_Thread_local static t_arena_quiet tl_quiet      = {NULL, false};
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static void arena_report_verror(t_arena* arena, const char* fmt, va_list args);
+
 /**
  * @brief
  * Generate and assign a unique identifier string for an arena.
@@ -254,22 +276,144 @@ void arena_report_error(t_arena* arena, const char* fmt, ...)
 {
 	va_list args;
 	va_start(args, fmt);
+	arena_report_verror(arena, fmt, args);
+	va_end(args);
+}
 
-	char message[512];
-	vsnprintf(message, sizeof(message), fmt, args);
+/**
+ * @brief
+ * Report an allocation failure and remember its code.
+ *
+ * @details
+ * Like `arena_report_error()`, after storing `error` as the calling thread's
+ * last error (see `arena_last_error()`). Inside `arena_try_alloc()` and its
+ * variants the message is only formatted if a custom error callback is
+ * installed on `arena`.
+ *
+ * @param arena Pointer to the arena reporting the error. Can be `NULL`.
+ * @param error Code describing the failure.
+ * @param fmt   `printf`-style format string describing the error.
+ * @param ...   Additional arguments corresponding to the format string.
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_report_error
+ * @see arena_try_alloc
+ */
+void arena_report_failure(t_arena* arena, t_arena_error error, const char* fmt, ...)
+{
+	tl_last_error = error;
+
+	va_list args;
+	va_start(args, fmt);
+	arena_report_verror(arena, fmt, args);
 	va_end(args);
+}
 
-	if (arena && arena->debug.error_cb)
-	{
-		arena->debug.error_cb(message, arena->debug.error_context);
-	}
-	else
-	{
-		fprintf(stderr, "[ARENA ERROR]");
-		if (arena && arena->debug.label)
-			fprintf(stderr, " (%s)", arena->debug.label);
-		fprintf(stderr, " %s\n", message);
-	}
+/**
+ * @brief
+ * Record an error code without reporting a message.
+ *
+ * @details
+ * Used by failure paths that are silent by design, e.g. an allocation racing
+ * with `arena_destroy()`.
+ *
+ * @ingroup arena_debug
+ */
+void arena_set_last_error(t_arena_error error)
+{
+	tl_last_error = error;
+}
+
+/**
+ * @brief
+ * Return the code of the calling thread's last allocation failure.
+ *
+ * @details
+ * Every failing allocation (`arena_alloc*()`, `arena_calloc*()` and the
+ * `arena_try_*()` variants) records its reason in thread-local storage, like
+ * `errno`. Successful allocations leave it unchanged.
+ *
+ * @return The last `t_arena_error` recorded on this thread, or `ARENA_OK`.
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_error_string
+ * @see arena_try_alloc
+ */
+t_arena_error arena_last_error(void)
+{
+	return tl_last_error;
+}
+
+/**
+ * @brief
+ * Describe an error code.
+ *
+ * @param error Code to describe.
+ *
+ * @return A static string; `"unknown error"` for codes out of range.
+ *
+ * @ingroup arena_debug
+ */
+const char* arena_error_string(t_arena_error error)
+{
+	static const char* const strings[ARENA_ERR_COUNT] = {
+	    [ARENA_OK]              = "no error",
+	    [ARENA_ERR_NULL_ARENA]  = "NULL arena",
+	    [ARENA_ERR_ZERO_SIZE]   = "zero-size allocation",
+	    [ARENA_ERR_ALIGNMENT]   = "alignment is not a power of two",
+	    [ARENA_ERR_FROZEN]      = "arena is frozen",
+	    [ARENA_ERR_DESTROYING]  = "arena is being destroyed",
+	    [ARENA_ERR_OVERFLOW]    = "size overflow",
+	    [ARENA_ERR_FULL]        = "arena is full and cannot grow",
+	    [ARENA_ERR_GROW_FAILED] = "growth failed",
+	    [ARENA_ERR_NO_MEMORY]   = "cannot map large allocation",
+	};
+
+	if ((unsigned) error >= ARENA_ERR_COUNT)
+		return "unknown error";
+	return strings[error];
+}
+
+/**
+ * @brief
+ * Open a section in which errors of `arena` are only formatted for custom callbacks.
+ *
+ * @details
+ * Used by `arena_try_alloc()` and its variants, whose callers check the
+ * returned code instead of reading messages, so that probing a full arena
+ * costs no `vsnprintf()` or `stderr` output. Only errors reported for
+ * `arena` itself are silenced: other arenas touched by hooks or growth
+ * callbacks during the call report as usual.
+ *
+ * Sections nest: each call returns the enclosing state, which the matching
+ * `arena_errors_quiet_end()` restores.
+ *
+ * @param arena Arena the try-function operates on (may be `NULL`).
+ *
+ * @return The state to pass to `arena_errors_quiet_end()`.
+ *
+ * @ingroup arena_debug
+ */
+t_arena_quiet arena_errors_quiet_begin(const t_arena* arena)
+{
+	t_arena_quiet outer = tl_quiet;
+	tl_quiet            = (t_arena_quiet) {arena, true};
+	return outer;
+}
+
+/**
+ * @brief
+ * Close a quiet section opened by `arena_errors_quiet_begin()`.
+ *
+ * @param outer State returned by the matching `arena_errors_quiet_begin()`.
+ *
+ * @ingroup arena_debug
+ */
+void arena_errors_quiet_end(t_arena_quiet outer)
+{
+	tl_quiet = outer;
 }
 
 /**
@@ -313,6 +457,39 @@ void arena_default_error_callback(const char* msg, void* ctx)
 	fprintf(stderr, "[ARENA ERROR] %s\n", msg);
 }
 
+/**
+ * @brief
+ * Format an error message and dispatch it to the arena's error callback.
+ *
+ * @details
+ * Shared by `arena_report_error()` and `arena_report_failure()`. Inside a
+ * quiet section opened for `arena` (`arena_errors_quiet_begin()`), nothing is
+ * formatted unless `arena` has a custom callback.
+ *
+ * @ingroup arena_debug
+ */
+static void arena_report_verror(t_arena* arena, const char* fmt, va_list args)
+{
+	bool custom = arena && arena->debug.error_cb && arena->debug.error_cb != arena_default_error_callback;
+	if (tl_quiet.active && tl_quiet.arena == arena && !custom)
+		return;
+
+	char message[512];
+	vsnprintf(message, sizeof(message), fmt, args);
+
+	if (arena && arena->debug.error_cb)
+	{
+		arena->debug.error_cb(message, arena->debug.error_context);
+	}
+	else
+	{
+		fprintf(stderr, "[ARENA ERROR]");
+		if (arena && arena->debug.label)
+			fprintf(stderr, " (%s)", arena->debug.label);
+		fprintf(stderr, " %s\n", message);
+	}
+}
+
 /**
  * @brief
  * Overwrite memory with a poison pattern to detect use-after-free or invalid access.
@@ -324,7 +501,9 @@ void arena_default_error_callback(const char* msg, void* ctx)
  * by making bugs more visible during debugging or testing (e.g., via sanitizer tools).
  *
  * - The memory is split into 32-bit words.
- * - Full words are filled with `ARENA_POISON_PATTERN` (`0xDEADBEEF`).
+ * - Full words are filled with `ARENA_POISON_PATTERN` (`0xDEADBEEF`) by
+ *   `arena_fill_pattern()`, which uses the widest vector stores available and
+ *   bypasses the caches for large ranges.
  * - Remaining bytes are filled with `0xEF`.
  *
  * This function is conditionally compiled only when `ARENA_POISON_MEMORY` is defined.
@@ -357,15 +536,13 @@ void arena_poison_memory(void* ptr, size_t size)
 	if (!ptr || size == 0)
 		return;
 
-	uint32_t* p         = (uint32_t*) ptr;
-	size_t    words     = size / sizeof(uint32_t);
-	size_t    remaining = size % sizeof(uint32_t);
+	size_t words     = size / sizeof(uint32_t);
+	size_t remaining = size % sizeof(uint32_t);
 
-	for (size_t i = 0; i < words; ++i)
-		p[i] = ARENA_POISON_PATTERN;
+	arena_fill_pattern(ptr, ARENA_POISON_PATTERN, words * sizeof(uint32_t));
 
 	if (remaining)
-		memset((uint8_t*) (p + words), 0xEF, remaining);
+		memset((uint8_t*) ptr + words * sizeof(uint32_t), 0xEF, remaining);
 }
 #endif
 
@@ -390,7 +567,10 @@ void arena_poison_memory(void* ptr, size_t size)
  *
  * In multithreaded configurations (`ARENA_ENABLE_THREAD_SAFE`), the function:
  * - Returns early if the arena is being destroyed or locking is disabled.
- * - Attempts a non-blocking lock (`pthread_mutex_trylock`) to avoid deadlocks.
+ * - Returns early if another thread owns the arena's bias (see `arena_enable_biased_lock()`),
+ *   since the mutex does not exclude it.
+ * - Attempts a non-blocking lock (`pthread_mutex_trylock`) to avoid deadlocks, unless the
+ *   calling thread is already inside the arena through its bias.
  *
  * If any issue is found, it reports a detailed error via `arena_report_error`,
  * including the file, line, and function from which it was called.
@@ -439,8 +619,14 @@ void arena_integrity_check(t_arena* arena, const char* file, int line, const cha
 	if (!arena->use_lock || atomic_load_explicit(&arena->is_destroying, memory_order_acquire))
 		return;
 
-	if (pthread_mutex_trylock(&arena->lock) != 0)
+	const bool biased = arena_bias_held(arena);
+	if (!biased && pthread_mutex_trylock(&arena->lock) != 0)
 		return;
+	if (!biased && arena_bias_foreign(arena))
+	{
+		pthread_mutex_unlock(&arena->lock);
+		return;
+	}
 #else
 	(void) file;
 	(void) line;
@@ -488,7 +674,8 @@ void arena_integrity_check(t_arena* arena, const char* file, int line, const cha
 	}
 
 #ifdef ARENA_ENABLE_THREAD_SAFE
-	pthread_mutex_unlock(&arena->lock);
+	if (!biased)
+		pthread_mutex_unlock(&arena->lock);
 #endif
 }
 
@@ -0,0 +1,587 @@
+/**
+ * @file arena_fill.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Vectorized pattern fills and scans with run-time kernel selection.
+ *
+ * @details
+ * Every fill is split into an unaligned head, a body of whole 64-byte blocks
+ * starting on a 64-byte boundary, and a tail. Head and tail are written with
+ * plain stores; the body goes to the selected kernel, which can then use
+ * aligned (and, when asked, non-temporal) vector stores. The pattern handed
+ * to the kernel is rotated by the head length, so the bytes still follow the
+ * pattern's phase from the start of the range.
+ *
+ * Scans split the range the same way. The scan kernel compares whole blocks
+ * against the rotated pattern and returns the first block that differs; only
+ * that block is then searched byte by byte.
+ *
+ * The kernel is picked on first use from what the CPU supports (AVX-512F,
+ * AVX2, SSE2 or NEON) and can be overridden with `arena_fill_use_isa()`. The
+ * x86 kernels beyond SSE2 are compiled with `target` attributes, so the
+ * library itself needs no `-m` flags. Streaming stores are followed by an
+ * `sfence` so they are visible before the caller drops the arena lock.
+ * AArch64 has no non-temporal store intrinsic; NEON always uses cached stores.
+ *
+ * @ingroup arena_internal
+ */
+
+#include "arena_fill.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ARENA_FILL_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define ARENA_FILL_ARM 1
+#include <arm_neon.h>
+#endif
+
+/// Bytes handled per kernel iteration, and alignment of the kernel's range.
+#define ARENA_FILL_BLOCK 64
+
+/**
+ * @brief
+ * Fill `len` bytes (a multiple of `ARENA_FILL_BLOCK`) at a block-aligned `dst` with `word`.
+ *
+ * @ingroup arena_internal
+ */
+typedef void (*t_arena_fill_kernel)(uint8_t* dst, uint32_t word, size_t len, bool stream);
+
+/**
+ * @brief
+ * Return the offset of the first block of `src` that is not all `word`, or `len`.
+ *
+ * @ingroup arena_internal
+ */
+typedef size_t (*t_arena_scan_kernel)(const uint8_t* src, uint32_t word, size_t len);
+
+/**
+ * @brief
+ * Fill and scan kernels built on one instruction set.
+ *
+ * @ingroup arena_internal
+ */
+typedef struct s_arena_fill_kernels
+{
+	t_arena_fill_kernel fill; ///< Block fill, `NULL` if this build has no such kernel.
+	t_arena_scan_kernel scan; ///< Block compare.
+} t_arena_fill_kernels;
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static void             arena_fill_run(uint8_t* dst, uint32_t pattern, size_t size, bool stream);
+static inline void      arena_fill_bytes(uint8_t* dst, const uint8_t bytes[4], size_t phase, size_t size);
+static inline size_t    arena_scan_bytes(const uint8_t* src, const uint8_t bytes[4], size_t phase, size_t size);
+static inline uint32_t  arena_fill_rotate(const uint8_t bytes[4], size_t phase);
+static t_arena_fill_isa arena_fill_current(void);
+static bool             arena_fill_supported(t_arena_fill_isa isa);
+static void             arena_fill_scalar(uint8_t* dst, uint32_t word, size_t len, bool stream);
+static size_t           arena_scan_scalar(const uint8_t* src, uint32_t word, size_t len);
+#ifdef ARENA_FILL_X86
+static void   arena_fill_sse2(uint8_t* dst, uint32_t word, size_t len, bool stream);
+static void   arena_fill_avx2(uint8_t* dst, uint32_t word, size_t len, bool stream);
+static void   arena_fill_avx512(uint8_t* dst, uint32_t word, size_t len, bool stream);
+static size_t arena_scan_sse2(const uint8_t* src, uint32_t word, size_t len);
+static size_t arena_scan_avx2(const uint8_t* src, uint32_t word, size_t len);
+static size_t arena_scan_avx512(const uint8_t* src, uint32_t word, size_t len);
+#endif
+#ifdef ARENA_FILL_ARM
+static void   arena_fill_neon(uint8_t* dst, uint32_t word, size_t len, bool stream);
+static size_t arena_scan_neon(const uint8_t* src, uint32_t word, size_t len);
+#endif
+
+/**
+ * @brief
+ * Kernels indexed by instruction set; `NULL` where this build has none.
+ *
+ * @ingroup arena_internal
+ */
+static const t_arena_fill_kernels g_fill_kernels[ARENA_FILL_ISA_COUNT] = {
+    [ARENA_FILL_SCALAR] = {arena_fill_scalar, arena_scan_scalar},
+#ifdef ARENA_FILL_X86
+    [ARENA_FILL_SSE2]   = {arena_fill_sse2, arena_scan_sse2},
+    [ARENA_FILL_AVX2]   = {arena_fill_avx2, arena_scan_avx2},
+    [ARENA_FILL_AVX512] = {arena_fill_avx512, arena_scan_avx512},
+#endif
+#ifdef ARENA_FILL_ARM
+    [ARENA_FILL_NEON] = {arena_fill_neon, arena_scan_neon},
+#endif
+};
+
+/**
+ * @brief
+ * Selected instruction set, or `-1` until the first fill.
+ *
+ * @ingroup arena_internal
+ */
+static _Atomic int g_fill_isa = -1;
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Repeat the 32-bit `pattern` over `size` bytes starting at `dst`.
+ *
+ * @details
+ * Non-temporal stores are used from `ARENA_FILL_STREAM_MIN` bytes on.
+ *
+ * @ingroup arena_internal
+ */
+void arena_fill_pattern(void* dst, uint32_t pattern, size_t size)
+{
+	if (!dst || size == 0)
+		return;
+	arena_fill_run((uint8_t*) dst, pattern, size, size >= ARENA_FILL_STREAM_MIN);
+}
+
+/**
+ * @brief
+ * Zero `size` bytes; large ranges bypass the caches.
+ *
+ * @details
+ * Below `ARENA_FILL_STREAM_MIN` this is `memset()`, which the C library
+ * already vectorizes; the zeroed memory is usually read right after.
+ *
+ * @ingroup arena_internal
+ */
+void arena_fill_zero(void* dst, size_t size)
+{
+	if (!dst || size == 0)
+		return;
+	if (size < ARENA_FILL_STREAM_MIN)
+		memset(dst, 0, size);
+	else
+		arena_fill_run((uint8_t*) dst, 0, size, true);
+}
+
+/**
+ * @brief
+ * Zero `size` bytes with non-temporal stores whatever the size.
+ *
+ * @ingroup arena_internal
+ */
+void arena_fill_zero_stream(void* dst, size_t size)
+{
+	if (!dst || size == 0)
+		return;
+	arena_fill_run((uint8_t*) dst, 0, size, true);
+}
+
+/**
+ * @brief
+ * Find the first byte of `[src, src + size)` that breaks the repeated `pattern`.
+ *
+ * @details
+ * The pattern is phased from `src`, as laid out by `arena_fill_pattern()`.
+ *
+ * @ingroup arena_internal
+ */
+size_t arena_scan_pattern(const void* src, uint32_t pattern, size_t size)
+{
+	if (!src || size == 0)
+		return 0;
+
+	const uint8_t* at = (const uint8_t*) src;
+	uint8_t        bytes[4];
+	memcpy(bytes, &pattern, sizeof(bytes));
+
+	if (size < 2 * ARENA_FILL_BLOCK)
+		return arena_scan_bytes(at, bytes, 0, size);
+
+	const size_t head = (size_t) (-(uintptr_t) at & (ARENA_FILL_BLOCK - 1));
+	const size_t body = (size - head) & ~(size_t) (ARENA_FILL_BLOCK - 1);
+
+	size_t bad = arena_scan_bytes(at, bytes, 0, head);
+	if (bad < head)
+		return bad;
+
+	size_t block = g_fill_kernels[arena_fill_current()].scan(at + head, arena_fill_rotate(bytes, head), body);
+	if (block < body)
+		return head + block + arena_scan_bytes(at + head + block, bytes, head + block, ARENA_FILL_BLOCK);
+
+	return head + body + arena_scan_bytes(at + head + body, bytes, head + body, size - head - body);
+}
+
+/**
+ * @brief
+ * Instruction set of the kernel currently in use.
+ *
+ * @ingroup arena_internal
+ */
+t_arena_fill_isa arena_fill_isa(void)
+{
+	return arena_fill_current();
+}
+
+/**
+ * @brief
+ * Force the kernel built on `isa`.
+ *
+ * @ingroup arena_internal
+ */
+bool arena_fill_use_isa(t_arena_fill_isa isa)
+{
+	if ((unsigned) isa >= ARENA_FILL_ISA_COUNT || !g_fill_kernels[isa].fill || !arena_fill_supported(isa))
+		return false;
+	atomic_store_explicit(&g_fill_isa, (int) isa, memory_order_relaxed);
+	return true;
+}
+
+/**
+ * @brief
+ * Printable name of `isa`.
+ *
+ * @ingroup arena_internal
+ */
+const char* arena_fill_isa_name(t_arena_fill_isa isa)
+{
+	static const char* names[ARENA_FILL_ISA_COUNT] = {"scalar", "sse2", "avx2", "avx512", "neon"};
+	return (unsigned) isa < ARENA_FILL_ISA_COUNT ? names[isa] : "unknown";
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Split a fill into head, vector body and tail.
+ *
+ * @details
+ * Ranges shorter than two blocks are filled with plain stores.
+ *
+ * @ingroup arena_internal
+ */
+static void arena_fill_run(uint8_t* dst, uint32_t pattern, size_t size, bool stream)
+{
+	uint8_t bytes[4];
+	memcpy(bytes, &pattern, sizeof(bytes));
+
+	if (size < 2 * ARENA_FILL_BLOCK)
+	{
+		arena_fill_bytes(dst, bytes, 0, size);
+		return;
+	}
+
+	const size_t head = (size_t) (-(uintptr_t) dst & (ARENA_FILL_BLOCK - 1));
+	const size_t body = (size - head) & ~(size_t) (ARENA_FILL_BLOCK - 1);
+
+	arena_fill_bytes(dst, bytes, 0, head);
+	g_fill_kernels[arena_fill_current()].fill(dst + head, arena_fill_rotate(bytes, head), body, stream);
+	arena_fill_bytes(dst + head + body, bytes, head + body, size - head - body);
+}
+
+/**
+ * @brief
+ * Write `size` pattern bytes, the first one being byte `phase % 4` of the pattern.
+ *
+ * @ingroup arena_internal
+ */
+static inline void arena_fill_bytes(uint8_t* dst, const uint8_t bytes[4], size_t phase, size_t size)
+{
+	size_t i = 0;
+	for (; i < size && ((phase + i) & 3); ++i)
+		dst[i] = bytes[(phase + i) & 3];
+	for (; i + 4 <= size; i += 4)
+		memcpy(dst + i, bytes, 4);
+	for (; i < size; ++i)
+		dst[i] = bytes[(phase + i) & 3];
+}
+
+/**
+ * @brief
+ * Return the index of the first of `size` bytes that differs from the pattern at `phase`, or `size`.
+ *
+ * @ingroup arena_internal
+ */
+static inline size_t arena_scan_bytes(const uint8_t* src, const uint8_t bytes[4], size_t phase, size_t size)
+{
+	for (size_t i = 0; i < size; ++i)
+		if (src[i] != bytes[(phase + i) & 3])
+			return i;
+	return size;
+}
+
+/**
+ * @brief
+ * Pattern word as seen from a byte `phase` bytes into the pattern.
+ *
+ * @ingroup arena_internal
+ */
+static inline uint32_t arena_fill_rotate(const uint8_t bytes[4], size_t phase)
+{
+	uint8_t  rotated[4];
+	uint32_t word;
+	for (size_t i = 0; i < sizeof(rotated); ++i)
+		rotated[i] = bytes[(phase + i) & 3];
+	memcpy(&word, rotated, sizeof(word));
+	return word;
+}
+
+/**
+ * @brief
+ * Return the selected instruction set, detecting the best one on first use.
+ *
+ * @details
+ * Concurrent first calls may both detect; they store the same value.
+ *
+ * @ingroup arena_internal
+ */
+static t_arena_fill_isa arena_fill_current(void)
+{
+	int isa = atomic_load_explicit(&g_fill_isa, memory_order_relaxed);
+	if (isa >= 0)
+		return (t_arena_fill_isa) isa;
+
+	isa = ARENA_FILL_ISA_COUNT - 1;
+	while (isa > ARENA_FILL_SCALAR && (!g_fill_kernels[isa].fill || !arena_fill_supported((t_arena_fill_isa) isa)))
+		--isa;
+	atomic_store_explicit(&g_fill_isa, isa, memory_order_relaxed);
+	return (t_arena_fill_isa) isa;
+}
+
+/**
+ * @brief
+ * Whether the CPU can run kernels built on `isa`.
+ *
+ * @ingroup arena_internal
+ */
+static bool arena_fill_supported(t_arena_fill_isa isa)
+{
+	switch (isa)
+	{
+	case ARENA_FILL_SCALAR:
+		return true;
+#ifdef ARENA_FILL_X86
+	case ARENA_FILL_SSE2:
+		return true;
+	case ARENA_FILL_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	case ARENA_FILL_AVX512:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f");
+#endif
+#ifdef ARENA_FILL_ARM
+	case ARENA_FILL_NEON:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief
+ * Portable kernel: eight 64-bit stores per block.
+ *
+ * @ingroup arena_internal
+ */
+static void arena_fill_scalar(uint8_t* dst, uint32_t word, size_t len, bool stream)
+{
+	(void) stream;
+
+	const uint64_t wide = (uint64_t) word << 32 | word;
+	uint64_t*      out  = (uint64_t*) dst;
+	for (size_t i = 0; i < len / sizeof(*out); ++i)
+		out[i] = wide;
+}
+
+/**
+ * @brief
+ * Portable scan: OR of eight 64-bit differences per block.
+ *
+ * @ingroup arena_internal
+ */
+static size_t arena_scan_scalar(const uint8_t* src, uint32_t word, size_t len)
+{
+	const uint64_t  wide = (uint64_t) word << 32 | word;
+	const uint64_t* in   = (const uint64_t*) src;
+	for (size_t block = 0; block < len; block += ARENA_FILL_BLOCK, in += 8)
+	{
+		uint64_t diff = 0;
+		for (size_t i = 0; i < 8; ++i)
+			diff |= in[i] ^ wide;
+		if (diff)
+			return block;
+	}
+	return len;
+}
+
+#ifdef ARENA_FILL_X86
+
+/**
+ * @brief
+ * SSE2 kernel: four 128-bit stores per block.
+ *
+ * @ingroup arena_internal
+ */
+static void arena_fill_sse2(uint8_t* dst, uint32_t word, size_t len, bool stream)
+{
+	const __m128i v   = _mm_set1_epi32((int) word);
+	__m128i*      out = (__m128i*) dst;
+	const size_t  n   = len / sizeof(*out);
+
+	if (!stream)
+	{
+		for (size_t i = 0; i < n; ++i)
+			_mm_store_si128(out + i, v);
+		return;
+	}
+	for (size_t i = 0; i < n; ++i)
+		_mm_stream_si128(out + i, v);
+	_mm_sfence();
+}
+
+/**
+ * @brief
+ * AVX2 kernel: two 256-bit stores per block.
+ *
+ * @ingroup arena_internal
+ */
+__attribute__((target("avx2"))) static void arena_fill_avx2(uint8_t* dst, uint32_t word, size_t len, bool stream)
+{
+	const __m256i v   = _mm256_set1_epi32((int) word);
+	__m256i*      out = (__m256i*) dst;
+	const size_t  n   = len / sizeof(*out);
+
+	if (!stream)
+	{
+		for (size_t i = 0; i < n; ++i)
+			_mm256_store_si256(out + i, v);
+		return;
+	}
+	for (size_t i = 0; i < n; ++i)
+		_mm256_stream_si256(out + i, v);
+	_mm_sfence();
+}
+
+/**
+ * @brief
+ * AVX-512F kernel: one 512-bit store per block.
+ *
+ * @ingroup arena_internal
+ */
+__attribute__((target("avx512f"))) static void arena_fill_avx512(uint8_t* dst, uint32_t word, size_t len,
+                                                                 bool stream)
+{
+	const __m512i v   = _mm512_set1_epi32((int) word);
+	__m512i*      out = (__m512i*) dst;
+	const size_t  n   = len / sizeof(*out);
+
+	if (!stream)
+	{
+		for (size_t i = 0; i < n; ++i)
+			_mm512_store_si512((void*) (out + i), v);
+		return;
+	}
+	for (size_t i = 0; i < n; ++i)
+		_mm512_stream_si512((void*) (out + i), v);
+	_mm_sfence();
+}
+
+/**
+ * @brief
+ * SSE2 scan: four 128-bit byte compares per block.
+ *
+ * @ingroup arena_internal
+ */
+static size_t arena_scan_sse2(const uint8_t* src, uint32_t word, size_t len)
+{
+	const __m128i  v  = _mm_set1_epi32((int) word);
+	const __m128i* in = (const __m128i*) src;
+	for (size_t block = 0; block < len; block += ARENA_FILL_BLOCK, in += 4)
+	{
+		__m128i eq = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128(in), v),
+		                                         _mm_cmpeq_epi8(_mm_load_si128(in + 1), v)),
+		                           _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128(in + 2), v),
+		                                         _mm_cmpeq_epi8(_mm_load_si128(in + 3), v)));
+		if (_mm_movemask_epi8(eq) != 0xFFFF)
+			return block;
+	}
+	return len;
+}
+
+/**
+ * @brief
+ * AVX2 scan: two 256-bit byte compares per block.
+ *
+ * @ingroup arena_internal
+ */
+__attribute__((target("avx2"))) static size_t arena_scan_avx2(const uint8_t* src, uint32_t word, size_t len)
+{
+	const __m256i  v  = _mm256_set1_epi32((int) word);
+	const __m256i* in = (const __m256i*) src;
+	for (size_t block = 0; block < len; block += ARENA_FILL_BLOCK, in += 2)
+	{
+		__m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_load_si256(in), v),
+		                              _mm256_cmpeq_epi8(_mm256_load_si256(in + 1), v));
+		if (_mm256_movemask_epi8(eq) != -1)
+			return block;
+	}
+	return len;
+}
+
+/**
+ * @brief
+ * AVX-512F scan: one 512-bit word compare per block.
+ *
+ * @ingroup arena_internal
+ */
+__attribute__((target("avx512f"))) static size_t arena_scan_avx512(const uint8_t* src, uint32_t word, size_t len)
+{
+	const __m512i v = _mm512_set1_epi32((int) word);
+	for (size_t block = 0; block < len; block += ARENA_FILL_BLOCK)
+		if (_mm512_cmpneq_epi32_mask(_mm512_load_si512((const void*) (src + block)), v))
+			return block;
+	return len;
+}
+
+#endif
+
+#ifdef ARENA_FILL_ARM
+
+/**
+ * @brief
+ * NEON kernel: four 128-bit stores per block.
+ *
+ * @ingroup arena_internal
+ */
+static void arena_fill_neon(uint8_t* dst, uint32_t word, size_t len, bool stream)
+{
+	(void) stream;
+
+	const uint32x4_t v = vdupq_n_u32(word);
+	for (size_t i = 0; i < len; i += sizeof(v))
+		vst1q_u32((uint32_t*) (dst + i), v);
+}
+
+/**
+ * @brief
+ * NEON scan: four 128-bit word compares per block.
+ *
+ * @ingroup arena_internal
+ */
+static size_t arena_scan_neon(const uint8_t* src, uint32_t word, size_t len)
+{
+	const uint32x4_t v = vdupq_n_u32(word);
+	for (size_t block = 0; block < len; block += ARENA_FILL_BLOCK)
+	{
+		const uint32_t* in = (const uint32_t*) (src + block);
+		uint32x4_t      eq = vandq_u32(vandq_u32(vceqq_u32(vld1q_u32(in), v), vceqq_u32(vld1q_u32(in + 4), v)),
+		                               vandq_u32(vceqq_u32(vld1q_u32(in + 8), v), vceqq_u32(vld1q_u32(in + 12), v)));
+		if (vminvq_u32(eq) != UINT32_MAX)
+			return block;
+	}
+	return len;
+}
+
+#endif
@@ -101,7 +101,9 @@ size_t default_grow_cb(size_t current_size, size_t requested_size)
  * This internal function updates the `peak_usage` statistic in the arena
  * if the current offset exceeds the previously recorded peak. This metric
  * reflects the highest memory usage observed since the arena was initialized
- * or last reset.
+ * or last reset. It also tracks `cycle_peak`, the peak since the last
+ * `arena_reset()`, which feeds the shrink hysteresis, and raises the
+ * `clean_from` watermark past memory that was just handed out.
  *
  * It uses locking to ensure thread-safe updates in concurrent environments.
  *
@@ -120,9 +122,36 @@ void arena_update_peak(t_arena* arena)
 	ARENA_LOCK(arena);
 	if (arena->offset > arena->stats.peak_usage)
 		arena->stats.peak_usage = arena->offset;
+	if (arena->offset > arena->cycle_peak)
+		arena->cycle_peak = arena->offset;
+	if (arena->offset > arena->clean_from)
+		arena->clean_from = arena->offset;
 	ARENA_UNLOCK(arena);
 }
 
+/**
+ * @brief
+ * Bytes of the buffer that may have been handed out since the last reset.
+ *
+ * @details
+ * Memory past this mark was either poisoned by an earlier reset or pop, or
+ * never allocated, so poisoning on reset and destruction stops here. Called
+ * with the arena lock held.
+ *
+ * @param arena Arena to inspect.
+ *
+ * @return `max(cycle_peak, offset)`, clamped to the buffer size.
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_reset
+ */
+size_t arena_cycle_high_water(const t_arena* arena)
+{
+	size_t used = arena->cycle_peak > arena->offset ? arena->cycle_peak : arena->offset;
+	return used < arena->size ? used : arena->size;
+}
+
 /**
  * @brief
  * Check whether an arena is in a valid state.
@@ -196,6 +225,8 @@ void arena_stats_reset(t_arena_stats* stats)
 	stats->bytes_allocated        = 0;
 	stats->wasted_alignment_bytes = 0;
 	stats->shrinks                = 0;
+	stats->shrinks_avoided        = 0;
+	stats->regrows_after_shrink   = 0;
 	stats->peak_usage             = 0;
 	stats->last_alloc_size        = 0;
 	stats->last_alloc_offset      = 0;
@@ -203,6 +234,9 @@ void arena_stats_reset(t_arena_stats* stats)
 	stats->alloc_id_counter       = 0;
 	stats->growth_history         = NULL;
 	stats->growth_history_count   = 0;
+	stats->large_allocations      = 0;
+	stats->large_bytes            = 0;
+	stats->background_grows       = 0;
 }
 
 /**
@@ -217,8 +251,9 @@ void arena_stats_reset(t_arena_stats* stats)
  *
  * Specifically, it:
  * - Sets the buffer pointer, size, and offset to zero.
- * - Resets ownership and growth flags atomically.
+ * - Resets ownership, growth, and frozen flags atomically.
  * - Clears growth callback and parent references.
+ * - Resets the buffer backing to the heap default.
  * - Resets all statistical counters via `arena_stats_reset()`.
  * - Clears debug fields including ID, label, and error context.
  * - Resets hook-related pointers.
@@ -246,9 +281,32 @@ void arena_zero_metadata(t_arena* arena)
 
 	atomic_store_explicit(&arena->owns_buffer, false, memory_order_release);
 	atomic_store_explicit(&arena->can_grow, false, memory_order_release);
+	atomic_store_explicit(&arena->is_frozen, false, memory_order_release);
 
-	arena->grow_cb    = NULL;
+	arena->grow_cb     = NULL;
+	arena->grow_policy = (t_arena_grow_policy) {0};
 	arena->parent_ref = NULL;
+	arena_backing_reset(&arena->backing);
+	arena->large_list      = NULL;
+	arena->large_threshold = 0;
+	arena->guards          = (t_arena_guards) {0};
+	arena->cycle_peak      = 0;
+	arena->shrink_policy   = (t_arena_shrink_policy) {0};
+	arena->shrink_window   = (t_arena_shrink_window) {0};
+	arena->budget          = NULL;
+	arena->budget_charged  = 0;
+	arena->create_flags    = 0;
+	arena->clean_from      = 0;
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	arena->pregrow_percent = 0;
+	arena->pregrow_stalled = 0;
+	arena->trim_registered = false;
+	arena->prezero_watched = false;
+	arena->io_pins         = NULL;
+	arena->io_retired      = NULL;
+	atomic_store_explicit(&arena->pregrow_pending, false, memory_order_relaxed);
+	atomic_store_explicit(&arena->prezero_pending, false, memory_order_relaxed);
+#endif
 
 	arena_stats_reset(&arena->stats);
 
@@ -257,6 +315,10 @@ void arena_zero_metadata(t_arena* arena)
 	arena->debug.error_cb         = NULL;
 	arena->debug.error_context    = NULL;
 	arena->debug.subarena_counter = 0;
+#ifdef ARENA_POISON_VERIFY
+	arena->debug.poison_hi   = 0;
+	arena->debug.owner_count = 0;
+#endif
 
 	arena->hooks.hook_cb = NULL;
 	arena->hooks.context = NULL;
@@ -0,0 +1,267 @@
+/**
+ * @file arena_io_pin.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Buffer pins for system calls made without the arena lock.
+ *
+ * @details
+ * `arena_read_fd()` and `arena_writer_flush()` reserve or gather their
+ * buffer range under the lock, pin it, and drop the lock for the blocking
+ * `read()` / `writev()`, so other threads keep allocating meanwhile. Those
+ * allocations may grow the arena, which would normally move the buffer under
+ * the kernel's feet.
+ *
+ * While a pin exists, `arena_grow()` goes through `arena_io_pinned_resize()`:
+ * - The buffer is extended in place when its backing allows it (see
+ *   `arena_backing_extend()`).
+ * - Otherwise heap and anonymous buffers are copied into a new buffer,
+ *   skipping the ranges the kernel is writing, and the old buffer is kept
+ *   on `io_retired` so that the system call can finish with it. File, memfd
+ *   and copy-on-write mappings cannot be duplicated, so their growth fails.
+ *
+ * Unpinning a range that the kernel wrote carries its bytes over to the
+ * current buffer. The last unpin releases the retired buffers, through the
+ * background reclaimer when it runs. Shrinking is refused while pinned (see
+ * `arena_can_shrink()`).
+ *
+ * @ingroup arena_internal
+ */
+
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+/**
+ * @brief
+ * Former arena buffer, kept until no system call uses it any more.
+ *
+ * @ingroup arena_internal
+ */
+struct s_arena_io_retired
+{
+	t_arena_io_retired* next;    ///< Next retired buffer of the same arena.
+	t_arena_backing     backing; ///< Backing record of the buffer.
+	uint8_t*            buffer;  ///< The buffer.
+	size_t              size;    ///< Size of the buffer in bytes.
+};
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline void arena_io_copy_unpinned(const t_arena* arena, uint8_t* dst, size_t used);
+static inline void arena_io_release_retired(t_arena* arena);
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Pin `[data, data + len)` for a system call made without the arena lock.
+ *
+ * @details
+ * Must be called with the arena lock held. `pin` stays linked into the arena
+ * until `arena_io_unpin()`, so it must outlive the system call.
+ *
+ * @param arena Arena owning the range.
+ * @param pin   Caller-owned pin record.
+ * @param data  Start of the range.
+ * @param len   Length of the range in bytes.
+ * @param write Whether the kernel writes into the range (`read()`).
+ *
+ * @ingroup arena_internal
+ */
+void arena_io_pin(t_arena* arena, t_arena_io_pin* pin, void* data, size_t len, bool write)
+{
+	const uintptr_t start = (uintptr_t) data;
+	const uintptr_t base  = (uintptr_t) arena->buffer;
+
+	pin->next   = NULL;
+	pin->buffer = NULL;
+	pin->data   = (uint8_t*) data;
+	pin->len    = len;
+	pin->write  = write;
+	if (!arena->buffer || start < base || start - base > arena->size || len > arena->size - (start - base))
+		return; // large-object mappings never move
+
+	pin->buffer    = arena->buffer;
+	pin->next      = arena->io_pins;
+	arena->io_pins = pin;
+}
+
+/**
+ * @brief
+ * Release a pin and return where its range lives now.
+ *
+ * @details
+ * Must be called with the arena lock held, after the system call returned.
+ * If the buffer moved while the kernel wrote into a `write` range, the bytes
+ * are copied from the retired buffer into the current one.
+ *
+ * @param arena Arena owning the range.
+ * @param pin   Pin set up by `arena_io_pin()`.
+ *
+ * @return The current address of the range.
+ *
+ * @ingroup arena_internal
+ */
+void* arena_io_unpin(t_arena* arena, t_arena_io_pin* pin)
+{
+	if (!pin->buffer)
+		return pin->data;
+
+	t_arena_io_pin** link = &arena->io_pins;
+	while (*link != pin)
+		link = &(*link)->next;
+	*link = pin->next;
+
+	uint8_t* data = arena->buffer + (pin->data - pin->buffer);
+	if (data != pin->data && pin->write)
+		memcpy(data, pin->data, pin->len);
+
+	if (!arena->io_pins)
+		arena_io_release_retired(arena);
+	return data;
+}
+
+/**
+ * @brief
+ * Grow a pinned buffer without invalidating the pinned ranges.
+ *
+ * @details
+ * Called by `arena_grow()` with the arena lock held, in place of
+ * `arena_backing_resize()`. On success `arena->backing` describes the
+ * returned buffer; the caller installs it as usual.
+ *
+ * @param arena    Arena being grown.
+ * @param new_size Requested buffer size in bytes.
+ * @param old_size Current buffer size in bytes.
+ *
+ * @return The grown or new buffer, or `NULL` on failure (the arena is unchanged).
+ *
+ * @ingroup arena_internal
+ *
+ * @see arena_backing_extend
+ */
+uint8_t* arena_io_pinned_resize(t_arena* arena, size_t new_size, size_t old_size)
+{
+	uint8_t* new_buf = arena_backing_extend(&arena->backing, new_size);
+	if (new_buf)
+		return new_buf;
+
+	if (arena->backing.kind != ARENA_BACKING_HEAP && arena->backing.kind != ARENA_BACKING_MMAP)
+		return NULL;
+
+	t_arena_io_retired* retired = malloc(sizeof(*retired));
+	if (!retired)
+		return NULL;
+
+	t_arena_backing backing;
+	new_buf = arena_backing_alloc(&backing, new_size);
+	if (!new_buf)
+	{
+		free(retired);
+		return NULL;
+	}
+
+	arena_io_copy_unpinned(arena, new_buf, arena->offset);
+	retired->backing  = arena->backing;
+	retired->buffer   = arena->buffer;
+	retired->size     = old_size;
+	retired->next     = arena->io_retired;
+	arena->io_retired = retired;
+	arena->backing    = backing;
+	return new_buf;
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Copy the first `used` bytes of the buffer, except the ranges being written by the kernel.
+ *
+ * @details
+ * Those ranges are filled in by `arena_io_unpin()` once the system call
+ * returned; copying them now would race with it.
+ *
+ * @ingroup arena_internal
+ */
+static inline void arena_io_copy_unpinned(const t_arena* arena, uint8_t* dst, size_t used)
+{
+	size_t from = 0;
+	while (from < used)
+	{
+		size_t to   = used; // start of the next written range
+		size_t next = used; // where copying resumes after it
+		for (const t_arena_io_pin* pin = arena->io_pins; pin; pin = pin->next)
+		{
+			size_t start = (size_t) (pin->data - pin->buffer);
+			size_t end   = start + pin->len;
+			if (!pin->write || end <= from)
+				continue;
+			if (start < from)
+				start = from;
+			if (start < to || (start == to && end > next))
+			{
+				to   = start;
+				next = end;
+			}
+		}
+		memcpy(dst + from, arena->buffer + from, to - from);
+		from = next;
+	}
+}
+
+/**
+ * @brief
+ * Release the buffers retired while the arena was pinned.
+ *
+ * @ingroup arena_internal
+ */
+static inline void arena_io_release_retired(t_arena* arena)
+{
+	while (arena->io_retired)
+	{
+		t_arena_io_retired* retired = arena->io_retired;
+		arena->io_retired           = retired->next;
+		if (!arena_reclaim_defer(&retired->backing, retired->buffer, retired->size))
+			arena_backing_release(&retired->backing, retired->buffer, retired->size);
+		free(retired);
+	}
+}
+
+#else
+
+void arena_io_pin(t_arena* arena, t_arena_io_pin* pin, void* data, size_t len, bool write)
+{
+	(void) arena;
+	pin->next   = NULL;
+	pin->buffer = NULL;
+	pin->data   = (uint8_t*) data;
+	pin->len    = len;
+	pin->write  = write;
+}
+
+void* arena_io_unpin(t_arena* arena, t_arena_io_pin* pin)
+{
+	(void) arena;
+	return pin->data;
+}
+
+uint8_t* arena_io_pinned_resize(t_arena* arena, size_t new_size, size_t old_size)
+{
+	(void) arena;
+	(void) new_size;
+	(void) old_size;
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file arena_poison.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * Poisoning of released arena memory and verification that it stays intact.
+ *
+ * @details
+ * Memory released by `arena_reset()`, `arena_pop()` or an in-place shrink is
+ * filled by `arena_poison_free()` with `ARENA_POISON_PATTERN` phased from the
+ * start of the buffer, so every free byte has one expected value however the
+ * free range was assembled.
+ *
+ * With `ARENA_POISON_VERIFY`, the arena also tracks `poison_hi`: every byte
+ * from the offset up to it holds intact poison. Before an allocation (or an
+ * in-place growth) takes bytes from that range, `arena_poison_check()` scans
+ * them with the vector kernels of `arena_scan_pattern()`. A mismatch means
+ * something wrote through a stale pointer after the memory was released. It
+ * is reported through the arena's error callback with its offset and the
+ * label of the most recent allocation that covered it, taken from a ring of
+ * the last `ARENA_POISON_HISTORY` allocations.
+ *
+ * Memory that legitimately stops holding poison (pages decommitted by the
+ * trimmer, zeroed by the pre-zeroing worker, cut off by a shrink, or
+ * overwritten by a snapshot load) lowers `poison_hi` through
+ * `ARENA_POISON_CLIP()` and is no longer checked.
+ *
+ * @ingroup arena_debug
+ */
+
+#include "arena.h"
+#include "arena_fill.h"
+
+#ifdef ARENA_POISON_MEMORY
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline uint32_t arena_poison_word_at(size_t offset);
+#ifdef ARENA_POISON_VERIFY
+static inline const t_arena_poison_owner* arena_poison_owner_of(const t_arena* arena, size_t offset);
+#endif
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Poison `[from, to)` of the buffer as it becomes free again.
+ *
+ * @details
+ * Called with the arena lock held, before the offset drops to `from`. The
+ * pattern is phased from the start of the buffer. With
+ * `ARENA_POISON_VERIFY`, the poisoned range joins the intact poison above
+ * the current offset.
+ *
+ * @param arena Arena whose memory is released.
+ * @param from  First released byte.
+ * @param to    End of the released range (at least the current offset).
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_reset
+ * @see arena_pop
+ */
+void arena_poison_free(t_arena* arena, size_t from, size_t to)
+{
+	if (!arena->buffer || from >= to)
+		return;
+
+	ARENA_SAN_OPEN(arena->buffer + from, to - from);
+	arena_fill_pattern(arena->buffer + from, arena_poison_word_at(from), to - from);
+	ARENA_SAN_CLOSE(arena->buffer + from, to - from);
+#ifdef ARENA_POISON_VERIFY
+	if (arena->debug.poison_hi < arena->offset || arena->debug.poison_hi < to)
+		arena->debug.poison_hi = to;
+#endif
+}
+
+#ifdef ARENA_POISON_VERIFY
+
+/**
+ * @brief
+ * Check that the free memory of `arena` still holds its poison.
+ *
+ * @details
+ * Scans everything from the offset up to `poison_hi`, e.g. from a soak test
+ * between frames. The first overwritten byte is reported, then the range is
+ * poisoned again so the same damage is not reported twice.
+ *
+ * @param arena Arena to audit.
+ *
+ * @return `true` if the poison is intact.
+ *
+ * @ingroup arena_debug
+ */
+bool arena_verify_poison(t_arena* arena)
+{
+	if (!arena)
+		return false;
+
+	ARENA_LOCK(arena);
+	bool ok = arena_poison_check(arena, arena->offset, arena->debug.poison_hi);
+	ARENA_UNLOCK(arena);
+	return ok;
+}
+
+/**
+ * @brief
+ * Report poison overwritten in `[from, to)` before it is handed out.
+ *
+ * @details
+ * Only the part below `poison_hi` is scanned. On a mismatch, the offset of
+ * the first bad byte and the last recorded owner of that byte are reported,
+ * and the scanned range is poisoned again. Called with the arena lock held.
+ *
+ * @return `true` if the range holds intact poison.
+ *
+ * @ingroup arena_debug
+ */
+bool arena_poison_check(t_arena* arena, size_t from, size_t to)
+{
+	const size_t end = to < arena->debug.poison_hi ? to : arena->debug.poison_hi;
+	if (!arena->buffer || from >= end)
+		return true;
+
+	ARENA_SAN_OPEN(arena->buffer + from, end - from);
+	const size_t bad = arena_scan_pattern(arena->buffer + from, arena_poison_word_at(from), end - from);
+	if (bad == end - from)
+	{
+		ARENA_SAN_CLOSE(arena->buffer + from, end - from);
+		return true;
+	}
+
+	const size_t                offset = from + bad;
+	const t_arena_poison_owner* owner  = arena_poison_owner_of(arena, offset);
+	if (owner)
+		arena_report_error(arena,
+		                   "arena poison check failed: byte at offset %zu written after release "
+		                   "(last owner: \"%s\", offset %zu, %zu bytes)",
+		                   offset, owner->label, owner->offset, owner->size);
+	else
+		arena_report_error(arena, "arena poison check failed: byte at offset %zu written after release", offset);
+
+	arena_fill_pattern(arena->buffer + from, arena_poison_word_at(from), end - from);
+	ARENA_SAN_CLOSE(arena->buffer + from, end - from);
+	return false;
+}
+
+/**
+ * @brief
+ * Remember `[offset, offset + size)` as owned by `label`.
+ *
+ * @details
+ * Called with the arena lock held after each allocation. The oldest entry of
+ * the ring is overwritten.
+ *
+ * @ingroup arena_debug
+ */
+void arena_poison_record(t_arena* arena, size_t offset, size_t size, const char* label)
+{
+	t_arena_poison_owner* owner = &arena->debug.owners[arena->debug.owner_count++ % ARENA_POISON_HISTORY];
+	owner->offset               = offset;
+	owner->size                 = size;
+	owner->label                = label ? label : "(unlabeled)";
+}
+
+#endif
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Poison pattern as laid out from buffer offset `offset`.
+ *
+ * @ingroup arena_debug
+ */
+static inline uint32_t arena_poison_word_at(size_t offset)
+{
+	uint32_t      pattern = ARENA_POISON_PATTERN;
+	uint8_t       bytes[4];
+	uint8_t       rotated[4];
+	const uint8_t shift = (uint8_t) (offset & 3);
+
+	memcpy(bytes, &pattern, sizeof(bytes));
+	for (uint8_t i = 0; i < 4; ++i)
+		rotated[i] = bytes[(shift + i) & 3];
+	memcpy(&pattern, rotated, sizeof(pattern));
+	return pattern;
+}
+
+#ifdef ARENA_POISON_VERIFY
+
+/**
+ * @brief
+ * Most recent recorded allocation covering `offset`, or `NULL`.
+ *
+ * @ingroup arena_debug
+ */
+static inline const t_arena_poison_owner* arena_poison_owner_of(const t_arena* arena, size_t offset)
+{
+	const size_t count = arena->debug.owner_count;
+	const size_t kept  = count < ARENA_POISON_HISTORY ? count : ARENA_POISON_HISTORY;
+
+	for (size_t i = 1; i <= kept; ++i)
+	{
+		const t_arena_poison_owner* owner = &arena->debug.owners[(count - i) % ARENA_POISON_HISTORY];
+		if (offset >= owner->offset && offset - owner->offset < owner->size)
+			return owner;
+	}
+	return NULL;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,293 @@
+/**
+ * @file arena_sanitize.c
+ * @author Toonsa
+ * @date 2025
+ *
+ * @brief
+ * AddressSanitizer and Valgrind client annotations for arena buffers.
+ *
+ * @details
+ * The arena keeps the checkers' view of its buffer in step with its offset:
+ * - `[0, offset)` is addressable, except for `ARENA_REDZONE_SIZE` bytes in
+ *   front of each allocation;
+ * - `[offset, size)` is poisoned (AddressSanitizer) or inaccessible
+ *   (Memcheck), whatever the arena's own byte poisoning writes there.
+ *
+ * With Valgrind, the arena struct is the mempool handle and every allocation
+ * is a chunk. After a buffer move or a bulk rewrite the used range is
+ * described again as a single defined chunk, which keeps Memcheck consistent
+ * at the cost of the redzones and of uninitialised-value tracking below the
+ * offset.
+ *
+ * All functions are called with the arena lock held (or before the arena is
+ * shared), like the offset updates they mirror.
+ *
+ * @ingroup arena_debug
+ */
+
+#include "arena.h"
+
+#ifdef ARENA_SANITIZE
+
+#ifdef ARENA_VALGRIND
+#include <valgrind/memcheck.h>
+#endif
+
+/*
+ * INTERNAL FUNCTION DECLARATIONS
+ */
+
+static inline void arena_sanitize_poison(void* ptr, size_t size);
+static inline void arena_sanitize_unpoison(void* ptr, size_t size);
+
+/*
+ * INTERNAL API
+ */
+
+/**
+ * @brief
+ * Describe a buffer the arena just started using.
+ *
+ * @details
+ * `[0, offset)` becomes one addressable region and the rest is poisoned. A
+ * Valgrind mempool already registered for the arena is replaced.
+ *
+ * @param arena Arena whose `buffer`, `size` and `offset` are set.
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_init_with_buffer
+ * @see arena_grow
+ */
+void arena_sanitize_attach(t_arena* arena)
+{
+	if (!arena->buffer)
+		return;
+
+#ifdef ARENA_VALGRIND
+	if (VALGRIND_MEMPOOL_EXISTS(arena))
+		VALGRIND_DESTROY_MEMPOOL(arena);
+	VALGRIND_CREATE_MEMPOOL(arena, 0, 0);
+	if (arena->offset)
+	{
+		VALGRIND_MEMPOOL_ALLOC(arena, arena->buffer, arena->offset);
+		VALGRIND_MAKE_MEM_DEFINED(arena->buffer, arena->offset);
+	}
+#endif
+	arena_sanitize_unpoison(arena->buffer, arena->offset);
+	arena_sanitize_poison(arena->buffer + arena->offset, arena->size - arena->offset);
+}
+
+/**
+ * @brief
+ * Turn the whole buffer back into plain memory.
+ *
+ * @details
+ * Called before the buffer is released, cached, resized or rewritten in bulk,
+ * so `free()`, `realloc()`, `munmap()` and later users of the same addresses
+ * see no stale annotations.
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_destroy
+ */
+void arena_sanitize_detach(t_arena* arena)
+{
+	if (!arena->buffer)
+		return;
+
+#ifdef ARENA_VALGRIND
+	if (VALGRIND_MEMPOOL_EXISTS(arena))
+		VALGRIND_DESTROY_MEMPOOL(arena);
+	VALGRIND_MAKE_MEM_DEFINED(arena->buffer, arena->size);
+#endif
+	arena_sanitize_unpoison(arena->buffer, arena->size);
+}
+
+/**
+ * @brief
+ * Make a new allocation addressable.
+ *
+ * @details
+ * Without redzones the alignment padding between `from` and `start` is
+ * unpoisoned along with the block, so `[0, offset)` stays contiguous.
+ *
+ * @param arena Arena the block comes from.
+ * @param from  Offset before the allocation.
+ * @param start Offset of the block.
+ * @param size  Size of the block in bytes.
+ *
+ * @ingroup arena_debug
+ */
+void arena_sanitize_alloc(t_arena* arena, size_t from, size_t start, size_t size)
+{
+	const size_t first = ARENA_REDZONE_SIZE ? start : from;
+
+#ifdef ARENA_VALGRIND
+	VALGRIND_MEMPOOL_ALLOC(arena, arena->buffer + start, size);
+#endif
+	arena_sanitize_unpoison(arena->buffer + first, start + size - first);
+}
+
+/**
+ * @brief
+ * Poison `[from, to)` as the offset drops to `from`.
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_pop
+ * @see arena_reset
+ */
+void arena_sanitize_release(t_arena* arena, size_t from, size_t to)
+{
+	if (!arena->buffer || from >= to)
+		return;
+
+#ifdef ARENA_VALGRIND
+	VALGRIND_MEMPOOL_TRIM(arena, arena->buffer, from);
+#endif
+	arena_sanitize_poison(arena->buffer + from, to - from);
+}
+
+/**
+ * @brief
+ * Follow an in-place resize of the last allocation.
+ *
+ * @details
+ * With Valgrind the block is registered again, which also works after a
+ * buffer move merged it into the single chunk of `arena_sanitize_attach()`;
+ * its surviving bytes stay defined.
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_realloc_last
+ */
+void arena_sanitize_resize(t_arena* arena, size_t start, size_t old_size, size_t new_size)
+{
+	uint8_t* block = arena->buffer + start;
+
+#ifdef ARENA_VALGRIND
+	VALGRIND_MEMPOOL_TRIM(arena, arena->buffer, start);
+	VALGRIND_MEMPOOL_ALLOC(arena, block, new_size);
+	VALGRIND_MAKE_MEM_DEFINED(block, old_size < new_size ? old_size : new_size);
+#endif
+	if (new_size > old_size)
+		arena_sanitize_unpoison(block + old_size, new_size - old_size);
+	else
+		arena_sanitize_poison(block + new_size, old_size - new_size);
+}
+
+/**
+ * @brief
+ * Let the library write free memory, e.g. to poison or zero it.
+ *
+ * @ingroup arena_debug
+ */
+void arena_sanitize_open(void* ptr, size_t size)
+{
+#ifdef ARENA_VALGRIND
+	VALGRIND_MAKE_MEM_UNDEFINED(ptr, size);
+#endif
+#ifdef ARENA_ASAN
+	ASAN_UNPOISON_MEMORY_REGION(ptr, size);
+#endif
+}
+
+/**
+ * @brief
+ * Mark memory opened with `arena_sanitize_open()` free again.
+ *
+ * @ingroup arena_debug
+ */
+void arena_sanitize_close(void* ptr, size_t size)
+{
+	arena_sanitize_poison(ptr, size);
+}
+
+/**
+ * @brief
+ * Let the library read `[0, size)` of the buffer in one call (e.g. `fwrite()`).
+ *
+ * @details
+ * AddressSanitizer cannot skip poisoned bytes inside a single read, so the
+ * redzones and the free memory of sub-arenas carved from the range are
+ * unpoisoned for good. Memcheck only stops reporting addressing errors in the range until
+ * `arena_sanitize_read_end()`.
+ *
+ * @ingroup arena_debug
+ *
+ * @see arena_save_to_file
+ */
+void arena_sanitize_read_begin(const t_arena* arena, size_t size)
+{
+	if (!arena->buffer || !size)
+		return;
+
+#ifdef ARENA_VALGRIND
+	VALGRIND_DISABLE_ADDR_ERROR_REPORTING_IN_RANGE(arena->buffer, size);
+#endif
+#ifdef ARENA_ASAN
+	ASAN_UNPOISON_MEMORY_REGION(arena->buffer, size);
+#endif
+}
+
+/**
+ * @brief
+ * End a bulk read started with `arena_sanitize_read_begin()`.
+ *
+ * @ingroup arena_debug
+ */
+void arena_sanitize_read_end(const t_arena* arena, size_t size)
+{
+#ifdef ARENA_VALGRIND
+	if (arena->buffer && size)
+		VALGRIND_ENABLE_ADDR_ERROR_REPORTING_IN_RANGE(arena->buffer, size);
+#else
+	(void) arena;
+	(void) size;
+#endif
+}
+
+/*
+ * INTERNAL HELPERS
+ */
+
+/**
+ * @brief
+ * Mark `[ptr, ptr + size)` unusable for both checkers.
+ *
+ * @ingroup arena_debug
+ */
+static inline void arena_sanitize_poison(void* ptr, size_t size)
+{
+	if (!size)
+		return;
+#ifdef ARENA_VALGRIND
+	VALGRIND_MAKE_MEM_NOACCESS(ptr, size);
+#endif
+#ifdef ARENA_ASAN
+	ASAN_POISON_MEMORY_REGION(ptr, size);
+#endif
+}
+
+/**
+ * @brief
+ * Make `[ptr, ptr + size)` addressable for AddressSanitizer.
+ *
+ * @details
+ * Memcheck learns about used memory through its mempool requests instead.
+ *
+ * @ingroup arena_debug
+ */
+static inline void arena_sanitize_unpoison(void* ptr, size_t size)
+{
+#ifdef ARENA_ASAN
+	if (size)
+		ASAN_UNPOISON_MEMORY_REGION(ptr, size);
+#else
+	(void) ptr;
+	(void) size;
+#endif
+}
+
+#endif
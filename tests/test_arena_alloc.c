@@ -4,6 +4,7 @@
 #include <pthread.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 
 #define TEST_BUFFER_SIZE 2048
 
@@ -94,12 +95,153 @@ void test_hook_invocation(void)
 	printf("✅ test_hook_invocation passed\n");
 }
 
+static int g_reported = 0;
+
+static void count_errors(const char* msg, void* ctx)
+{
+	(void) msg;
+	(void) ctx;
+	g_reported++;
+}
+
+void test_try_alloc_error_codes(void)
+{
+	t_arena* arena = arena_create(TEST_BUFFER_SIZE, false);
+	assert(arena);
+	void* ptr = NULL;
+
+	assert(arena_try_alloc(arena, 64, &ptr) == ARENA_OK && ptr);
+	assert(arena_try_calloc(arena, 4, 8, &ptr) == ARENA_OK && ptr && ((char*) ptr)[31] == 0);
+	assert(arena_try_alloc(NULL, 8, &ptr) == ARENA_ERR_NULL_ARENA && !ptr);
+	assert(arena_try_alloc(arena, 0, &ptr) == ARENA_ERR_ZERO_SIZE);
+	assert(arena_try_alloc_aligned(arena, 8, 3, &ptr) == ARENA_ERR_ALIGNMENT);
+	assert(arena_try_alloc(arena, (size_t) -32, &ptr) == ARENA_ERR_OVERFLOW);
+	assert(arena_try_calloc(arena, SIZE_MAX / 2, 4, &ptr) == ARENA_ERR_OVERFLOW);
+	assert(arena_last_error() == ARENA_ERR_OVERFLOW);
+
+	size_t count = 0;
+	while (arena_try_alloc(arena, 100, NULL) == ARENA_OK)
+		count++;
+	assert(count > 0 && arena_last_error() == ARENA_ERR_FULL);
+
+	// The regular path records codes too.
+	assert(!arena_alloc(arena, 0) && arena_last_error() == ARENA_ERR_ZERO_SIZE);
+
+	assert(strcmp(arena_error_string(ARENA_OK), "no error") == 0);
+	assert(strstr(arena_error_string(ARENA_ERR_FULL), "full"));
+	assert(strcmp(arena_error_string(ARENA_ERR_COUNT), "unknown error") == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_try_alloc_error_codes passed\n");
+}
+
+void test_try_alloc_reports_to_custom_callback(void)
+{
+	t_arena* arena = arena_create(256, false);
+	assert(arena);
+
+	// With the default callback nothing is formatted or printed.
+	assert(arena_try_alloc(arena, 4096, NULL) == ARENA_ERR_FULL);
+
+	g_reported = 0;
+	arena_set_error_callback(arena, count_errors, NULL);
+	assert(arena_try_alloc(arena, 4096, NULL) == ARENA_ERR_FULL);
+	assert(g_reported > 0);
+
+	int before = g_reported;
+	assert(!arena_alloc(arena, 4096));
+	assert(g_reported > before);
+
+	arena_delete(&arena);
+	printf("✅ test_try_alloc_reports_to_custom_callback passed\n");
+}
+
+static t_arena* g_other;
+
+static void fail_other_hook(t_arena* arena, int id, void* ptr, size_t size, size_t offset, size_t wasted,
+                            const char* label)
+{
+	(void) arena;
+	(void) id;
+	(void) ptr;
+	(void) size;
+	(void) offset;
+	(void) wasted;
+	(void) label;
+	assert(arena_try_alloc(g_other, 4000, NULL) == ARENA_ERR_FULL); // nested, silent
+	assert(!arena_alloc(g_other, 4096));                            // not the try's arena, reported
+}
+
+void test_try_alloc_quiet_only_for_its_arena(void)
+{
+	t_arena* arena = arena_create(TEST_BUFFER_SIZE, false);
+	g_other        = arena_create(256, false);
+	assert(arena && g_other);
+	arena->hooks.hook_cb = fail_other_hook;
+
+	fflush(stderr);
+	FILE* capture = tmpfile();
+	int   saved   = dup(STDERR_FILENO);
+	assert(capture && saved >= 0);
+	dup2(fileno(capture), STDERR_FILENO);
+
+	assert(arena_try_alloc(arena, 32, NULL) == ARENA_OK);
+	arena->hooks.hook_cb = NULL;
+	assert(arena_try_alloc(arena, TEST_BUFFER_SIZE, NULL) == ARENA_ERR_FULL);
+
+	fflush(stderr);
+	dup2(saved, STDERR_FILENO);
+	close(saved);
+
+	// Only the regular allocation on the other arena printed its messages.
+	char output[4096] = {0};
+	rewind(capture);
+	assert(fread(output, 1, sizeof(output) - 1, capture) > 0);
+	fclose(capture);
+	assert(strstr(output, "[ARENA ERROR]"));
+	assert(strstr(output, "requested: 4096"));
+	assert(!strstr(output, "requested: 4000"));
+	assert(!strstr(output, "requested: 2048"));
+
+	arena_delete(&g_other);
+	arena_delete(&arena);
+	printf("✅ test_try_alloc_quiet_only_for_its_arena passed\n");
+}
+
+static void* fail_in_thread(void* arg)
+{
+	(void) arg;
+	assert(arena_last_error() == ARENA_OK);
+	assert(arena_try_alloc(NULL, 8, NULL) == ARENA_ERR_NULL_ARENA);
+	return NULL;
+}
+
+void test_last_error_is_per_thread(void)
+{
+	t_arena* arena = arena_create(TEST_BUFFER_SIZE, false);
+	assert(arena);
+	assert(arena_try_alloc(arena, 0, NULL) == ARENA_ERR_ZERO_SIZE);
+
+	pthread_t thread;
+	assert(pthread_create(&thread, NULL, fail_in_thread, NULL) == 0);
+	pthread_join(thread, NULL);
+	assert(arena_last_error() == ARENA_ERR_ZERO_SIZE);
+
+	arena_set_last_error(ARENA_OK);
+	arena_delete(&arena);
+	printf("✅ test_last_error_is_per_thread passed\n");
+}
+
 int main(void)
 {
 	test_normal_allocations();
 	test_edge_cases();
 	test_stats_tracking();
 	test_hook_invocation();
+	test_try_alloc_error_codes();
+	test_try_alloc_reports_to_custom_callback();
+	test_try_alloc_quiet_only_for_its_arena();
+	test_last_error_is_per_thread();
 	printf("🎉 All arena_alloc* tests passed.\n");
 	return 0;
 }
@@ -0,0 +1,202 @@
+#include "arena.h"
+#include "arena_budget.h"
+#include <assert.h>
+#include <stdio.h>
+
+static int g_errors = 0;
+
+static void count_error_cb(const char* msg, void* ctx)
+{
+	(void) msg;
+	(void) ctx;
+	g_errors++;
+}
+
+static void test_budget_caps_growth(void)
+{
+	t_arena_budget budget;
+	assert(arena_budget_init(&budget, 16 * 1024, NULL));
+
+	t_arena* arena = arena_create_in_budget(&budget, 4096, true);
+	assert(arena);
+	arena_set_error_callback(arena, count_error_cb, NULL);
+	assert(arena_budget_used(&budget) == 4096);
+
+	// Growing to 16 KiB still fits, the next growth does not.
+	assert(arena_alloc(arena, 6000));
+	assert(arena_alloc(arena, 6000));
+	assert(arena_budget_used(&budget) == 16 * 1024);
+	g_errors = 0;
+	assert(!arena_alloc(arena, 6000));
+	assert(g_errors > 0);
+	assert(arena->size == 16 * 1024);
+	assert(arena_budget_used(&budget) == 16 * 1024);
+	assert(atomic_load(&budget.denials) == 1);
+	assert(atomic_load(&budget.peak) == 16 * 1024);
+
+	// Creation is charged too.
+	assert(!arena_create_in_budget(&budget, 1, false));
+
+	arena_delete(&arena);
+	assert(arena_budget_used(&budget) == 0);
+	arena_budget_destroy(&budget);
+	printf("✅ test_budget_caps_growth passed\n");
+}
+
+static void test_budget_hierarchy(void)
+{
+	t_arena_budget process, tenant_a, tenant_b;
+	assert(arena_budget_init(&process, 60 * 1024, NULL));
+	assert(arena_budget_init(&tenant_a, 48 * 1024, &process));
+	assert(arena_budget_init(&tenant_b, 48 * 1024, &process));
+
+	t_arena* a = arena_create_in_budget(&tenant_a, 32 * 1024, true);
+	t_arena* b = arena_create_in_budget(&tenant_b, 16 * 1024, true);
+	assert(a && b);
+	arena_set_error_callback(b, count_error_cb, NULL);
+	assert(arena_budget_used(&process) == 48 * 1024);
+
+	// Growing b to 32 KiB fits tenant_b, but the process budget refuses.
+	assert(arena_alloc(b, 10 * 1024));
+	assert(!arena_alloc(b, 10 * 1024));
+	assert(arena_budget_used(&tenant_b) == 16 * 1024);
+	assert(atomic_load(&process.denials) == 1);
+	assert(atomic_load(&tenant_b.denials) == 0);
+
+	// Releasing tenant_a's memory lets tenant_b grow.
+	arena_delete(&a);
+	assert(arena_budget_used(&tenant_a) == 0);
+	assert(arena_alloc(b, 10 * 1024));
+	assert(arena_budget_used(&tenant_b) == 32 * 1024);
+	assert(arena_budget_used(&process) == 32 * 1024);
+
+	arena_delete(&b);
+	assert(arena_budget_used(&process) == 0);
+	arena_budget_destroy(&tenant_a);
+	arena_budget_destroy(&tenant_b);
+	arena_budget_destroy(&process);
+	printf("✅ test_budget_hierarchy passed\n");
+}
+
+typedef struct
+{
+	t_arena* idle;
+	int      calls;
+} reclaim_ctx;
+
+static size_t reclaim_idle(t_arena_budget* budget, size_t needed, void* context)
+{
+	(void) budget;
+	reclaim_ctx* ctx = context;
+	ctx->calls++;
+	assert(needed > 0);
+
+	size_t before = ctx->idle->size;
+	arena_reset(ctx->idle);
+	arena_shrink(ctx->idle, 1024);
+	return before - ctx->idle->size;
+}
+
+static void test_budget_reclaim(void)
+{
+	t_arena_budget budget;
+	assert(arena_budget_init(&budget, 40 * 1024, NULL));
+
+	t_arena* idle   = arena_create_in_budget(&budget, 16 * 1024, true);
+	t_arena* active = arena_create_in_budget(&budget, 8 * 1024, true);
+	assert(idle && active);
+	assert(arena_alloc(idle, 8 * 1024));
+
+	reclaim_ctx ctx = {.idle = idle};
+	arena_budget_set_policy(&budget, ARENA_BUDGET_RECLAIM, 0);
+	arena_budget_set_reclaim(&budget, reclaim_idle, &ctx);
+
+	// Growing to 32 KiB needs 24 KiB, more than the 16 KiB left: the idle arena gives some back.
+	assert(arena_alloc(active, 12 * 1024));
+	assert(ctx.calls == 1);
+	assert(idle->size == 1024);
+	assert(arena_budget_used(&budget) == 1024 + 32 * 1024);
+
+	// Once nothing is left to reclaim, the allocation fails.
+	arena_set_error_callback(active, count_error_cb, NULL);
+	assert(!arena_alloc(active, 32 * 1024));
+	assert(ctx.calls == 2);
+	assert(atomic_load(&budget.reclaims) == 2);
+
+	arena_delete(&idle);
+	arena_delete(&active);
+	assert(arena_budget_used(&budget) == 0);
+	arena_budget_destroy(&budget);
+	printf("✅ test_budget_reclaim passed\n");
+}
+
+static void test_budget_attach_shrink_large(void)
+{
+	t_arena_budget budget;
+	assert(arena_budget_init(&budget, 0, NULL)); // accounting only
+
+	t_arena* arena = arena_create(64 * 1024, true);
+	assert(arena);
+	arena_set_large_threshold(arena, 256 * 1024);
+	assert(arena_alloc(arena, 512 * 1024));
+
+	// Attaching charges the buffer and the large mapping it already holds.
+	assert(arena_budget_attach(arena, &budget));
+	size_t attached = arena_budget_used(&budget);
+	assert(attached > 64 * 1024 + 512 * 1024);
+
+	// Popping the large allocation and shrinking credit the budget.
+	arena_reset(arena);
+	assert(arena_budget_used(&budget) == 64 * 1024);
+	arena_shrink(arena, 4096);
+	assert(arena_budget_used(&budget) == 4096);
+
+	arena_budget_detach(arena);
+	assert(arena_budget_used(&budget) == 0);
+	assert(atomic_load(&budget.peak) == attached);
+
+	// A budget too small for the arena refuses the attach.
+	t_arena_budget tiny;
+	assert(arena_budget_init(&tiny, 1024, NULL));
+	arena_set_error_callback(arena, count_error_cb, NULL);
+	assert(!arena_budget_attach(arena, &tiny));
+	assert(!arena->budget && arena_budget_used(&tiny) == 0);
+
+	assert(!arena_budget_attach(NULL, &budget));
+	assert(!arena_budget_attach(arena, NULL));
+	arena_budget_detach(NULL);
+
+	arena_delete(&arena);
+	arena_budget_destroy(&tiny);
+	arena_budget_destroy(&budget);
+	printf("✅ test_budget_attach_shrink_large passed\n");
+}
+
+static void test_budget_borrowed_buffer(void)
+{
+	t_arena_budget budget;
+	assert(arena_budget_init(&budget, 4096, NULL));
+
+	// Borrowed memory is not charged, only what the arena obtains itself.
+	uint8_t buffer[8192];
+	t_arena arena;
+	arena_init_with_buffer(&arena, buffer, sizeof(buffer), false);
+	assert(arena_budget_attach(&arena, &budget));
+	assert(arena_budget_used(&budget) == 0);
+	arena_destroy(&arena);
+	assert(arena_budget_used(&budget) == 0);
+
+	arena_budget_destroy(&budget);
+	printf("✅ test_budget_borrowed_buffer passed\n");
+}
+
+int main(void)
+{
+	test_budget_caps_growth();
+	test_budget_hierarchy();
+	test_budget_reclaim();
+	test_budget_attach_shrink_large();
+	test_budget_borrowed_buffer();
+	printf("🎉 All arena_budget tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,146 @@
+#include "arena.h"
+#include "arena_cow.h"
+#include "arena_handoff.h"
+#include "arena_persist.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char* g_path = "/tmp/arena_test_cow.arena";
+
+static void test_cow_clone_is_private(void)
+{
+	t_arena* source = arena_create_memfd("cow_source", 4 * 4096, true);
+	assert(source);
+	char* text = arena_alloc(source, 32);
+	strcpy(text, "original");
+	size_t used = source->offset;
+
+	t_arena* clone = arena_clone_cow(source);
+	assert(clone);
+	assert(clone->backing.kind == ARENA_BACKING_COW);
+	assert(clone->buffer != source->buffer);
+	assert(clone->size == source->size);
+	assert(clone->offset == used);
+	assert(strcmp((char*) clone->buffer, "original") == 0);
+
+	// Writes and allocations in the clone never reach the source.
+	strcpy((char*) clone->buffer, "speculative");
+	char* extra = arena_alloc(clone, 64);
+	assert(extra);
+	memset(extra, 'x', 64);
+	assert(strcmp(text, "original") == 0);
+	assert(source->offset == used);
+
+	// Clones share the source file, so they cannot be resized.
+	assert(!arena_alloc(clone, clone->size));
+	arena_reset(clone);
+	arena_shrink(clone, 4096);
+	assert(clone->size == source->size);
+
+	arena_delete(&clone);
+	assert(strcmp(text, "original") == 0);
+	arena_delete(&source);
+	printf("✅ test_cow_clone_is_private passed\n");
+}
+
+static void test_cow_promote(void)
+{
+	t_arena* source = arena_create_memfd("cow_promote", 8 * 4096, false);
+	assert(source);
+	int* values = arena_alloc(source, 4 * 4096);
+	for (int i = 0; i < 4096; ++i)
+		values[i] = i;
+
+	t_arena* clone = arena_clone_cow(source);
+	assert(clone);
+	int* cloned = (int*) clone->buffer;
+	cloned[10]  = -10;
+	cloned[3000] = -3000;
+	char* tail  = arena_alloc(clone, 16);
+	strcpy(tail, "appended");
+
+	assert(values[10] == 10);
+	assert(arena_cow_promote(clone, source));
+	assert(values[10] == -10 && values[3000] == -3000 && values[11] == 11);
+	assert(source->offset == clone->offset);
+	assert(strcmp((char*) source->buffer + (tail - (char*) clone->buffer), "appended") == 0);
+	assert(arena_peak(source) >= source->offset);
+
+	arena_delete(&clone);
+	arena_delete(&source);
+	printf("✅ test_cow_promote passed\n");
+}
+
+static void test_cow_persistent_source(void)
+{
+	unlink(g_path);
+	t_arena* source = arena_open_persistent(g_path, 8192, false);
+	assert(source);
+	strcpy(arena_alloc(source, 16), "on disk");
+
+	t_arena* clone = arena_clone_cow(source);
+	assert(clone);
+	assert(strcmp((char*) clone->buffer, "on disk") == 0);
+	char* promoted = arena_alloc(clone, 16);
+	strcpy(promoted, "promoted");
+	size_t promoted_at = (size_t) (promoted - (char*) clone->buffer);
+	size_t used        = clone->offset;
+
+	assert(arena_cow_promote(clone, source));
+	assert(!arena_sync(clone));
+
+	// Destroying the source first leaves the clone valid (it owns its own descriptor).
+	arena_delete(&source);
+	assert(strcmp((char*) clone->buffer + promoted_at, "promoted") == 0);
+	arena_delete(&clone);
+
+	source = arena_open_persistent(g_path, 8192, false);
+	assert(source);
+	assert(source->offset == used);
+	assert(strcmp((char*) source->buffer + promoted_at, "promoted") == 0);
+	arena_delete(&source);
+	unlink(g_path);
+	printf("✅ test_cow_persistent_source passed\n");
+}
+
+static void test_cow_error_cases(void)
+{
+	assert(!arena_clone_cow(NULL));
+
+	t_arena* heap = arena_create(4096, false);
+	assert(heap);
+	assert(!arena_clone_cow(heap));
+
+	t_arena* a = arena_create_memfd("cow_a", 4096, false);
+	t_arena* b = arena_create_memfd("cow_b", 4096, false);
+	assert(a && b);
+	t_arena* clone = arena_clone_cow(a);
+	assert(clone);
+
+	assert(!arena_cow_promote(clone, b));
+	assert(!arena_cow_promote(a, b));
+	assert(!arena_cow_promote(clone, heap));
+	assert(!arena_cow_promote(clone, clone));
+	assert(!arena_cow_promote(NULL, a));
+
+	// A clone of a clone would share no file with a writable source.
+	assert(!arena_clone_cow(clone));
+
+	arena_delete(&clone);
+	arena_delete(&a);
+	arena_delete(&b);
+	arena_delete(&heap);
+	printf("✅ test_cow_error_cases passed\n");
+}
+
+int main(void)
+{
+	test_cow_clone_is_private();
+	test_cow_promote();
+	test_cow_persistent_source();
+	test_cow_error_cases();
+	printf("🎉 All arena_cow tests passed.\n");
+	return 0;
+}
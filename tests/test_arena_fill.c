@@ -0,0 +1,140 @@
+#include "arena.h"
+#include "arena_prezero.h"
+#include "internal/arena_fill.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define GUARD 0xA5
+
+static bool pattern_ok(const uint8_t* ptr, size_t len, uint32_t pattern)
+{
+	uint8_t bytes[4];
+	memcpy(bytes, &pattern, sizeof(bytes));
+	for (size_t i = 0; i < len; ++i)
+		if (ptr[i] != bytes[i % 4])
+			return false;
+	return true;
+}
+
+static void test_fill_pattern_all_kernels(void)
+{
+	static const size_t sizes[] = {0, 1, 3, 4, 63, 64, 127, 128, 129, 200, 1000, 4097};
+	static uint8_t      buffer[8192];
+	t_arena_fill_isa    initial = arena_fill_isa();
+	int                 kernels = 0;
+
+	for (int isa = 0; isa < ARENA_FILL_ISA_COUNT; ++isa)
+	{
+		if (!arena_fill_use_isa((t_arena_fill_isa) isa))
+			continue;
+		kernels++;
+		for (size_t shift = 0; shift < 8; ++shift)
+			for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+			{
+				memset(buffer, GUARD, sizeof(buffer));
+				arena_fill_pattern(buffer + 16 + shift, ARENA_POISON_PATTERN, sizes[i]);
+				assert(pattern_ok(buffer + 16 + shift, sizes[i], ARENA_POISON_PATTERN));
+				assert(buffer[15 + shift] == GUARD && buffer[16 + shift + sizes[i]] == GUARD);
+			}
+		printf("   kernel %s ok\n", arena_fill_isa_name((t_arena_fill_isa) isa));
+	}
+
+	assert(kernels >= 1);
+	assert(!arena_fill_use_isa(ARENA_FILL_ISA_COUNT));
+	assert(arena_fill_use_isa(initial));
+	printf("✅ test_fill_pattern_all_kernels passed\n");
+}
+
+static void test_fill_zero_streams_large_ranges(void)
+{
+	const size_t     len     = ARENA_FILL_STREAM_MIN + 77;
+	uint8_t*         buffer  = malloc(len + 64);
+	t_arena_fill_isa initial = arena_fill_isa();
+	assert(buffer);
+
+	for (int isa = 0; isa < ARENA_FILL_ISA_COUNT; ++isa)
+	{
+		if (!arena_fill_use_isa((t_arena_fill_isa) isa))
+			continue;
+		memset(buffer, GUARD, len + 64);
+		arena_fill_zero(buffer + 3, len);
+		assert(pattern_ok(buffer + 3, len, 0));
+		assert(buffer[2] == GUARD && buffer[3 + len] == GUARD);
+
+		memset(buffer, GUARD, len + 64);
+		arena_fill_zero_stream(buffer + 1, 4000);
+		assert(pattern_ok(buffer + 1, 4000, 0));
+		assert(buffer[0] == GUARD && buffer[4001] == GUARD);
+	}
+
+	assert(arena_fill_use_isa(initial));
+	free(buffer);
+	printf("✅ test_fill_zero_streams_large_ranges passed\n");
+}
+
+static void test_scan_pattern_all_kernels(void)
+{
+	static uint8_t   buffer[4096];
+	t_arena_fill_isa initial = arena_fill_isa();
+
+	for (int isa = 0; isa < ARENA_FILL_ISA_COUNT; ++isa)
+	{
+		if (!arena_fill_use_isa((t_arena_fill_isa) isa))
+			continue;
+		for (size_t shift = 0; shift < 5; ++shift)
+		{
+			const size_t len = sizeof(buffer) - 8;
+			arena_fill_pattern(buffer + shift, ARENA_POISON_PATTERN, len);
+			assert(arena_scan_pattern(buffer + shift, ARENA_POISON_PATTERN, len) == len);
+
+			// A single changed byte is found wherever it is: head, vector body or tail.
+			static const size_t spots[] = {0, 5, 70, 1000, 2049, 4087};
+			for (size_t i = 0; i < sizeof(spots) / sizeof(*spots); ++i)
+			{
+				buffer[shift + spots[i]] ^= 0x01;
+				assert(arena_scan_pattern(buffer + shift, ARENA_POISON_PATTERN, len) == spots[i]);
+				assert(arena_scan_pattern(buffer + shift, ARENA_POISON_PATTERN, spots[i]) == spots[i]);
+				buffer[shift + spots[i]] ^= 0x01;
+			}
+		}
+	}
+
+	assert(arena_fill_use_isa(initial));
+	printf("✅ test_scan_pattern_all_kernels passed\n");
+}
+
+static void test_reset_poisons_used_range(void)
+{
+#ifdef ARENA_POISON_MEMORY
+	t_arena* arena = arena_create(64 * 1024, false);
+	assert(arena);
+
+	uint8_t* block = arena_alloc(arena, 4096);
+	assert(block);
+	memset(block, 0, 4096);
+	arena_reset(arena);
+
+	// Only what this cycle handed out is poisoned; the untouched tail stays clean.
+	ARENA_SAN_OPEN(arena->buffer, arena->size);
+	assert(pattern_ok(arena->buffer, 4096, ARENA_POISON_PATTERN));
+	assert(arena->buffer[4096] == 0 && arena->buffer[64 * 1024 - 1] == 0);
+	assert(arena_clean_bytes(arena) == 60 * 1024);
+
+	arena_delete(&arena);
+	printf("✅ test_reset_poisons_used_range passed\n");
+#else
+	printf("⚠️ Skipped test_reset_poisons_used_range (ARENA_POISON_MEMORY disabled)\n");
+#endif
+}
+
+int main(void)
+{
+	printf("   fill kernel: %s\n", arena_fill_isa_name(arena_fill_isa()));
+	test_fill_pattern_all_kernels();
+	test_fill_zero_streams_large_ranges();
+	test_scan_pattern_all_kernels();
+	test_reset_poisons_used_range();
+	printf("🎉 All arena_fill tests passed.\n");
+	return 0;
+}
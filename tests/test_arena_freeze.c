@@ -0,0 +1,158 @@
+#define _GNU_SOURCE
+#include "arena.h"
+#include "arena_handoff.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static sigjmp_buf g_fault_jmp;
+
+static void on_fault(int sig)
+{
+	(void) sig;
+	siglongjmp(g_fault_jmp, 1);
+}
+
+static bool write_faults(volatile char* ptr)
+{
+	struct sigaction sa;
+	struct sigaction old;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = on_fault;
+	sigaction(SIGSEGV, &sa, &old);
+
+	bool faulted = false;
+	ARENA_SAN_OPEN((char*) ptr, 1); // probes free arena memory
+	if (sigsetjmp(g_fault_jmp, 1) == 0)
+		*ptr = 'X';
+	else
+		faulted = true;
+
+	sigaction(SIGSEGV, &old, NULL);
+	return faulted;
+}
+
+static void test_freeze_rejects_mutation(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	char* text = arena_alloc(arena, 32);
+	strcpy(text, "read only");
+	t_arena_marker mark = arena_mark(arena);
+	size_t         used = arena_used(arena);
+
+	assert(!arena_is_frozen(arena));
+	assert(arena_freeze(arena));
+	assert(arena_is_frozen(arena));
+	assert(arena_freeze(arena));
+
+	assert(!arena_alloc(arena, 8));
+	assert(!arena_calloc(arena, 4, 4));
+	assert(!arena_realloc_last(arena, text, 32, 64));
+	assert(!arena_grow(arena, 8192));
+	arena_shrink(arena, 64);
+	assert(!arena_might_shrink(arena));
+	arena_pop(arena, 0);
+	arena_reset(arena);
+
+	// Read paths still work and the state is unchanged.
+	assert(arena_used(arena) == used);
+	assert(arena_mark(arena) == mark);
+	assert(arena_remaining(arena) == 4096 - used);
+	assert(arena_peak(arena) == used);
+	assert(arena_get_stats(arena).allocations == 1);
+	assert(arena->size == 4096);
+	assert(strcmp(text, "read only") == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_freeze_rejects_mutation passed\n");
+}
+
+static void test_freeze_protects_pages(void)
+{
+	// A large heap buffer always contains whole pages.
+	t_arena* arena = arena_create(64 * 1024, false);
+	assert(arena);
+	assert(arena_alloc(arena, 100));
+	assert(arena_freeze(arena));
+
+	char* middle = (char*) arena->buffer + 32 * 1024;
+	assert(write_faults(middle));
+	assert(*middle != 'X');
+
+	// Destroy makes the pages writable again before releasing them.
+	arena_delete(&arena);
+
+	t_arena* memfd = arena_create_memfd("freeze", 8192, false);
+	assert(memfd);
+	assert(arena_freeze(memfd));
+	assert(write_faults((char*) memfd->buffer));
+	arena_delete(&memfd);
+	printf("✅ test_freeze_protects_pages passed\n");
+}
+
+static void test_freeze_sub_arena_is_logical(void)
+{
+	t_arena* parent = arena_create(8192, false);
+	t_arena  child;
+	assert(parent);
+	assert(arena_alloc_sub(parent, &child, 4096));
+
+	assert(arena_freeze(&child));
+	assert(!arena_alloc(&child, 8));
+	assert(!write_faults((char*) child.buffer));
+
+	// The parent owns the memory and is unaffected.
+	assert(arena_alloc(parent, 64));
+	arena_reset(parent);
+
+	arena_destroy(&child);
+	arena_delete(&parent);
+	printf("✅ test_freeze_sub_arena_is_logical passed\n");
+}
+
+static void test_seal_memfd(void)
+{
+	t_arena* arena = arena_create_memfd("sealed", 4096, true);
+	assert(arena);
+	strcpy(arena_alloc(arena, 16), "sealed data");
+	assert(arena_seal(arena));
+	assert(arena_is_frozen(arena));
+
+	int seals = fcntl(arena->backing.fd, F_GET_SEALS);
+	assert(seals & F_SEAL_GROW);
+	assert(seals & F_SEAL_SHRINK);
+	assert(write(arena->backing.fd, "x", 1) == -1);
+	assert(mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, arena->backing.fd, 0) == MAP_FAILED);
+
+	void* view = mmap(NULL, 4096, PROT_READ, MAP_SHARED, arena->backing.fd, 0);
+	assert(view != MAP_FAILED);
+	assert(strcmp((char*) view, "sealed data") == 0);
+	munmap(view, 4096);
+
+	arena_delete(&arena);
+
+	t_arena* heap = arena_create(1024, false);
+	assert(!arena_seal(heap));
+	assert(!arena_is_frozen(heap));
+	arena_delete(&heap);
+	assert(!arena_seal(NULL));
+	assert(!arena_freeze(NULL));
+	assert(!arena_is_frozen(NULL));
+	printf("✅ test_seal_memfd passed\n");
+}
+
+int main(void)
+{
+	test_freeze_rejects_mutation();
+	test_freeze_protects_pages();
+	test_freeze_sub_arena_is_logical();
+	test_seal_memfd();
+	printf("🎉 All arena_freeze tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,163 @@
+#include "arena.h"
+#include "arena_grow_policy.h"
+#include <assert.h>
+#include <stdio.h>
+#include <unistd.h>
+
+typedef struct
+{
+	int    calls;
+	size_t last_history_count;
+} policy_probe;
+
+static size_t exact_policy(t_arena* arena, size_t required_size, void* context)
+{
+	policy_probe* probe = context;
+	probe->calls++;
+	probe->last_history_count = arena->stats.growth_history_count;
+	return arena->offset + required_size;
+}
+
+static size_t too_small_policy(t_arena* arena, size_t required_size, void* context)
+{
+	(void) required_size;
+	(void) context;
+	return arena->size;
+}
+
+static size_t triple_cb(size_t current_size, size_t requested_size)
+{
+	(void) requested_size;
+	return current_size * 3;
+}
+
+static void test_policy_geometric(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_grow_policy(arena, arena_grow_policy_geometric(1.5, 0));
+
+	assert(arena_alloc(arena, 4000));
+	assert(arena_alloc(arena, 200));
+	assert(arena->size == 6144);
+
+	// A capped step still fits the allocation that triggered it.
+	arena_set_grow_policy(arena, arena_grow_policy_geometric(4.0, 8192));
+	assert(arena_alloc(arena, 3000));
+	assert(arena->size == 6144 + 8192);
+	size_t offset = arena->offset;
+	assert(arena_alloc(arena, 100000));
+	assert(arena->size == align_up(offset + ARENA_REDZONE_SIZE, ARENA_DEFAULT_ALIGNMENT) + 100000);
+
+	// Invalid factors fall back to the default.
+	assert(arena_grow_policy_geometric(0.5, 0).factor == ARENA_GROW_DEFAULT_FACTOR);
+
+	arena_delete(&arena);
+	printf("✅ test_policy_geometric passed\n");
+}
+
+static void test_policy_linear(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_grow_policy(arena, arena_grow_policy_linear(1000));
+
+	assert(arena_alloc(arena, 4096));
+	assert(arena_alloc(arena, 2500));
+	assert(arena->size == 4096 + 3000);
+	assert(arena_alloc(arena, 600));
+	assert(arena->size == 4096 + 4000);
+
+	assert(arena_grow_policy_linear(0).step == (size_t) sysconf(_SC_PAGESIZE));
+	arena_delete(&arena);
+	printf("✅ test_policy_linear passed\n");
+}
+
+static void test_policy_rounded(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_grow_policy(arena, arena_grow_policy_rounded(ARENA_HUGE_PAGE_SIZE));
+
+	assert(arena_alloc(arena, 8192));
+	assert(arena->size == ARENA_HUGE_PAGE_SIZE);
+	assert(arena_alloc(arena, ARENA_HUGE_PAGE_SIZE + 1));
+	assert(arena->size == 2 * ARENA_HUGE_PAGE_SIZE);
+
+	const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+	arena_set_grow_policy(arena, arena_grow_policy_rounded(0));
+	size_t before = arena->size;
+	assert(arena_alloc(arena, arena->size));
+	assert(arena->size > before && arena->size % page == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_policy_rounded passed\n");
+}
+
+static void test_policy_adaptive(void)
+{
+	t_arena* arena = arena_create(1024, true);
+	assert(arena);
+	arena_set_grow_policy(arena, arena_grow_policy_adaptive(16));
+	assert(arena->grow_policy.factor == ARENA_GROW_DEFAULT_FACTOR);
+
+	// Back-to-back growths push the factor up to its ceiling.
+	for (int i = 0; i < 4; ++i)
+		assert(arena_alloc(arena, arena->size));
+	assert(arena->grow_policy.factor == ARENA_GROW_ADAPTIVE_MAX_FACTOR);
+	size_t before = arena->size;
+	assert(arena_alloc(arena, arena->size));
+	assert(arena->size >= before * (size_t) ARENA_GROW_ADAPTIVE_MAX_FACTOR);
+
+	// A long quiet period lowers it again.
+	for (int i = 0; i < 16 * 4; ++i)
+		assert(arena_alloc(arena, 1));
+	assert(arena_alloc(arena, arena->size));
+	assert(arena->grow_policy.factor == ARENA_GROW_ADAPTIVE_MAX_FACTOR / 2);
+
+	arena_delete(&arena);
+	printf("✅ test_policy_adaptive passed\n");
+}
+
+static void test_policy_custom_and_fallback(void)
+{
+	t_arena* arena = arena_create(1024, true);
+	assert(arena);
+
+	policy_probe        probe  = {0};
+	t_arena_grow_policy policy = {.fn = exact_policy, .context = &probe};
+	arena_set_grow_policy(arena, policy);
+
+	assert(arena_alloc(arena, 1024));
+	assert(arena_alloc(arena, 100));
+	assert(arena_alloc(arena, 100));
+	assert(probe.calls == 2);
+	assert(probe.last_history_count == 1);
+	assert(arena->size == arena->offset);
+
+	// A policy returning too little fails the allocation.
+	arena_set_grow_policy(arena, (t_arena_grow_policy) {.fn = too_small_policy});
+	assert(!arena_alloc(arena, 64));
+
+	// Without a policy function, grow_cb applies again.
+	arena->grow_cb = triple_cb;
+	arena_set_grow_policy(arena, (t_arena_grow_policy) {0});
+	size_t before = arena->size;
+	assert(arena_alloc(arena, 64));
+	assert(arena->size == before * 3);
+
+	arena_set_grow_policy(NULL, policy);
+	arena_delete(&arena);
+	printf("✅ test_policy_custom_and_fallback passed\n");
+}
+
+int main(void)
+{
+	test_policy_geometric();
+	test_policy_linear();
+	test_policy_rounded();
+	test_policy_adaptive();
+	test_policy_custom_and_fallback();
+	printf("🎉 All arena_grow_policy tests passed.\n");
+	return 0;
+}
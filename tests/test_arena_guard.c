@@ -0,0 +1,180 @@
+#include "arena.h"
+#include "arena_io.h"
+#include "arena_scratch.h"
+#include <assert.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static sigjmp_buf g_fault_jmp;
+
+static void on_fault(int sig)
+{
+	(void) sig;
+	siglongjmp(g_fault_jmp, 1);
+}
+
+// Rewrites the byte in place, so poison patterns below the offset stay intact.
+static bool write_faults(volatile char* ptr)
+{
+	struct sigaction sa;
+	struct sigaction old;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = on_fault;
+	sigaction(SIGSEGV, &sa, &old);
+
+	bool faulted = false;
+	ARENA_SAN_OPEN((char*) ptr, 1); // probes memory past the end of a sub-arena
+	if (sigsetjmp(g_fault_jmp, 1) == 0)
+		*ptr = *ptr;
+	else
+		faulted = true;
+
+	sigaction(SIGSEGV, &old, NULL);
+	return faulted;
+}
+
+static void test_sub_arena_overrun_faults(void)
+{
+	const size_t page   = (size_t) sysconf(_SC_PAGESIZE);
+	t_arena*     parent = arena_create(16 * page, false);
+	assert(parent);
+	assert(!arena_guard_pages(parent));
+	arena_set_guard_pages(parent, true);
+	assert(arena_guard_pages(parent));
+
+	t_arena first;
+	t_arena second;
+	assert(arena_alloc_sub(parent, &first, 100));
+	assert(arena_alloc_sub_aligned(parent, &second, page + 1, 64));
+	assert(((uintptr_t) first.buffer & (page - 1)) == 0);
+	assert(first.size == page && second.size == 2 * page);
+	assert(second.buffer == first.buffer + align_up(2 * page + ARENA_REDZONE_SIZE, page));
+
+	memset(arena_alloc(&first, first.size), 0x11, first.size);
+	memset(arena_alloc(&second, second.size), 0x22, second.size);
+	assert(write_faults((char*) first.buffer + first.size));
+	assert(write_faults((char*) second.buffer + second.size));
+	assert(first.buffer[first.size - 1] == 0x11 && second.buffer[0] == 0x22);
+
+	arena_destroy(&second);
+	arena_destroy(&first);
+	arena_delete(&parent);
+	printf("✅ test_sub_arena_overrun_faults passed\n");
+}
+
+static void test_pop_and_reset_lift_guards(void)
+{
+	const size_t page   = (size_t) sysconf(_SC_PAGESIZE);
+	t_arena*     parent = arena_create(16 * page, false);
+	assert(parent);
+	arena_set_guard_pages(parent, true);
+
+	t_arena keep;
+	t_arena temp;
+	assert(arena_alloc_sub(parent, &keep, page));
+	t_arena_marker mark = arena_mark(parent);
+	assert(arena_alloc_sub(parent, &temp, page));
+	assert(parent->guards.count == 2);
+	char* temp_guard = (char*) temp.buffer + temp.size;
+
+	arena_destroy(&temp);
+	arena_pop(parent, mark);
+	assert(parent->guards.count == 1);
+	assert(!write_faults(temp_guard));
+	assert(write_faults((char*) keep.buffer + keep.size));
+
+	arena_destroy(&keep);
+	arena_reset(parent);
+	assert(parent->guards.count == 0);
+	memset(arena_alloc(parent, 4 * page), 0, 4 * page); // former guard pages are plain memory again
+
+	arena_delete(&parent);
+	printf("✅ test_pop_and_reset_lift_guards passed\n");
+}
+
+static void test_guards_survive_growth_in_place(void)
+{
+	const size_t page   = (size_t) sysconf(_SC_PAGESIZE);
+	t_arena*     parent = arena_create(4 * page, true);
+	assert(parent);
+	arena_set_guard_pages(parent, true);
+
+	t_arena child;
+	assert(arena_alloc_sub(parent, &child, page));
+	size_t   guard  = (size_t) (child.buffer + child.size - parent->buffer);
+	uint8_t* before = parent->buffer;
+	arena_destroy(&child);
+
+	assert(arena_alloc(parent, 64 * page)); // grows, possibly moving the buffer
+	if (parent->buffer == before)
+		assert(write_faults((char*) parent->buffer + guard));
+	else
+		assert(parent->guards.count == 0); // the sub-arena was left behind
+	assert(!write_faults((char*) parent->buffer + guard - 1));
+
+	arena_delete(&parent);
+	printf("✅ test_guards_survive_growth_in_place passed\n");
+}
+
+static void test_snapshot_reads_past_guards(void)
+{
+	const size_t page   = (size_t) sysconf(_SC_PAGESIZE);
+	const char*  path   = "test_arena_guard.bin";
+	t_arena*     parent = arena_create(8 * page, false);
+	assert(parent);
+	arena_set_guard_pages(parent, true);
+
+	t_arena child;
+	assert(arena_alloc_sub(parent, &child, page));
+	memset(arena_alloc(&child, 16), 0x5A, 16);
+	assert(arena_save_to_file(parent, path));
+	assert(write_faults((char*) child.buffer + child.size));
+	arena_destroy(&child);
+
+	size_t used = parent->offset;
+	assert(arena_load_from_file(parent, path));
+	assert(parent->offset == used && parent->guards.count == 0);
+	assert(!write_faults((char*) parent->buffer + used - 1));
+
+	remove(path);
+	arena_delete(&parent);
+	printf("✅ test_snapshot_reads_past_guards passed\n");
+}
+
+static void test_guarded_scratch_pool(void)
+{
+	const size_t         page = (size_t) sysconf(_SC_PAGESIZE);
+	t_scratch_arena_pool pool;
+
+	assert(scratch_pool_init_guarded(&pool, 1000, false));
+	assert(pool.slot_size == page);
+
+	t_arena* a = scratch_acquire(&pool);
+	t_arena* b = scratch_acquire(&pool);
+	assert(a && b && a != b);
+	assert(a->size == page && !arena_alloc(a, 2 * page)); // slots do not grow
+
+	memset(arena_alloc(a, page), 0x33, page);
+	assert(write_faults((char*) a->buffer + a->size));
+	assert(write_faults((char*) b->buffer + b->size));
+
+	scratch_release(&pool, b);
+	scratch_release(&pool, a);
+	assert(scratch_pool_trim(&pool) == 0);
+	scratch_pool_destroy(&pool);
+	printf("✅ test_guarded_scratch_pool passed\n");
+}
+
+int main(void)
+{
+	test_sub_arena_overrun_faults();
+	test_pop_and_reset_lift_guards();
+	test_guards_survive_growth_in_place();
+	test_snapshot_reads_past_guards();
+	test_guarded_scratch_pool();
+	printf("🎉 All arena_guard tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,152 @@
+#include "arena.h"
+#include "arena_handoff.h"
+#include "arena_persist.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+typedef struct s_node
+{
+	struct s_node* next;
+	int            value;
+} t_node;
+
+static int adopt_child(void)
+{
+	t_arena* arenas[2] = {NULL, NULL};
+	if (arena_handoff_adopt(-1, arenas, 2) != 2)
+		return 10;
+	if (getenv(ARENA_HANDOFF_ENV))
+		return 11;
+
+	t_arena* list = arenas[0];
+	t_arena* text = arenas[1];
+	if (arena_persist_relocation(list) != 0)
+		return 12;
+
+	// Absolute pointers written by the previous image are still valid.
+	int     expected = 0;
+	t_node* node     = (t_node*) list->buffer;
+	while (node)
+	{
+		if (node->value != expected++)
+			return 13;
+		node = node->next;
+	}
+	if (expected != 8 || strcmp((char*) text->buffer, "handed over") != 0)
+		return 14;
+
+	// The adopted arenas remain fully usable, including growth.
+	if (!arena_alloc(text, 64 * 1024) || text->backing.kind != ARENA_BACKING_MEMFD)
+		return 15;
+
+	arena_delete(&list);
+	arena_delete(&text);
+	return 0;
+}
+
+static void test_memfd_arena_basics(void)
+{
+	t_arena* arena = arena_create_memfd("test_memfd", 4096, true);
+	assert(arena);
+	assert(arena->backing.kind == ARENA_BACKING_MEMFD);
+	assert(fcntl(arena->backing.fd, F_GETFD) & FD_CLOEXEC);
+
+	char* first = arena_alloc(arena, 16);
+	strcpy(first, "memfd");
+	assert(arena_alloc(arena, 32 * 1024));
+	assert(arena->size >= 32 * 1024);
+	assert(strcmp((char*) arena->buffer, "memfd") == 0);
+
+	arena_reset(arena);
+	arena_shrink(arena, 4096);
+	assert(arena->size == 4096);
+
+	arena_delete(&arena);
+	assert(!arena_create_memfd("zero", 0, false));
+	printf("✅ test_memfd_arena_basics passed\n");
+}
+
+static void test_handoff_across_exec(const char* self)
+{
+	t_arena* list = arena_create_memfd("list", 4096, false);
+	t_arena* text = arena_create_memfd("text", 4096, true);
+	assert(list && text);
+
+	t_node* prev = NULL;
+	for (int i = 0; i < 8; ++i)
+	{
+		t_node* node = arena_alloc(list, sizeof(t_node));
+		node->value  = i;
+		node->next   = NULL;
+		if (prev)
+			prev->next = node;
+		prev = node;
+	}
+	strcpy(arena_alloc(text, 16), "handed over");
+
+	t_arena* arenas[2] = {list, text};
+	int      manifest  = arena_handoff_prepare(arenas, 2);
+	assert(manifest >= 0);
+	assert(getenv(ARENA_HANDOFF_ENV));
+	assert(!(fcntl(list->backing.fd, F_GETFD) & FD_CLOEXEC));
+
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if (pid == 0)
+	{
+		char* argv[] = {(char*) self, "--adopt", NULL};
+		execve("/proc/self/exe", argv, environ);
+		_exit(127);
+	}
+
+	int status = 0;
+	assert(waitpid(pid, &status, 0) == pid);
+	assert(WIFEXITED(status));
+	assert(WEXITSTATUS(status) == 0);
+
+	close(manifest);
+	unsetenv(ARENA_HANDOFF_ENV);
+	arena_delete(&list);
+	arena_delete(&text);
+	printf("✅ test_handoff_across_exec passed\n");
+}
+
+static void test_handoff_error_cases(void)
+{
+	t_arena* heap = arena_create(1024, false);
+	assert(heap);
+	assert(arena_handoff_prepare(&heap, 1) == -1);
+	assert(arena_handoff_prepare(NULL, 1) == -1);
+	assert(arena_handoff_prepare(&heap, 0) == -1);
+	arena_delete(&heap);
+
+	t_arena* out[1] = {NULL};
+	unsetenv(ARENA_HANDOFF_ENV);
+	assert(arena_handoff_adopt(-1, out, 1) == 0);
+
+	int bogus[2];
+	assert(pipe(bogus) == 0);
+	assert(write(bogus[1], "not a manifest", 14) == 14);
+	close(bogus[1]);
+	assert(arena_handoff_adopt(bogus[0], out, 1) == 0);
+	printf("✅ test_handoff_error_cases passed\n");
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "--adopt") == 0)
+		return adopt_child();
+
+	test_memfd_arena_basics();
+	test_handoff_across_exec(argv[0]);
+	test_handoff_error_cases();
+	printf("🎉 All arena_handoff tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,161 @@
+#include "arena.h"
+#include "arena_handoff.h"
+#include "arena_stats.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LARGE_SIZE (64u << 20)
+
+static void test_large_bypasses_buffer(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	assert(arena_large_threshold(arena) == ARENA_LARGE_THRESHOLD);
+	arena_set_large_threshold(arena, 1 << 20);
+	assert(arena_large_threshold(arena) == 1 << 20);
+
+	char* small = arena_alloc(arena, 64);
+	assert(small);
+	memset(small, 's', 64);
+
+	uint8_t* big = arena_alloc(arena, LARGE_SIZE);
+	assert(big);
+	assert(((uintptr_t) big & (uintptr_t) (sysconf(_SC_PAGESIZE) - 1)) == 0);
+	assert(big < arena->buffer || big >= arena->buffer + arena->size);
+	memset(big, 0xAB, LARGE_SIZE);
+
+	// The bump buffer only consumed a one-byte ticket and never grew.
+	assert(arena->size == 4096);
+	assert(arena->offset <= 64 + ARENA_REDZONE_SIZE + ARENA_DEFAULT_ALIGNMENT + 1);
+
+	t_arena_stats stats = arena_get_stats(arena);
+	assert(stats.large_allocations == 1);
+	assert(stats.large_bytes == LARGE_SIZE);
+	assert(stats.allocations == 2);
+
+	// Small allocations keep coming from the buffer after the large one.
+	char* after = arena_alloc(arena, 32);
+	assert(after >= (char*) arena->buffer && after < (char*) arena->buffer + arena->size);
+
+	arena_delete(&arena);
+	printf("✅ test_large_bypasses_buffer passed\n");
+}
+
+static void test_large_pop_releases_past_marker(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_large_threshold(arena, 8192);
+
+	void*          first = arena_alloc(arena, 100000);
+	t_arena_marker mark  = arena_mark(arena);
+	void*          second = arena_alloc(arena, 200000);
+	void*          third  = arena_alloc(arena, 300000);
+	assert(first && second && third);
+	assert(arena_get_stats(arena).large_bytes == 600000);
+
+	// A marker taken right after a large allocation keeps it alive.
+	arena_pop(arena, mark);
+	assert(arena_get_stats(arena).large_bytes == 100000);
+	memset(first, 1, 100000);
+
+	void* again = arena_alloc(arena, 50000);
+	assert(again);
+	assert(arena_get_stats(arena).large_bytes == 150000);
+	assert(arena_get_stats(arena).large_allocations == 4);
+
+	arena_reset(arena);
+	assert(arena_get_stats(arena).large_bytes == 0);
+	assert(arena->large_list == NULL);
+	assert(arena->offset == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_large_pop_releases_past_marker passed\n");
+}
+
+static void test_large_calloc_and_alignment(void)
+{
+	t_arena* arena = arena_create(1024, false);
+	assert(arena);
+	arena_set_large_threshold(arena, 4096);
+
+	// A fixed-size arena can hold objects far larger than its buffer.
+	int* zeros = arena_calloc(arena, 1 << 20, sizeof(int));
+	assert(zeros);
+	for (size_t i = 0; i < (1u << 20); i += 4093)
+		assert(zeros[i] == 0);
+
+	void* aligned = arena_alloc_aligned(arena, 65536, 4096);
+	assert(aligned && ((uintptr_t) aligned & 4095) == 0);
+
+	// Alignments above the page size stay in the buffer (and fail here).
+	assert(!arena_alloc_aligned(arena, 65536, 1 << 16));
+
+	// Below the threshold, the fixed buffer still applies.
+	assert(!arena_alloc(arena, 2048));
+	assert(arena_get_stats(arena).large_allocations == 2);
+
+	arena_delete(&arena);
+	printf("✅ test_large_calloc_and_alignment passed\n");
+}
+
+static void test_large_disabled_cases(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+
+	// Disabled by default: the buffer grows as before.
+	assert(arena_alloc(arena, 1 << 20));
+	assert(arena->size >= 1 << 20);
+	assert(arena_get_stats(arena).large_allocations == 0);
+	arena_delete(&arena);
+
+	// Mapped arenas keep every allocation in their file.
+	t_arena* shared = arena_create_memfd("large_memfd", 4096, true);
+	assert(shared);
+	arena_set_large_threshold(shared, 1024);
+	assert(arena_alloc(shared, 8192));
+	assert(arena_get_stats(shared).large_allocations == 0);
+	arena_delete(&shared);
+
+	arena_set_large_threshold(NULL, 1);
+	assert(arena_large_threshold(NULL) == 0);
+	printf("✅ test_large_disabled_cases passed\n");
+}
+
+static void test_large_freeze_and_sub_arena(void)
+{
+	t_arena* parent = arena_create(1 << 16, false);
+	assert(parent);
+	t_arena child;
+	assert(arena_alloc_sub(parent, &child, 4096));
+	arena_set_large_threshold(&child, 1 << 16);
+
+	char* big = arena_alloc(&child, 1 << 20);
+	assert(big);
+	strcpy(big, "frozen");
+	assert(parent->offset <= 4096 + ARENA_DEFAULT_ALIGNMENT);
+
+	assert(arena_freeze(&child));
+	assert(strcmp(big, "frozen") == 0);
+	assert(arena_get_stats(&child).large_bytes == 1 << 20);
+
+	// Destroying the sub-arena unmaps its large objects.
+	arena_destroy(&child);
+	arena_delete(&parent);
+	printf("✅ test_large_freeze_and_sub_arena passed\n");
+}
+
+int main(void)
+{
+	test_large_bypasses_buffer();
+	test_large_pop_releases_past_marker();
+	test_large_calloc_and_alignment();
+	test_large_disabled_cases();
+	test_large_freeze_and_sub_arena();
+	printf("🎉 All arena_large tests passed.\n");
+	return 0;
+}
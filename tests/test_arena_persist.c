@@ -0,0 +1,166 @@
+#define _GNU_SOURCE
+#include "arena.h"
+#include "arena_persist.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static const char* g_path = "/tmp/arena_test_persist.arena";
+
+static void test_persist_create_and_reopen(void)
+{
+	unlink(g_path);
+
+	t_arena* arena = arena_open_persistent(g_path, 8192, false);
+	assert(arena);
+	assert(arena->size == 8192);
+	assert(arena->offset == 0);
+	assert(arena_persist_relocation(arena) == 0);
+
+	char* msg = arena_alloc(arena, 32);
+	assert(msg);
+	strcpy(msg, "survives restart");
+	size_t    used     = arena->offset;
+	uintptr_t old_base = (uintptr_t) arena->buffer;
+
+	assert(arena_sync(arena));
+	arena_delete(&arena);
+
+	arena = arena_open_persistent(g_path, 1, false);
+	assert(arena);
+	assert(arena->size == 8192);
+	assert(arena->offset == used);
+	assert(strcmp((char*) arena->buffer, "survives restart") == 0);
+	assert((uintptr_t) arena->buffer - (uintptr_t) arena_persist_relocation(arena) == old_base);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_persist_create_and_reopen passed\n");
+}
+
+static void test_persist_destroy_syncs_offset(void)
+{
+	unlink(g_path);
+
+	t_arena* arena = arena_open_persistent(g_path, 4096, false);
+	assert(arena);
+	int* values = arena_alloc(arena, 16 * sizeof(int));
+	assert(values);
+	for (int i = 0; i < 16; ++i)
+		values[i] = i * 3;
+	size_t used = arena->offset;
+	arena_delete(&arena); // no explicit sync
+
+	arena = arena_open_persistent(g_path, 4096, false);
+	assert(arena);
+	assert(arena->offset == used);
+	for (int i = 0; i < 16; ++i)
+		assert(((int*) arena->buffer)[i] == i * 3);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_persist_destroy_syncs_offset passed\n");
+}
+
+static void test_persist_grow(void)
+{
+	unlink(g_path);
+
+	t_arena* arena = arena_open_persistent(g_path, 4096, true);
+	assert(arena);
+	char* first = arena_alloc(arena, 16);
+	assert(first);
+	strcpy(first, "head");
+
+	char* big = arena_alloc(arena, 64 * 1024);
+	assert(big);
+	memset(big, 'x', 64 * 1024);
+	assert(arena->size >= 4096 + 64 * 1024);
+	assert(strcmp((char*) arena->buffer, "head") == 0);
+	size_t size = arena->size;
+	size_t used = arena->offset;
+	arena_delete(&arena);
+
+	arena = arena_open_persistent(g_path, 4096, true);
+	assert(arena);
+	assert(arena->size == size);
+	assert(arena->offset == used);
+	assert(strcmp((char*) arena->buffer, "head") == 0);
+	assert(arena->buffer[used - 1] == 'x');
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_persist_grow passed\n");
+}
+
+static void test_persist_relocated_reopen(void)
+{
+	unlink(g_path);
+
+	t_arena* arena = arena_open_persistent(g_path, 4096, false);
+	assert(arena);
+	char* msg = arena_alloc(arena, 8);
+	strcpy(msg, "moved");
+	uint8_t* old_map = (uint8_t*) arena->backing.map_base;
+	size_t   map_len = arena->backing.map_len;
+	arena_delete(&arena);
+
+	// Occupy the previous address so the arena must be relocated.
+	void* blocker = mmap(old_map, map_len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	assert(blocker != MAP_FAILED);
+
+	arena = arena_open_persistent(g_path, 4096, false);
+	assert(arena);
+	assert(arena->backing.map_base != old_map);
+	assert(arena_persist_relocation(arena) == (intptr_t) ((uintptr_t) arena->backing.map_base - (uintptr_t) old_map));
+	assert(strcmp((char*) arena->buffer, "moved") == 0);
+
+	arena_delete(&arena);
+	munmap(blocker, map_len);
+	unlink(g_path);
+	printf("✅ test_persist_relocated_reopen passed\n");
+}
+
+static void test_persist_error_cases(void)
+{
+	unlink(g_path);
+
+	assert(!arena_open_persistent(NULL, 4096, false));
+	assert(!arena_open_persistent(g_path, 0, false));
+	unlink(g_path);
+
+	t_arena* arena = arena_open_persistent(g_path, 4096, false);
+	assert(arena);
+	assert(!arena_open_persistent(g_path, 4096, false)); // already open
+	arena_delete(&arena);
+	unlink(g_path);
+
+	FILE* f = fopen(g_path, "wb");
+	assert(f);
+	fwrite("NOTANARENA-AT-ALL-NOT-A-HEADER-PAD", 1, 34, f);
+	fclose(f);
+	assert(!arena_open_persistent(g_path, 4096, false));
+	unlink(g_path);
+
+	t_arena* heap = arena_create(1024, false);
+	assert(heap);
+	assert(!arena_sync(heap));
+	assert(!arena_sync(NULL));
+	assert(arena_persist_relocation(heap) == 0);
+	arena_delete(&heap);
+
+	printf("✅ test_persist_error_cases passed\n");
+}
+
+int main(void)
+{
+	test_persist_create_and_reopen();
+	test_persist_destroy_syncs_offset();
+	test_persist_grow();
+	test_persist_relocated_reopen();
+	test_persist_error_cases();
+	printf("🎉 All arena_persist tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,140 @@
+#include "arena.h"
+#include "arena_trim.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARENA_POISON_VERIFY
+
+static char g_last_error[512];
+static int  g_errors = 0;
+
+static void capture_error(const char* msg, void* ctx)
+{
+	(void) ctx;
+	g_errors++;
+	snprintf(g_last_error, sizeof(g_last_error), "%s", msg);
+}
+
+// AddressSanitizer would stop at the stale write itself; let it through so the poison check sees it.
+static void stale_write(uint8_t* ptr, uint8_t value)
+{
+	ARENA_SAN_OPEN(ptr, 1);
+	*ptr = value;
+}
+
+static t_arena* make_arena(size_t size)
+{
+	t_arena* arena = arena_create(size, false);
+	assert(arena);
+	arena_set_error_callback(arena, capture_error, NULL);
+	g_errors        = 0;
+	g_last_error[0] = '\0';
+	return arena;
+}
+
+static void test_clean_reuse_is_silent(void)
+{
+	t_arena* arena = make_arena(64 * 1024);
+
+	for (int cycle = 0; cycle < 4; ++cycle)
+	{
+		memset(arena_alloc(arena, 1000 + cycle), 0x11, 1000 + cycle);
+		t_arena_marker mark = arena_mark(arena);
+		memset(arena_alloc_labeled(arena, 333, "temp"), 0x22, 333);
+		arena_pop(arena, mark);
+		assert(arena_realloc_last(arena, arena_alloc(arena, 16), 16, 4000));
+		arena_reset(arena);
+	}
+
+	assert(arena_verify_poison(arena));
+	assert(arena_alloc(arena, 32 * 1024));
+	assert(g_errors == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_clean_reuse_is_silent passed\n");
+}
+
+static void test_write_after_reset_is_reported(void)
+{
+	t_arena* arena = make_arena(64 * 1024);
+
+	assert(arena_alloc(arena, 64));
+	uint8_t* stale = arena_alloc_labeled(arena, 256, "frame_buffer");
+	assert(stale);
+	arena_reset(arena);
+
+	stale_write(stale + 100, 0x42); // use after reset
+	assert(arena_alloc(arena, 1024));
+	assert(g_errors == 1);
+	assert(strstr(g_last_error, "offset 164"));
+	assert(strstr(g_last_error, "\"frame_buffer\""));
+
+	// The damaged bytes were handed out; nothing is left to report.
+	assert(arena_verify_poison(arena));
+	assert(g_errors == 1);
+
+	arena_delete(&arena);
+	printf("✅ test_write_after_reset_is_reported passed\n");
+}
+
+static void test_verify_after_pop(void)
+{
+	t_arena* arena = make_arena(64 * 1024);
+
+	assert(arena_alloc(arena, 128));
+	t_arena_marker mark  = arena_mark(arena);
+	uint8_t*       stale = arena_alloc_labeled(arena, 4096, "scratch_rows");
+	assert(stale);
+	arena_pop(arena, mark);
+
+	stale_write(stale + 3000, 0);
+	assert(!arena_verify_poison(arena));
+	assert(g_errors == 1);
+	assert(strstr(g_last_error, "offset 3128"));
+	assert(strstr(g_last_error, "\"scratch_rows\""));
+
+	// The range was poisoned again after the report.
+	assert(arena_verify_poison(arena));
+	assert(g_errors == 1);
+
+	arena_delete(&arena);
+	printf("✅ test_verify_after_pop passed\n");
+}
+
+static void test_zeroed_memory_is_not_poison(void)
+{
+	t_arena* arena = make_arena(4 << 20);
+
+	memset(arena_alloc(arena, 2 << 20), 0x33, 2 << 20);
+	arena_reset(arena);
+	assert(arena_decommit(arena) > 0);
+
+	// Decommitted pages read as zero and must not be reported.
+	assert(arena_verify_poison(arena));
+	assert(arena_alloc(arena, 3 << 20));
+	assert(g_errors == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_zeroed_memory_is_not_poison passed\n");
+}
+
+int main(void)
+{
+	test_clean_reuse_is_silent();
+	test_write_after_reset_is_reported();
+	test_verify_after_pop();
+	test_zeroed_memory_is_not_poison();
+	printf("🎉 All arena_poison_verify tests passed.\n");
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	printf("⚠️ Skipped arena_poison_verify tests (ARENA_POISON_VERIFY disabled)\n");
+	return 0;
+}
+
+#endif
@@ -0,0 +1,130 @@
+#include "arena.h"
+#include "arena_prefault.h"
+#include "arena_trim.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Number of non-resident pages in [ptr, ptr + len), ptr page-aligned.
+static size_t missing_pages(void* ptr, size_t len)
+{
+	const size_t  page  = (size_t) sysconf(_SC_PAGESIZE);
+	const size_t  pages = len / page;
+	unsigned char vec[pages];
+	assert(mincore(ptr, pages * page, vec) == 0);
+
+	size_t missing = 0;
+	for (size_t i = 0; i < pages; ++i)
+		missing += !(vec[i] & 1);
+	return missing;
+}
+
+// Locked memory of the process, from /proc/self/status, in KiB.
+static long locked_kib(void)
+{
+	FILE* file = fopen("/proc/self/status", "r");
+	char  line[256];
+	long  kib = -1;
+	while (file && fgets(line, sizeof(line), file))
+		if (sscanf(line, "VmLck: %ld kB", &kib) == 1)
+			break;
+	if (file)
+		fclose(file);
+	return kib;
+}
+
+static void test_create_prefaulted(void)
+{
+	const size_t size  = 4 * ARENA_MMAP_THRESHOLD;
+	t_arena*     plain = arena_create(size, false);
+	t_arena*     warm  = arena_create_with_flags(size, false, ARENA_CREATE_PREFAULT);
+	assert(plain && warm);
+	assert(missing_pages(plain->buffer, size) > 0);
+	assert(missing_pages(warm->buffer, size) == 0);
+	ARENA_SAN_OPEN(warm->buffer + size - 1, 1);
+	assert(warm->buffer[size - 1] == 0);
+
+	arena_delete(&plain);
+	arena_delete(&warm);
+	printf("✅ test_create_prefaulted passed\n");
+}
+
+static void test_prefault_range(void)
+{
+	const size_t size  = 4 * ARENA_MMAP_THRESHOLD;
+	t_arena*     arena = arena_create(size, false);
+	assert(arena);
+
+	char* kept = arena_alloc(arena, 8192);
+	memset(kept, 0x7E, 8192);
+
+	// Warm the next 1 MiB; live bytes keep their contents.
+	assert(arena_prefault_range(arena, 0, ARENA_MMAP_THRESHOLD));
+	assert(missing_pages(arena->buffer, ARENA_MMAP_THRESHOLD) == 0);
+	assert(missing_pages(arena->buffer + ARENA_MMAP_THRESHOLD, size - ARENA_MMAP_THRESHOLD) > 0);
+	assert(kept[0] == 0x7E && kept[8191] == 0x7E);
+
+	// Decommitted pages come back; ranges are clamped to the buffer.
+	arena_decommit(arena);
+	assert(arena_prefault_range(arena, ARENA_MMAP_THRESHOLD, (size_t) -1));
+	assert(missing_pages(arena->buffer + ARENA_MMAP_THRESHOLD, size - ARENA_MMAP_THRESHOLD) == 0);
+	assert(arena_prefault_range(arena, size + 1, 16));
+
+	assert(!arena_prefault_range(NULL, 0, 16));
+	arena_delete(&arena);
+	printf("✅ test_prefault_range passed\n");
+}
+
+static void test_prefault_after_growth(void)
+{
+	t_arena* arena = arena_create_with_flags(ARENA_MMAP_THRESHOLD, true, ARENA_CREATE_PREFAULT);
+	assert(arena);
+	assert(arena_alloc(arena, 2 * ARENA_MMAP_THRESHOLD));
+	assert(arena->size > 2 * ARENA_MMAP_THRESHOLD);
+	assert(missing_pages(arena->buffer, arena_page_round(arena->size) & ~(size_t) 4095) == 0);
+	arena_delete(&arena);
+	printf("✅ test_prefault_after_growth passed\n");
+}
+
+static void test_create_mlocked(void)
+{
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+	// The sanitizer runtimes turn mlock() into a no-op.
+	printf("⚠️  test_create_mlocked skipped (sanitizer build)\n");
+	return;
+#endif
+	struct rlimit limit;
+	assert(getrlimit(RLIMIT_MEMLOCK, &limit) == 0);
+	if (locked_kib() < 0 || (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < 4 * ARENA_MMAP_THRESHOLD))
+	{
+		printf("⚠️  test_create_mlocked skipped (RLIMIT_MEMLOCK too low)\n");
+		return;
+	}
+
+	const long before = locked_kib();
+	t_arena*   arena  = arena_create_with_flags(256 * 1024, true, ARENA_CREATE_MLOCK);
+	assert(arena);
+	assert(locked_kib() >= before + 256);
+
+	// Growth moves the heap buffer into a mapping: the new buffer is locked.
+	assert(arena_alloc(arena, ARENA_MMAP_THRESHOLD));
+	assert(locked_kib() >= before + (long) (arena->size / 1024));
+	assert(missing_pages(arena->buffer, arena->size & ~(size_t) 4095) == 0);
+
+	arena_delete(&arena);
+	assert(locked_kib() == before);
+	printf("✅ test_create_mlocked passed\n");
+}
+
+int main(void)
+{
+	test_create_prefaulted();
+	test_prefault_range();
+	test_prefault_after_growth();
+	test_create_mlocked();
+	printf("🎉 All arena_prefault tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,274 @@
+#include "arena.h"
+#include "arena_pregrow.h"
+#include "arena_stats.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static atomic_int g_errors = 0;
+
+static void count_error_cb(const char* msg, void* ctx)
+{
+	(void) msg;
+	(void) ctx;
+	atomic_fetch_add(&g_errors, 1);
+}
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+static size_t stuck_grow_cb(size_t current_size, size_t requested_size)
+{
+	(void) requested_size;
+	return current_size;
+}
+
+static void sleep_ms(long ms)
+{
+	struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+}
+
+// Wait until the worker brought the arena back under its high-water mark.
+static bool wait_below_mark(t_arena* arena, unsigned percent)
+{
+	for (int i = 0; i < 2000; ++i)
+	{
+		ARENA_LOCK(arena);
+		bool below = arena->offset < arena->size / 100 * percent;
+		ARENA_UNLOCK(arena);
+		if (below)
+			return true;
+		sleep_ms(1);
+	}
+	return false;
+}
+
+// Wait until the worker either grew the arena past its mark or gave up at this size.
+static bool wait_serviced(t_arena* arena, unsigned percent)
+{
+	for (int i = 0; i < 2000; ++i)
+	{
+		ARENA_LOCK(arena);
+		bool done = arena->offset < arena->size / 100 * percent || arena->pregrow_stalled == arena->size;
+		ARENA_UNLOCK(arena);
+		if (done)
+			return true;
+		sleep_ms(1);
+	}
+	return false;
+}
+
+static uint8_t* locked_buffer(t_arena* arena)
+{
+	ARENA_LOCK(arena);
+	uint8_t* buffer = arena->buffer;
+	ARENA_UNLOCK(arena);
+	return buffer;
+}
+
+static void test_pregrow_grows_ahead(void)
+{
+	static char* blocks[1024];
+	t_arena*     arena = arena_create(64 * 1024, true);
+	assert(arena);
+	assert(arena_pregrow_watch(arena, 50));
+	assert(arena_pregrow_is_watched(arena));
+
+	// The heap buffer cannot grow in place: the first growth is inline and
+	// moves it into a reservation, which the worker then extends.
+	size_t   first = 0;
+	uint8_t* base  = NULL;
+	for (size_t i = 0; i < 1024; ++i)
+	{
+		blocks[i] = arena_alloc(arena, 1024);
+		assert(blocks[i]);
+		memset(blocks[i], (int) (i & 0xFF), 1024);
+		assert(wait_serviced(arena, 50));
+		if (!base && arena_get_stats(arena).reallocations)
+		{
+			base  = locked_buffer(arena);
+			first = i;
+		}
+	}
+
+	// Every later growth happened on the worker, without moving the buffer.
+	t_arena_stats stats = arena_get_stats(arena);
+	assert(stats.background_grows > 0);
+	assert(stats.reallocations == stats.background_grows + 1);
+	assert(locked_buffer(arena) == base);
+	for (size_t i = first; i < 1024; ++i)
+		for (size_t b = 0; b < 1024; ++b)
+			assert(blocks[i][b] == (char) (i & 0xFF));
+
+	arena_delete(&arena);
+	printf("✅ test_pregrow_grows_ahead passed\n");
+}
+
+static void test_pregrow_keeps_pointers(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	assert(arena_pregrow_watch(arena, 50));
+
+	// Past the mark of a heap arena: the worker gives up rather than realloc().
+	char* block = arena_alloc(arena, 3000);
+	assert(block);
+	assert(wait_serviced(arena, 50));
+	block[0] = 1;
+	assert(arena_get_stats(arena).background_grows == 0);
+
+	// Once in a reservation, background growth leaves blocks where they are.
+	block = arena_alloc(arena, 3000);
+	assert(block);
+	assert(wait_below_mark(arena, 50));
+	memset(block, 2, 3000);
+	assert(arena_get_stats(arena).background_grows == 1);
+	assert(arena_alloc(arena, arena->size / 2));
+	assert(wait_below_mark(arena, 50));
+	for (size_t b = 0; b < 3000; ++b)
+		assert(block[b] == 2);
+	assert(arena_get_stats(arena).background_grows == 2);
+
+	arena_delete(&arena);
+	printf("✅ test_pregrow_keeps_pointers passed\n");
+}
+
+static void test_pregrow_mmap_backed(void)
+{
+	t_arena* arena = arena_create(ARENA_MMAP_THRESHOLD, true);
+	assert(arena);
+	assert(arena_pregrow_watch(arena, 0));
+
+	size_t chunk = ARENA_MMAP_THRESHOLD / 16;
+	for (int i = 0; i < 64; ++i)
+	{
+		assert(arena_alloc(arena, chunk));
+		assert(wait_serviced(arena, ARENA_PREGROW_DEFAULT_PERCENT));
+	}
+	t_arena_stats stats = arena_get_stats(arena);
+	assert(stats.background_grows > 0);
+	assert(stats.background_grows + 1 >= stats.reallocations);
+	assert(arena->size >= 4 * ARENA_MMAP_THRESHOLD);
+
+	arena_delete(&arena);
+	printf("✅ test_pregrow_mmap_backed passed\n");
+}
+
+static void test_pregrow_watch_unwatch(void)
+{
+	t_arena* first  = arena_create(4096, true);
+	t_arena* second = arena_create(4096, true);
+	assert(first && second);
+
+	assert(arena_pregrow_watch(first, 90));
+	assert(arena_pregrow_watch(first, 60)); // updates the mark
+	assert(first->pregrow_percent == 60);
+	assert(arena_pregrow_watch(second, 0));
+
+	arena_pregrow_unwatch(first);
+	assert(!arena_pregrow_is_watched(first));
+	arena_pregrow_unwatch(first);
+
+	// An unwatched arena grows inline as usual.
+	assert(arena_alloc(first, 3500));
+	assert(arena_get_stats(first).background_grows == 0);
+
+	// Destroying a watched arena unwatches it; the worker restarts on demand.
+	// `first` is on the heap, so its next growth is inline and reserves address
+	// space; the one after that is done by the worker.
+	assert(arena_alloc(second, 3500));
+	arena_delete(&second);
+	assert(arena_pregrow_watch(first, 50));
+	assert(arena_alloc(first, 4096));
+	assert(arena_alloc(first, 4096));
+	assert(wait_below_mark(first, 50));
+	assert(arena_get_stats(first).background_grows >= 1);
+
+	arena_delete(&first);
+	printf("✅ test_pregrow_watch_unwatch passed\n");
+}
+
+static void test_pregrow_failed_growth_not_retried(void)
+{
+	t_arena* arena = arena_create(64 * 1024, true);
+	assert(arena);
+	arena_set_error_callback(arena, count_error_cb, NULL);
+	arena->grow_cb = stuck_grow_cb;
+	assert(arena_pregrow_watch(arena, 50));
+
+	for (int i = 0; i < 60; ++i)
+	{
+		assert(arena_alloc(arena, 1024));
+		sleep_ms(1);
+	}
+	sleep_ms(50);
+
+	// One failed attempt at this size, then the worker leaves the arena alone.
+	assert(atomic_load(&g_errors) == 1);
+	assert(arena_get_stats(arena).background_grows == 0);
+	assert(arena->size == 64 * 1024);
+
+	arena_delete(&arena);
+	printf("✅ test_pregrow_failed_growth_not_retried passed\n");
+}
+
+#else
+
+static void test_pregrow_unavailable(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_error_callback(arena, count_error_cb, NULL);
+	assert(!arena_pregrow_watch(arena, 50));
+	assert(!arena_pregrow_is_watched(arena));
+	assert(atomic_load(&g_errors) == 1);
+	arena_delete(&arena);
+	printf("✅ test_pregrow_unavailable passed\n");
+}
+
+#endif
+
+static void test_pregrow_invalid(void)
+{
+	t_arena* fixed = arena_create(4096, false);
+	assert(fixed);
+	arena_set_error_callback(fixed, count_error_cb, NULL);
+	assert(!arena_pregrow_watch(fixed, 50));
+	assert(!arena_pregrow_is_watched(fixed));
+	arena_delete(&fixed);
+
+	uint8_t buffer[256];
+	t_arena borrowed;
+	arena_init_with_buffer(&borrowed, buffer, sizeof(buffer), true);
+	arena_set_error_callback(&borrowed, count_error_cb, NULL);
+	assert(!arena_pregrow_watch(&borrowed, 50));
+	arena_destroy(&borrowed);
+
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_error_callback(arena, count_error_cb, NULL);
+	assert(!arena_pregrow_watch(arena, 100));
+	assert(!arena_pregrow_watch(NULL, 50));
+	assert(!arena_pregrow_is_watched(NULL));
+	arena_pregrow_unwatch(NULL);
+	arena_delete(&arena);
+	printf("✅ test_pregrow_invalid passed\n");
+}
+
+int main(void)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_pregrow_grows_ahead();
+	test_pregrow_keeps_pointers();
+	test_pregrow_mmap_backed();
+	test_pregrow_watch_unwatch();
+	test_pregrow_failed_growth_not_retried();
+#else
+	test_pregrow_unavailable();
+#endif
+	test_pregrow_invalid();
+	printf("🎉 All arena_pregrow tests passed.\n");
+	return 0;
+}
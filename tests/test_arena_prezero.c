@@ -0,0 +1,176 @@
+#include "arena.h"
+#include "arena_prezero.h"
+#include "arena_scratch.h"
+#include "arena_trim.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static bool is_zero(const uint8_t* ptr, size_t len)
+{
+	ARENA_SAN_OPEN((uint8_t*) ptr, len); // also inspects free arena memory
+	for (size_t i = 0; i < len; ++i)
+		if (ptr[i])
+			return false;
+	return true;
+}
+
+static void test_calloc_skips_clean_memory(void)
+{
+	t_arena* arena = arena_create(64 * 1024, false);
+	assert(arena);
+	assert(arena_clean_bytes(arena) == 64 * 1024);
+
+	char* block = arena_calloc(arena, 1, 1024);
+	assert(block && is_zero((uint8_t*) block, 1024));
+	assert(arena_clean_bytes(arena) == 63 * 1024);
+	memset(block, 0xFF, 1024);
+
+	// The reset leaves the written (or poisoned) bytes below the watermark; calloc clears them.
+	arena_reset(arena);
+	assert(arena_clean_bytes(arena) == 63 * 1024);
+	char* again = arena_calloc(arena, 1, 2048);
+	assert(again == block && is_zero((uint8_t*) again, 2048));
+
+	// Borrowed buffers are never assumed clean.
+	static uint8_t buffer[4096];
+	t_arena        borrowed;
+	memset(buffer, 0x11, sizeof(buffer));
+	arena_init_with_buffer(&borrowed, buffer, sizeof(buffer), false);
+	assert(arena_clean_bytes(&borrowed) == 0);
+	assert(is_zero(arena_calloc(&borrowed, 4, 64), 256));
+	arena_destroy(&borrowed);
+
+	arena_delete(&arena);
+	printf("✅ test_calloc_skips_clean_memory passed\n");
+}
+
+static void test_watermark_follows_resizes(void)
+{
+	// A heap buffer grown by realloc() has an uncleared tail.
+	t_arena* heap = arena_create(4096, true);
+	assert(heap);
+	assert(arena_alloc(heap, 6000));
+	assert(arena_clean_bytes(heap) == 0);
+	assert(is_zero(arena_calloc(heap, 1, 2000), 2000));
+	arena_delete(&heap);
+
+	// Decommitted pages read as zero again.
+	const size_t size   = 4 * ARENA_MMAP_THRESHOLD;
+	t_arena*     mapped = arena_create(size, false);
+	assert(mapped);
+	memset(arena_alloc(mapped, size / 2), 0xEE, size / 2);
+	arena_reset(mapped);
+	assert(arena_alloc(mapped, 64 * 1024));
+	assert(arena_decommit(mapped) > 0);
+	assert(arena_clean_bytes(mapped) == size - 64 * 1024);
+	assert(is_zero(arena_calloc(mapped, 1, 8192), 8192));
+	arena_delete(&mapped);
+
+	assert(arena_clean_bytes(NULL) == 0);
+	printf("✅ test_watermark_follows_resizes passed\n");
+}
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+static void test_prezero_after_reset(void)
+{
+	const size_t size  = 2 * ARENA_MMAP_THRESHOLD;
+	t_arena*     arena = arena_create(size, false);
+	assert(arena);
+	assert(arena_prezero_watch(arena));
+	assert(arena_prezero_watch(arena)); // no-op
+
+	memset(arena_alloc(arena, size), 0xFF, size);
+	arena_reset(arena);
+	arena_prezero_wait(arena);
+	assert(arena_clean_bytes(arena) == size);
+	assert(is_zero(arena->buffer, size));
+
+	// The worker stops at the offset: live bytes are never cleared.
+	memset(arena_alloc(arena, size / 2), 0xFF, size / 2);
+	arena_reset(arena);
+	char* live = arena_alloc(arena, 8192);
+	memset(live, 0xAB, 8192);
+	arena_prezero_wait(arena);
+	assert(arena_clean_bytes(arena) == size - 8192);
+	assert(live[0] == (char) 0xAB && live[8191] == (char) 0xAB);
+	assert(is_zero(arena->buffer + 8192, size - 8192));
+
+	arena_prezero_unwatch(arena);
+	arena_prezero_unwatch(arena);
+	arena_delete(&arena);
+	printf("✅ test_prezero_after_reset passed\n");
+}
+
+static void test_scratch_pool_prezero(void)
+{
+	t_scratch_arena_pool pool;
+	assert(scratch_pool_init(&pool, 64 * 1024, true));
+	assert(scratch_pool_prezero(&pool));
+
+	t_arena* slot = scratch_acquire(&pool);
+	assert(slot);
+	memset(arena_alloc(slot, 32 * 1024), 0x5A, 32 * 1024);
+	scratch_release(&pool, slot);
+
+	arena_prezero_wait(slot);
+	assert(arena_clean_bytes(slot) == 64 * 1024);
+	assert(is_zero(slot->buffer, 64 * 1024));
+
+	scratch_pool_destroy(&pool); // unwatches every slot
+	assert(!scratch_pool_prezero(NULL));
+	printf("✅ test_scratch_pool_prezero passed\n");
+}
+
+#else
+
+static int g_errors = 0;
+
+static void count_error_cb(const char* msg, void* ctx)
+{
+	(void) msg;
+	(void) ctx;
+	++g_errors;
+}
+
+static void test_prezero_unavailable(void)
+{
+	t_arena* arena = arena_create(2 * ARENA_MMAP_THRESHOLD, false);
+	assert(arena);
+	arena_set_error_callback(arena, count_error_cb, NULL);
+	assert(!arena_prezero_watch(arena));
+	assert(g_errors == 1);
+
+	// Without a worker, reset memory stays dirty until calloc() clears it.
+	memset(arena_alloc(arena, 8192), 0xFF, 8192);
+	arena_reset(arena);
+	arena_prezero_wait(arena); // no-op
+	arena_prezero_unwatch(arena);
+	assert(arena_clean_bytes(arena) == 2 * ARENA_MMAP_THRESHOLD - 8192);
+	assert(is_zero(arena_calloc(arena, 1, 8192), 8192));
+
+	t_scratch_arena_pool pool;
+	assert(scratch_pool_init(&pool, 4096, false));
+	assert(!scratch_pool_prezero(&pool));
+	scratch_pool_destroy(&pool);
+
+	arena_delete(&arena);
+	printf("✅ test_prezero_unavailable passed\n");
+}
+
+#endif
+
+int main(void)
+{
+	test_calloc_skips_clean_memory();
+	test_watermark_follows_resizes();
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_prezero_after_reset();
+	test_scratch_pool_prezero();
+#else
+	test_prezero_unavailable();
+#endif
+	printf("🎉 All arena_prezero tests passed.\n");
+	return 0;
+}
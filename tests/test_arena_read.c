@@ -0,0 +1,222 @@
+#include "arena.h"
+#include "arena_io.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const char* g_path = "/tmp/arena_test_read.txt";
+
+static void write_file(const char* path, const char* data, size_t len)
+{
+	FILE* f = fopen(path, "wb");
+	assert(f);
+	assert(fwrite(data, 1, len, f) == len);
+	fclose(f);
+}
+
+// Fork a child that writes `len` bytes of 'a'..'z' into a new pipe; returns its pid.
+static pid_t feed_pipe(int fds[2], size_t len)
+{
+	assert(pipe(fds) == 0);
+
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if (pid == 0)
+	{
+		close(fds[0]);
+		char block[1000];
+		for (size_t sent = 0; sent < len; sent += sizeof(block))
+		{
+			size_t n = len - sent < sizeof(block) ? len - sent : sizeof(block);
+			for (size_t i = 0; i < n; ++i)
+				block[i] = (char) ('a' + (sent + i) % 26);
+			if (write(fds[1], block, n) != (ssize_t) n)
+				_exit(1);
+		}
+		_exit(0);
+	}
+	close(fds[1]);
+	return pid;
+}
+
+static void test_read_regular_file(void)
+{
+	write_file(g_path, "hello arena", 11);
+
+	t_arena* arena = arena_create(4096, false);
+	assert(arena);
+
+	t_arena_view view = arena_read_file(arena, g_path, ARENA_READ_NUL_TERMINATE);
+	assert(view.data && view.size == 11);
+	assert(strcmp((char*) view.data, "hello arena") == 0);
+	assert(view.data >= arena->buffer && view.data + 12 <= arena->buffer + arena->offset);
+
+	t_arena_view raw = arena_read_file(arena, g_path, ARENA_READ_DEFAULT);
+	assert(raw.size == 11 && memcmp(raw.data, "hello arena", 11) == 0);
+
+	// Reading a descriptor starts at its current position and consumes the rest.
+	int fd = open(g_path, O_RDONLY);
+	assert(fd >= 0);
+	assert(lseek(fd, 6, SEEK_SET) == 6);
+	t_arena_view tail = arena_read_fd(arena, fd, ARENA_READ_DEFAULT);
+	assert(tail.size == 5 && memcmp(tail.data, "arena", 5) == 0);
+	assert(lseek(fd, 0, SEEK_CUR) == 11);
+	close(fd);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_read_regular_file passed\n");
+}
+
+static void test_read_large_file_grows_arena(void)
+{
+	const size_t len  = 3 * 1024 * 1024;
+	char*        data = malloc(len);
+	assert(data);
+	for (size_t i = 0; i < len; ++i)
+		data[i] = (char) (i * 31);
+	write_file(g_path, data, len);
+
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	t_arena_view view = arena_read_file(arena, g_path, ARENA_READ_DEFAULT);
+	assert(view.data && view.size == len);
+	assert(memcmp(view.data, data, len) == 0);
+
+	arena_delete(&arena);
+	free(data);
+	unlink(g_path);
+	printf("✅ test_read_large_file_grows_arena passed\n");
+}
+
+static void test_read_pipe_stream(void)
+{
+	const size_t len = 200 * 1024 + 17; // several chunks, not a multiple of the chunk size
+	int          fds[2];
+	pid_t        pid = feed_pipe(fds, len);
+
+	t_arena* arena = arena_create(1024, true);
+	assert(arena);
+	assert(arena_alloc(arena, 10));
+	t_arena_view view = arena_read_fd(arena, fds[0], ARENA_READ_NUL_TERMINATE);
+	close(fds[0]);
+	waitpid(pid, NULL, 0);
+
+	assert(view.data && view.size == len);
+	for (size_t i = 0; i < len; ++i)
+		assert(view.data[i] == (uint8_t) ('a' + i % 26));
+	assert(view.data[len] == '\0');
+	// The allocation was trimmed to the data and its terminator.
+	assert((size_t) (arena->buffer + arena->offset - view.data) == len + 1);
+
+	arena_delete(&arena);
+	printf("✅ test_read_pipe_stream passed\n");
+}
+
+static void test_read_pipe_large_threshold(void)
+{
+	const size_t len = 409600;
+	int          fds[2];
+	pid_t        pid = feed_pipe(fds, len);
+
+	// The read region gets its own mapping and is remapped as it grows.
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_large_threshold(arena, 16384);
+	assert(arena_alloc(arena, 10));
+	t_arena_view view = arena_read_fd(arena, fds[0], ARENA_READ_NUL_TERMINATE);
+	close(fds[0]);
+	waitpid(pid, NULL, 0);
+
+	assert(view.data && view.size == len);
+	for (size_t i = 0; i < len; ++i)
+		assert(view.data[i] == (uint8_t) ('a' + i % 26));
+	assert(view.data[len] == '\0');
+	assert(arena->size == 4096);
+	assert(arena->stats.large_bytes == len + 1);
+
+	// Allocations keep working, and a reset unmaps the region.
+	assert(arena_alloc(arena, 64));
+	arena_reset(arena);
+	assert(arena->stats.large_bytes == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_read_pipe_large_threshold passed\n");
+}
+
+static void test_read_fixed_arena_limits(void)
+{
+	int fds[2];
+	assert(pipe(fds) == 0);
+	assert(write(fds[1], "0123456789", 10) == 10);
+	close(fds[1]);
+
+	// A stream that fits exactly into the remaining space is accepted.
+	t_arena* arena = arena_create(16, false);
+	assert(arena);
+	t_arena_view view = arena_read_fd(arena, fds[0], ARENA_READ_DEFAULT);
+	close(fds[0]);
+	assert(view.data && view.size == 10);
+	assert(memcmp(view.data, "0123456789", 10) == 0);
+
+	// One that does not fit fails and leaves the arena untouched.
+	assert(pipe(fds) == 0);
+	assert(write(fds[1], "this is far too long", 20) == 20);
+	close(fds[1]);
+	size_t before = arena->offset;
+	view          = arena_read_fd(arena, fds[0], ARENA_READ_DEFAULT);
+	close(fds[0]);
+	assert(!view.data && view.size == 0);
+	assert(arena->offset == before);
+
+	// Regular files larger than a fixed arena are rejected up front.
+	write_file(g_path, "0123456789abcdef0123", 20);
+	view = arena_read_file(arena, g_path, ARENA_READ_DEFAULT);
+	assert(!view.data);
+	assert(arena->offset == before);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_read_fixed_arena_limits passed\n");
+}
+
+static void test_read_empty_and_errors(void)
+{
+	write_file(g_path, "", 0);
+	t_arena* arena = arena_create(4096, false);
+	assert(arena);
+
+	t_arena_view view = arena_read_file(arena, g_path, ARENA_READ_NUL_TERMINATE);
+	assert(view.data && view.size == 0 && view.data[0] == '\0');
+	view = arena_read_file(arena, g_path, ARENA_READ_DEFAULT);
+	assert(view.data && view.size == 0);
+
+	// procfs files report a size of zero but have content.
+	view = arena_read_file(arena, "/proc/self/stat", ARENA_READ_NUL_TERMINATE);
+	assert(view.data && view.size > 0 && strlen((char*) view.data) == view.size);
+
+	assert(!arena_read_file(arena, "/nonexistent/arena/file", 0).data);
+	assert(!arena_read_file(NULL, g_path, 0).data);
+	assert(!arena_read_file(arena, NULL, 0).data);
+	assert(!arena_read_fd(arena, -1, 0).data);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_read_empty_and_errors passed\n");
+}
+
+int main(void)
+{
+	test_read_regular_file();
+	test_read_large_file_grows_arena();
+	test_read_pipe_stream();
+	test_read_pipe_large_threshold();
+	test_read_fixed_arena_limits();
+	test_read_empty_and_errors();
+	printf("🎉 All arena_read tests passed.\n");
+	return 0;
+}
@@ -39,6 +39,7 @@ static void test_realloc_in_place_shrink(void)
 	assert(arena->offset >= 128);
 
 	uint8_t* poison = (uint8_t*) ptr + 128;
+	ARENA_SAN_OPEN(poison, 3);
 	printf("ℹ️  Shrunk region may still contain old data: %02X %02X %02X\n",
 		poison[0], poison[1], poison[2]);
 
@@ -83,6 +84,79 @@ void test_realloc_fallback_copy(void)
 	printf("✅ test_realloc_fallback_copy passed\n");
 }
 
+static void test_realloc_in_place_grow_moves_buffer(void)
+{
+	t_arena* arena = arena_create(256, true);
+	assert(arena);
+
+	char* ptr = arena_alloc(arena, 200);
+	memset(ptr, 'a', 200);
+	size_t offset = (size_t) ((uint8_t*) ptr - arena->buffer);
+
+	// Growing past the buffer reallocates it; the result must follow the new buffer.
+	char* grown = arena_realloc_last(arena, ptr, 200, 64 * 1024);
+	assert(grown);
+	assert((uint8_t*) grown == arena->buffer + offset);
+	assert(arena->offset == offset + 64 * 1024);
+	for (int i = 0; i < 200; ++i)
+		assert(grown[i] == 'a');
+
+	arena_delete(&arena);
+	printf("✅ test_realloc_in_place_grow_moves_buffer passed\n");
+}
+
+static void test_realloc_with_large_threshold(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_large_threshold(arena, 16 * 1024);
+
+	// Fallback into a large mapping: the bump offset must not move
+	uint8_t* p = arena_alloc(arena, 100);
+	assert(p);
+	memset(p, 'p', 100);
+	assert(arena_alloc(arena, 10));
+	size_t used = arena_used(arena);
+
+	uint8_t* big = arena_realloc_last(arena, p, 100, 20000);
+	assert(big);
+	assert(big < arena->buffer || big >= arena->buffer + arena->size);
+	assert(arena_used(arena) == used + ARENA_REDZONE_SIZE + 1); // only the ticket byte
+	for (size_t i = 0; i < 100; ++i)
+		assert(big[i] == 'p');
+	assert(arena_alloc(arena, 64));
+
+	// The newest large allocation grows and shrinks by remapping
+	uint8_t* last = arena_alloc(arena, 20000);
+	assert(last);
+	memset(last, 'l', 20000);
+	used = arena_used(arena);
+
+	uint8_t* grown = arena_realloc_last(arena, last, 20000, 1 << 20);
+	assert(grown);
+	assert(arena_used(arena) == used);
+	assert(arena->stats.large_bytes == 20000 + (1 << 20));
+	for (size_t i = 0; i < 20000; ++i)
+		assert(grown[i] == 'l');
+	memset(grown, 'g', 1 << 20);
+
+	uint8_t* shrunk = arena_realloc_last(arena, grown, 1 << 20, 30000);
+	assert(shrunk);
+	assert(arena_used(arena) == used);
+	assert(arena->stats.large_bytes == 20000 + 30000);
+	assert(shrunk[0] == 'g' && shrunk[29999] == 'g');
+
+	// The buffer keeps serving small allocations, and pop unmaps everything
+	t_arena_marker mark = arena_mark(arena);
+	assert(arena_alloc(arena, 128));
+	arena_pop(arena, mark);
+	arena_reset(arena);
+	assert(arena->stats.large_bytes == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_realloc_with_large_threshold passed\n");
+}
+
 static void test_invalid_inputs(void)
 {
 	t_arena* arena = arena_create(512, false);
@@ -102,6 +176,8 @@ int main(void)
 	test_realloc_in_place_shrink();
 	test_realloc_same_size();
 	test_realloc_fallback_copy();
+	test_realloc_in_place_grow_moves_buffer();
+	test_realloc_with_large_threshold();
 	test_invalid_inputs();
 	printf("🎉 All arena_realloc_last tests passed.\n");
 	return 0;
@@ -0,0 +1,127 @@
+#include "arena.h"
+#include "arena_reclaim.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static t_arena* make_filled_arena(size_t size)
+{
+	t_arena* arena = arena_create(size, false);
+	assert(arena);
+	void* block = arena_alloc(arena, size);
+	assert(block);
+	memset(block, 0x5A, size);
+	return arena;
+}
+
+static void test_reclaim_disabled_by_default(void)
+{
+	t_arena* arena = make_filled_arena(2 * ARENA_MMAP_THRESHOLD);
+	arena_delete(&arena);
+	assert(!arena);
+
+	t_arena_reclaim_stats stats = arena_reclaimer_stats();
+	assert(stats.deferred == 0 && stats.pending == 0);
+	printf("✅ test_reclaim_disabled_by_default passed\n");
+}
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+static void test_reclaim_defers_large_buffers(void)
+{
+	assert(arena_reclaimer_start(0));
+	assert(!arena_reclaimer_start(0));
+
+	// Mapped buffers past the default threshold go to the reclaimer.
+	for (int i = 0; i < 8; ++i)
+	{
+		t_arena* arena = make_filled_arena(4 * ARENA_MMAP_THRESHOLD);
+		arena_delete(&arena);
+	}
+
+	// Smaller buffers are released inline.
+	t_arena* small = make_filled_arena(64 * 1024);
+	arena_delete(&small);
+
+	arena_reclaimer_flush();
+	t_arena_reclaim_stats stats = arena_reclaimer_stats();
+	assert(stats.deferred == 8);
+	assert(stats.pending == 0 && stats.pending_bytes == 0);
+
+	arena_reclaimer_stop();
+	arena_reclaimer_stop();
+	printf("✅ test_reclaim_defers_large_buffers passed\n");
+}
+
+static void test_reclaim_heap_and_stop(void)
+{
+	// A low threshold takes heap buffers too.
+	assert(arena_reclaimer_start(4096));
+	t_arena* heap = make_filled_arena(64 * 1024);
+	arena_delete(&heap);
+
+	// Stopping releases what is still queued.
+	t_arena* mapped = make_filled_arena(2 * ARENA_MMAP_THRESHOLD);
+	arena_delete(&mapped);
+	arena_reclaimer_stop();
+
+	t_arena_reclaim_stats stats = arena_reclaimer_stats();
+	assert(stats.deferred == 8 + 2);
+	assert(stats.pending == 0);
+
+	// After stop, buffers are released inline again.
+	t_arena* after = make_filled_arena(2 * ARENA_MMAP_THRESHOLD);
+	arena_delete(&after);
+	assert(arena_reclaimer_stats().deferred == 10);
+	arena_reclaimer_flush();
+	printf("✅ test_reclaim_heap_and_stop passed\n");
+}
+
+static void test_reclaim_skips_borrowed(void)
+{
+	assert(arena_reclaimer_start(1));
+
+	static uint8_t buffer[8192];
+	t_arena        arena;
+	arena_init_with_buffer(&arena, buffer, sizeof(buffer), false);
+	assert(arena_alloc(&arena, 128));
+	arena_destroy(&arena);
+	arena_reclaimer_flush();
+	assert(arena_reclaimer_stats().deferred == 10);
+
+	arena_reclaimer_stop();
+	printf("✅ test_reclaim_skips_borrowed passed\n");
+}
+
+#else
+
+static void test_reclaim_unavailable(void)
+{
+	assert(!arena_reclaimer_start(0));
+
+	// Buffers are released inline and nothing is counted.
+	t_arena* arena = make_filled_arena(4 * ARENA_MMAP_THRESHOLD);
+	arena_delete(&arena);
+	arena_reclaimer_flush();
+	arena_reclaimer_stop();
+
+	t_arena_reclaim_stats stats = arena_reclaimer_stats();
+	assert(stats.deferred == 0 && stats.inline_frees == 0 && stats.pending == 0);
+	printf("✅ test_reclaim_unavailable passed\n");
+}
+
+#endif
+
+int main(void)
+{
+	test_reclaim_disabled_by_default();
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_reclaim_defers_large_buffers();
+	test_reclaim_heap_and_stop();
+	test_reclaim_skips_borrowed();
+#else
+	test_reclaim_unavailable();
+#endif
+	printf("🎉 All arena_reclaim tests passed.\n");
+	return 0;
+}
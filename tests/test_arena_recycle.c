@@ -0,0 +1,184 @@
+#include "arena.h"
+#include "arena_recycle.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static bool is_zero(const uint8_t* ptr, size_t len)
+{
+	ARENA_SAN_OPEN((uint8_t*) ptr, len); // also inspects free arena memory
+	for (size_t i = 0; i < len; ++i)
+		if (ptr[i])
+			return false;
+	return true;
+}
+
+static void test_recycle_disabled_by_default(void)
+{
+	t_arena* arena = arena_create(4096, false);
+	assert(arena);
+	arena_delete(&arena);
+
+	t_arena_recycle_stats stats = arena_recycle_stats();
+	assert(stats.hits == 0 && stats.misses == 0);
+	assert(stats.struct_hits == 0 && stats.struct_misses == 0);
+	assert(stats.cached_buffers == 0 && stats.cached_bytes == 0);
+	printf("✅ test_recycle_disabled_by_default passed\n");
+}
+
+static void test_recycle_reuses_buffer(void)
+{
+	arena_recycle_enable(0);
+
+	t_arena* arena = arena_create(64 * 1024, false);
+	assert(arena);
+	t_arena*  first_struct = arena;
+	uint8_t*  first_buffer = arena->buffer;
+	char*     block        = arena_alloc(arena, 1024);
+	assert(block);
+	memset(block, 0xAB, 1024);
+	arena_delete(&arena);
+
+	t_arena_recycle_stats stats = arena_recycle_stats();
+	assert(stats.cached_buffers == 1 && stats.cached_bytes == 64 * 1024);
+
+	// Any size from half the cached capacity up reuses it, zeroed.
+	arena = arena_create(40 * 1024, false);
+	assert(arena);
+	assert(arena == first_struct);
+	assert(arena->buffer == first_buffer);
+	assert(arena->size == 40 * 1024);
+	assert(arena->offset == 0);
+	assert(is_zero(arena->buffer, arena->size));
+	assert(arena_alloc(arena, 40 * 1024));
+
+	stats = arena_recycle_stats();
+	assert(stats.hits == 1 && stats.struct_hits == 1);
+	assert(stats.cached_buffers == 0 && stats.cached_bytes == 0);
+
+	arena_delete(&arena);
+	arena_recycle_disable();
+	printf("✅ test_recycle_reuses_buffer passed\n");
+}
+
+static void test_recycle_size_classes(void)
+{
+	arena_recycle_enable(0);
+	t_arena_recycle_stats before = arena_recycle_stats();
+
+	t_arena* arena = arena_create(64 * 1024, false);
+	assert(arena);
+	arena_delete(&arena);
+
+	// Too small (would waste more than half) and too large both miss.
+	t_arena* small = arena_create(16 * 1024, false);
+	t_arena* large = arena_create(128 * 1024, false);
+	assert(small && large);
+	t_arena_recycle_stats stats = arena_recycle_stats();
+	assert(stats.hits == before.hits);
+	assert(stats.misses == before.misses + 3);
+	assert(stats.cached_buffers == 1);
+
+	arena_delete(&small);
+	arena_delete(&large);
+	arena_recycle_disable();
+	printf("✅ test_recycle_size_classes passed\n");
+}
+
+static void test_recycle_mapped_buffer(void)
+{
+	arena_recycle_enable(0);
+
+	t_arena* arena = arena_create(2 * ARENA_MMAP_THRESHOLD, false);
+	assert(arena);
+	uint8_t* buffer = arena->buffer;
+	char*    block  = arena_alloc(arena, 8192);
+	memset(block, 0xCD, 8192);
+	arena_delete(&arena);
+
+	arena = arena_create(2 * ARENA_MMAP_THRESHOLD - 4096, false);
+	assert(arena);
+	assert(arena->buffer == buffer);
+	assert(is_zero(arena->buffer, arena->size));
+	memset(arena_alloc(arena, arena->size), 0xEF, arena->size);
+	arena_delete(&arena);
+
+	// The whole previous use is cleared, even past the new size.
+	arena = arena_create(2 * ARENA_MMAP_THRESHOLD, false);
+	assert(arena);
+	assert(arena->buffer == buffer);
+	assert(is_zero(arena->buffer, arena->size));
+
+	arena_delete(&arena);
+	arena_recycle_disable();
+	printf("✅ test_recycle_mapped_buffer passed\n");
+}
+
+static void test_recycle_grown_heap_buffer(void)
+{
+	arena_recycle_enable(0);
+
+	// realloc() leaves the grown tail uninitialized: it must be cleared too.
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	assert(arena_alloc(arena, 6000));
+	const size_t size = arena->size;
+	ARENA_SAN_OPEN(arena->buffer, size);
+	memset(arena->buffer, 0x5A, size);
+	arena_delete(&arena);
+
+	arena = arena_create(size, false);
+	assert(arena);
+	assert(is_zero(arena->buffer, arena->size));
+	assert(arena_recycle_stats().cached_buffers == 0);
+
+	arena_delete(&arena);
+	arena_recycle_disable();
+	printf("✅ test_recycle_grown_heap_buffer passed\n");
+}
+
+static void test_recycle_limits(void)
+{
+	arena_recycle_enable(100 * 1024);
+	t_arena_recycle_stats before = arena_recycle_stats();
+
+	t_arena* arenas[3];
+	for (int i = 0; i < 3; ++i)
+		assert((arenas[i] = arena_create(64 * 1024, false)));
+	for (int i = 0; i < 3; ++i)
+		arena_delete(&arenas[i]);
+
+	t_arena_recycle_stats stats = arena_recycle_stats();
+	assert(stats.cached_buffers == 1 && stats.cached_bytes == 64 * 1024);
+	assert(stats.rejected == before.rejected + 2);
+
+	// Borrowed buffers are never cached.
+	static uint8_t buffer[4096];
+	t_arena        borrowed;
+	arena_init_with_buffer(&borrowed, buffer, sizeof(buffer), false);
+	arena_destroy(&borrowed);
+	assert(arena_recycle_stats().cached_buffers == 1);
+
+	arena_recycle_drain();
+	stats = arena_recycle_stats();
+	assert(stats.cached_buffers == 0 && stats.cached_bytes == 0);
+
+	// Disabled: nothing is kept any more.
+	arena_recycle_disable();
+	t_arena* arena = arena_create(64 * 1024, false);
+	arena_delete(&arena);
+	assert(arena_recycle_stats().cached_buffers == 0);
+	printf("✅ test_recycle_limits passed\n");
+}
+
+int main(void)
+{
+	test_recycle_disabled_by_default();
+	test_recycle_reuses_buffer();
+	test_recycle_size_classes();
+	test_recycle_mapped_buffer();
+	test_recycle_grown_heap_buffer();
+	test_recycle_limits();
+	printf("🎉 All arena_recycle tests passed.\n");
+	return 0;
+}
@@ -1,8 +1,10 @@
 
 #include "arena.h"
 #include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 static void test_arena_grow_normal(void)
 {
@@ -127,6 +129,145 @@ static void test_arena_might_shrink(void)
 	printf("✅ test_arena_might_shrink passed\n");
 }
 
+static void test_arena_mmap_backing(void)
+{
+	// Large owned buffers are anonymous mappings resized with mremap().
+	t_arena* arena = arena_create(ARENA_MMAP_THRESHOLD, true);
+	assert(arena);
+	assert(arena->backing.kind == ARENA_BACKING_MMAP);
+	char* text = arena_alloc(arena, 64);
+	strcpy(text, "mapped");
+	size_t used = arena->offset;
+
+	assert(arena_grow(arena, 4 * ARENA_MMAP_THRESHOLD));
+	assert(arena->backing.kind == ARENA_BACKING_MMAP);
+	assert(strcmp((char*) arena->buffer + (used - 64), "mapped") == 0);
+	ARENA_SAN_OPEN(arena->buffer + used, arena->size - used);
+	memset(arena->buffer + used, 0x5A, arena->size - used);
+
+	arena_shrink(arena, ARENA_MMAP_THRESHOLD / 2);
+	assert(arena->size == ARENA_MMAP_THRESHOLD / 2);
+	assert(strcmp((char*) arena->buffer + (used - 64), "mapped") == 0);
+	arena_delete(&arena);
+
+	// Heap buffers move into a mapping once, when they grow past the threshold.
+	arena = arena_create(4096, true);
+	assert(arena);
+	assert(arena->backing.kind == ARENA_BACKING_HEAP);
+	memset(arena_alloc(arena, 4096), 0x11, 4096);
+	assert(arena_grow(arena, ARENA_MMAP_THRESHOLD));
+	assert(arena->backing.kind == ARENA_BACKING_MMAP);
+	for (size_t i = 0; i < 4096; ++i)
+		assert(arena->buffer[i] == 0x11);
+	arena_delete(&arena);
+
+	printf("✅ test_arena_mmap_backing passed\n");
+}
+
+static size_t huge_cb(size_t current, size_t requested)
+{
+	(void) current;
+	(void) requested;
+	return (size_t) ARENA_MAX_ALLOWED_SIZE + 1;
+}
+
+static void* use_arena_from_thread(void* arg)
+{
+	return arena_alloc((t_arena*) arg, 16);
+}
+
+static void test_arena_grow_size_limit(void)
+{
+	t_arena* arena = arena_create(64, true);
+	assert(arena);
+	arena->grow_cb = huge_cb;
+	assert(!arena_grow(arena, 128));
+	assert(arena->size == 64);
+
+	// The rejection must release the lock for other threads.
+	pthread_t thread;
+	void*     result = NULL;
+	assert(pthread_create(&thread, NULL, use_arena_from_thread, arena) == 0);
+	assert(pthread_join(thread, &result) == 0);
+	assert(result);
+
+	arena_delete(&arena);
+	printf("✅ test_arena_grow_size_limit passed\n");
+}
+
+static void run_burst(t_arena* arena, size_t bytes)
+{
+	assert(arena_alloc(arena, bytes));
+	arena_reset(arena);
+	arena_might_shrink(arena);
+}
+
+static void test_arena_shrink_hysteresis(void)
+{
+	// Without a policy, every quiet moment shrinks and every burst regrows.
+	t_arena* plain = arena_create(1024, true);
+	assert(plain);
+	for (int i = 0; i < 3; ++i)
+		run_burst(plain, 40000);
+	assert(plain->stats.shrinks == 3);
+	assert(plain->stats.regrows_after_shrink == 2);
+	arena_delete(&plain);
+
+	t_arena* arena = arena_create(1024, true);
+	assert(arena);
+	t_arena_shrink_policy policy = {.window_resets = 4, .min_size = 4096, .headroom_percent = 25};
+	arena_set_shrink_policy(arena, policy);
+
+	// Nothing shrinks before a full window, then the arena fits the burst peak.
+	// A refused shrink counts once per window, however often it is polled.
+	for (int i = 0; i < 3; ++i)
+		run_burst(arena, 40000);
+	for (int i = 0; i < 10; ++i)
+		assert(!arena_might_shrink(arena));
+	assert(arena->stats.shrinks == 0);
+	assert(arena->stats.shrinks_avoided == 1);
+	for (int i = 0; i < 5; ++i)
+		run_burst(arena, 40000);
+	assert(arena->stats.shrinks == 1);
+	assert(arena->stats.shrinks_avoided == 3); // one more in each of the two windows that followed
+	assert(arena->size == 40000 + 40000 / 100 * 25 + ARENA_SHRINK_PADDING);
+	assert(arena->stats.regrows_after_shrink == 0);
+
+	// Once a whole window is quiet, it shrinks down to the minimum size.
+	for (int i = 0; i < 8; ++i)
+		run_burst(arena, 1000);
+	assert(arena->size == 4096);
+	assert(arena->stats.shrinks == 2);
+	assert(arena->stats.regrows_after_shrink == 0);
+	assert(arena->cycle_peak == 0);
+
+	// An all-zero policy restores the immediate behavior.
+	arena_set_shrink_policy(arena, (t_arena_shrink_policy) {0});
+	assert(arena_alloc(arena, 100));
+	assert(arena_might_shrink(arena));
+
+	arena_delete(&arena);
+	printf("✅ test_arena_shrink_hysteresis passed\n");
+}
+
+static void test_arena_shrink_hysteresis_time_window(void)
+{
+	t_arena* arena = arena_create(1024, true);
+	assert(arena);
+	arena_set_shrink_policy(arena, (t_arena_shrink_policy) {.window_ms = 30});
+
+	run_burst(arena, 40000);
+	assert(arena->stats.shrinks == 0 && arena->stats.shrinks_avoided == 1);
+
+	struct timespec ts = {0, 40 * 1000000L};
+	nanosleep(&ts, NULL);
+	assert(arena_might_shrink(arena));
+	assert(arena->size == 40000 + ARENA_SHRINK_PADDING);
+
+	arena_delete(&arena);
+	printf("✅ test_arena_shrink_hysteresis_time_window passed\n");
+}
+
 int main(void)
 {
 	test_arena_grow_normal();
@@ -134,6 +275,10 @@ int main(void)
 	test_arena_shrink_valid();
 	test_arena_shrink_edge_cases();
 	test_arena_might_shrink();
+	test_arena_mmap_backing();
+	test_arena_grow_size_limit();
+	test_arena_shrink_hysteresis();
+	test_arena_shrink_hysteresis_time_window();
 	printf("\n🎉 All arena resize tests passed.\n");
 	return 0;
 }
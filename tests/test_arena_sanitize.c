@@ -0,0 +1,135 @@
+#include "arena.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARENA_ASAN
+
+static bool poisoned(const void* ptr)
+{
+	return __asan_address_is_poisoned(ptr);
+}
+
+static bool addressable(const void* ptr, size_t size)
+{
+	return __asan_region_is_poisoned((void*) ptr, size) == NULL;
+}
+
+static void test_alloc_and_pop(void)
+{
+	t_arena* arena = arena_create(4096, false);
+	assert(arena);
+	assert(poisoned(arena->buffer) && poisoned(arena->buffer + 4095));
+
+	uint8_t* a = arena_alloc(arena, 64);
+	assert(addressable(a, 64));
+	assert(poisoned(a + 64));
+
+	t_arena_marker mark = arena_mark(arena);
+	uint8_t*       b    = arena_alloc(arena, 200);
+	assert(addressable(b, 200));
+	arena_pop(arena, mark);
+	assert(poisoned(b) && poisoned(b + 199));
+	assert(addressable(a, 64));
+
+	arena_reset(arena);
+	assert(poisoned(a));
+
+	arena_delete(&arena);
+	printf("✅ test_alloc_and_pop passed\n");
+}
+
+static void test_realloc_last_in_place(void)
+{
+	t_arena* arena = arena_create(4096, false);
+	assert(arena);
+
+	uint8_t* block = arena_alloc(arena, 256);
+	assert(arena_realloc_last(arena, block, 256, 64) == block);
+	assert(addressable(block, 64));
+	assert(poisoned(block + 64) && poisoned(block + 255));
+
+	assert(arena_realloc_last(arena, block, 64, 1024) == block);
+	assert(addressable(block, 1024));
+	assert(poisoned(block + 1024));
+
+	arena_delete(&arena);
+	printf("✅ test_realloc_last_in_place passed\n");
+}
+
+static void test_grow_and_shrink_keep_annotations(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+
+	memset(arena_alloc(arena, 3000), 0x11, 3000);
+	t_arena_marker mark = arena_mark(arena);
+	assert(arena_alloc(arena, 8000)); // moves the buffer
+	size_t used = arena->offset;
+	assert(addressable(arena->buffer, 3000));
+	assert(addressable(arena->buffer + used - 8000, 8000));
+	assert(poisoned(arena->buffer + used));
+	assert(poisoned(arena->buffer + arena->size - 1));
+
+	arena_pop(arena, mark);
+	arena_shrink(arena, 4096);
+	assert(arena->size < used);
+	assert(addressable(arena->buffer, 3000));
+	assert(poisoned(arena->buffer + 3000));
+
+	arena_delete(&arena);
+	printf("✅ test_grow_and_shrink_keep_annotations passed\n");
+}
+
+static void test_destroy_unpoisons_user_buffer(void)
+{
+	static uint8_t storage[2048];
+	t_arena        arena;
+
+	arena_init_with_buffer(&arena, storage, sizeof(storage), false);
+	assert(arena_alloc(&arena, 100));
+	assert(poisoned(storage + 1000));
+
+	arena_destroy(&arena);
+	assert(addressable(storage, sizeof(storage)));
+	printf("✅ test_destroy_unpoisons_user_buffer passed\n");
+}
+
+static void test_redzones(void)
+{
+#if ARENA_REDZONE_SIZE > 0
+	t_arena* arena = arena_create(4096, false);
+	assert(arena);
+
+	uint8_t* a = arena_alloc(arena, 40);
+	uint8_t* b = arena_alloc(arena, 40);
+	assert(b >= a + 40 + ARENA_REDZONE_SIZE);
+	assert(poisoned(a + 40) && poisoned(b - 1));
+
+	arena_delete(&arena);
+	printf("✅ test_redzones passed\n");
+#else
+	printf("⚠️ Skipped test_redzones (ARENA_REDZONE_SIZE is 0)\n");
+#endif
+}
+
+int main(void)
+{
+	test_alloc_and_pop();
+	test_realloc_last_in_place();
+	test_grow_and_shrink_keep_annotations();
+	test_destroy_unpoisons_user_buffer();
+	test_redzones();
+	printf("🎉 All arena_sanitize tests passed.\n");
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	printf("⚠️ Skipped arena_sanitize tests (AddressSanitizer disabled)\n");
+	return 0;
+}
+
+#endif
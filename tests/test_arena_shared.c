@@ -0,0 +1,186 @@
+#include "arena_shared.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+typedef struct s_msg
+{
+	t_shared_ref next;
+	int          id;
+	char         text[24];
+} t_msg;
+
+static void test_shared_alloc_and_refs(void)
+{
+	t_shared_arena* arena = arena_create_shared(NULL, 4096);
+	assert(arena);
+	assert(arena->header->attached == 1);
+	assert(arena_shared_used(arena) == 0);
+
+	char* a = arena_shared_alloc(arena, 3, 1);
+	void* b = arena_shared_alloc(arena, 16, 64);
+	assert(a && b);
+	assert(((uintptr_t) b % 64) == 0);
+	assert(arena_shared_used(arena) == (size_t) ((char*) b - a) + 16);
+
+	t_shared_ref ref = arena_shared_ref(arena, b);
+	assert(ref != ARENA_SHARED_NULL);
+	assert(arena_shared_ptr(arena, ref) == b);
+	assert(arena_shared_ref(arena, NULL) == ARENA_SHARED_NULL);
+	assert(arena_shared_ref(arena, &ref) == ARENA_SHARED_NULL);
+	assert(arena_shared_ptr(arena, ARENA_SHARED_NULL) == NULL);
+
+	t_arena_stats stats = arena_shared_get_stats(arena);
+	assert(stats.allocations == 2);
+	assert(stats.bytes_allocated == 19);
+	assert(stats.wasted_alignment_bytes == 61);
+	assert(stats.peak_usage == 80);
+
+	arena_shared_reset(arena);
+	assert(arena_shared_used(arena) == 0);
+	assert(arena_shared_get_stats(arena).peak_usage == 80);
+
+	arena_shared_close(&arena);
+	assert(arena == NULL);
+	printf("✅ test_shared_alloc_and_refs passed\n");
+}
+
+static void test_shared_capacity(void)
+{
+	t_shared_arena* arena = arena_create_shared(NULL, 100);
+	assert(arena);
+	size_t capacity = (size_t) arena->header->size;
+	assert(capacity >= 100);
+
+	assert(arena_shared_alloc(arena, capacity, 1));
+	assert(!arena_shared_alloc(arena, 1, 1));
+	assert(arena_shared_get_stats(arena).failed_allocations == 1);
+
+	arena_shared_close(&arena);
+	printf("✅ test_shared_capacity passed\n");
+}
+
+static void test_shared_producer_consumer(void)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "arena_test_shared_%d", (int) getpid());
+	arena_shared_unlink(name);
+
+	t_shared_arena* producer = arena_create_shared(name, 64 * 1024);
+	assert(producer);
+	assert(!arena_create_shared(name, 4096));
+
+	t_shared_ref* head = arena_shared_alloc(producer, sizeof(t_shared_ref), _Alignof(t_shared_ref));
+	*head              = ARENA_SHARED_NULL;
+
+	int pipefd[2];
+	assert(pipe(pipefd) == 0);
+
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if (pid == 0)
+	{
+		// Consumer: attach by name and walk the list built by the producer.
+		close(pipefd[1]);
+		char go;
+		if (read(pipefd[0], &go, 1) != 1)
+			_exit(1);
+
+		t_shared_arena* consumer = arena_open_shared(name);
+		if (!consumer || consumer->header->attached != 2)
+			_exit(2);
+
+		t_shared_ref* list  = arena_shared_ptr(consumer, arena_shared_ref(producer, head));
+		int           count = 0;
+		for (t_msg* msg = arena_shared_ptr(consumer, *list); msg; msg = arena_shared_ptr(consumer, msg->next))
+		{
+			char expected[24];
+			snprintf(expected, sizeof(expected), "message %d", msg->id);
+			if (msg->id != 9 - count || strcmp(msg->text, expected) != 0)
+				_exit(3);
+			count++;
+		}
+
+		// Allocations from the consumer are visible to the producer.
+		int* reply = arena_shared_alloc(consumer, sizeof(int), _Alignof(int));
+		if (count != 10 || !reply)
+			_exit(4);
+		*reply = count;
+		arena_shared_close(&consumer);
+		_exit(0);
+	}
+
+	close(pipefd[0]);
+	for (int i = 0; i < 10; ++i)
+	{
+		t_msg* msg = arena_shared_alloc(producer, sizeof(t_msg), _Alignof(t_msg));
+		assert(msg);
+		msg->id   = i;
+		msg->next = *head;
+		snprintf(msg->text, sizeof(msg->text), "message %d", i);
+		*head = arena_shared_ref(producer, msg);
+	}
+	size_t used_before = arena_shared_used(producer);
+	assert(write(pipefd[1], "g", 1) == 1);
+	close(pipefd[1]);
+
+	int status = 0;
+	assert(waitpid(pid, &status, 0) == pid);
+	assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	assert(arena_shared_used(producer) > used_before);
+	assert(*(int*) ((char*) producer->data + used_before) == 10);
+	assert(arena_shared_get_stats(producer).allocations == 12);
+	assert(producer->header->attached == 1);
+
+	assert(arena_shared_unlink(name));
+	arena_shared_close(&producer);
+	printf("✅ test_shared_producer_consumer passed\n");
+}
+
+static void test_shared_error_cases(void)
+{
+	assert(!arena_create_shared(NULL, 0));
+	assert(!arena_create_shared("bad/name", 4096));
+	assert(!arena_open_shared("arena_test_shared_missing"));
+	assert(!arena_open_shared(NULL));
+	assert(!arena_open_shared_fd(-1));
+	assert(!arena_shared_unlink(""));
+
+	// A descriptor that does not hold a shared arena is rejected.
+	FILE* tmp = tmpfile();
+	assert(tmp);
+	assert(fwrite("not an arena", 1, 12, tmp) == 12);
+	fflush(tmp);
+	assert(!arena_open_shared_fd(fileno(tmp)));
+	fclose(tmp);
+
+	t_shared_arena* arena = arena_create_shared(NULL, 4096);
+	assert(arena);
+	assert(!arena_shared_alloc(arena, 0, 8));
+	assert(!arena_shared_alloc(arena, 8, 3));
+	assert(!arena_shared_alloc(NULL, 8, 8));
+
+	t_shared_arena* second = arena_open_shared_fd(arena->fd);
+	assert(second && second->header->attached == 2);
+	arena_shared_close(&second);
+	assert(arena->header->attached == 1);
+
+	arena_shared_close(&arena);
+	arena_shared_close(&arena);
+	arena_shared_close(NULL);
+	printf("✅ test_shared_error_cases passed\n");
+}
+
+int main(void)
+{
+	test_shared_alloc_and_refs();
+	test_shared_capacity();
+	test_shared_producer_consumer();
+	test_shared_error_cases();
+	printf("🎉 All arena_shared tests passed.\n");
+	return 0;
+}
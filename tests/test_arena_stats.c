@@ -118,7 +118,7 @@ static void test_arena_print_stats_output(void)
 	arena_print_stats(arena, fp);
 
 	rewind(fp);
-	char   buffer[1024] = {0};
+	char   buffer[4096] = {0};
 	size_t _            = fread(buffer, 1, sizeof(buffer) - 1, fp);
 	(void) _;
 	assert(strstr(buffer, "Arena Diagnostics"));
@@ -0,0 +1,242 @@
+#include "arena.h"
+#include "arena_scratch.h"
+#include "arena_trim.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// Number of resident pages in [ptr, ptr + len), ptr page-aligned.
+static size_t resident_pages(void* ptr, size_t len)
+{
+	const size_t  page  = (size_t) sysconf(_SC_PAGESIZE);
+	const size_t  pages = len / page;
+	unsigned char vec[pages];
+	assert(mincore(ptr, pages * page, vec) == 0);
+
+	size_t resident = 0;
+	for (size_t i = 0; i < pages; ++i)
+		resident += vec[i] & 1;
+	return resident;
+}
+
+static void test_decommit_releases_free_pages(void)
+{
+	const size_t size  = 4 * ARENA_MMAP_THRESHOLD;
+	t_arena*     arena = arena_create(size, false);
+	assert(arena);
+
+	char* block = arena_alloc(arena, size - 4096);
+	assert(block);
+	memset(block, 0xAB, size - 4096);
+	assert(resident_pages(arena->buffer, size) >= (size - 4096) / 4096);
+
+	// Keep the first 64 KiB; everything past it goes back to the kernel.
+	arena_reset(arena);
+	char* kept = arena_alloc(arena, 64 * 1024);
+	memset(kept, 0xCD, 64 * 1024);
+	size_t released = arena_decommit(arena);
+	assert(released == size - 64 * 1024);
+	assert(resident_pages(arena->buffer, size) <= 64 * 1024 / 4096 + 1);
+	assert(kept[64 * 1024 - 1] == (char) 0xCD);
+
+	// Decommitted pages fault back in on use.
+	char* again = arena_alloc(arena, 4096);
+	assert(again);
+	memset(again, 0xEF, 4096);
+	assert(arena_decommit(arena) == size - align_up(arena->offset, (size_t) sysconf(_SC_PAGESIZE)));
+
+	assert(arena_decommit(NULL) == 0);
+	arena_delete(&arena);
+	printf("✅ test_decommit_releases_free_pages passed\n");
+}
+
+static void test_decommit_skips_borrowed(void)
+{
+	static uint8_t buffer[64 * 1024];
+	t_arena        arena;
+	arena_init_with_buffer(&arena, buffer, sizeof(buffer), false);
+	assert(arena_decommit(&arena) == 0);
+	arena_destroy(&arena);
+
+	t_arena* small = arena_create(128, false);
+	assert(small);
+	assert(arena_decommit(small) == 0); // no whole page to release
+	arena_delete(&small);
+	printf("✅ test_decommit_skips_borrowed passed\n");
+}
+
+static void test_scratch_pool_trim(void)
+{
+	t_scratch_arena_pool pool;
+	assert(scratch_pool_init(&pool, 4096, true));
+
+	t_arena* busy = scratch_acquire(&pool);
+	t_arena* used = scratch_acquire(&pool);
+	assert(busy && used);
+	assert(arena_alloc(used, 256 * 1024));
+	assert(arena_alloc(busy, 256 * 1024));
+	scratch_release(&pool, used);
+
+	// The released slot shrinks back to slot_size; the acquired one is untouched.
+	size_t busy_size = busy->size;
+	assert(scratch_pool_trim(&pool) >= 256 * 1024);
+	assert(used->size == 4096);
+	assert(busy->size == busy_size);
+
+	scratch_release(&pool, busy);
+	assert(scratch_pool_trim(NULL) == 0);
+	scratch_pool_destroy(&pool);
+	printf("✅ test_scratch_pool_trim passed\n");
+}
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+static atomic_int g_pressure = ARENA_PRESSURE_NONE;
+static atomic_int g_samples  = 0;
+
+static t_arena_pressure fake_source(void* context)
+{
+	assert(context == &g_pressure);
+	atomic_fetch_add(&g_samples, 1);
+	return (t_arena_pressure) atomic_load(&g_pressure);
+}
+
+static void sleep_ms(long ms)
+{
+	struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+}
+
+static void test_trim_now_idle_only(void)
+{
+	t_arena* idle   = arena_create(64 * 1024, true);
+	t_arena* active = arena_create(64 * 1024, true);
+	assert(idle && active);
+	assert(arena_trimmer_register(idle));
+	assert(arena_trimmer_register(active));
+	assert(arena_trimmer_register(idle)); // no-op
+
+	assert(arena_alloc(idle, 200 * 1024));
+	assert(arena_alloc(active, 200 * 1024));
+	arena_reset(idle);
+	arena_reset(active);
+	size_t idle_size   = idle->size;
+	size_t active_size = active->size;
+
+	// Both allocated since registering: the first pass only records them.
+	assert(arena_trim_now(ARENA_PRESSURE_SOME) == 0);
+
+	// Now only `active` allocates: under some pressure, only `idle` is trimmed.
+	assert(arena_alloc(active, 16));
+	assert(arena_trim_now(ARENA_PRESSURE_SOME) > 0);
+	assert(idle->size < idle_size);
+	assert(active->size == active_size);
+
+	// Full pressure trims everyone.
+	assert(arena_alloc(active, 16));
+	assert(arena_trim_now(ARENA_PRESSURE_FULL) > 0);
+	assert(active->size < active_size);
+	assert(arena_trim_now(ARENA_PRESSURE_NONE) == 0);
+
+	arena_trimmer_unregister(active);
+	arena_delete(&active);
+	arena_delete(&idle); // unregisters
+	printf("✅ test_trim_now_idle_only passed\n");
+}
+
+static void test_trimmer_thread(void)
+{
+	t_arena* arena = arena_create(64 * 1024, true);
+	assert(arena);
+	assert(arena_alloc(arena, 1 << 20));
+	arena_reset(arena);
+	const size_t grown = arena->size;
+	assert(arena_trimmer_register(arena));
+
+	assert(arena_trimmer_start(fake_source, &g_pressure, 5));
+	assert(!arena_trimmer_start(fake_source, &g_pressure, 5));
+	while (atomic_load(&g_samples) < 3)
+		sleep_ms(1);
+
+	// No pressure, no trimming.
+	ARENA_LOCK(arena);
+	assert(arena->size == grown);
+	ARENA_UNLOCK(arena);
+
+	atomic_store(&g_pressure, ARENA_PRESSURE_SOME);
+	bool shrunk = false;
+	for (int i = 0; i < 2000 && !shrunk; ++i)
+	{
+		ARENA_LOCK(arena);
+		shrunk = arena->size < grown;
+		ARENA_UNLOCK(arena);
+		sleep_ms(1);
+	}
+	assert(shrunk);
+
+	arena_trimmer_stop();
+	arena_trimmer_stop();
+	atomic_store(&g_pressure, ARENA_PRESSURE_NONE);
+	arena_delete(&arena);
+
+	// The default source always yields a valid level.
+	t_arena_pressure level = arena_pressure_read(NULL);
+	assert(level >= ARENA_PRESSURE_NONE && level <= ARENA_PRESSURE_FULL);
+	printf("✅ test_trimmer_thread passed\n");
+}
+
+#else
+
+static atomic_int g_errors = 0;
+
+static void count_error_cb(const char* msg, void* ctx)
+{
+	(void) msg;
+	(void) ctx;
+	atomic_fetch_add(&g_errors, 1);
+}
+
+static void test_trimmer_unavailable(void)
+{
+	t_arena* arena = arena_create(64 * 1024, true);
+	assert(arena);
+	arena_set_error_callback(arena, count_error_cb, NULL);
+	assert(!arena_trimmer_register(arena));
+	assert(atomic_load(&g_errors) == 1);
+
+	t_scratch_arena_pool pool;
+	assert(scratch_pool_init(&pool, 4096, false));
+	assert(!arena_trimmer_register_pool(&pool));
+	assert(!arena_trimmer_start(NULL, NULL, 0));
+	arena_trimmer_stop(); // no-op
+
+	// Nothing is registered, so an explicit pass releases nothing.
+	assert(arena_alloc(arena, 1 << 20));
+	arena_reset(arena);
+	assert(arena_trim_now(ARENA_PRESSURE_FULL) == 0);
+
+	scratch_pool_destroy(&pool);
+	arena_delete(&arena);
+	printf("✅ test_trimmer_unavailable passed\n");
+}
+
+#endif
+
+int main(void)
+{
+	test_decommit_releases_free_pages();
+	test_decommit_skips_borrowed();
+	test_scratch_pool_trim();
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_trim_now_idle_only();
+	test_trimmer_thread();
+#else
+	test_trimmer_unavailable();
+#endif
+	printf("🎉 All arena_trim tests passed.\n");
+	return 0;
+}
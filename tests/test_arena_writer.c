@@ -0,0 +1,281 @@
+#include "arena.h"
+#include "arena_writer.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+static const char* g_path = "/tmp/arena_test_writer.out";
+
+static char* read_back(size_t* len)
+{
+	FILE* f = fopen(g_path, "rb");
+	assert(f);
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char* data = malloc((size_t) size + 1);
+	assert(data);
+	assert(fread(data, 1, (size_t) size, f) == (size_t) size);
+	data[size] = '\0';
+	fclose(f);
+	*len = (size_t) size;
+	return data;
+}
+
+static int open_output(void)
+{
+	int fd = open(g_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	assert(fd >= 0);
+	return fd;
+}
+
+static void test_writer_basic(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	t_arena_writer out;
+	assert(arena_writer_init(&out, arena, 0));
+	assert(arena_writer_size(&out) == 0);
+
+	assert(arena_writer_puts(&out, "status: "));
+	assert(arena_writer_printf(&out, "%d %s", 200, "OK"));
+	assert(arena_writer_write(&out, "\n", 1));
+	assert(arena_writer_write(&out, NULL, 0));
+	assert(arena_writer_size(&out) == strlen("status: 200 OK\n"));
+
+	int fd = open_output();
+	assert(arena_writer_flush(&out, fd) == (ssize_t) strlen("status: 200 OK\n"));
+	close(fd);
+	assert(arena_writer_size(&out) == 0);
+
+	size_t len  = 0;
+	char*  data = read_back(&len);
+	assert(strcmp(data, "status: 200 OK\n") == 0);
+	free(data);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_writer_basic passed\n");
+}
+
+static void test_writer_extends_in_place(void)
+{
+	t_arena* arena = arena_create(1024, true);
+	assert(arena);
+	t_arena_writer out;
+	assert(arena_writer_init(&out, arena, 64));
+
+	// Nothing else allocates, so the single chunk keeps growing with the arena.
+	for (int i = 0; i < 2000; ++i)
+		assert(arena_writer_printf(&out, "line %04d\n", i));
+	assert(out.chunk_count == 1);
+	assert(arena_writer_size(&out) == 2000 * 10);
+	assert(arena->size > 1024);
+
+	int fd = open_output();
+	assert(arena_writer_flush(&out, fd) == 2000 * 10);
+	close(fd);
+
+	size_t len  = 0;
+	char*  data = read_back(&len);
+	assert(len == 2000 * 10);
+	assert(strncmp(data, "line 0000\nline 0001\n", 20) == 0);
+	assert(strncmp(data + len - 10, "line 1999\n", 10) == 0);
+	free(data);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_writer_extends_in_place passed\n");
+}
+
+static void test_writer_interleaved_allocations(void)
+{
+	t_arena* arena = arena_create(256, true);
+	assert(arena);
+	t_arena_writer out;
+	assert(arena_writer_init(&out, arena, 32));
+
+	char expected[4096] = {0};
+	for (int i = 0; i < 100; ++i)
+	{
+		char line[32];
+		snprintf(line, sizeof(line), "<%d>", i);
+		strcat(expected, line);
+		assert(arena_writer_puts(&out, line));
+		// Foreign allocations force new chunks and the buffer moves as it grows.
+		char* other = arena_alloc(arena, 40);
+		assert(other);
+		memset(other, '#', 40);
+	}
+	assert(out.chunk_count > 1);
+	assert(arena_writer_size(&out) == strlen(expected));
+
+	int fd = open_output();
+	assert(arena_writer_flush(&out, fd) == (ssize_t) strlen(expected));
+	close(fd);
+
+	size_t len  = 0;
+	char*  data = read_back(&len);
+	assert(strcmp(data, expected) == 0);
+	free(data);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_writer_interleaved_allocations passed\n");
+}
+
+static void test_writer_many_chunks_pipe(void)
+{
+	t_arena* arena = arena_create(1 << 16, true);
+	assert(arena);
+	t_arena_writer out;
+	assert(arena_writer_init(&out, arena, 8));
+
+	// More chunks than one writev() call accepts.
+	const int count = IOV_MAX + 300;
+	for (int i = 0; i < count; ++i)
+	{
+		assert(arena_writer_write(&out, "abcdefgh", 8));
+		assert(arena_alloc(arena, 1));
+	}
+	assert(out.chunk_count == (size_t) count);
+
+	int pipefd[2];
+	assert(pipe(pipefd) == 0);
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if (pid == 0)
+	{
+		close(pipefd[0]);
+		_exit(arena_writer_flush(&out, pipefd[1]) == (ssize_t) count * 8 ? 0 : 1);
+	}
+	close(pipefd[1]);
+
+	size_t  total = 0;
+	char    buf[4096];
+	ssize_t n;
+	while ((n = read(pipefd[0], buf, sizeof(buf))) > 0)
+	{
+		for (ssize_t i = 0; i < n; ++i)
+			assert(buf[i] == "abcdefgh"[(total + (size_t) i) % 8]);
+		total += (size_t) n;
+	}
+	close(pipefd[0]);
+	assert(total == (size_t) count * 8);
+
+	int status = 0;
+	assert(waitpid(pid, &status, 0) == pid);
+	assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_writer_many_chunks_pipe passed\n");
+}
+
+static void test_writer_large_threshold(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	arena_set_large_threshold(arena, 8192);
+	t_arena_writer out;
+	assert(arena_writer_init(&out, arena, 0));
+
+	// Chunks above the threshold stay in the buffer, which then grows and moves.
+	static char big[20000];
+	memset(big, 'a', sizeof(big));
+	assert(arena_writer_write(&out, big, sizeof(big)));
+	assert(arena->stats.large_allocations == 0);
+	for (int i = 0; i < 2000; ++i)
+		assert(arena_alloc(arena, 64));
+	memset(big, 'b', sizeof(big));
+	assert(arena_writer_write(&out, big, sizeof(big)));
+	assert(arena_writer_size(&out) == 2 * sizeof(big));
+
+	int fd = open_output();
+	assert(arena_writer_flush(&out, fd) == (ssize_t) (2 * sizeof(big)));
+	close(fd);
+
+	size_t len  = 0;
+	char*  data = read_back(&len);
+	assert(len == 2 * sizeof(big));
+	for (size_t i = 0; i < len; ++i)
+		assert(data[i] == (i < sizeof(big) ? 'a' : 'b'));
+	free(data);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_writer_large_threshold passed\n");
+}
+
+static void test_writer_out_of_memory(void)
+{
+	t_arena* arena = arena_create(128, false);
+	assert(arena);
+	t_arena_writer out;
+	assert(arena_writer_init(&out, arena, 16));
+
+	assert(arena_writer_puts(&out, "fits"));
+	char big[512];
+	memset(big, 'z', sizeof(big));
+	assert(!arena_writer_write(&out, big, sizeof(big)));
+	assert(out.failed);
+	assert(arena_writer_flush(&out, STDOUT_FILENO) == -1);
+
+	// Reset drops the partial output and clears the failure.
+	arena_writer_reset(&out);
+	assert(!out.failed);
+	assert(arena_writer_size(&out) == 0);
+
+	arena_delete(&arena);
+	printf("✅ test_writer_out_of_memory passed\n");
+}
+
+static void test_writer_error_cases(void)
+{
+	t_arena_writer out;
+	assert(!arena_writer_init(NULL, NULL, 0));
+	assert(!arena_writer_init(&out, NULL, 0));
+
+	t_arena* arena = arena_create(2 * ARENA_WRITER_CHUNK_SIZE, false);
+	assert(arena);
+	assert(arena_writer_init(&out, arena, 0));
+	assert(out.chunk_size == ARENA_WRITER_CHUNK_SIZE);
+	assert(!arena_writer_write(NULL, "x", 1));
+	assert(!arena_writer_write(&out, NULL, 1));
+	assert(!arena_writer_puts(&out, NULL));
+	assert(arena_writer_flush(&out, -1) == -1);
+	assert(arena_writer_flush(&out, STDOUT_FILENO) == 0);
+	assert(arena_writer_size(NULL) == 0);
+
+	// A closed descriptor fails and keeps the buffered output.
+	assert(arena_writer_puts(&out, "kept"));
+	int fd = open_output();
+	close(fd);
+	assert(arena_writer_flush(&out, fd) == -1);
+	assert(arena_writer_size(&out) == 4);
+
+	arena_delete(&arena);
+	unlink(g_path);
+	printf("✅ test_writer_error_cases passed\n");
+}
+
+int main(void)
+{
+	test_writer_basic();
+	test_writer_extends_in_place();
+	test_writer_interleaved_allocations();
+	test_writer_many_chunks_pipe();
+	test_writer_large_threshold();
+	test_writer_out_of_memory();
+	test_writer_error_cases();
+	printf("🎉 All arena_writer tests passed.\n");
+	return 0;
+}
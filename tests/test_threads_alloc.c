@@ -56,6 +56,9 @@ void* thread_func(void* arg)
 		size_t alignment = 1 << ((rand() % 5) + 3);
 		int    variant   = rand() % 4;
 
+		// Past ARENA_MMAP_THRESHOLD, a growth moves the buffer with mremap(), which unmaps the
+		// old range at once: write the block before another thread can grow the arena.
+		ARENA_LOCK(args->arena);
 		void* ptr = NULL;
 		switch (variant)
 		{
@@ -75,6 +78,7 @@ void* thread_func(void* arg)
 
 		if (ptr)
 			memset(ptr, args->thread_id, size); // mark memory
+		ARENA_UNLOCK(args->arena);
 		atomic_fetch_add(args->global_alloc_counter, 1);
 	}
 	return NULL;
@@ -46,6 +46,7 @@ void* thread_alloc_sub(void* arg)
 		assert(child.debug.label != NULL);
 		assert(strncmp(child.debug.label, "subarena", 8) == 0 || strstr(child.debug.label, "thread_") != NULL);
 
+		ARENA_SAN_OPEN(child.buffer, SUBARENA_SIZE);
 		memset(child.buffer, ctx->index, SUBARENA_SIZE);
 		ctx->successful_allocs++;
 	}
@@ -55,7 +56,10 @@ void* thread_alloc_sub(void* arg)
 
 void test_multithreaded_subarena_alloc()
 {
-	t_arena* parent = arena_create(THREAD_COUNT * LOOP_COUNT * SUBARENA_SIZE, true);
+	// Room for every child and the redzones between them: a growth would move
+	// the parent under the children still in use.
+	const size_t stride = align_up(SUBARENA_SIZE + ARENA_REDZONE_SIZE, ARENA_DEFAULT_ALIGNMENT);
+	t_arena*     parent = arena_create(THREAD_COUNT * LOOP_COUNT * stride, true);
 	assert(parent);
 	parent->use_lock = true;
 
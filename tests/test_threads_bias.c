@@ -0,0 +1,153 @@
+#include "arena.h"
+#include "arena_bias.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define THREAD_COUNT 4
+#define ALLOCS_PER_THREAD 2000
+#define BLOCK_SIZE 64
+
+typedef struct
+{
+	t_arena* arena;
+	int      thread_id;
+	uint8_t* blocks[ALLOCS_PER_THREAD];
+} thread_args;
+
+// Bytes used by `blocks` blocks of BLOCK_SIZE, counting the redzones between them.
+static size_t used_by(size_t blocks)
+{
+	return blocks ? blocks * BLOCK_SIZE + (blocks - 1) * align_up(ARENA_REDZONE_SIZE, ARENA_DEFAULT_ALIGNMENT) : 0;
+}
+
+static void* alloc_func(void* arg)
+{
+	thread_args* args = (thread_args*) arg;
+	for (size_t i = 0; i < ALLOCS_PER_THREAD; ++i)
+	{
+		args->blocks[i] = arena_alloc(args->arena, BLOCK_SIZE);
+		assert(args->blocks[i]);
+		memset(args->blocks[i], args->thread_id + 1, BLOCK_SIZE);
+	}
+	return NULL;
+}
+
+static void* used_func(void* arg)
+{
+	return (void*) arena_used((t_arena*) arg);
+}
+
+static void test_owner_keeps_bias(void)
+{
+	t_arena* arena = arena_create(1 << 20, false);
+	assert(arena);
+	assert(arena_enable_biased_lock(arena));
+	assert(arena_enable_biased_lock(arena)); // no effect the second time
+
+	static thread_args args;
+	args.arena     = arena;
+	args.thread_id = 0;
+	alloc_func(&args);
+
+	// Nested locking by the owner, including a reset inside its critical section.
+	ARENA_LOCK(arena);
+	ARENA_LOCK(arena);
+	assert(arena_used(arena) == used_by(ALLOCS_PER_THREAD));
+	arena_reset(arena);
+	ARENA_UNLOCK(arena);
+	assert(arena_alloc(arena, BLOCK_SIZE));
+	ARENA_UNLOCK(arena);
+
+	assert(arena_is_biased(arena));
+	assert(arena_get_stats(arena).allocations == ALLOCS_PER_THREAD + 1);
+
+	arena_delete(&arena);
+	printf("✅ test_owner_keeps_bias passed\n");
+}
+
+static void test_other_thread_revokes(void)
+{
+	t_arena* arena = arena_create(1 << 20, false);
+	assert(arena);
+	assert(arena_enable_biased_lock(arena));
+	uint8_t* first = arena_alloc(arena, BLOCK_SIZE);
+	memset(first, 0x5A, BLOCK_SIZE);
+
+	pthread_t thread;
+	void*     used;
+	assert(pthread_create(&thread, NULL, used_func, arena) == 0);
+	pthread_join(thread, &used);
+	assert((size_t) used == BLOCK_SIZE);
+	assert(!arena_is_biased(arena));
+	assert(!arena_enable_biased_lock(arena)); // revocation is permanent
+
+	// The former owner goes through the mutex from now on.
+	assert(arena_alloc(arena, BLOCK_SIZE) == first + used_by(2) - BLOCK_SIZE);
+	assert(first[0] == 0x5A && first[BLOCK_SIZE - 1] == 0x5A);
+
+	arena_delete(&arena);
+	printf("✅ test_other_thread_revokes passed\n");
+}
+
+static void test_revocation_under_contention(void)
+{
+	t_arena* arena = arena_create(used_by(THREAD_COUNT * ALLOCS_PER_THREAD), false);
+	assert(arena);
+	assert(arena_enable_biased_lock(arena));
+
+	pthread_t          threads[THREAD_COUNT];
+	static thread_args args[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; ++i)
+	{
+		args[i].arena     = arena;
+		args[i].thread_id = i;
+		assert(pthread_create(&threads[i], NULL, alloc_func, &args[i]) == 0);
+	}
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_join(threads[i], NULL);
+
+	// Every block is distinct and kept its contents, whoever owned the bias.
+	assert(arena_used(arena) == used_by(THREAD_COUNT * ALLOCS_PER_THREAD));
+	for (int t = 0; t < THREAD_COUNT; ++t)
+		for (size_t i = 0; i < ALLOCS_PER_THREAD; ++i)
+			for (size_t b = 0; b < BLOCK_SIZE; ++b)
+				assert(args[t].blocks[i][b] == (uint8_t) (t + 1));
+	assert(!arena_is_biased(arena));
+
+	arena_delete(&arena);
+	printf("✅ test_revocation_under_contention passed\n");
+}
+
+static void test_requires_lock(void)
+{
+	t_arena arena;
+	assert(arena_init(&arena, 256, false));
+	arena_destroy(&arena); // leaves the arena without a lock
+
+	assert(!arena_enable_biased_lock(&arena));
+	assert(!arena_is_biased(&arena));
+	assert(!arena_enable_biased_lock(NULL));
+	printf("✅ test_requires_lock passed\n");
+}
+
+int main(void)
+{
+	t_arena* probe = arena_create(64, false);
+	assert(probe);
+	bool supported = arena_enable_biased_lock(probe);
+	arena_delete(&probe);
+	if (!supported)
+	{
+		printf("⚠️ Skipped arena_bias tests (membarrier() unavailable)\n");
+		return 0;
+	}
+
+	test_owner_keeps_bias();
+	test_other_thread_revokes();
+	test_revocation_under_contention();
+	test_requires_lock();
+	printf("🎉 All arena_bias tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,113 @@
+#include "arena.h"
+#include "arena_budget.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+#define THREAD_COUNT 8
+#define ROUNDS 200
+#define ARENA_SIZE (16 * 1024)
+
+static void sleep_ms(long ms)
+{
+	struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+}
+
+static void silent_error_cb(const char* msg, void* ctx)
+{
+	(void) msg;
+	(void) ctx;
+}
+
+static void* churn_func(void* arg)
+{
+	t_arena_budget* budget = arg;
+	for (int i = 0; i < ROUNDS; ++i)
+	{
+		t_arena* arena = arena_create_in_budget(budget, ARENA_SIZE, true);
+		assert(arena);
+		assert(arena_alloc(arena, ARENA_SIZE / 2));
+		assert(arena_budget_used(budget) <= budget->limit);
+		arena_delete(&arena);
+	}
+	return NULL;
+}
+
+static void test_threads_budget_block_churn(void)
+{
+	// Room for half the threads at once: the others block until memory is credited.
+	t_arena_budget budget;
+	assert(arena_budget_init(&budget, THREAD_COUNT / 2 * ARENA_SIZE, NULL));
+	arena_budget_set_policy(&budget, ARENA_BUDGET_BLOCK, 0);
+
+	pthread_t threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		assert(pthread_create(&threads[i], NULL, churn_func, &budget) == 0);
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_join(threads[i], NULL);
+
+	assert(arena_budget_used(&budget) == 0);
+	assert(atomic_load(&budget.peak) <= budget.limit);
+	assert(atomic_load(&budget.denials) == 0);
+
+	arena_budget_destroy(&budget);
+	printf("✅ test_threads_budget_block_churn passed\n");
+}
+
+static void* release_later_func(void* arg)
+{
+	t_arena** holder = arg;
+	sleep_ms(50);
+	arena_delete(holder);
+	return NULL;
+}
+
+static void test_threads_budget_block_timeout(void)
+{
+	t_arena_budget budget;
+	assert(arena_budget_init(&budget, 32 * 1024, NULL));
+	arena_budget_set_policy(&budget, ARENA_BUDGET_BLOCK, 20);
+
+	t_arena* holder = arena_create_in_budget(&budget, 24 * 1024, false);
+	t_arena* arena  = arena_create_in_budget(&budget, 8 * 1024, true);
+	assert(holder && arena);
+	arena_set_error_callback(arena, silent_error_cb, NULL);
+
+	// Nobody releases memory within the timeout.
+	assert(!arena_alloc(arena, 12 * 1024));
+	assert(atomic_load(&budget.denials) == 1);
+
+	// A release during the wait lets the growth through.
+	arena_budget_set_policy(&budget, ARENA_BUDGET_BLOCK, 5000);
+	pthread_t thread;
+	assert(pthread_create(&thread, NULL, release_later_func, &holder) == 0);
+	assert(arena_alloc(arena, 12 * 1024));
+	pthread_join(thread, NULL);
+	assert(atomic_load(&budget.waits) == 2);
+	assert(arena_budget_used(&budget) == 32 * 1024);
+
+	// A charge larger than the limit never blocks.
+	assert(!arena_alloc(arena, 64 * 1024));
+
+	arena_delete(&arena);
+	arena_budget_destroy(&budget);
+	printf("✅ test_threads_budget_block_timeout passed\n");
+}
+
+#endif
+
+int main(void)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_threads_budget_block_churn();
+	test_threads_budget_block_timeout();
+	printf("🎉 All threaded arena_budget tests passed.\n");
+#else
+	printf("⚠️ Skipped threaded arena_budget tests (ARENA_ENABLE_THREAD_SAFE disabled)\n");
+#endif
+	return 0;
+}
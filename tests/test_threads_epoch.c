@@ -0,0 +1,175 @@
+#include "arena_epoch.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#define READER_COUNT 4
+#define EPOCHS 500
+#define SNAPSHOT_WORDS 64
+
+typedef struct
+{
+	uint64_t sequence;
+	uint64_t words[SNAPSHOT_WORDS];
+} t_snapshot;
+
+static t_arena_epoch         g_ring;
+static _Atomic(t_snapshot*)  g_snapshot;
+static atomic_bool           g_done;
+static _Atomic unsigned long g_reads;
+
+static void test_advance_cycles_arenas(void)
+{
+	assert(!arena_epoch_init(&g_ring, 1, 4096));
+	assert(!arena_epoch_init(&g_ring, ARENA_EPOCH_MAX_ARENAS + 1, 4096));
+	assert(arena_epoch_init(&g_ring, 3, 4096));
+	assert(arena_epoch_now(&g_ring) == 1);
+
+	t_arena* first = arena_epoch_current(&g_ring);
+	assert(arena_alloc(first, 1000));
+	assert(arena_epoch_try_advance(&g_ring));
+	assert(arena_epoch_current(&g_ring) != first);
+	assert(arena_epoch_try_advance(&g_ring));
+	assert(arena_epoch_try_advance(&g_ring));
+
+	// Back to the first arena, reset on the way in.
+	assert(arena_epoch_now(&g_ring) == 4);
+	assert(arena_epoch_current(&g_ring) == first);
+	assert(arena_used(first) == 0);
+	assert(!arena_alloc(first, 8192)); // ring arenas do not grow
+
+	arena_epoch_destroy(&g_ring);
+	printf("✅ test_advance_cycles_arenas passed\n");
+}
+
+static void test_reader_holds_back_oldest_arena(void)
+{
+	assert(arena_epoch_init(&g_ring, 3, 4096));
+	t_arena_epoch_reader* reader = arena_epoch_register(&g_ring);
+	assert(reader);
+
+	assert(arena_epoch_enter(reader) == 1);
+	assert(arena_epoch_enter(reader) == 1); // nested
+	assert(arena_epoch_try_advance(&g_ring));  // a reader of epoch 1 may still use arena 0 only
+	assert(!arena_epoch_try_advance(&g_ring)); // epoch 3 would reset it
+
+	arena_epoch_exit(reader);
+	assert(!arena_epoch_try_advance(&g_ring)); // still inside the outer call
+	arena_epoch_exit(reader);
+	assert(arena_epoch_try_advance(&g_ring));
+
+	// Readers of the current epoch do not hold a ring of three back.
+	assert(arena_epoch_enter(reader) == 3);
+	assert(arena_epoch_try_advance(&g_ring));
+	assert(!arena_epoch_try_advance(&g_ring));
+	arena_epoch_exit(reader);
+
+	arena_epoch_unregister(reader);
+	arena_epoch_destroy(&g_ring);
+	printf("✅ test_reader_holds_back_oldest_arena passed\n");
+}
+
+static void test_two_arena_ring_waits_for_every_reader(void)
+{
+	assert(arena_epoch_init(&g_ring, 2, 4096));
+	t_arena_epoch_reader* reader = arena_epoch_register(&g_ring);
+	assert(reader);
+
+	arena_epoch_enter(reader);
+	assert(!arena_epoch_try_advance(&g_ring));
+	arena_epoch_exit(reader);
+	assert(arena_epoch_try_advance(&g_ring));
+
+	arena_epoch_unregister(reader);
+	arena_epoch_destroy(&g_ring);
+	printf("✅ test_two_arena_ring_waits_for_every_reader passed\n");
+}
+
+static void test_reader_records_run_out(void)
+{
+	static t_arena_epoch_reader* readers[ARENA_EPOCH_MAX_READERS];
+	assert(arena_epoch_init(&g_ring, 3, 4096));
+
+	for (size_t i = 0; i < ARENA_EPOCH_MAX_READERS; ++i)
+		assert((readers[i] = arena_epoch_register(&g_ring)));
+	assert(!arena_epoch_register(&g_ring));
+	arena_epoch_unregister(readers[7]);
+	assert(arena_epoch_register(&g_ring) == readers[7]);
+
+	for (size_t i = 0; i < ARENA_EPOCH_MAX_READERS; ++i)
+		arena_epoch_unregister(readers[i]);
+	arena_epoch_destroy(&g_ring);
+	printf("✅ test_reader_records_run_out passed\n");
+}
+
+static void* reader_func(void* arg)
+{
+	(void) arg;
+	t_arena_epoch_reader* reader = arena_epoch_register(&g_ring);
+	assert(reader);
+
+	while (!atomic_load(&g_done))
+	{
+		arena_epoch_enter(reader);
+		const t_snapshot* snapshot = atomic_load_explicit(&g_snapshot, memory_order_acquire);
+		for (size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+			assert(snapshot->words[i] == snapshot->sequence * SNAPSHOT_WORDS + i);
+		arena_epoch_exit(reader);
+		atomic_fetch_add_explicit(&g_reads, 1, memory_order_relaxed);
+		sched_yield(); // interleave with the writer on small machines
+	}
+
+	arena_epoch_unregister(reader);
+	return NULL;
+}
+
+static void publish(uint64_t sequence)
+{
+	t_snapshot* snapshot = arena_alloc(arena_epoch_current(&g_ring), sizeof(*snapshot));
+	assert(snapshot);
+	snapshot->sequence = sequence;
+	for (size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+		snapshot->words[i] = sequence * SNAPSHOT_WORDS + i;
+	atomic_store_explicit(&g_snapshot, snapshot, memory_order_release);
+}
+
+static void test_lock_free_readers(void)
+{
+	assert(arena_epoch_init(&g_ring, 3, 64 * 1024));
+	publish(0);
+
+	pthread_t readers[READER_COUNT];
+	for (int i = 0; i < READER_COUNT; ++i)
+		assert(pthread_create(&readers[i], NULL, reader_func, NULL) == 0);
+
+	// Each epoch publishes a fresh snapshot; advancing resets the arena of two
+	// epochs ago, which poisons it in debug builds, so a premature reset fails
+	// the readers' checks.
+	for (uint64_t sequence = 1; sequence <= EPOCHS; ++sequence)
+	{
+		arena_epoch_advance(&g_ring);
+		publish(sequence);
+		sched_yield();
+	}
+
+	atomic_store(&g_done, true);
+	for (int i = 0; i < READER_COUNT; ++i)
+		pthread_join(readers[i], NULL);
+	assert(arena_epoch_now(&g_ring) == EPOCHS + 1);
+
+	arena_epoch_destroy(&g_ring);
+	printf("✅ test_lock_free_readers passed (%lu reads)\n", (unsigned long) atomic_load(&g_reads));
+}
+
+int main(void)
+{
+	test_advance_cycles_arenas();
+	test_reader_holds_back_oldest_arena();
+	test_two_arena_ring_waits_for_every_reader();
+	test_reader_records_run_out();
+	test_lock_free_readers();
+	printf("🎉 All arena_epoch tests passed.\n");
+	return 0;
+}
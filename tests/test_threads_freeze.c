@@ -0,0 +1,54 @@
+#include "arena.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define THREAD_COUNT 8
+#define ITERATIONS 10000
+
+static t_arena* g_arena;
+static size_t   g_used;
+
+static void* thread_reader(void* arg)
+{
+	(void) arg;
+	for (int i = 0; i < ITERATIONS; ++i)
+	{
+		assert(arena_used(g_arena) == g_used);
+		assert(arena_remaining(g_arena) == g_arena->size - g_used);
+		assert(arena_peak(g_arena) == g_used);
+		assert(arena_get_stats(g_arena).allocations == 64);
+		if (i % 1000 == 0)
+			assert(!arena_alloc(g_arena, 16));
+	}
+	return NULL;
+}
+
+static void test_threads_read_frozen_arena(void)
+{
+	g_arena = arena_create(16 * 1024, false);
+	assert(g_arena);
+	for (int i = 0; i < 64; ++i)
+		memset(arena_alloc(g_arena, 32), i, 32);
+	g_used = arena_used(g_arena);
+	assert(arena_freeze(g_arena));
+
+	pthread_t threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_create(&threads[i], NULL, thread_reader, NULL);
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_join(threads[i], NULL);
+
+	assert(arena_get_stats(g_arena).failed_allocations == 0);
+	arena_delete(&g_arena);
+	printf("✅ test_threads_read_frozen_arena passed\n");
+}
+
+int main(void)
+{
+	test_threads_read_frozen_arena();
+	printf("🎉 All threaded arena_freeze tests passed.\n");
+	return 0;
+}
@@ -1,11 +1,15 @@
+#define _GNU_SOURCE
 #include "arena.h"
 #include "arena_io.h"
+#include "arena_writer.h"
 
 #include <assert.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
 #define THREAD_COUNT 8
@@ -79,6 +83,16 @@ void create_corrupt_file(const char* path)
 	fclose(f);
 }
 
+void* thread_read_file(void* arg)
+{
+	t_arena*     arena = (t_arena*) arg;
+	t_arena_view view  = arena_read_file(arena, SNAPSHOT_FILE, ARENA_READ_NUL_TERMINATE);
+	assert(view.data);
+	assert(view.size == sizeof(t_arena_snapshot_header) + strlen(TEST_STRING) + 1);
+	assert(strcmp((char*) view.data + sizeof(t_arena_snapshot_header), TEST_STRING) == 0);
+	return NULL;
+}
+
 void* thread_load_corrupt()
 {
 	t_arena arena;
@@ -88,6 +102,131 @@ void* thread_load_corrupt()
 	return NULL;
 }
 
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+#define PIPE_LEN (200 * 1000)
+#define GROW_LEN (1 << 20)
+
+typedef struct
+{
+	t_arena*     arena;
+	int          fd;
+	t_arena_view view;
+} t_pipe_payload;
+
+static void* thread_read_pipe(void* arg)
+{
+	t_pipe_payload* p = (t_pipe_payload*) arg;
+	p->view           = arena_read_fd(p->arena, p->fd, 0);
+	return NULL;
+}
+
+static void test_read_fd_unlocked(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	int fds[2];
+	assert(pipe(fds) == 0);
+
+	t_pipe_payload payload = {.arena = arena, .fd = fds[0]};
+	pthread_t      reader;
+	pthread_create(&reader, NULL, thread_read_pipe, &payload);
+	while (arena_get_stats(arena).allocations == 0)
+		usleep(1000);
+
+	// The reader is blocked on the empty pipe; its buffer must move for this allocation.
+	ARENA_LOCK(arena);
+	uint8_t* before = arena->buffer;
+	uint8_t* block  = arena_alloc(arena, GROW_LEN);
+	assert(block && arena->buffer != before);
+	memset(block, 0x5A, GROW_LEN);
+	size_t block_off = (size_t) (block - arena->buffer);
+	ARENA_UNLOCK(arena);
+
+	uint8_t* data = malloc(PIPE_LEN);
+	for (size_t i = 0; i < PIPE_LEN; ++i)
+		data[i] = (uint8_t) (i * 7 + 3);
+	assert(write(fds[1], data, PIPE_LEN) == PIPE_LEN);
+	close(fds[1]);
+	pthread_join(reader, NULL);
+
+	assert(payload.view.data && payload.view.size == PIPE_LEN);
+	assert(memcmp(payload.view.data, data, PIPE_LEN) == 0);
+	ARENA_LOCK(arena);
+	assert(arena->buffer[block_off] == 0x5A && arena->buffer[block_off + GROW_LEN - 1] == 0x5A);
+	assert(!arena->io_pins && !arena->io_retired);
+	ARENA_UNLOCK(arena);
+
+	free(data);
+	close(fds[0]);
+	arena_delete(&arena);
+	printf("✅ arena_read_fd without the lock passed\n");
+}
+
+typedef struct
+{
+	t_arena_writer* writer;
+	int             fd;
+	ssize_t         written;
+} t_flush_payload;
+
+static void* thread_flush(void* arg)
+{
+	t_flush_payload* p = (t_flush_payload*) arg;
+	p->written         = arena_writer_flush(p->writer, p->fd);
+	close(p->fd);
+	return NULL;
+}
+
+static void test_writer_flush_unlocked(void)
+{
+	t_arena* arena = arena_create(4096, true);
+	assert(arena);
+	t_arena_writer writer;
+	assert(arena_writer_init(&writer, arena, 0));
+	uint8_t* data = malloc(PIPE_LEN);
+	for (size_t i = 0; i < PIPE_LEN; ++i)
+		data[i] = (uint8_t) (i * 7 + 3);
+	assert(arena_writer_write(&writer, data, PIPE_LEN));
+
+	int fds[2];
+	assert(pipe(fds) == 0);
+	const int       capacity = fcntl(fds[1], F_GETPIPE_SZ);
+	t_flush_payload payload  = {.writer = &writer, .fd = fds[1]};
+	pthread_t       flusher;
+	pthread_create(&flusher, NULL, thread_flush, &payload);
+	int queued = 0;
+	while (queued < capacity)
+	{
+		usleep(1000);
+		assert(ioctl(fds[0], FIONREAD, &queued) == 0);
+	}
+
+	// The flusher is blocked on the full pipe; the chunks must move for this allocation.
+	ARENA_LOCK(arena);
+	uint8_t* before = arena->buffer;
+	assert(arena_alloc(arena, GROW_LEN) && arena->buffer != before);
+	ARENA_UNLOCK(arena);
+
+	uint8_t* received = malloc(PIPE_LEN);
+	size_t   got      = 0;
+	ssize_t  n;
+	while ((n = read(fds[0], received + got, PIPE_LEN - got)) > 0)
+		got += (size_t) n;
+	pthread_join(flusher, NULL);
+	assert(payload.written == PIPE_LEN && got == PIPE_LEN);
+	assert(memcmp(received, data, PIPE_LEN) == 0);
+	assert(!arena->io_pins && !arena->io_retired);
+
+	free(received);
+	free(data);
+	close(fds[0]);
+	arena_delete(&arena);
+	printf("✅ arena_writer_flush without the lock passed\n");
+}
+
+#endif
+
 int main(void)
 {
 	t_arena* arena = arena_create(BUFFER_SIZE, false);
@@ -139,6 +278,18 @@ int main(void)
 
 	printf("✅ Concurrent arena_load_from_file passed\n");
 
+	t_arena* shared = arena_create(64 * 1024, false);
+	assert(shared);
+	pthread_t read_threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_create(&read_threads[i], NULL, thread_read_file, shared);
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_join(read_threads[i], NULL);
+	assert(arena_get_stats(shared).allocations == THREAD_COUNT);
+	arena_delete(&shared);
+
+	printf("✅ Concurrent arena_read_file passed\n");
+
 	pthread_t fault, corrupt;
 	create_corrupt_file("corrupt.bin");
 
@@ -149,6 +300,11 @@ int main(void)
 
 	printf("✅ Fault injection tests passed\n");
 
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_read_fd_unlocked();
+	test_writer_flush_unlocked();
+#endif
+
 	arena_destroy(arena);
 	arena_delete(&arena);
 
@@ -0,0 +1,126 @@
+#include "arena.h"
+#include "arena_pregrow.h"
+#include "arena_stats.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+#define THREAD_COUNT 8
+#define ALLOCS_PER_THREAD 2000
+#define BLOCK_SIZE 256
+
+typedef struct
+{
+	t_arena* arena;
+	int      thread_id;
+	size_t   offsets[ALLOCS_PER_THREAD];
+} thread_args;
+
+static void* thread_func(void* arg)
+{
+	thread_args* args = (thread_args*) arg;
+	for (size_t i = 0; i < ALLOCS_PER_THREAD; ++i)
+	{
+		// Another thread's inline growth may move the buffer: fill and record under the lock.
+		ARENA_LOCK(args->arena);
+		uint8_t* block = arena_alloc(args->arena, BLOCK_SIZE);
+		assert(block);
+		memset(block, args->thread_id + 1, BLOCK_SIZE);
+		args->offsets[i] = (size_t) (block - args->arena->buffer);
+		ARENA_UNLOCK(args->arena);
+	}
+	return NULL;
+}
+
+static void test_threads_pregrow_concurrent_allocs(void)
+{
+	t_arena* arena = arena_create(16 * 1024, true);
+	assert(arena);
+	assert(arena_pregrow_watch(arena, 70));
+
+	pthread_t          threads[THREAD_COUNT];
+	static thread_args args[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; ++i)
+	{
+		args[i].arena     = arena;
+		args[i].thread_id = i;
+		assert(pthread_create(&threads[i], NULL, thread_func, &args[i]) == 0);
+	}
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_join(threads[i], NULL);
+
+	// Blocks keep their contents across background and inline growths. The
+	// worker may still be faulting pages in, so read under the arena lock.
+	ARENA_LOCK(arena);
+	for (int t = 0; t < THREAD_COUNT; ++t)
+		for (size_t i = 0; i < ALLOCS_PER_THREAD; ++i)
+		{
+			const uint8_t* block = arena->buffer + args[t].offsets[i];
+			for (size_t b = 0; b < BLOCK_SIZE; ++b)
+				assert(block[b] == (uint8_t) (t + 1));
+		}
+	ARENA_UNLOCK(arena);
+
+	t_arena_stats stats = arena_get_stats(arena);
+	assert(stats.allocations == THREAD_COUNT * ALLOCS_PER_THREAD);
+	assert(stats.reallocations >= stats.background_grows);
+
+	arena_delete(&arena);
+	printf("✅ test_threads_pregrow_concurrent_allocs passed\n");
+}
+
+static void* watch_toggle_func(void* arg)
+{
+	t_arena* arena = (t_arena*) arg;
+	for (int i = 0; i < 200; ++i)
+	{
+		assert(arena_pregrow_watch(arena, 50));
+		arena_pregrow_unwatch(arena);
+	}
+	return NULL;
+}
+
+static void test_threads_pregrow_watch_churn(void)
+{
+	t_arena* arenas[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		arenas[i] = arena_create(4096, true);
+		assert(arenas[i]);
+	}
+
+	// One arena stays watched while others come and go; it must keep growing ahead.
+	assert(arena_pregrow_watch(arenas[0], 50));
+	pthread_t threads[3];
+	for (int i = 0; i < 3; ++i)
+		assert(pthread_create(&threads[i], NULL, watch_toggle_func, arenas[i + 1]) == 0);
+
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 400; ++j)
+			assert(arena_alloc(arenas[i + 1], 64));
+	for (int i = 0; i < 1000; ++i)
+		assert(arena_alloc(arenas[0], 64));
+
+	for (int i = 0; i < 3; ++i)
+		pthread_join(threads[i], NULL);
+	for (int i = 0; i < 4; ++i)
+		arena_delete(&arenas[i]);
+	printf("✅ test_threads_pregrow_watch_churn passed\n");
+}
+
+#endif
+
+int main(void)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_threads_pregrow_concurrent_allocs();
+	test_threads_pregrow_watch_churn();
+	printf("🎉 All threaded arena_pregrow tests passed.\n");
+#else
+	printf("⚠️ Skipped threaded arena_pregrow tests (ARENA_ENABLE_THREAD_SAFE disabled)\n");
+#endif
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include "arena.h"
+#include "arena_reclaim.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+#define THREAD_COUNT 8
+#define ARENAS_PER_THREAD 40
+
+static void* churn_func(void* arg)
+{
+	(void) arg;
+	for (int i = 0; i < ARENAS_PER_THREAD; ++i)
+	{
+		t_arena* arena = arena_create(ARENA_MMAP_THRESHOLD, true);
+		assert(arena);
+		char* block = arena_alloc(arena, 3 * ARENA_MMAP_THRESHOLD);
+		assert(block);
+		memset(block, i, 3 * ARENA_MMAP_THRESHOLD);
+		arena_delete(&arena);
+	}
+	return NULL;
+}
+
+static void* flush_func(void* arg)
+{
+	(void) arg;
+	for (int i = 0; i < 50; ++i)
+		arena_reclaimer_flush();
+	return NULL;
+}
+
+static void test_threads_reclaim_churn(void)
+{
+	assert(arena_reclaimer_start(0));
+
+	pthread_t threads[THREAD_COUNT];
+	pthread_t flusher;
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		assert(pthread_create(&threads[i], NULL, churn_func, NULL) == 0);
+	assert(pthread_create(&flusher, NULL, flush_func, NULL) == 0);
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_join(threads[i], NULL);
+	pthread_join(flusher, NULL);
+
+	// Every buffer was either queued or, with the queue full, released inline.
+	arena_reclaimer_stop();
+	t_arena_reclaim_stats stats = arena_reclaimer_stats();
+	assert(stats.deferred + stats.inline_frees == THREAD_COUNT * ARENAS_PER_THREAD);
+	assert(stats.pending == 0 && stats.pending_bytes == 0);
+	printf("✅ test_threads_reclaim_churn passed\n");
+}
+
+#endif
+
+int main(void)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_threads_reclaim_churn();
+	printf("🎉 All threaded arena_reclaim tests passed.\n");
+#else
+	printf("⚠️ Skipped threaded arena_reclaim tests (ARENA_ENABLE_THREAD_SAFE disabled)\n");
+#endif
+	return 0;
+}
@@ -0,0 +1,66 @@
+#include "arena.h"
+#include "arena_recycle.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARENA_ENABLE_THREAD_SAFE
+
+#define THREAD_COUNT 8
+#define ARENAS_PER_THREAD 500
+
+static void* churn_func(void* arg)
+{
+	const size_t id   = (size_t) arg;
+	const size_t base = (size_t) 4096 << (id % 4);
+	for (int i = 0; i < ARENAS_PER_THREAD; ++i)
+	{
+		size_t   size  = base + (size_t) (i % 7) * 512;
+		t_arena* arena = arena_create(size, true);
+		assert(arena);
+		ARENA_SAN_OPEN(arena->buffer, arena->size);
+		for (size_t j = 0; j < arena->size; ++j)
+			assert(arena->buffer[j] == 0);
+
+		char* block = arena_alloc(arena, size / 2 + (size_t) i % 3 * size);
+		assert(block);
+		memset(block, (int) id + 1, size / 2);
+		arena_delete(&arena);
+	}
+	return NULL;
+}
+
+static void test_threads_recycle_churn(void)
+{
+	arena_recycle_enable(0);
+
+	pthread_t threads[THREAD_COUNT];
+	for (size_t i = 0; i < THREAD_COUNT; ++i)
+		assert(pthread_create(&threads[i], NULL, churn_func, (void*) i) == 0);
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		pthread_join(threads[i], NULL);
+
+	t_arena_recycle_stats stats = arena_recycle_stats();
+	assert(stats.hits + stats.misses == THREAD_COUNT * ARENAS_PER_THREAD);
+	assert(stats.struct_hits + stats.struct_misses == THREAD_COUNT * ARENAS_PER_THREAD);
+	assert(stats.hits > 0 && stats.struct_hits > 0);
+
+	arena_recycle_disable();
+	stats = arena_recycle_stats();
+	assert(stats.cached_buffers == 0 && stats.cached_bytes == 0);
+	printf("✅ test_threads_recycle_churn passed\n");
+}
+
+#endif
+
+int main(void)
+{
+#ifdef ARENA_ENABLE_THREAD_SAFE
+	test_threads_recycle_churn();
+	printf("🎉 All threaded arena_recycle tests passed.\n");
+#else
+	printf("⚠️ Skipped threaded arena_recycle tests (ARENA_ENABLE_THREAD_SAFE disabled)\n");
+#endif
+	return 0;
+}
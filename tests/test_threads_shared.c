@@ -0,0 +1,122 @@
+#include "arena_shared.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define THREAD_COUNT 4
+#define PROCESS_COUNT 3
+#define ALLOCS_PER_WORKER 500
+#define RECORD_SIZE 24
+
+typedef struct
+{
+	uint32_t owner;
+	uint32_t seq;
+	uint8_t  fill[RECORD_SIZE - 8];
+} t_record;
+
+typedef struct
+{
+	t_shared_arena* arena;
+	uint32_t        owner;
+} t_worker;
+
+static void run_worker(t_shared_arena* arena, uint32_t owner)
+{
+	for (uint32_t i = 0; i < ALLOCS_PER_WORKER; ++i)
+	{
+		t_record* rec = arena_shared_alloc(arena, sizeof(t_record), (i % 2) ? 8 : 16);
+		assert(rec);
+		rec->owner = owner;
+		rec->seq   = i;
+		memset(rec->fill, (int) owner, sizeof(rec->fill));
+	}
+}
+
+static void* thread_worker(void* arg)
+{
+	t_worker* w = (t_worker*) arg;
+	run_worker(w->arena, w->owner);
+	return NULL;
+}
+
+static void test_threads_and_processes_share_bump(void)
+{
+	const size_t    total = (THREAD_COUNT + PROCESS_COUNT) * ALLOCS_PER_WORKER;
+	t_shared_arena* arena = arena_create_shared(NULL, total * (sizeof(t_record) + 16));
+	assert(arena);
+
+	pid_t pids[PROCESS_COUNT];
+	for (int p = 0; p < PROCESS_COUNT; ++p)
+	{
+		pids[p] = fork();
+		assert(pids[p] >= 0);
+		if (pids[p] == 0)
+		{
+			t_shared_arena* child = arena_open_shared_fd(arena->fd);
+			if (!child)
+				_exit(1);
+			run_worker(child, (uint32_t) (THREAD_COUNT + p + 1));
+			arena_shared_close(&child);
+			_exit(0);
+		}
+	}
+
+	pthread_t threads[THREAD_COUNT];
+	t_worker  workers[THREAD_COUNT];
+	for (int t = 0; t < THREAD_COUNT; ++t)
+	{
+		workers[t] = (t_worker){.arena = arena, .owner = (uint32_t) (t + 1)};
+		pthread_create(&threads[t], NULL, thread_worker, &workers[t]);
+	}
+	for (int t = 0; t < THREAD_COUNT; ++t)
+		pthread_join(threads[t], NULL);
+	for (int p = 0; p < PROCESS_COUNT; ++p)
+	{
+		int status = 0;
+		assert(waitpid(pids[p], &status, 0) == pids[p]);
+		assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+	}
+
+	t_arena_stats stats = arena_shared_get_stats(arena);
+	assert(stats.allocations == total);
+	assert(stats.bytes_allocated == total * sizeof(t_record));
+	assert(stats.failed_allocations == 0);
+	assert(arena_shared_used(arena) == stats.bytes_allocated + stats.wasted_alignment_bytes);
+
+	// Walk the region: every record is intact, so no two allocations overlapped.
+	uint32_t next_seq[THREAD_COUNT + PROCESS_COUNT + 1] = {0};
+	size_t   found                                      = 0;
+	size_t   pos                                        = 0;
+	while (pos + sizeof(t_record) <= arena_shared_used(arena))
+	{
+		t_record* rec = (t_record*) (arena->data + pos);
+		if (rec->owner == 0)
+		{
+			pos += 8;
+			continue;
+		}
+		assert(rec->owner <= THREAD_COUNT + PROCESS_COUNT);
+		assert(rec->seq == next_seq[rec->owner]++);
+		for (size_t i = 0; i < sizeof(rec->fill); ++i)
+			assert(rec->fill[i] == (uint8_t) rec->owner);
+		pos += sizeof(t_record);
+		found++;
+	}
+	assert(found == total);
+
+	arena_shared_close(&arena);
+	printf("✅ test_threads_and_processes_share_bump passed\n");
+}
+
+int main(void)
+{
+	test_threads_and_processes_share_bump();
+	printf("🎉 All threaded arena_shared tests passed.\n");
+	return 0;
+}
@@ -27,11 +27,17 @@ void* thread_alloc_and_track(void* arg)
 	while (total_allocated < MAX_TOTAL_ALLOC_PER_THREAD)
 	{
 		size_t size = 64 + (rand() % 128);
-		void*  ptr  = arena_alloc(arena, size);
+
+		// A growth copies the buffer while other threads fill their blocks, and writes made
+		// after the copy are lost: allocate and fill under the (recursive) lock.
+		ARENA_LOCK(arena);
+		void* ptr = arena_alloc(arena, size);
+		if (ptr)
+			memset(ptr, id, size);
+		ARENA_UNLOCK(arena);
 		if (!ptr)
 			break;
 
-		memset(ptr, id, size);
 		total_allocated += size;
 		usleep(500);
 	}